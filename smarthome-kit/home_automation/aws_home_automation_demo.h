@@ -57,5 +57,31 @@ typedef struct Shadow_Properties
     AIRCON_STATE      aircon;
 } xShadowProperties;
 
+/* Connector publish coalescer statistics. Ratio of ulChanges to ulPublishes
+   shows how many MQTT round trips were saved. */
+typedef struct Coalescer_Stats
+{
+    uint32_t          ulWindowMs;   // Coalescing window
+    uint32_t          ulChanges;    // Changes received from HVAC
+    uint32_t          ulFlushes;    // Expired windows
+    uint32_t          ulPublishes;  // Status and shadow publishes issued
+    uint32_t          ulErrors;     // Failed publishes
+    uint32_t          ulMaxBatch;   // Most changes merged into one flush
+} xCoalescerStats;
+
+void vGetCoalescerStats( xCoalescerStats *pxStats );
+
+/* Incoming config and shadow delta parse statistics, times in microseconds. */
+typedef struct Parse_Stats
+{
+    uint32_t          ulMessages;   // Parsed messages
+    uint32_t          ulErrors;     // Malformed messages dropped
+    uint32_t          ulLastUs;     // Parse time of the last message
+    uint32_t          ulMaxUs;      // Longest parse time
+    uint32_t          ulTotalUs;    // Sum of parse times
+} xParseStats;
+
+void vGetParseStats( xParseStats *pxStats );
+
 
 #endif
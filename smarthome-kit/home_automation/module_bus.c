@@ -0,0 +1,328 @@
+/*
+    module_bus.c
+
+    | Global Library Prefix | **BUS**               |
+    |:---------------------:|:---------------------:|
+    | Version               | **1.0.0**             |
+
+    ---
+
+    **Version Info :**
+    - **1.0.0** Module Created
+
+-----------------------------------------------------------------------------
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include "module_bus.h"
+#include "module_common.h"
+
+/* ------------------------------------------------------------------- MACROS */
+//                                                                     ------
+
+//  Upper bound of the first histogram bucket, each next one is 10x wider.
+
+#define BUS_WAIT_HIST_FIRST_US      10
+
+//  Maximum number of tasks of single client waiting for the bus.
+
+#define BUS_CLIENT_TASKS_MAX        4
+
+//  Owner value while bus is free.
+
+#define BUS_OWNER_NONE              BUS_CLIENT_CNT
+
+/* ---------------------------------------------------------------- VARIABLES */
+//                                                                  ---------
+
+/*
+    Bus is passed by grants. Releasing client picks next owner and gives its
+    grant semaphore, so the bus can not be taken by anybody else in between
+    whatever the task priorities are.
+*/
+
+static SemaphoreHandle_t    bus_grant[ BUS_CLIENT_CNT ];
+
+static volatile BUS_CLIENT  bus_owner = BUS_OWNER_NONE;
+
+//  Number of tasks of each client waiting for the grant.
+
+static volatile uint8_t     bus_waiting[ BUS_CLIENT_CNT ];
+
+static BUS_STATS            bus_stats[ BUS_CLIENT_CNT ];
+
+/* ------------------------------------------- PRIVATE FUNCTIONS DECLARATIONS */
+//                                             ------------------------------
+
+static BUS_CLIENT bus_next_owner ( BUS_CLIENT below );
+
+static void bus_grant_next ( void );
+
+static bool bus_wait_grant ( BUS_CLIENT client, TickType_t timeout );
+
+static void bus_record_wait ( BUS_CLIENT client, uint32_t wait_us );
+
+static bool bus_wifi_acquire ( uint32_t timeout_ms );
+
+static void bus_wifi_release ( void );
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+//                                                           ----------------
+
+void BUS_Initialize ( void )
+{
+    BUS_CLIENT  i;
+
+    for ( i = 0; i < BUS_CLIENT_CNT; i++ )
+    {
+        bus_grant[ i ] = xSemaphoreCreateCounting( BUS_CLIENT_TASKS_MAX, 0 );
+    }
+
+    WDRV_STUB_SPI_BusArbiterSet( bus_wifi_acquire, bus_wifi_release );
+}
+
+bool BUS_Acquire ( BUS_CLIENT client, TickType_t timeout )
+{
+    uint32_t    start;
+
+    start = MODULE_CYCLE_COUNT( );
+
+    taskENTER_CRITICAL( );
+
+    if ( bus_owner == BUS_OWNER_NONE )
+    {
+        bus_owner = client;
+        taskEXIT_CRITICAL( );
+    }
+    else if ( !timeout )
+    {
+        taskEXIT_CRITICAL( );
+        bus_stats[ client ].timeouts++;
+
+        return false;
+    }
+    else
+    {
+        bus_waiting[ client ]++;
+        taskEXIT_CRITICAL( );
+
+        if ( !bus_wait_grant( client, timeout ) )
+        {
+            return false;
+        }
+    }
+
+    bus_record_wait( client,
+            ( MODULE_CYCLE_COUNT( ) - start ) / MODULE_CYCLES_PER_US );
+
+    return true;
+}
+
+bool BUS_Release ( BUS_CLIENT client )
+{
+    taskENTER_CRITICAL( );
+
+    if ( bus_owner != client )
+    {
+        taskEXIT_CRITICAL( );
+
+        return false;
+    }
+
+    bus_grant_next( );
+    taskEXIT_CRITICAL( );
+
+    return true;
+}
+
+bool BUS_Yield ( BUS_CLIENT client, TickType_t timeout )
+{
+    uint32_t    start;
+
+    taskENTER_CRITICAL( );
+
+    if ( bus_owner != client )
+    {
+        taskEXIT_CRITICAL( );
+
+        return false;
+    }
+
+    if ( bus_next_owner( client ) == BUS_OWNER_NONE )
+    {
+        taskEXIT_CRITICAL( );
+
+        return true;
+    }
+
+    /*
+        Higher priority client gets the bus directly. Yielding client
+        queues up as waiter in the same step, so it gets the grant back
+        when the bus is released.
+    */
+
+    bus_waiting[ client ]++;
+    bus_grant_next( );
+    taskEXIT_CRITICAL( );
+
+    bus_stats[ client ].yields++;
+    start = MODULE_CYCLE_COUNT( );
+
+    if ( !bus_wait_grant( client, timeout ) )
+    {
+        return false;
+    }
+
+    bus_record_wait( client,
+            ( MODULE_CYCLE_COUNT( ) - start ) / MODULE_CYCLES_PER_US );
+
+    return true;
+}
+
+void BUS_GetStats ( BUS_CLIENT client, BUS_STATS *stats )
+{
+    taskENTER_CRITICAL( );
+    *stats = bus_stats[ client ];
+    taskEXIT_CRITICAL( );
+}
+
+/* -------------------------------------------------------- PRIVATE FUNCTIONS */
+//                                                          -----------------
+
+//  Highest priority waiting client above given one, BUS_OWNER_NONE if none.
+
+static BUS_CLIENT bus_next_owner ( BUS_CLIENT below )
+{
+    BUS_CLIENT  i;
+
+    for ( i = 0; i < below; i++ )
+    {
+        if ( bus_waiting[ i ] )
+        {
+            return i;
+        }
+    }
+
+    return BUS_OWNER_NONE;
+}
+
+//  Must be called from critical section by the bus owner.
+
+static void bus_grant_next ( void )
+{
+    bus_owner = bus_next_owner( BUS_CLIENT_CNT );
+
+    if ( bus_owner != BUS_OWNER_NONE )
+    {
+        bus_waiting[ bus_owner ]--;
+        xSemaphoreGive( bus_grant[ bus_owner ] );
+    }
+}
+
+static bool bus_wait_grant ( BUS_CLIENT client, TickType_t timeout )
+{
+    bool    granted;
+
+    if ( xSemaphoreTake( bus_grant[ client ], timeout ) == pdTRUE )
+    {
+        return true;
+    }
+
+    /*
+        Grant could be given after the timeout expired. It has to be taken
+        then, otherwise the bus stays owned by nobody.
+    */
+
+    taskENTER_CRITICAL( );
+
+    granted = ( xSemaphoreTake( bus_grant[ client ], 0 ) == pdTRUE );
+
+    if ( !granted )
+    {
+        bus_waiting[ client ]--;
+    }
+
+    taskEXIT_CRITICAL( );
+
+    if ( !granted )
+    {
+        bus_stats[ client ].timeouts++;
+    }
+
+    return granted;
+}
+
+static bool bus_wifi_acquire ( uint32_t timeout_ms )
+{
+    return BUS_Acquire( BUS_CLIENT_WIFI, pdMS_TO_TICKS( timeout_ms ) );
+}
+
+static void bus_wifi_release ( void )
+{
+    BUS_Release( BUS_CLIENT_WIFI );
+}
+
+static void bus_record_wait ( BUS_CLIENT client, uint32_t wait_us )
+{
+    BUS_STATS   *stats = &bus_stats[ client ];
+    uint32_t    bound = BUS_WAIT_HIST_FIRST_US;
+    uint8_t     bucket = 0;
+
+    while ( ( bucket < BUS_WAIT_HIST_BUCKETS - 1 ) && ( wait_us >= bound ) )
+    {
+        bound *= 10;
+        bucket++;
+    }
+
+    stats->acquired++;
+    stats->wait_hist[ bucket ]++;
+
+    if ( wait_us > stats->wait_max_us )
+    {
+        stats->wait_max_us = wait_us;
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*
+    module_bus.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
@@ -0,0 +1,186 @@
+/*
+    module_bus.h
+
+-----------------------------------------------------------------------------
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+/**
+    \file     module_bus.h
+    \brief    SPI2 Bus Arbiter
+    \defgroup BUS
+    \brief    SPI2 Bus Arbiter
+    \{
+
+| Global Library Prefix | **BUS**               |
+|:---------------------:|:---------------------:|
+| Version               | **1.0.0**             |
+
+---
+
+**Version Info :**
+- **1.0.0** Module Created
+
+SPI2 is shared by WILC1000 and OLED C click. Each client owns the bus for one
+chip select window at most. Long users ( display frame ) call BUS_Yield
+between windows so higher priority client ( WiFi ) waiting for the bus gets
+it before the next window is started.
+
+Bus is handed over explicitly : release grants it to the highest priority
+waiting client, so client priority does not depend on task priorities. Bus
+is not a mutex, owner task does not inherit priority of waiting tasks.
+
+WiFi driver acquires the bus through the WDRV SPI arbiter hook, it is
+registered by BUS_Initialize.
+
+Time spent waiting for the bus is recorded per client in a histogram with
+decade buckets : < 10 us, < 100 us, < 1 ms, < 10 ms, < 100 ms and above.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#ifndef _MODULE_BUS_H_
+#define _MODULE_BUS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "FreeRTOS.h"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define BUS_WAIT_HIST_BUCKETS       6
+
+/* -------------------------------------------------------------------- TYPES */
+
+//  Clients in priority order, lower value wins.
+
+typedef enum
+{
+    BUS_CLIENT_WIFI             = 0,
+    BUS_CLIENT_DISPLAY,
+    BUS_CLIENT_CNT
+
+} BUS_CLIENT;
+
+/**
+    \struct BUS_STATS
+    \brief Bus usage of single client
+
+*/
+typedef struct
+{
+    uint32_t            acquired;
+    uint32_t            timeouts;
+    uint32_t            yields;
+    uint32_t            wait_max_us;
+    uint32_t            wait_hist[ BUS_WAIT_HIST_BUCKETS ];
+
+} BUS_STATS;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+    \brief Bus Arbiter Initialization
+
+Has to be called before any client uses the bus and before WiFi driver is
+initialized.
+*/
+void BUS_Initialize ( void );
+
+/**
+    \brief Acquire bus
+
+    \param[in] client       bus client
+    \param[in] timeout      maximum block time in ticks
+
+    \retval true if bus is acquired
+*/
+bool BUS_Acquire ( BUS_CLIENT client, TickType_t timeout );
+
+/**
+    \brief Release bus
+
+    \param[in] client       bus client
+
+    \retval true if bus was held by the client and is released
+
+Release by a client which does not hold the bus is rejected, the bus stays
+with its owner.
+*/
+bool BUS_Release ( BUS_CLIENT client );
+
+/**
+    \brief Preemption point
+
+    \param[in] client       bus client holding the bus
+    \param[in] timeout      maximum block time in ticks to get bus back
+
+    \retval true if client still holds the bus
+
+Must be called only while chip select of the client is released. If client
+with higher priority waits for the bus, bus is granted to it and caller
+blocks until it is released and granted back. Otherwise returns immediately.
+
+On false return bus is not held by the caller anymore. Client which does
+not hold the bus gets false and nothing is yielded.
+*/
+bool BUS_Yield ( BUS_CLIENT client, TickType_t timeout );
+
+/**
+    \brief Get bus statistics of client
+
+    \param[in] client       bus client
+    \param[out] stats       statistics
+*/
+void BUS_GetStats ( BUS_CLIENT client, BUS_STATS *stats );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/// \}
+/* -------------------------------------------------------------------------- */
+/*
+    module_bus.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
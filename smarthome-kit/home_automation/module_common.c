@@ -21,6 +21,7 @@
 ----------------------------------------------------------------------------- */
 
 #include "module_common.h"
+#include "module_bus.h"
 
 #include "remote_hvac/module_hvac.h"
 #include "remote_hvac/module_sensor.h"
@@ -32,7 +33,6 @@
 //                                                                  ---------
 
 SemaphoreHandle_t    smphrSPI1;                 // THERMOSTAT / SENSOR
-SemaphoreHandle_t    smphrSPI2;                 // CONN / DISPLAY
 
 QueueHandle_t        qHVAC_Fan;                 // CONN             -> HVAC
 QueueHandle_t        qHVAC_Sensor;              // SENSOR           -> HVAC
@@ -50,13 +50,29 @@ QueueHandle_t        qDISPLAY_Sensor;           // HVAC             -> DISPLAY
 QueueHandle_t        qDISPLAY_TargetT;          // HVAC             -> DISPLAY
 QueueHandle_t        qDISPLAY_Conn;             // CONN             -> DISPLAY
 
+MODULE_EVENTS        evSENSOR;                  // delay only
+MODULE_EVENTS        evTHERMOSTAT;              // ISR
+MODULE_EVENTS        evHVAC;                    // qHVAC_*
+MODULE_EVENTS        evDISPLAY;                 // qDISPLAY_* / ISR
+MODULE_EVENTS        evCONN;                    // qCONN_* (except reported)
+
+/* ------------------------------------------- PRIVATE FUNCTIONS DECLARATIONS */
+//                                             ------------------------------
+
+static void module_events_create ( MODULE_EVENTS *events, bool signaled );
+
+static void module_count_wakeup ( MODULE_EVENTS *events );
+
 /* --------------------------------------------------------- PUBLIC FUNCTIONS */
 //                                                           ----------------
 
 void MODULES_Initialize ( void )
 {
     smphrSPI1           = xSemaphoreCreateMutex( );
-    smphrSPI2           = xSemaphoreCreateMutex( );
+
+    //  SPI2 is shared by CONN ( WiFi ) and DISPLAY through bus arbiter.
+
+    BUS_Initialize( );
     
     qHVAC_Fan           = xQueueCreate( 4, sizeof( FAN_STATE ) );
     qHVAC_Sensor        = xQueueCreate( 4, sizeof( SENSOR_VALUE ) );
@@ -73,6 +89,125 @@ void MODULES_Initialize ( void )
     qDISPLAY_Sensor     = xQueueCreate( 4, sizeof( SENSOR_VALUE ) );
     qDISPLAY_Conn       = xQueueCreate( 4, sizeof( int ) );
     qDISPLAY_TargetT    = xQueueCreate( 4, sizeof( float ) );
+
+    //  Sensor has no event source, rest is woken by posts or ISR.
+
+    module_events_create( &evSENSOR, false );
+    module_events_create( &evTHERMOSTAT, true );
+    module_events_create( &evHVAC, true );
+    module_events_create( &evDISPLAY, true );
+    module_events_create( &evCONN, true );
+}
+
+void MODULE_WaitForEvent ( MODULE_EVENTS *events, uint32_t poll_ms, 
+        TickType_t timeout )
+{
+#if MODULE_EVENT_DRIVEN
+    if ( events->wake != NULL )
+    {
+        /*
+            Posts made while the task was running leave the semaphore given, 
+            task passes once more and finds its queues empty at worst.
+        */
+
+        xSemaphoreTake( events->wake, timeout );
+    }
+    else
+    {
+        vTaskDelay( timeout );
+    }
+#else
+    vTaskDelay( poll_ms / portTICK_PERIOD_MS );
+#endif
+    module_count_wakeup( events );
+}
+
+BaseType_t MODULE_Post ( QueueHandle_t queue, const void *item, 
+        MODULE_EVENTS *events )
+{
+    BaseType_t ret = xQueueSend( queue, item, RTOS_NO_BLOCKING );
+
+    if ( ( ret == pdTRUE ) && ( events->wake != NULL ) )
+    {
+        xSemaphoreGive( events->wake );
+    }
+
+    return ret;
+}
+
+void MODULE_WakeFromISR ( MODULE_EVENTS *events )
+{
+    BaseType_t woken = pdFALSE;
+
+    if ( events->wake != NULL )
+    {
+        xSemaphoreGiveFromISR( events->wake, &woken );
+        portEND_SWITCHING_ISR( woken );
+    }
+}
+
+uint32_t MODULE_GetWakeupsPerSecond ( MODULE_EVENTS *events )
+{
+    TickType_t elapsed = xTaskGetTickCount( ) - events->window_start;
+
+    /*
+        Task blocked longer than statistics period is reported using still 
+        open window, latched value would be stale.
+    */
+
+    if ( elapsed >= 2 * ( MODULE_WAKEUP_STATS_PERIOD / portTICK_PERIOD_MS ) )
+    {
+        return ( events->wakeups * configTICK_RATE_HZ ) / elapsed;
+    }
+
+    return events->wakeups_per_sec;
+}
+
+void MODULES_LogWakeups ( void )
+{
+    vLoggingPrintf( "Wakeups/s SENSOR:%u THERMOSTAT:%u HVAC:%u DISPLAY:%u "
+            "CONN:%u\r\n",
+            MODULE_GetWakeupsPerSecond( &evSENSOR ),
+            MODULE_GetWakeupsPerSecond( &evTHERMOSTAT ),
+            MODULE_GetWakeupsPerSecond( &evHVAC ),
+            MODULE_GetWakeupsPerSecond( &evDISPLAY ),
+            MODULE_GetWakeupsPerSecond( &evCONN ) );
+}
+
+/* -------------------------------------------------------- PRIVATE FUNCTIONS */
+//                                                          -----------------
+
+static void module_events_create ( MODULE_EVENTS *events, bool signaled )
+{
+    events->wakeups         = 0;
+    events->wakeups_total   = 0;
+    events->wakeups_per_sec = 0;
+    events->window_start    = xTaskGetTickCount( );
+    events->wake            = NULL;
+
+    //  Module without any event source is only delayed.
+
+    if ( signaled )
+    {
+        events->wake = xSemaphoreCreateBinary( );
+    }
+}
+
+static void module_count_wakeup ( MODULE_EVENTS *events )
+{
+    TickType_t now = xTaskGetTickCount( );
+    TickType_t elapsed = now - events->window_start;
+
+    ++events->wakeups;
+    ++events->wakeups_total;
+
+    if ( elapsed >= ( MODULE_WAKEUP_STATS_PERIOD / portTICK_PERIOD_MS ) )
+    {
+        events->wakeups_per_sec = ( events->wakeups * configTICK_RATE_HZ ) / 
+                elapsed;
+        events->wakeups         = 0;
+        events->window_start    = now;
+    }
 }
 
 
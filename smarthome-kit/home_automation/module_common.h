@@ -49,11 +49,23 @@
 
 #define RTOS_NO_BLOCKING            0
 
+//  Stack sizes in words, host builds with other word sizes provide their own.
+
+#ifndef SENSOR_TASK_STACK_SIZE
 #define SENSOR_TASK_STACK_SIZE      256
+#endif
+#ifndef THERMOSTAT_TASK_STACK_SIZE
 #define THERMOSTAT_TASK_STACK_SIZE  256
+#endif
+#ifndef HVAC_TASK_STACK_SIZE
 #define HVAC_TASK_STACK_SIZE        2048
+#endif
+#ifndef DISPLAY_TASK_STACK_SIZE
 #define DISPLAY_TASK_STACK_SIZE     20480
+#endif
+#ifndef CONNECTOR_TASK_STACK_SIZE
 #define CONNECTOR_TASK_STACK_SIZE   3072
+#endif
 
 #define SENSOR_TASK_PRIORITY        1
 #define THERMOSTAT_TASK_PRIORITY    1
@@ -67,6 +79,55 @@
 #define DISPLAY_TASK_DELAY          1
 #define CONNECTOR_TASK_DELAY        1
 
+//  Changes received by connector within this window are published together.
+
+#define CONNECTOR_COALESCE_WINDOW   500
+
+/*
+    Event driven scheduling.
+
+When enabled module tasks block on their wake semaphore instead of polling 
+queues every TASK_DELAY. Periods below are used only in event 
+driven mode as upper bound for work which can not be signaled by an event.
+*/
+#define MODULE_EVENT_DRIVEN         1
+
+#define HVAC_BUTTON_POLL_PERIOD     20
+#define DISPLAY_ANIMATION_PERIOD    100
+#define MODULE_WAKEUP_STATS_PERIOD  1000
+
+//  Display gives SPI2 to WiFi between bands and waits this long to get it back.
+
+#define DISPLAY_BUS_YIELD_TIMEOUT   50
+
+//  Debug logging, off by default to keep the console quiet.
+
+#ifndef SENSOR_LOG_SAMPLE_BYTES
+#define SENSOR_LOG_SAMPLE_BYTES     0
+#endif
+#ifndef MODULE_LOG_WAKEUPS
+#define MODULE_LOG_WAKEUPS          0
+#endif
+
+/*
+    Board services.
+
+Modules touch the board only through these and the click driver HAL. A port
+to another board, or a host build with simulated clicks, provides its own
+definitions before this header is included.
+*/
+
+#ifndef MODULE_CYCLE_COUNT
+//  Core timer runs at half of the system clock.
+#define MODULE_CYCLE_COUNT()        _CP0_GET_COUNT( )
+#define MODULE_CYCLES_PER_US        ( SYS_CLK_FREQ / 2 / 1000000 )
+#endif
+
+#ifndef MODULE_BUTTON_1
+#define MODULE_BUTTON_1()           BOARDBTN_1StateGet( )
+#define MODULE_BUTTON_2()           BOARDBTN_2StateGet( )
+#endif
+
 #define jsonFAN_REFERENCE           ("FAN")
 #define jsonAIRCON_REFERENCE        ("AIRCON")
 #define jsonSENSOR_T_REFERENCE      ("SENSOR_T")
@@ -80,6 +141,10 @@
 #define mqttAIRCON_DESIRED_PAYLOAD  ("{ \"state\":{\"desired\":{\"%s\":\"%s\"}}}")
 #define mqttTARGET_REPORTED_PAYLOAD ("{ \"state\":{\"reported\":{\"%s\":\"%.1f\"}}}")
 #define mqttTARGET_DESIRED_PAYLOAD  ("{ \"state\":{\"desired\":{\"%s\":\"%.1f\"}}}")
+#define mqttDESIRED_BEGIN           ("{ \"state\":{\"desired\":{")
+#define mqttDESIRED_END             ("}}}")
+#define mqttSTRING_FIELD            ("%s\"%s\":\"%s\"")
+#define mqttFLOAT_FIELD             ("%s\"%s\":\"%.1f\"")
 
 #define logSENSOR_PAYLOAD           ("<\"%s\":\"%.1f\", \"%s\":\"%.1f\">\r\n")
 #define logFAN_PAYLOAD              ("<\"%s\":\"%s\">\r\n")
@@ -113,10 +178,31 @@ typedef enum
 
 } MODULE_STATE;
 
+/**
+    \struct MODULE_EVENTS
+    \brief Module event sources and wakeup statistics
+
+Wake semaphore is given by every post to one of the module input queues 
+( MODULE_Post ) and by the module ISR handlers. It is a binary semaphore, 
+several posts may end up as one wakeup, so module task has to drain all of 
+its input queues on every pass. Modules without any event source have NULL 
+wake semaphore and are only delayed.
+
+*/
+typedef struct
+{
+    SemaphoreHandle_t   wake;
+
+    uint32_t            wakeups;
+    uint32_t            wakeups_total;
+    uint32_t            wakeups_per_sec;
+    TickType_t          window_start;
+
+} MODULE_EVENTS;
+
 /* ----------------------------------------------------------- RTOS VARIABLES */
 
 extern SemaphoreHandle_t    smphrSPI1;
-extern SemaphoreHandle_t    smphrSPI2;
 
 extern QueueHandle_t        qHVAC_Fan;
 extern QueueHandle_t        qHVAC_Sensor;
@@ -134,6 +220,12 @@ extern QueueHandle_t        qDISPLAY_Sensor;
 extern QueueHandle_t        qDISPLAY_TargetT;
 extern QueueHandle_t        qDISPLAY_Conn;
 
+extern MODULE_EVENTS        evSENSOR;
+extern MODULE_EVENTS        evTHERMOSTAT;
+extern MODULE_EVENTS        evHVAC;
+extern MODULE_EVENTS        evDISPLAY;
+extern MODULE_EVENTS        evCONN;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -143,6 +235,61 @@ extern "C" {
 */
 void MODULES_Initialize ( void );
 
+/**
+    \brief Wait for next module event
+
+    \param[in] events      module event sources
+    \param[in] poll_ms     task delay used in polling mode
+    \param[in] timeout     maximum block time in ticks used in event mode
+
+In event driven mode task blocks until wake semaphore is given or timeout 
+expires. Otherwise task is 
+delayed for poll_ms like before. In both modes wakeup is counted.
+*/
+void MODULE_WaitForEvent ( MODULE_EVENTS *events, uint32_t poll_ms, 
+        TickType_t timeout );
+
+/**
+    \brief Post item to module input queue
+
+    \param[in] queue       input queue of the receiving module
+    \param[in] item        item to copy into the queue
+    \param[in] events      event sources of the receiving module
+
+    \retval pdTRUE when item was queued
+
+Item is sent without blocking and receiving module task is woken up.
+*/
+BaseType_t MODULE_Post ( QueueHandle_t queue, const void *item, 
+        MODULE_EVENTS *events );
+
+/**
+    \brief Wake module task from ISR
+
+    \param[in] events      module event sources
+
+Used by ISR handlers after module state change so module blocked on its 
+wake semaphore can react to it.
+*/
+void MODULE_WakeFromISR ( MODULE_EVENTS *events );
+
+/**
+    \brief Module task wakeups per second
+
+    \param[in] events      module event sources
+
+    \retval number of task wakeups during last statistics period
+*/
+uint32_t MODULE_GetWakeupsPerSecond ( MODULE_EVENTS *events );
+
+/**
+    \brief Log wakeups per second of all modules
+
+    Sensor task calls it every SENSOR_TASK_DELAY when MODULE_LOG_WAKEUPS is
+    enabled.
+*/
+void MODULES_LogWakeups ( void );
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,500 @@
+/*
+    module_json.c
+
+    | Global Library Prefix | **JSON**              |
+    |:---------------------:|:---------------------:|
+    | Version               | **1.0.0**             |
+    
+    ---
+    
+    **Version Info :**
+    - **1.0.0** Module Created
+
+-----------------------------------------------------------------------------
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "module_json.h"
+
+/* ------------------------------------------------------------------- MACROS */
+//                                                                     ------
+
+//  Longest number accepted by JSON_FieldToFloat.
+
+#define JSON_NUMBER_MAX_LEN         15
+
+/* -------------------------------------------------------------------- TYPES */
+//                                                                      -----
+
+typedef struct
+{
+    const char          *cur;
+    const char          *end;
+    bool                any_depth;
+    JSON_FIELD          *fields;
+    uint8_t             field_cnt;
+
+} JSON_CTX;
+
+/* ------------------------------------------- PRIVATE FUNCTIONS DECLARATIONS */
+//                                             ------------------------------
+
+static void skip_ws ( JSON_CTX *ctx );
+
+static JSON_RETURN parse_object ( JSON_CTX *ctx, uint8_t depth, 
+        const char *path );
+
+static JSON_RETURN parse_array ( JSON_CTX *ctx, uint8_t depth );
+
+static JSON_RETURN parse_value ( JSON_CTX *ctx, uint8_t depth, 
+        const char *path, const char **value, uint16_t *length );
+
+static JSON_RETURN parse_string ( JSON_CTX *ctx, const char **value, 
+        uint16_t *length );
+
+static JSON_RETURN parse_primitive ( JSON_CTX *ctx, const char **value, 
+        uint16_t *length );
+
+static const char *path_next ( const char *path, const char *key, 
+        uint16_t key_len );
+
+static void match_key ( JSON_CTX *ctx, const char *key, uint16_t key_len, 
+        const char *value, uint16_t length );
+
+static void clear_fields ( JSON_FIELD *fields, uint8_t field_cnt );
+
+/* --------------------------------------------------------- PUBLIC FUNCTIONS */
+//                                                           ----------------
+
+JSON_RETURN JSON_Extract ( const char *json, size_t len, const char *path,
+        JSON_FIELD *fields, uint8_t field_cnt )
+{
+    JSON_CTX    ctx;
+
+    ctx.cur         = json;
+    ctx.end         = json + len;
+    ctx.any_depth   = ( path == NULL );
+    ctx.fields      = fields;
+    ctx.field_cnt   = field_cnt;
+
+    clear_fields( fields, field_cnt );
+
+    skip_ws( &ctx );
+
+    if ( ( ctx.cur >= ctx.end ) || ( *ctx.cur != '{' ) ||
+            ( parse_object( &ctx, 1, path ) != JSON_OK ) )
+    {
+        clear_fields( fields, field_cnt );
+        return JSON_ERROR;
+    }
+
+    //  Only white space or string terminator may follow the document.
+
+    while ( ( ctx.cur < ctx.end ) && ( *ctx.cur == '\0' ) )
+    {
+        ++ctx.cur;
+        skip_ws( &ctx );
+    }
+
+    skip_ws( &ctx );
+
+    if ( ctx.cur != ctx.end )
+    {
+        clear_fields( fields, field_cnt );
+        return JSON_ERROR;
+    }
+
+    return JSON_OK;
+}
+
+bool JSON_FieldEquals ( const JSON_FIELD *field, const char *str )
+{
+    if ( field->value == NULL )
+    {
+        return false;
+    }
+
+    return ( strlen( str ) == field->length ) && 
+            ( memcmp( field->value, str, field->length ) == 0 );
+}
+
+JSON_RETURN JSON_FieldToFloat ( const JSON_FIELD *field, float *value )
+{
+    char    tmp[ JSON_NUMBER_MAX_LEN + 1 ];
+    char    *tail;
+
+    if ( ( field->value == NULL ) || ( field->length == 0 ) || 
+            ( field->length > JSON_NUMBER_MAX_LEN ) )
+    {
+        return JSON_ERROR;
+    }
+
+    //  Source buffer is not terminated, only the number itself is copied.
+
+    memcpy( tmp, field->value, field->length );
+    tmp[ field->length ] = '\0';
+
+    *value = strtof( tmp, &tail );
+
+    return ( tail == &tmp[ field->length ] ) ? JSON_OK : JSON_ERROR;
+}
+
+/* -------------------------------------------------------- PRIVATE FUNCTIONS */
+//                                                          -----------------
+
+static void skip_ws ( JSON_CTX *ctx )
+{
+    while ( ( ctx->cur < ctx->end ) && ( ( *ctx->cur == ' ' ) || 
+            ( *ctx->cur == '\t' ) || ( *ctx->cur == '\r' ) || 
+            ( *ctx->cur == '\n' ) ) )
+    {
+        ++ctx->cur;
+    }
+}
+
+/*
+    Object is entered with cursor on '{'. Path is the part of the searched 
+    path still to be matched, empty when this is the target object and NULL 
+    when the object is off the path.
+*/
+
+static JSON_RETURN parse_object ( JSON_CTX *ctx, uint8_t depth, 
+        const char *path )
+{
+    if ( depth > JSON_MAX_DEPTH )
+    {
+        return JSON_ERROR;
+    }
+
+    ++ctx->cur;
+    skip_ws( ctx );
+
+    if ( ( ctx->cur < ctx->end ) && ( *ctx->cur == '}' ) )
+    {
+        ++ctx->cur;
+        return JSON_OK;
+    }
+
+    for ( ; ; )
+    {
+        const char  *key;
+        const char  *value;
+        uint16_t    key_len;
+        uint16_t    length;
+
+        skip_ws( ctx );
+
+        if ( ( ctx->cur >= ctx->end ) || ( *ctx->cur != '\"' ) || 
+                ( parse_string( ctx, &key, &key_len ) != JSON_OK ) )
+        {
+            return JSON_ERROR;
+        }
+
+        skip_ws( ctx );
+
+        if ( ( ctx->cur >= ctx->end ) || ( *ctx->cur != ':' ) )
+        {
+            return JSON_ERROR;
+        }
+
+        ++ctx->cur;
+
+        if ( parse_value( ctx, depth, path_next( path, key, key_len ), 
+                    &value, &length ) != JSON_OK )
+        {
+            return JSON_ERROR;
+        }
+
+        //  Only scalar values of the target object are reported.
+
+        if ( ( value != NULL ) && 
+                ( ctx->any_depth || ( ( path != NULL ) && ( *path == '\0' ) ) ) )
+        {
+            match_key( ctx, key, key_len, value, length );
+        }
+
+        skip_ws( ctx );
+
+        if ( ctx->cur >= ctx->end )
+        {
+            return JSON_ERROR;
+        }
+
+        if ( *ctx->cur == ',' )
+        {
+            ++ctx->cur;
+        }
+        else if ( *ctx->cur == '}' )
+        {
+            ++ctx->cur;
+            return JSON_OK;
+        }
+        else
+        {
+            return JSON_ERROR;
+        }
+    }
+}
+
+static JSON_RETURN parse_array ( JSON_CTX *ctx, uint8_t depth )
+{
+    if ( depth > JSON_MAX_DEPTH )
+    {
+        return JSON_ERROR;
+    }
+
+    ++ctx->cur;
+    skip_ws( ctx );
+
+    if ( ( ctx->cur < ctx->end ) && ( *ctx->cur == ']' ) )
+    {
+        ++ctx->cur;
+        return JSON_OK;
+    }
+
+    for ( ; ; )
+    {
+        const char  *value;
+        uint16_t    length;
+
+        if ( parse_value( ctx, depth, NULL, &value, &length ) != JSON_OK )
+        {
+            return JSON_ERROR;
+        }
+
+        skip_ws( ctx );
+
+        if ( ctx->cur >= ctx->end )
+        {
+            return JSON_ERROR;
+        }
+
+        if ( *ctx->cur == ',' )
+        {
+            ++ctx->cur;
+        }
+        else if ( *ctx->cur == ']' )
+        {
+            ++ctx->cur;
+            return JSON_OK;
+        }
+        else
+        {
+            return JSON_ERROR;
+        }
+    }
+}
+
+static JSON_RETURN parse_value ( JSON_CTX *ctx, uint8_t depth, 
+        const char *path, const char **value, uint16_t *length )
+{
+    *value  = NULL;
+    *length = 0;
+
+    skip_ws( ctx );
+
+    if ( ctx->cur >= ctx->end )
+    {
+        return JSON_ERROR;
+    }
+
+    switch ( *ctx->cur )
+    {
+        case '{':   return parse_object( ctx, depth + 1, path );
+        case '[':   return parse_array( ctx, depth + 1 );
+        case '\"':  return parse_string( ctx, value, length );
+        default:    return parse_primitive( ctx, value, length );
+    }
+}
+
+static JSON_RETURN parse_string ( JSON_CTX *ctx, const char **value, 
+        uint16_t *length )
+{
+    const char  *start = ++ctx->cur;
+
+    while ( ( ctx->cur < ctx->end ) && ( *ctx->cur != '\"' ) )
+    {
+        //  Control characters are not allowed, escapes are kept as is.
+
+        if ( (unsigned char) *ctx->cur < 0x20 )
+        {
+            return JSON_ERROR;
+        }
+
+        if ( *ctx->cur == '\\' )
+        {
+            if ( ctx->end - ctx->cur < 2 )
+            {
+                return JSON_ERROR;
+            }
+
+            ++ctx->cur;
+        }
+
+        ++ctx->cur;
+    }
+
+    if ( ( ctx->cur >= ctx->end ) || ( ctx->cur - start > UINT16_MAX ) )
+    {
+        return JSON_ERROR;
+    }
+
+    *value  = start;
+    *length = (uint16_t) ( ctx->cur - start );
+    ++ctx->cur;
+
+    return JSON_OK;
+}
+
+static JSON_RETURN parse_primitive ( JSON_CTX *ctx, const char **value, 
+        uint16_t *length )
+{
+    static const char   *literals[ ] = { "true", "false", "null" };
+    const char          *start = ctx->cur;
+    size_t              lit_len;
+    uint8_t             i;
+
+    //  Literals have to match in full, "tru" or "nul" are rejected.
+
+    for ( i = 0; i < sizeof( literals ) / sizeof( literals[ 0 ] ); i++ )
+    {
+        lit_len = strlen( literals[ i ] );
+
+        if ( ( ( size_t ) ( ctx->end - ctx->cur ) >= lit_len ) && 
+                ( memcmp( ctx->cur, literals[ i ], lit_len ) == 0 ) )
+        {
+            ctx->cur += lit_len;
+            break;
+        }
+    }
+
+    //  Numbers.
+
+    if ( ctx->cur == start )
+    {
+        while ( ( ctx->cur < ctx->end ) && 
+                ( ( ( *ctx->cur >= '0' ) && ( *ctx->cur <= '9' ) ) || 
+                  ( *ctx->cur == '-' ) || ( *ctx->cur == '+' ) || 
+                  ( *ctx->cur == '.' ) || ( *ctx->cur == 'e' ) || 
+                  ( *ctx->cur == 'E' ) ) )
+        {
+            ++ctx->cur;
+        }
+    }
+
+    if ( ( ctx->cur == start ) || ( ctx->cur - start > UINT16_MAX ) )
+    {
+        return JSON_ERROR;
+    }
+
+    //  Delimiter has to follow, "truex" or "1a" are rejected.
+
+    if ( ( ctx->cur < ctx->end ) && ( *ctx->cur != ' ' ) && 
+            ( *ctx->cur != '\t' ) && ( *ctx->cur != '\r' ) && 
+            ( *ctx->cur != '\n' ) && ( *ctx->cur != ',' ) && 
+            ( *ctx->cur != '}' ) && ( *ctx->cur != ']' ) )
+    {
+        return JSON_ERROR;
+    }
+
+    *value  = start;
+    *length = (uint16_t) ( ctx->cur - start );
+
+    return JSON_OK;
+}
+
+static const char *path_next ( const char *path, const char *key, 
+        uint16_t key_len )
+{
+    size_t  seg_len;
+
+    if ( ( path == NULL ) || ( *path == '\0' ) )
+    {
+        return NULL;
+    }
+
+    seg_len = strcspn( path, "." );
+
+    if ( ( seg_len != key_len ) || ( memcmp( path, key, key_len ) != 0 ) )
+    {
+        return NULL;
+    }
+
+    return ( path[ seg_len ] == '.' ) ? &path[ seg_len + 1 ] : &path[ seg_len ];
+}
+
+static void match_key ( JSON_CTX *ctx, const char *key, uint16_t key_len, 
+        const char *value, uint16_t length )
+{
+    uint8_t i;
+
+    for ( i = 0; i < ctx->field_cnt; i++ )
+    {
+        JSON_FIELD  *field = &ctx->fields[ i ];
+
+        if ( ( strlen( field->key ) == key_len ) && 
+                ( memcmp( field->key, key, key_len ) == 0 ) )
+        {
+            field->value  = value;
+            field->length = length;
+        }
+    }
+}
+
+static void clear_fields ( JSON_FIELD *fields, uint8_t field_cnt )
+{
+    uint8_t i;
+
+    for ( i = 0; i < field_cnt; i++ )
+    {
+        fields[ i ].value  = NULL;
+        fields[ i ].length = 0;
+    }
+}
+
+
+/* -------------------------------------------------------------------------- */
+/*
+    module_json.c
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
\ No newline at end of file
@@ -0,0 +1,162 @@
+/*
+    module_json.h
+
+-----------------------------------------------------------------------------
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+----------------------------------------------------------------------------- */
+/**
+    \file     module_json.h
+    \brief    JSON Key Extractor
+    \defgroup JSON
+    \brief    JSON Key Extractor
+    \{
+
+| Global Library Prefix | **JSON**              |
+|:---------------------:|:---------------------:|
+| Version               | **1.0.0**             |
+
+---
+
+**Version Info :**
+- **1.0.0** Module Created
+
+Single pass extractor which works in place on received MQTT payload. Values
+are returned as pointers into the source buffer, nothing is copied and the
+buffer does not have to be NUL terminated.
+
+Module does not depend on RTOS or Harmony so it can be built on host as is.
+
+*/
+/* -------------------------------------------------------------------------- */
+
+#ifndef _MODULE_JSON_H_
+#define _MODULE_JSON_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ------------------------------------------------------------------- MACROS */
+
+//  Deepest object / array nesting accepted before document is rejected.
+
+#define JSON_MAX_DEPTH              8
+
+/* -------------------------------------------------------------------- TYPES */
+
+typedef enum
+{
+    JSON_OK                     = 0,
+    JSON_ERROR
+
+} JSON_RETURN;
+
+/**
+    \struct JSON_FIELD
+    \brief Searched key and its value
+
+Key has to be set by the caller. After extraction value points to the first
+character of the value inside of the source buffer (quotes are not included
+for string values) or it is NULL if key was not found.
+
+*/
+typedef struct
+{
+    const char          *key;
+    const char          *value;
+    uint16_t            length;
+
+} JSON_FIELD;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+    \brief Extract values of given keys
+
+    \param[in] json         source document
+    \param[in] len          length of the source document
+    \param[in] path         dot separated path of object holding the keys
+                            ( e.g. "state.desired" ), empty string for top
+                            level object or NULL to match keys at any depth
+    \param[in,out] fields   keys to search, values are filled by extractor
+    \param[in] field_cnt    number of fields
+
+    \retval JSON_OK when document is well formed, JSON_ERROR otherwise
+
+Document is parsed only once regardless of number of fields. When key appears
+more than once the last value wins. Values of fields are valid only if
+JSON_OK is returned and as long as source buffer is valid.
+*/
+JSON_RETURN JSON_Extract ( const char *json, size_t len, const char *path,
+        JSON_FIELD *fields, uint8_t field_cnt );
+
+/**
+    \brief Compare field value with string
+
+    \param[in] field        extracted field
+    \param[in] str          NUL terminated string
+
+    \retval true if field was found and its value equals to str
+*/
+bool JSON_FieldEquals ( const JSON_FIELD *field, const char *str );
+
+/**
+    \brief Convert field value to float
+
+    \param[in] field        extracted field
+    \param[out] value       converted value
+
+    \retval JSON_OK if field was found and holds a number
+*/
+JSON_RETURN JSON_FieldToFloat ( const JSON_FIELD *field, float *value );
+
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+/// \}
+/* -------------------------------------------------------------------------- */
+/*
+    module_json.h
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+3. All advertising materials mentioning features or use of this software
+   must display the following acknowledgement:
+   This product includes software developed by the MikroElektonika.
+
+4. Neither the name of the MikroElektonika nor the
+   names of its contributors may be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY MIKROELEKTRONIKA ''AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL MIKROELEKTRONIKA BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------- */
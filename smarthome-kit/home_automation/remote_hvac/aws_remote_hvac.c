@@ -21,7 +21,6 @@
 
 /* MQTT includes. */
 #include "iot_mqtt_agent.h"
-#include "jsmn.h"
 
 /* Credentials includes. */
 #include "aws_clientcredential.h"
@@ -31,6 +30,7 @@
 #include "../aws_home_automation_demo.h"
 
 #include "../module_common.h"
+#include "../module_json.h"
 #include "module_sensor.h"
 #include "module_display.h"
 #include "module_thermostat.h"
@@ -78,9 +78,37 @@ enum
     CONNECTED,
 };
 
+enum
+{
+    FIELD_FAN                   = 0x01,
+    FIELD_AIRCON                = 0x02,
+    FIELD_SENSOR                = 0x04,
+    FIELD_TARGET_T              = 0x08,
+
+    FIELD_SHADOW                = FIELD_FAN | FIELD_AIRCON | FIELD_TARGET_T
+};
+
+//  Changes collected during one coalescing window, latest value wins.
+
+typedef struct
+{
+    uint32_t            fields;
+    uint32_t            changes;
+    TickType_t          window_start;
+
+    FAN_STATE           fan;
+    AIRCON_STATE        aircon;
+    SENSOR_VALUE        sensor;
+    float               target;
+
+} CONNECTION_BATCH;
+
 typedef struct
 {
     MODULE_STATE        state;
+    CONNECTION_BATCH    batch;
+    xCoalescerStats     stats;
+    xParseStats         parse;
 
 } CONNECTION_DATA;
 
@@ -129,6 +157,14 @@ static MODULE_RETURN publish_shadow_update ( char *message );
 static MQTTBool_t prvMQTTCallback ( void * pvUserData,
                     const MQTTPublishData_t * const pxPublishParameters );
 
+static void coalescer_collect ( void );
+
+static void coalescer_add ( uint32_t field );
+
+static void coalescer_flush ( void );
+
+static void update_parse_stats ( uint32_t parse_us, JSON_RETURN parsed );
+
 // ----------------------------------------------------------- PUBLIC FUNCTIONS
 
 void vStartRemoteHVACDemo ( void )
@@ -149,6 +185,11 @@ void vStartRemoteHVACDemo ( void )
     configPRINTF( ( "Creating Connector Task...\r\n" ) );
     
     connectionData.state = MODULE_STATE_INIT;
+    
+    memset( &connectionData.batch, 0, sizeof( connectionData.batch ) );
+    memset( &connectionData.stats, 0, sizeof( connectionData.stats ) );
+    memset( &connectionData.parse, 0, sizeof( connectionData.parse ) );
+    connectionData.stats.ulWindowMs = CONNECTOR_COALESCE_WINDOW;
 
     (void) xTaskCreate( (TaskFunction_t) connector_task, 
                         "Connector Task",
@@ -168,12 +209,24 @@ void vStartRemoteHVACDemo ( void )
 #endif
 }
 
+void vGetCoalescerStats ( xCoalescerStats *pxStats )
+{
+    memcpy( pxStats, &connectionData.stats, sizeof( xCoalescerStats ) );
+}
+
+void vGetParseStats ( xParseStats *pxStats )
+{
+    memcpy( pxStats, &connectionData.parse, sizeof( xParseStats ) );
+}
+
 // -------------------------------------------- PRIVATE FUNCTION IMPLEMENTATION
 
 static void connector_task ( void )
 {
     for ( ; ; )
     {
+        TickType_t timeout = CONNECTOR_TASK_DELAY / portTICK_PERIOD_MS;
+
         switch ( connectionData.state )
         {
             case MODULE_STATE_INIT:
@@ -223,74 +276,40 @@ static void connector_task ( void )
             }
             case MODULE_STATE_ACTIVE:
             {
-                char            cDataBuffer[ 256 ];
-    
-                SENSOR_VALUE    sensorv;
-                FAN_STATE       fanv;
-                AIRCON_STATE    airconv;
-                float           targetv;
-                
-                //  New fan data received - publish it to status topic.
+                TickType_t      elapsed;
 
-                if ( xQueueReceive( qCONN_Fan, (FAN_STATE *) &fanv, 
-                            RTOS_NO_BLOCKING ) )
-                {
-                    (void) sprintf( cDataBuffer, mqttFAN_DESIRED_PAYLOAD, 
-                                    jsonFAN_REFERENCE, 
-                                    FAN_STATE_STRING[ fanv ] );
-                    
-                    if ( publish_shadow_update( cDataBuffer ) != MODULE_OK )
-                    {
-                        configPRINTF( ( "Failed to publish %s. [ERROR: %d]\r\n", 
-                            cDataBuffer, xErrorCode ) );
-                    }
-                }
+                //  Collect all changes HVAC sent since the last pass.
 
-                //  New aircon data received - publish it to status topic.
-    
-                if ( xQueueReceive( qCONN_Aircon, (AIRCON_STATE *) &airconv, 
-                            RTOS_NO_BLOCKING ) )
+                coalescer_collect( );
+
+                if ( connectionData.batch.fields == 0 )
                 {
-                    (void) sprintf( cDataBuffer, mqttAIRCON_DESIRED_PAYLOAD, 
-                                    jsonAIRCON_REFERENCE, 
-                                    AIRCON_STATE_STRING[ airconv ] );   
-                    
-                    if ( publish_shadow_update( cDataBuffer ) != MODULE_OK )
-                    {
-                        configPRINTF( ( "Failed to publish %s. [ERROR: %d]\r\n", 
-                            cDataBuffer, xErrorCode ) );
-                    }
+                    //  Nothing else to do until HVAC sends new data.
+
+                    timeout = portMAX_DELAY;
+
+                    break;
                 }
 
-                //  New sensor data received - publish it to status topic.
-    
-                if ( xQueueReceive( qCONN_Sensor, (SENSOR_VALUE *) &sensorv, 
-                            RTOS_NO_BLOCKING ) )
+                /*
+                    Changes are published once the window opened by the first
+                    of them expires, everything received meanwhile goes to the
+                    same status document and shadow update.
+                */
+
+                elapsed = xTaskGetTickCount( ) - 
+                        connectionData.batch.window_start;
+
+                if ( elapsed >= ( CONNECTOR_COALESCE_WINDOW / 
+                            portTICK_PERIOD_MS ) )
                 {
-                    (void) sprintf( cDataBuffer, mqttSENSOR_PAYLOAD, clientcredentialIOT_THING_NAME, xTaskGetTickCount(),
-                                    jsonSENSOR_T_REFERENCE, sensorv.temperature, 
-                                    jsonSENSOR_H_REFERENCE, sensorv.humidity );
-                    
-                    if ( publish_message( cDataBuffer ) != MODULE_OK )
-                    {
-                        configPRINTF( ( "Failed to publish %s. [ERROR: %d]\r\n", 
-                            cDataBuffer, xErrorCode ) );
-                    }
+                    coalescer_flush( );
+                    timeout = portMAX_DELAY;
                 }
-
-                //  New target data received - publish it to status topic.
-    
-                if ( xQueueReceive( qCONN_TargetT, (float *) &targetv, 
-                            RTOS_NO_BLOCKING ) )
+                else
                 {
-                    (void) sprintf( cDataBuffer, mqttTARGET_DESIRED_PAYLOAD, 
-                                    jsonTARGET_T_REFERENCE, targetv );
-                    
-                    if ( publish_shadow_update( cDataBuffer ) != MODULE_OK )
-                    {
-                        configPRINTF( ( "Failed to publish %s. [ERROR: %d]\r\n", 
-                            cDataBuffer, xErrorCode ) );
-                    }
+                    timeout = ( CONNECTOR_COALESCE_WINDOW / 
+                            portTICK_PERIOD_MS ) - elapsed;
                 }
                 
                 break;
@@ -317,7 +336,7 @@ static void connector_task ( void )
             break;
         }
         
-        vTaskDelay( CONNECTOR_TASK_DELAY / portTICK_PERIOD_MS );
+        MODULE_WaitForEvent( &evCONN, CONNECTOR_TASK_DELAY, timeout );
     }
 }
 
@@ -386,7 +405,7 @@ static MODULE_RETURN connect_to_broker ( void )
     {
         int tmp = CONNECTED;
         
-        if ( xQueueSend( qDISPLAY_Conn, &tmp, RTOS_NO_BLOCKING ) )
+        if ( MODULE_Post( qDISPLAY_Conn, &tmp, &evDISPLAY ) )
         {
             //  TODO : Handle error.
         }
@@ -411,7 +430,7 @@ static MODULE_RETURN disconnect_from_broker ( void )
     {
         int tmp = DISCONNECTED;
         
-        if ( xQueueSend( qDISPLAY_Conn, &tmp, RTOS_NO_BLOCKING ) )
+        if ( MODULE_Post( qDISPLAY_Conn, &tmp, &evDISPLAY ) )
         {
             //  TODO : Handle error.
         }
@@ -525,98 +544,221 @@ static MODULE_RETURN publish_shadow_update ( char *message )
     return xReturn;
 }
 
-static MQTTBool_t prvMQTTCallback ( void * pvUserData,
-                        const MQTTPublishData_t * const pxPublishParameters )
+static void coalescer_collect ( void )
 {
-    char plBuffer[ 256 ] = { 0 };
-    
-    //  Remove warnings about the unused parameters.
+    CONNECTION_BATCH    *batch = &connectionData.batch;
 
-    (void) pvUserData;   
-    //memset( plBuffer, 0, 256 );
+    while ( xQueueReceive( qCONN_Fan, (FAN_STATE *) &batch->fan, 
+                RTOS_NO_BLOCKING ) )
+    {
+        coalescer_add( FIELD_FAN );
+    }
+
+    while ( xQueueReceive( qCONN_Aircon, (AIRCON_STATE *) &batch->aircon, 
+                RTOS_NO_BLOCKING ) )
+    {
+        coalescer_add( FIELD_AIRCON );
+    }
 
-    if ( pxPublishParameters->ulDataLength < 256 )
+    while ( xQueueReceive( qCONN_Sensor, (SENSOR_VALUE *) &batch->sensor, 
+                RTOS_NO_BLOCKING ) )
     {
-        char *tmp;
+        coalescer_add( FIELD_SENSOR );
+    }
 
-        memcpy( plBuffer, pxPublishParameters->pvData, 
-                (size_t) pxPublishParameters->ulDataLength );
+    while ( xQueueReceive( qCONN_TargetT, (float *) &batch->target, 
+                RTOS_NO_BLOCKING ) )
+    {
+        coalescer_add( FIELD_TARGET_T );
+    }
+}
 
-        /*  
-            Parse message received and forward it to HVAC module. Only FAN and
-            Target temperature are configurable from the "outside" so only 
-            that two references are searched through the received string.
-        */
+static void coalescer_add ( uint32_t field )
+{
+    CONNECTION_BATCH    *batch = &connectionData.batch;
 
-        // Target temperature reference search.
+    //  First change opens the window.
 
-        if ( ( tmp = strstr( plBuffer, jsonTARGET_T_REFERENCE ) ) != NULL )
+    if ( batch->fields == 0 )
+    {
+        batch->window_start = xTaskGetTickCount( );
+    }
+
+    batch->fields |= field;
+    ++batch->changes;
+    ++connectionData.stats.ulChanges;
+}
+
+static void coalescer_flush ( void )
+{
+    char                cDataBuffer[ 256 ];
+    CONNECTION_BATCH    *batch = &connectionData.batch;
+    xCoalescerStats     *stats = &connectionData.stats;
+
+    //  Telemetry goes to status topic.
+
+    if ( batch->fields & FIELD_SENSOR )
+    {
+        (void) sprintf( cDataBuffer, mqttSENSOR_PAYLOAD, 
+                        clientcredentialIOT_THING_NAME, xTaskGetTickCount(),
+                        jsonSENSOR_T_REFERENCE, batch->sensor.temperature, 
+                        jsonSENSOR_H_REFERENCE, batch->sensor.humidity );
+
+        ++stats->ulPublishes;
+
+        if ( publish_message( cDataBuffer ) != MODULE_OK )
         {
-            float       tmpV;
-            char        *valS;
-            char        *valE;
-            char        tmpS[ 32 ];
+            ++stats->ulErrors;
+            configPRINTF( ( "Failed to publish %s. [ERROR: %d]\r\n", 
+                cDataBuffer, xErrorCode ) );
+        }
+    }
 
-            tmp += strlen( jsonTARGET_T_REFERENCE );
-            valS = strchr( tmp + 1, '\"' );
-            valE = strchr( valS + 1, '\"' );
+    //  All changed HVAC states go to single shadow update.
 
-            memset( tmpS, 0, 32 );
-            memcpy( tmpS, valS + 1, valE - valS - 1 );
-            sscanf (tmpS, "%f", &tmpV );
+    if ( batch->fields & FIELD_SHADOW )
+    {
+        const char  *sep = "";
+        int         len;
 
-            //  Forward new target value to HVAC module.
+        len = sprintf( cDataBuffer, mqttDESIRED_BEGIN );
 
-            if ( xQueueSend( qHVAC_TargetT, &tmpV, RTOS_NO_BLOCKING ) )
-            {
-                //  TODO : Handle error.
-            }
+        if ( batch->fields & FIELD_FAN )
+        {
+            len += sprintf( cDataBuffer + len, mqttSTRING_FIELD, sep,
+                            jsonFAN_REFERENCE, FAN_STATE_STRING[ batch->fan ] );
+            sep = ",";
+        }
+
+        if ( batch->fields & FIELD_AIRCON )
+        {
+            len += sprintf( cDataBuffer + len, mqttSTRING_FIELD, sep,
+                            jsonAIRCON_REFERENCE, 
+                            AIRCON_STATE_STRING[ batch->aircon ] );
+            sep = ",";
+        }
+
+        if ( batch->fields & FIELD_TARGET_T )
+        {
+            len += sprintf( cDataBuffer + len, mqttFLOAT_FIELD, sep,
+                            jsonTARGET_T_REFERENCE, batch->target );
         }
 
-        // Fan reference search.
+        (void) sprintf( cDataBuffer + len, mqttDESIRED_END );
 
-        if ( ( tmp = strstr( plBuffer, jsonFAN_REFERENCE ) ) != NULL )
+        ++stats->ulPublishes;
+
+        if ( publish_shadow_update( cDataBuffer ) != MODULE_OK )
         {
-            int         c;
-            char        *valS;
-            char        *valE;
-            char        tmpS[32];
+            ++stats->ulErrors;
+            configPRINTF( ( "Failed to publish %s. [ERROR: %d]\r\n", 
+                cDataBuffer, xErrorCode ) );
+        }
+    }
+
+    ++stats->ulFlushes;
+
+    if ( batch->changes > stats->ulMaxBatch )
+    {
+        stats->ulMaxBatch = batch->changes;
+    }
+
+    batch->fields  = 0;
+    batch->changes = 0;
+}
+
+static MQTTBool_t prvMQTTCallback ( void * pvUserData,
+                        const MQTTPublishData_t * const pxPublishParameters )
+{
+    JSON_FIELD          fields[ 2 ];
+    JSON_RETURN         parsed;
+    uint32_t            parse_us;
+    const char          *payload = pxPublishParameters->pvData;
+    
+    //  Remove warnings about the unused parameters.
 
-            tmp += strlen( jsonFAN_REFERENCE );
-            valS = strchr( tmp + 1, '\"' );
-            valE = strchr( valS + 1, '\"' );
+    (void) pvUserData;   
+
+    /*  
+        Parse message in place and forward it to HVAC module. Only FAN and 
+        Target temperature are configurable from the "outside" so only that 
+        two keys are searched, at any depth of the received document.
+    */
+
+    fields[ 0 ].key = jsonTARGET_T_REFERENCE;
+    fields[ 1 ].key = jsonFAN_REFERENCE;
+
+    parse_us = MODULE_CYCLE_COUNT( );
+    parsed = JSON_Extract( payload, pxPublishParameters->ulDataLength, NULL, 
+                    fields, 2 );
+    parse_us = ( MODULE_CYCLE_COUNT( ) - parse_us ) / MODULE_CYCLES_PER_US;
 
-            memset( tmpS, 0, 32 );
-            memcpy( tmpS, valS + 1, valE - valS - 1 );
+    update_parse_stats( parse_us, parsed );
 
-            for ( c = 0; c < 3; c++ )
+    if ( parsed == JSON_OK )
+    {
+        float       targetv;
+        int         c;
+
+        //  Forward new target value to HVAC module.
+
+        if ( JSON_FieldToFloat( &fields[ 0 ], &targetv ) == JSON_OK )
+        {
+            if ( MODULE_Post( qHVAC_TargetT, &targetv, &evHVAC ) )
             {
-                //  Now check wich predefined value is received.
+                //  TODO : Handle error.
+            }
+        }
 
-                if ( !strcmp( tmpS, FAN_STATE_STRING[ c ] ) )
-                {
-                    //  Forward new FAN value to HVAC module.
+        //  Now check wich predefined FAN value is received.
 
-                    if ( xQueueSend( qHVAC_Fan, &c, RTOS_NO_BLOCKING ) )
-                    {
-                        //  TODO : Handle error.
-                    }
+        for ( c = 0; c < 3; c++ )
+        {
+            if ( JSON_FieldEquals( &fields[ 1 ], 
+                        (const char *) FAN_STATE_STRING[ c ] ) )
+            {
+                //  Forward new FAN value to HVAC module.
 
-                    break;
+                if ( MODULE_Post( qHVAC_Fan, &c, &evHVAC ) )
+                {
+                    //  TODO : Handle error.
                 }
+
+                break;
             }
         }
 
-        configPRINTF( ( "Received %s\r\n", plBuffer ) );
+        configPRINTF( ( "Received %.*s [parsed in %u us]\r\n", 
+                (int) pxPublishParameters->ulDataLength, payload, parse_us ) );
     }
     else
     {
-        configPRINTF( ( "Dropped message.\r\n" ) );
+        configPRINTF( ( "Dropped malformed message.\r\n" ) );
     }
     
     return eMQTTFalse;
 }
 
+static void update_parse_stats ( uint32_t parse_us, JSON_RETURN parsed )
+{
+    xParseStats     *stats = &connectionData.parse;
+
+    ++stats->ulMessages;
+
+    if ( parsed != JSON_OK )
+    {
+        ++stats->ulErrors;
+    }
+
+    stats->ulLastUs = parse_us;
+    stats->ulTotalUs += parse_us;
+
+    if ( parse_us > stats->ulMaxUs )
+    {
+        stats->ulMaxUs = parse_us;
+    }
+}
+
 static void App_OTACompleteCallback( OTA_JobEvent_t eEvent )
 {
     OTA_Err_t xErr = kOTA_Err_Uninitialized;
@@ -664,135 +806,60 @@ void vOTAUpdateDemoTask( void * pvParameters )
     }
 }
 
-static int jsoneq(const char *json, jsmntok_t *tok, const char *s);
-static int jsoneq(const char *json, jsmntok_t *tok, const char *s) {
-    if ( tok->type == JSMN_STRING &&
-             (int) strlen(s) == tok->end - tok->start &&
-             strncmp(json + tok->start, s, tok->end - tok->start) == 0) {
-        return 0;
-    }
-    return -1;
-}
-void jsonSimpleKeyValue(jsmn_parser p, char * payload, char * parent_key, char * target_key, char * result);
-void jsonSimpleKeyValue(jsmn_parser p, char * payload, char * parent_key, char * target_key, char * result)
+static MQTTBool_t prvMqttShadowDeltaCb( void * pvUserData,
+                                          const MQTTPublishData_t * const pxPublishParameters )
 {
-    int idx;
-    int r;
-    int target_parent_found = 0;
-    int target_parent_end = 0; // where the token ends
-    jsmntok_t tokens[128];
+    JSON_FIELD          fields[ 3 ];
+    JSON_RETURN         parsed;
+    uint32_t            parse_us;
+    xShadowProperties   shadowProperties;
+    int                 c;
 
-  #ifdef JSMN_PARSING_DEBUG
-    char debug_token[128];
-    int  debug_idx;
-  #endif
+    /* Silence compiler warnings about unused variables. */
+    ( void ) pvUserData;
 
-    r = jsmn_parse( &p, ( char *) payload,  strlen(payload), tokens,
-                    ( sizeof( tokens ) / sizeof( tokens[0] ) ) );
+    /* Delta document carries changed desired values directly in "state".
+       Keys which are not present keep current HVAC values. */
+    fields[ 0 ].key = jsonTARGET_T_REFERENCE;
+    fields[ 1 ].key = jsonFAN_REFERENCE;
+    fields[ 2 ].key = jsonAIRCON_REFERENCE;
 
-    for ( idx = 0; idx < r; idx++)
-    {
+    parse_us = MODULE_CYCLE_COUNT( );
+    parsed = JSON_Extract( pxPublishParameters->pvData, 
+                    pxPublishParameters->ulDataLength, "state", fields, 3 );
+    parse_us = ( MODULE_CYCLE_COUNT( ) - parse_us ) / MODULE_CYCLES_PER_US;
 
-  #ifdef JSMN_PARSING_DEBUG
-      for (debug_idx=0; debug_idx < 128; debug_idx++) debug_token[debug_idx] = '\0';
-      (void) strncpy(debug_token, (payload + tokens[idx].start), (tokens[idx].end - tokens[idx].start));
-      printf("type: %d, start: %d, end: %d, size: %d, token: %s\n",
-             tokens[ idx ].type,
-             tokens[ idx ].start,
-             tokens[ idx ].end,
-             tokens[ idx ].size,
-             debug_token
-        );
-  #endif
-
-      // if the current object has key we want, then following string(s) contain key
-      // we are searching for.
-      if ( target_parent_found == 0 )
-      {
-        if ( tokens[idx].type == JSMN_OBJECT &&
-             tokens[idx].size >  0           &&
-             jsoneq( payload, &tokens[ idx - 1 ], parent_key ) == 0)
-        {
-          target_parent_found = 1;
-          target_parent_end = tokens[ idx ].end;
-        }
-        continue;
-      }
-
-      if ( tokens[idx].end > target_parent_end ) return;
-
-      // if the current is JSMN_OBJECT, skip.
-      if ( tokens[ idx ].type == JSMN_OBJECT )
-        continue;
-      // if the current is JSMN_PRIMITIVE, then it is a value. skip.
-      if ( tokens[ idx ].type == JSMN_PRIMITIVE )
-        continue;
-
-      // if the current is JSMN_STRING but has NO SIZE, then it is a VALUE.  skip.
-      if ( tokens[ idx ].type == JSMN_STRING &&
-           tokens[ idx ].size == 0 )
-        continue;
-
-      // if the current matches target_key, then retrieve value from idx+1 and return.
-      // if idx+1 is a primitive, then convert to string.  we will only return char *.
-      if ( ! ( tokens[ idx ].type == JSMN_STRING &&
-               jsoneq( payload, &tokens[ idx ], target_key ) == 0 ) )
-        continue;
-
-      (void) strncpy(result, (payload + tokens[idx + 1].start), (tokens[idx + 1].end - tokens[idx + 1].start));
-      return;
+    update_parse_stats( parse_us, parsed );
+
+    if( parsed != JSON_OK )
+    {
+        configPRINTF( ( "Dropped malformed shadow delta.\r\n" ) );
+        return eMQTTFalse;
     }
-}
 
-static MQTTBool_t prvMqttShadowDeltaCb( void * pvUserData,
-                                          const MQTTPublishData_t * const pxPublishParameters )
-{
-    jsmn_parser xJSMNParser;
-    xShadowProperties shadowProperties;
+    memset( &shadowProperties, 0x00, sizeof( xShadowProperties ) );
+    shadowProperties.fan = HVAC_GetFanState( );
+    shadowProperties.aircon = HVAC_GetAirconState( );
 
-    /* Silence compiler warnings about unused variables. */
-    ( void ) pvUserData;
+    if( JSON_FieldToFloat( &fields[ 0 ], &shadowProperties.target_temp ) != JSON_OK )
+    {
+        shadowProperties.target_temp = HVAC_GetTargetTemperature( );
+    }
 
-    char cBuffer[ 128 ];
-    uint32_t ulBytesToCopy = ( 128 - 1 );
-    memset( cBuffer, 0x00, sizeof( cBuffer ) );
-    memcpy( cBuffer, pxPublishParameters->pvData, ( size_t ) ulBytesToCopy );
+    for( c = 0; c < 3; c++ )
+    {
+        if( JSON_FieldEquals( &fields[ 1 ], ( const char * ) FAN_STATE_STRING[ c ] ) )
+        {
+            shadowProperties.fan = ( FAN_STATE ) c;
+        }
 
-    jsmn_init( &xJSMNParser );
-    memset( &shadowProperties, 0x00, sizeof( xShadowProperties ) );
+        if( JSON_FieldEquals( &fields[ 2 ], ( const char * ) AIRCON_STATE_STRING[ c ] ) )
+        {
+            shadowProperties.aircon = ( AIRCON_STATE ) c;
+        }
+    }
 
-    uint8_t target_temp, fan, aircon;
-    char reading[4];
-
-    memset( reading, 0x00, sizeof( reading ) );
-    ( void ) jsonSimpleKeyValue( xJSMNParser,
-                                 (char *) cBuffer,
-                                 "state",  // TODO: remove magic string
-                                 "TARGET_T",  // TODO: remove magic string
-                                 reading);
-    target_temp = atoi(reading);
-
-    shadowProperties.target_temp = target_temp;
-
-    // Brightness - if the thing does not handle brightness, this will be 0x00.
-    memset( reading, 0x00, sizeof( reading ) );
-    ( void ) jsonSimpleKeyValue( xJSMNParser,
-                                 (char *) cBuffer,
-                                 "state",  // TODO: remove magic string
-                                 "FAN",  // TODO: remove magic string
-                                 reading);
-    fan = atoi(reading);
-    shadowProperties.fan = fan;
-
-    // Brightness - if the thing does not handle brightness, this will be 0x00.
-    memset( reading, 0x00, sizeof( reading ) );
-    ( void ) jsonSimpleKeyValue( xJSMNParser,
-                                 (char *) cBuffer,
-                                 "state",  // TODO: remove magic string
-                                 "AIRCON",  // TODO: remove magic string
-                                 reading);
-    aircon = atoi(reading);
-    shadowProperties.aircon = aircon;
+    configPRINTF( ( "Shadow delta parsed in %u us\r\n", parse_us ) );
 
     if( xQueueSendToBack( qCONN_ShadowReported, &shadowProperties, RTOS_NO_BLOCKING ) == pdTRUE )
     {
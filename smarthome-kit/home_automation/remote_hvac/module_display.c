@@ -24,6 +24,7 @@
 
 #include "../aws_home_automation_demo.h"
 #include "../remote_hvac/module_display.h"
+#include "../module_bus.h"
 #include "../../mikroe/OLED_C/click_oled_c.h"
 
 /* ------------------------------------------------------------------- MACROS */
@@ -47,12 +48,20 @@ This structure should be initialized by the LOGGER_Initialize function.
 */
 DISPLAY_DATA displayData;
 
+//  Cleared when SPI2 was yielded in the middle of frame and not taken back.
+
+static bool display_bus_held;
+
 /* ------------------------------------------- PRIVATE FUNCTIONS DECLARATIONS */
 //                                             ------------------------------
 
 static void _DISPLAY_Tasks ( void );
 
-static void display_update ( void );
+static int display_update ( void );
+
+static int display_bus_yield ( void );
+
+static TickType_t display_wait_timeout ( void );
 
 static void display_intro ( void );
 
@@ -81,8 +90,10 @@ void DISPLAY_Initialize ( void )
     */
 
     displayData.state               = MODULE_STATE_INIT;
+    displayData.flush_pending       = false;
 
     oledc_spiDriverInit( NULL, NULL );
+    oledc_set_yield( display_bus_yield );
     xTaskCreate( ( TaskFunction_t ) _DISPLAY_Tasks, "Display Task",
             DISPLAY_TASK_STACK_SIZE, NULL, DISPLAY_TASK_PRIORITY, NULL );
 
@@ -147,39 +158,42 @@ void DISPLAY_Tasks ( void )
             int             conn;
             float           target_t;
 
-            if ( xQueueReceive( qDISPLAY_Fan, (FAN_STATE *) &fan, 
+            //  Queues are drained, several posts may wake the task only once.
+
+            while ( xQueueReceive( qDISPLAY_Fan, (FAN_STATE *) &fan, 
                         RTOS_NO_BLOCKING ) )
             {
                 display_update_wave( );
             }
 
-            if ( xQueueReceive( qDISPLAY_Aircon, (AIRCON_STATE *) &aircon, 
+            while ( xQueueReceive( qDISPLAY_Aircon, (AIRCON_STATE *) &aircon, 
                         RTOS_NO_BLOCKING ) )
             {
                 display_update_wave( );
             }
 
-            if ( xQueueReceive( qDISPLAY_Sensor, (SENSOR_VALUE *) &sensor, 
+            while ( xQueueReceive( qDISPLAY_Sensor, (SENSOR_VALUE *) &sensor, 
                         RTOS_NO_BLOCKING ) )
             {
                 display_update_sensor_values( sensor.temperature, 
                         sensor.humidity );
             }
 
-            if ( xQueueReceive( qDISPLAY_TargetT, (float *) &target_t, 
+            while ( xQueueReceive( qDISPLAY_TargetT, (float *) &target_t, 
                         RTOS_NO_BLOCKING ) )
             {
                 display_update_target_temperature( target_t );
             }
 
-            if ( xQueueReceive( qDISPLAY_Conn, (int *) &conn, 
+            while ( xQueueReceive( qDISPLAY_Conn, (int *) &conn, 
                         RTOS_NO_BLOCKING ) )
             {
                 display_update_conn( conn );
             }
 
             display_update_fan( );
-            display_update( );
+
+            displayData.flush_pending = ( display_update( ) != MODULE_OK );
 
             break;
         }
@@ -233,6 +247,8 @@ void DISPLAY_ISR_Handler ( void )
 
         break;
     }
+
+    MODULE_WakeFromISR( &evDISPLAY );
 }
 
 /* -------------------------------------------------------- PRIVATE FUNCTIONS */
@@ -243,19 +259,67 @@ static void _DISPLAY_Tasks ( void )
     for (;;)
     {
         DISPLAY_Tasks();
-        vTaskDelay(DISPLAY_TASK_DELAY / portTICK_PERIOD_MS);
+        MODULE_WaitForEvent( &evDISPLAY, DISPLAY_TASK_DELAY, 
+                display_wait_timeout( ) );
+    }
+}
+
+static int display_update ( void )
+{
+    int err;
+
+    // Take bus and draw frame, WiFi may cut in between bands.
+
+    if ( !BUS_Acquire( BUS_CLIENT_DISPLAY, RTOS_NO_BLOCKING ) )
+    {
+        return MODULE_ERROR;
+    }
+
+    display_bus_held = true;
+    err = oledc_task( );
+
+    if ( display_bus_held )
+    {
+        BUS_Release( BUS_CLIENT_DISPLAY );
     }
+
+    return ( err == OLEDC_OK ) ? MODULE_OK : MODULE_ERROR;
+}
+
+static int display_bus_yield ( void )
+{
+    display_bus_held = BUS_Yield( BUS_CLIENT_DISPLAY, 
+            DISPLAY_BUS_YIELD_TIMEOUT / portTICK_PERIOD_MS );
+
+    return display_bus_held ? 0 : 1;
 }
 
-static void display_update ( void )
+static TickType_t display_wait_timeout ( void )
 {
-    // Take semaphore and draw frame.
+    //  Frame not flushed because SPI2 was busy, retry as soon as possible.
+
+    if ( displayData.flush_pending )
+    {
+        return DISPLAY_TASK_DELAY / portTICK_PERIOD_MS;
+    }
+
+    //  Spinning fan is the only content which changes without an event.
+
+    if ( ( displayData.state == MODULE_STATE_ACTIVE ) && 
+            ( HVAC_GetFanState( ) != FAN_OFF ) )
+    {
+        return DISPLAY_ANIMATION_PERIOD / portTICK_PERIOD_MS;
+    }
 
-    if ( xSemaphoreTake( smphrSPI2, RTOS_NO_BLOCKING ) )
+    //  Transition states are handled on the next pass.
+
+    if ( ( displayData.state != MODULE_STATE_ACTIVE ) && 
+            ( displayData.state != MODULE_STATE_INACTIVE ) )
     {
-        oledc_task( );
-        xSemaphoreGive( smphrSPI2 );
+        return DISPLAY_TASK_DELAY / portTICK_PERIOD_MS;
     }
+
+    return portMAX_DELAY;
 }
 
 static void display_intro ( void )
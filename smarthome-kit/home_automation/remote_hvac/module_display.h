@@ -41,6 +41,7 @@
 typedef struct 
 {
     MODULE_STATE        state;
+    bool                flush_pending;
     
 } DISPLAY_DATA;
 
@@ -182,9 +182,14 @@ void HVAC_Tasks ( void )
                 hvac_update_fan( hvacData.fan );
             }
 
+            /*
+                Several posts may wake the task only once, input queues are 
+                drained on every pass.
+            */
+
             //  FAN status update received from CONN module.
 
-            if ( xQueueReceive( qHVAC_Fan, (FAN_STATE *) &fanv, 
+            while ( xQueueReceive( qHVAC_Fan, (FAN_STATE *) &fanv, 
                         RTOS_NO_BLOCKING ) )
             {
                 if ( hvacData.hvac == HVAC_INACTIVE )
@@ -229,7 +234,7 @@ void HVAC_Tasks ( void )
 
             //  New measurements received from SENSOR module.
 
-            if ( xQueueReceive( qHVAC_Sensor, (SENSOR_VALUE *) &sensorv, 
+            while ( xQueueReceive( qHVAC_Sensor, (SENSOR_VALUE *) &sensorv, 
                         RTOS_NO_BLOCKING ) )
             {
                 hvacData.current.temperature = sensorv.temperature;
@@ -245,7 +250,7 @@ void HVAC_Tasks ( void )
 
             //  New target temperature received from THERMOSTAT or CONN module.
 
-            if ( xQueueReceive( qHVAC_TargetT, (float *) &targetv, 
+            while ( xQueueReceive( qHVAC_TargetT, (float *) &targetv, 
                         RTOS_NO_BLOCKING ) )
             {
                 hvacData.target_temp = targetv;
@@ -303,18 +308,22 @@ static void _HVAC_Tasks ( void )
     for ( ; ; )
     {
         HVAC_Tasks( );
-        vTaskDelay( HVAC_TASK_DELAY / portTICK_PERIOD_MS );
+
+        //  Board buttons have no interrupt and still have to be polled.
+
+        MODULE_WaitForEvent( &evHVAC, HVAC_TASK_DELAY, 
+                HVAC_BUTTON_POLL_PERIOD / portTICK_PERIOD_MS );
     }
 }
 
 static void hvac_update_fan ( FAN_STATE fan )
 {
-    if ( xQueueSend( qDISPLAY_Fan, &fan, RTOS_NO_BLOCKING ) )
+    if ( MODULE_Post( qDISPLAY_Fan, &fan, &evDISPLAY ) )
     {
         //  TODO : Handle error.
     }
 
-    if ( xQueueSend( qCONN_Fan, &fan, RTOS_NO_BLOCKING ) )
+    if ( MODULE_Post( qCONN_Fan, &fan, &evCONN ) )
     {
         //  TODO : Handle error.
     }
@@ -327,14 +336,14 @@ static void hvac_update_fan ( FAN_STATE fan )
 
 static void hvac_update_aircon( AIRCON_STATE aircon )
 {
-    if ( xQueueSend( qDISPLAY_Aircon, &aircon, RTOS_NO_BLOCKING ) )
+    if ( MODULE_Post( qDISPLAY_Aircon, &aircon, &evDISPLAY ) )
     {
         //  TODO : Handle error.
     }
 
     //  Forward sensor data to CONN module
 
-    if ( xQueueSend( qCONN_Aircon, &aircon, RTOS_NO_BLOCKING ) )
+    if ( MODULE_Post( qCONN_Aircon, &aircon, &evCONN ) )
     {
         //  TODO : Handle error.
     }
@@ -349,14 +358,14 @@ static void hvac_update_sensor( SENSOR_VALUE sensor )
 {
     //  Forward sensor data to CONN module
 
-    if ( xQueueSend( qCONN_Sensor, &sensor, RTOS_NO_BLOCKING ) )
+    if ( MODULE_Post( qCONN_Sensor, &sensor, &evCONN ) )
     {
         //  TODO : Handle error.
     }
 
     //  Forward sensor data to DISPLAY module
 
-    if ( xQueueSend( qDISPLAY_Sensor, &sensor, RTOS_NO_BLOCKING ) )
+    if ( MODULE_Post( qDISPLAY_Sensor, &sensor, &evDISPLAY ) )
     {
         //  TODO : Handle error.
     }
@@ -371,14 +380,14 @@ static void hvac_update_target_t( float temp )
 {
     //  Forward sensor data to CONN module
 
-    if ( xQueueSend( qCONN_TargetT, &temp, RTOS_NO_BLOCKING ) )
+    if ( MODULE_Post( qCONN_TargetT, &temp, &evCONN ) )
     {
         //  TODO : Handle error.
     }
 
     //  Forward sensor data to DISPLAY module
 
-    if ( xQueueSend( qDISPLAY_TargetT, &temp, RTOS_NO_BLOCKING ) )
+    if ( MODULE_Post( qDISPLAY_TargetT, &temp, &evDISPLAY ) )
     {
         //  TODO : Handle error.
     }
@@ -496,14 +505,14 @@ static int check_hvac_button ( void )
 
     //  Rising edge detection.
 
-    if ( BOARDBTN_1StateGet( ) && !btn1_press )
+    if ( MODULE_BUTTON_1( ) && !btn1_press )
     {
         btn1_press = 1;
     }
 
     //  Falling edge detection.
 
-    if ( !BOARDBTN_1StateGet( ) && btn1_press )
+    if ( !MODULE_BUTTON_1( ) && btn1_press )
     {
         btn1_press = 0;
 
@@ -519,14 +528,14 @@ static int check_fan_button ( void )
 
     //  Rising edge detection.
 
-    if ( BOARDBTN_2StateGet( ) && !btn2_press )
+    if ( MODULE_BUTTON_2( ) && !btn2_press )
     {
         btn2_press = 1;
     }
 
     //  Falling edge detection.
 
-    if ( !BOARDBTN_2StateGet( ) && btn2_press )
+    if ( !MODULE_BUTTON_2( ) && btn2_press )
     {
         btn2_press = 0;
 
@@ -82,12 +82,10 @@ void SENSOR_Tasks ( void )
                 of calibration data.
             */         
 
-            weather_setStandbyTime( _WEATHER_STANDBY_TIME_1_MS );
-            weather_setFilterCoefficient( _WEATHER_FILTER_COEFF_16 );
-            weather_setOversamplingTemperature( _WEATHER_OVERSAMP_2X );
-            weather_setOversamplingHumidity( _WEATHER_OVERSAMP_1X );
-            weather_setOversamplingPressure( _WEATHER_OVERSAMP_16X );
-            weather_setOversamplingMode( _WEATHER_NORMAL_MODE );
+            weather_configure( _WEATHER_STANDBY_TIME_1_MS,
+                    _WEATHER_FILTER_COEFF_16, _WEATHER_OVERSAMP_2X,
+                    _WEATHER_OVERSAMP_1X, _WEATHER_OVERSAMP_16X,
+                    _WEATHER_NORMAL_MODE );
             weather_readCalibrationParams( );
 
             sensorData.state = MODULE_STATE_PREACTIVE;
@@ -109,16 +107,16 @@ void SENSOR_Tasks ( void )
             {
                 //  Send measurement to HVAC module 
 
-                if ( xQueueSend( qHVAC_Sensor, &sensorData.value, 
-                            RTOS_NO_BLOCKING ) )
+                if ( MODULE_Post( qHVAC_Sensor, &sensorData.value, 
+                            &evHVAC ) )
                 {
                     //  TODO : Handle error.
                 }
 
                 //  Send measurement to HVAC module as initial target values
 
-                if ( xQueueSend( qHVAC_TargetT, &sensorData.value, 
-                            RTOS_NO_BLOCKING ) )
+                if ( MODULE_Post( qHVAC_TargetT, &sensorData.value, 
+                            &evHVAC ) )
                 {
                     //  TODO : Handle error.
                 }
@@ -144,8 +142,8 @@ void SENSOR_Tasks ( void )
             {
                 //  Send measurement to HVAC module
 
-                if ( xQueueSend( qHVAC_Sensor, &sensorData.value, 
-                            RTOS_NO_BLOCKING ) )
+                if ( MODULE_Post( qHVAC_Sensor, &sensorData.value, 
+                            &evHVAC ) )
                 {
                     //  TODO : Handle error.
                 }
@@ -178,7 +176,11 @@ static void _SENSOR_Tasks ( void )
     for ( ; ; )
     {
         SENSOR_Tasks( );
-        vTaskDelay( SENSOR_TASK_DELAY / portTICK_PERIOD_MS );
+#if MODULE_LOG_WAKEUPS
+        MODULES_LogWakeups( );
+#endif
+        MODULE_WaitForEvent( &evSENSOR, SENSOR_TASK_DELAY, 
+                SENSOR_TASK_DELAY / portTICK_PERIOD_MS );
     }
 }
 
@@ -196,6 +198,11 @@ static int read_sensor_measurement ( SENSOR_VALUE *data )
         weather_getWeather( &data->temperature, &data->humidity, &data->pressure );
         xSemaphoreGive( smphrSPI1 );
 
+#if SENSOR_LOG_SAMPLE_BYTES
+        vLoggingPrintf( "Weather sample: %u SPI bytes\r\n", 
+                weather_getSampleBytes( ) );
+#endif
+
         retval = MODULE_OK;
     }
 
@@ -237,8 +237,8 @@ void THERMOSTAT_Tasks ( void )
 
             //  Add data to queue
 
-            if ( xQueueSend( qHVAC_TargetT, &thermostatData.target, 
-                        RTOS_NO_BLOCKING ) )
+            if ( MODULE_Post( qHVAC_TargetT, &thermostatData.target, 
+                        &evHVAC ) )
             {
                 //  TODO : Handle error.
             }
@@ -293,6 +293,8 @@ void THERMOSTAT_ISR_Handler ( void )
 
         break;
     }
+
+    MODULE_WakeFromISR( &evTHERMOSTAT );
 }
     
 /* -------------------------------------------------------- PRIVATE FUNCTIONS */
@@ -302,8 +304,21 @@ static void _THERMOSTAT_Tasks ( void )
 {
     for ( ; ; )
     {
+        TickType_t timeout = THERMOSTAT_TASK_DELAY / portTICK_PERIOD_MS;
+
         THERMOSTAT_Tasks( );
-        vTaskDelay( THERMOSTAT_TASK_DELAY / portTICK_PERIOD_MS );
+
+        /*
+            Encoder lines have no interrupt so they are polled while ACTIVE, 
+            INACTIVE module sleeps until Rotary stick is pressed.
+        */
+
+        if ( thermostatData.state == MODULE_STATE_INACTIVE )
+        {
+            timeout = portMAX_DELAY;
+        }
+
+        MODULE_WaitForEvent( &evTHERMOSTAT, THERMOSTAT_TASK_DELAY, timeout );
     }
 }
 
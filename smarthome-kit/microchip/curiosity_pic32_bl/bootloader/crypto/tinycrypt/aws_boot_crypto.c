@@ -70,16 +70,26 @@ BaseType_t BOOT_CRYPTO_Verify( const uint8_t * pucData,
                                uint32_t ulSignatureSize )
 {
     BaseType_t xResult = pdFALSE;
-    int32_t lReturn;
-    uint32_t ulBitStringPos = 0;
 
     uint8_t pucHash[ TC_SHA256_DIGEST_SIZE ];
 
-    /* ASN.1 encodes signature.*/
-    uint8_t pucSignatureEncoded[ BOOT_ECC_SIGNATURE_SIZE_MAX ];
+    xResult = BOOT_CRYPTO_Digest( pucData, ulSize, pucHash );
 
-    /* Decoded signature containing required elements on the curve.*/
-    uint8_t pucSignatureDecoded[ ECC_NUM_SIG_COMPONENTS * ECC_NUM_BYTES_PER_SIG_COMPONENT ];
+    if( xResult == pdTRUE )
+    {
+        xResult = BOOT_CRYPTO_VerifyDigest( pucHash, pucSignature, ulSignatureSize );
+    }
+
+    return xResult;
+}
+
+/*-----------------------------------------------------------*/
+
+BaseType_t BOOT_CRYPTO_Digest( const uint8_t * pucData,
+                               uint32_t ulSize,
+                               uint8_t * pucDigest )
+{
+    BaseType_t xResult = pdFALSE;
 
     /*
      * Hashing context.
@@ -101,7 +111,7 @@ BaseType_t BOOT_CRYPTO_Verify( const uint8_t * pucData,
             /*
              * Finalize the hash.
              */
-            if( TC_CRYPTO_SUCCESS == tc_sha256_final( pucHash, &xCtx ) )
+            if( TC_CRYPTO_SUCCESS == tc_sha256_final( pucDigest, &xCtx ) )
             {
                 xResult = pdTRUE;
             }
@@ -120,12 +130,32 @@ BaseType_t BOOT_CRYPTO_Verify( const uint8_t * pucData,
         xResult = pdFALSE;
     }
 
+    return xResult;
+}
+
+/*-----------------------------------------------------------*/
+
+BaseType_t BOOT_CRYPTO_VerifyDigest( const uint8_t * pucDigest,
+                                     const uint8_t * pucSignature,
+                                     uint32_t ulSignatureSize )
+{
+    BaseType_t xResult = pdFALSE;
+    int32_t lReturn;
+    uint32_t ulBitStringPos = 0;
+
+    /* ASN.1 encodes signature.*/
+    uint8_t pucSignatureEncoded[ BOOT_ECC_SIGNATURE_SIZE_MAX ];
+
+    /* Decoded signature containing required elements on the curve.*/
+    uint8_t pucSignatureDecoded[ ECC_NUM_SIG_COMPONENTS * ECC_NUM_BYTES_PER_SIG_COMPONENT ];
+
     /*
      * Copy signature in coded form to local buffer.
      */
-    if( ( xResult == pdTRUE ) && ( ulSignatureSize <= BOOT_ECC_SIGNATURE_SIZE_MAX ) )
+    if( ulSignatureSize <= BOOT_ECC_SIGNATURE_SIZE_MAX )
     {
         memcpy( pucSignatureEncoded, pucSignature, ulSignatureSize );
+        xResult = pdTRUE;
     }
     else
     {
@@ -151,7 +181,7 @@ BaseType_t BOOT_CRYPTO_Verify( const uint8_t * pucData,
         ulBitStringPos = ulCodeSignPublickeyLength - ECC_PUBKEY_BIT_STRING_SIZE;
 
         lReturn = uECC_verify( pucCodeSignPublicKey + ulBitStringPos,
-                               pucHash,
+                               pucDigest,
                                TC_SHA256_DIGEST_SIZE,
                                pucSignatureDecoded,
                                uECC_secp256r1() );
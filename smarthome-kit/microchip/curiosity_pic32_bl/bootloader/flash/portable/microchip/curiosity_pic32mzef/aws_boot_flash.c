@@ -44,6 +44,22 @@
 #include "aws_boot_flash_info.h"
 #include "aws_boot_log.h"
 
+/* Row program reads the data from RAM, rows are staged here. While one
+ * buffer is programmed the next row is copied into the other one.
+ */
+static uint32_t aulRowBuffer[ 2 ][ AWS_NVM_ROW_SIZE / sizeof( uint32_t ) ] __attribute__( ( aligned( 16 ) ) );
+
+/**
+ * @brief Program full rows.
+ * @param[in] pulAddress row aligned flash address.
+ * @param[in] pulData data to program, can be anywhere in memory.
+ * @param[in] ulRows number of rows.
+ * @return pdTRUE if all rows are programmed, pdFALSE otherwise.
+ */
+static BaseType_t prvFlashWriteRows( const uint32_t * pulAddress,
+                                     const uint32_t * pulData,
+                                     uint32_t ulRows );
+
 /*-----------------------------------------------------------*/
 
 BaseType_t BOOT_FLASH_Write( const uint32_t * pulAddress,
@@ -51,15 +67,98 @@ BaseType_t BOOT_FLASH_Write( const uint32_t * pulAddress,
                              int lLength )
 {
     BaseType_t xReturn = pdFALSE;
+    int lHead = 0;
+    int lRows = 0;
 
     if( ( lLength % AWS_NVM_QUAD_SIZE ) == 0 )
     {
-        /* Use quad word write. */
-        xReturn = AWS_NVM_QuadWordWrite( pulAddress, pulData, lLength / AWS_NVM_QUAD_SIZE );
+        /* Quad words up to the first row boundary. */
+        lHead = ( AWS_NVM_ROW_SIZE - ( ( uint32_t ) pulAddress % AWS_NVM_ROW_SIZE ) ) % AWS_NVM_ROW_SIZE;
+
+        if( lHead > lLength )
+        {
+            lHead = lLength;
+        }
+
+        lRows = ( lLength - lHead ) / AWS_NVM_ROW_SIZE;
+
+        xReturn = pdTRUE;
+
+        if( lHead > 0 )
+        {
+            /* Use quad word write. */
+            xReturn = AWS_NVM_QuadWordWrite( pulAddress, pulData, lHead / AWS_NVM_QUAD_SIZE );
+            pulAddress += lHead / sizeof( uint32_t );
+            pulData += lHead / sizeof( uint32_t );
+            lLength -= lHead;
+        }
+
+        if( ( xReturn == pdTRUE ) && ( lRows > 0 ) )
+        {
+            xReturn = prvFlashWriteRows( pulAddress, pulData, lRows );
+            pulAddress += lRows * AWS_NVM_ROW_SIZE / sizeof( uint32_t );
+            pulData += lRows * AWS_NVM_ROW_SIZE / sizeof( uint32_t );
+            lLength -= lRows * AWS_NVM_ROW_SIZE;
+        }
+
+        if( ( xReturn == pdTRUE ) && ( lLength > 0 ) )
+        {
+            /* Remaining partial row. */
+            xReturn = AWS_NVM_QuadWordWrite( pulAddress, pulData, lLength / AWS_NVM_QUAD_SIZE );
+        }
     }
 
     return xReturn;
 }
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvFlashWriteRows( const uint32_t * pulAddress,
+                                     const uint32_t * pulData,
+                                     uint32_t ulRows )
+{
+    DEFINE_BOOT_METHOD_NAME( "prvFlashWriteRows" );
+
+    uint32_t ulRow;
+    uint8_t ucBuffer = 0;
+    const uint32_t ulRowWords = AWS_NVM_ROW_SIZE / sizeof( uint32_t );
+
+    memcpy( aulRowBuffer[ ucBuffer ], pulData, AWS_NVM_ROW_SIZE );
+
+    for( ulRow = 0; ulRow < ulRows; ulRow++ )
+    {
+        if( !AWS_NVM_RowWriteStart( pulAddress + ulRow * ulRowWords,
+                                    aulRowBuffer[ ucBuffer ],
+                                    NULL,
+                                    0 ) )
+        {
+            return pdFALSE;
+        }
+
+        /* Stage the next row while this one is programmed. */
+        if( ( ulRow + 1 ) < ulRows )
+        {
+            memcpy( aulRowBuffer[ ucBuffer ^ 1 ], pulData + ( ulRow + 1 ) * ulRowWords, AWS_NVM_ROW_SIZE );
+        }
+
+        if( !AWS_NVM_Wait() )
+        {
+            BOOT_LOG_L1( "[%s] Row program failed at 0x%08x\r\n",
+                         BOOT_METHOD_NAME,
+                         pulAddress + ulRow * ulRowWords );
+            return pdFALSE;
+        }
+
+        ucBuffer ^= 1;
+    }
+
+    BOOT_LOG_L3( "[%s] %lu rows programmed, %lu B/s\r\n",
+                 BOOT_METHOD_NAME,
+                 ( unsigned long ) ulRows,
+                 ( unsigned long ) AWS_NVM_GetBytesPerSecond() );
+
+    return pdTRUE;
+}
 /*-----------------------------------------------------------*/
 
 BaseType_t BOOT_FLASH_EraseHeader( const BOOTImageDescriptor_t * pxAppDescriptor )
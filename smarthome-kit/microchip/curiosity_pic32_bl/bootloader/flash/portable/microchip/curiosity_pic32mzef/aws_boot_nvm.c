@@ -52,16 +52,44 @@
 
 #define AWS_NVM_QUAD_MASK          0xfffffff0
 
+/* core timer runs at half of the system clock */
+#define AWS_NVM_CORE_TMR_FREQ      ( SYS_CLK_FREQ / 2 )
+
+/* ongoing asynchronous operation */
+typedef struct
+{
+    AWS_NVM_CALLBACK callback;
+    uintptr_t context;
+    uint32_t nBytes;     /* bytes programmed by the operation, 0 for erase */
+    uint32_t startCount; /* core timer at start */
+    bool busy;
+    bool failed;         /* last completed operation failed, not reported */
+                         /* by AWS_NVM_Wait yet */
+} AWS_NVM_ASYNC_OP;
+
+static AWS_NVM_ASYNC_OP nvmAsyncOp;
+
+/* programming statistics */
+static uint64_t nvmProgBytes;
+static uint64_t nvmProgCycles;
+
 /* prototypes */
 static bool AWS_NVMOperation( uint32_t nvmop );
+static void AWS_NVMOperationStart( uint32_t nvmop );
+static bool AWS_NVMAsyncStart( uint32_t nvmop,
+                               uint32_t nBytes,
+                               AWS_NVM_CALLBACK callback,
+                               uintptr_t context );
 static void AWS_NVMClearError( void );
 
 /* implementation */
 
-static bool AWS_NVMOperation( uint32_t nvmop )
+static void AWS_NVMOperationStart( uint32_t nvmop )
 {
     uint32_t processorStatus;
 
+    /* the unlock sequence must not be interrupted; the operation */
+    /* itself runs in the background */
     processorStatus = PLIB_INT_GetStateAndDisable( INT_ID_0 );
 
     /* Disable flash write/erase operations */
@@ -79,17 +107,43 @@ static bool AWS_NVMOperation( uint32_t nvmop )
 
     PLIB_NVM_FlashWriteStart( NVM_ID_0 );
 
+    PLIB_INT_SetState( INT_ID_0, processorStatus );
+}
+
+static bool AWS_NVMOperation( uint32_t nvmop )
+{
+    AWS_NVMOperationStart( nvmop );
+
     while( !PLIB_NVM_FlashWriteCycleHasCompleted( NVM_ID_0 ) )
     {
     }
 
     bool success = PLIB_NVM_WriteOperationHasTerminated( NVM_ID_0 ) == false;
 
-    PLIB_INT_SetState( INT_ID_0, processorStatus );
-
     return success;
 }
 
+static bool AWS_NVMAsyncStart( uint32_t nvmop,
+                               uint32_t nBytes,
+                               AWS_NVM_CALLBACK callback,
+                               uintptr_t context )
+{
+    if( nvmAsyncOp.busy )
+    {
+        return false;
+    }
+
+    nvmAsyncOp.callback = callback;
+    nvmAsyncOp.context = context;
+    nvmAsyncOp.nBytes = nBytes;
+    nvmAsyncOp.startCount = _CP0_GET_COUNT();
+    nvmAsyncOp.busy = true;
+
+    AWS_NVMOperationStart( nvmop );
+
+    return true;
+}
+
 
 /*-----------------------------------------------------------*/
 
@@ -105,6 +159,13 @@ bool AWS_NVM_QuadWordWrite( const uint32_t * address,
     uint32_t phys_addr = KVA_TO_PA( ( uint32_t ) address );
 
     bool success = true;
+    uint32_t startCount = _CP0_GET_COUNT();
+    uint32_t nBytes = 0;
+
+    if( nvmAsyncOp.busy )
+    {
+        return false;
+    }
 
     while( nQuads-- )
     {
@@ -121,13 +182,130 @@ bool AWS_NVM_QuadWordWrite( const uint32_t * address,
 
         phys_addr += AWS_NVM_QUAD_SIZE;
         data += AWS_NVM_QUAD_SIZE / sizeof( *data );
+        nBytes += AWS_NVM_QUAD_SIZE;
     }
 
+    nvmProgBytes += nBytes;
+    nvmProgCycles += _CP0_GET_COUNT() - startCount;
+
     return success;
 }
 
 /*-----------------------------------------------------------*/
 
+bool AWS_NVM_RowWriteStart( const uint32_t * address,
+                            const uint32_t * rowData,
+                            AWS_NVM_CALLBACK callback,
+                            uintptr_t context )
+{
+    uint32_t phys_flash_addr = KVA_TO_PA( ( uint32_t ) address );
+    uint32_t phys_data_addr = KVA_TO_PA( ( uint32_t ) rowData );
+
+    if( ( phys_flash_addr & ( AWS_NVM_ROW_SIZE - 1 ) ) != 0 )
+    {
+        return false;
+    }
+
+    if( nvmAsyncOp.busy )
+    {
+        return false;
+    }
+
+    /* the NVM controller reads the row directly from RAM */
+    SYS_DEVCON_DataCacheClean( ( uint32_t ) rowData, AWS_NVM_ROW_SIZE );
+
+    PLIB_NVM_FlashAddressToModify( NVM_ID_0, phys_flash_addr );
+    PLIB_NVM_DataBlockSourceAddress( NVM_ID_0, phys_data_addr );
+
+    return AWS_NVMAsyncStart( ROW_PROGRAM_OPERATION, AWS_NVM_ROW_SIZE, callback, context );
+}
+
+/*-----------------------------------------------------------*/
+
+bool AWS_NVM_PageEraseStart( const uint32_t * pagePtr,
+                             AWS_NVM_CALLBACK callback,
+                             uintptr_t context )
+{
+    uint32_t phys_addr = KVA_TO_PA( ( uint32_t ) pagePtr );
+
+    if( nvmAsyncOp.busy )
+    {
+        return false;
+    }
+
+    PLIB_NVM_FlashAddressToModify( NVM_ID_0, phys_addr );
+
+    return AWS_NVMAsyncStart( PAGE_ERASE_OPERATION, 0, callback, context );
+}
+
+/*-----------------------------------------------------------*/
+
+bool AWS_NVM_IsBusy( void )
+{
+    if( !nvmAsyncOp.busy )
+    {
+        return false;
+    }
+
+    if( !PLIB_NVM_FlashWriteCycleHasCompleted( NVM_ID_0 ) )
+    {
+        return true;
+    }
+
+    bool success = PLIB_NVM_WriteOperationHasTerminated( NVM_ID_0 ) == false;
+
+    nvmAsyncOp.failed = !success;
+
+    if( !success )
+    {
+        AWS_NVMClearError();
+    }
+    else if( nvmAsyncOp.nBytes )
+    {
+        nvmProgBytes += nvmAsyncOp.nBytes;
+        nvmProgCycles += _CP0_GET_COUNT() - nvmAsyncOp.startCount;
+    }
+
+    nvmAsyncOp.busy = false;
+
+    if( nvmAsyncOp.callback )
+    {
+        nvmAsyncOp.callback( success, nvmAsyncOp.context );
+    }
+
+    return false;
+}
+
+/*-----------------------------------------------------------*/
+
+bool AWS_NVM_Wait( void )
+{
+    while( AWS_NVM_IsBusy() )
+    {
+    }
+
+    /* a failure is reported once; waiting while idle succeeds */
+    bool failed = nvmAsyncOp.failed;
+
+    nvmAsyncOp.failed = false;
+
+    return !failed;
+}
+
+/*-----------------------------------------------------------*/
+
+uint32_t AWS_NVM_GetBytesPerSecond( void )
+{
+    if( nvmProgCycles == 0 )
+    {
+        return 0;
+    }
+
+    return ( uint32_t ) ( ( nvmProgBytes * AWS_NVM_CORE_TMR_FREQ ) / nvmProgCycles );
+}
+
+/*-----------------------------------------------------------*/
+
 void AWS_NVM_ToggleFlashBanks( void )
 {
     bool bank2Low = PLIB_NVM_ProgramFlashBank2IsLowerRegion( NVM_ID_0 );
@@ -165,6 +343,11 @@ bool AWS_UpperBootPageErase( const uint32_t * pagePtr )
 {
     uint32_t phys_addr = KVA_TO_PA( ( uint32_t ) pagePtr );
 
+    if( nvmAsyncOp.busy )
+    {
+        return false;
+    }
+
     PLIB_NVM_FlashAddressToModify( NVM_ID_0, phys_addr );
 
     if( !AWS_NVMOperation( PAGE_ERASE_OPERATION ) )
@@ -186,6 +369,11 @@ bool AWS_UpperBootWriteRow( const uint32_t * ptrFlash,
     uint32_t phys_flash_addr = KVA_TO_PA( ( uint32_t ) ptrFlash );
     uint32_t phys_data_addr = KVA_TO_PA( ( uint32_t ) rowData );
 
+    if( nvmAsyncOp.busy )
+    {
+        return false;
+    }
+
     PLIB_NVM_FlashAddressToModify( NVM_ID_0, phys_flash_addr );
     PLIB_NVM_DataBlockSourceAddress( NVM_ID_0, phys_data_addr );
 
@@ -241,6 +429,11 @@ bool AWS_FlashProgramIsSwapped( void )
 
 bool AWS_FlashErase( uint32_t ulFlashNvop )
 {
+    if( nvmAsyncOp.busy )
+    {
+        return false;
+    }
+
     if( !AWS_NVMOperation( ulFlashNvop ) )
     {
         /* failed; clear the NVM error */
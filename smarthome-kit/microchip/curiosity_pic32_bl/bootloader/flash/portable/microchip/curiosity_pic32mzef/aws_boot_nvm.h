@@ -32,12 +32,43 @@
 
 
 #define AWS_NVM_QUAD_SIZE    16
+#define AWS_NVM_ROW_SIZE     2048
+#define AWS_NVM_PAGE_SIZE    16384
+
+/* completion callback of an asynchronous operation */
+/* success is false if the operation was terminated */
+typedef void ( * AWS_NVM_CALLBACK )( bool success,
+                                     uintptr_t context );
 
 /* performs a quad write operation */
 bool AWS_NVM_QuadWordWrite( const uint32_t * address,
                             const uint32_t * data,
                             int nQuads );
 
+/* starts programming of one row, returns immediately */
+/* address has to be row aligned, rowData has to be in RAM */
+/* and must stay valid until the operation completes */
+bool AWS_NVM_RowWriteStart( const uint32_t * address,
+                            const uint32_t * rowData,
+                            AWS_NVM_CALLBACK callback,
+                            uintptr_t context );
+
+/* starts erase of one page, returns immediately */
+bool AWS_NVM_PageEraseStart( const uint32_t * pagePtr,
+                             AWS_NVM_CALLBACK callback,
+                             uintptr_t context );
+
+/* polls the ongoing operation and completes it when done */
+/* the callback is called from here; returns true while busy */
+bool AWS_NVM_IsBusy( void );
+
+/* waits for the ongoing operation; returns false if an operation */
+/* completed with an error since the last wait, true otherwise */
+bool AWS_NVM_Wait( void );
+
+/* programming throughput of all quad and row writes so far */
+uint32_t AWS_NVM_GetBytesPerSecond( void );
+
 /* toggles the mapping of the program flash panels: */
 /* lower <-> upper */
 void AWS_NVM_ToggleFlashBanks( void );
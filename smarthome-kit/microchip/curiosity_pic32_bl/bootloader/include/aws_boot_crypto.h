@@ -67,6 +67,11 @@
  */
 #define BOOT_CRYPTO_SIGNATURE_SIZE         ( 256U )
 
+/**
+ * @brief Size of image digest in bytes.
+ */
+#define BOOT_CRYPTO_DIGEST_SIZE            ( 32U )
+
 /**
  * @brief Boot crypto module initialization.
  * @param[in] None.
@@ -88,4 +93,28 @@ BaseType_t BOOT_CRYPTO_Verify( const uint8_t * pucData,
                                const uint8_t * pucSignature,
                                uint32_t ulSignatureSize );
 
+/**
+ * @brief Computes the digest of a data block.
+ * @param[in] pucData - points to start of the data
+ * @param[in] ulSize - size of the data
+ * @param[out] pucDigest - BOOT_CRYPTO_DIGEST_SIZE bytes of digest
+ * @return pdTRUE - if digest is computed, or pdFALSE otherwise.
+ */
+BaseType_t BOOT_CRYPTO_Digest( const uint8_t * pucData,
+                               uint32_t ulSize,
+                               uint8_t * pucDigest );
+
+/**
+ * @brief Verifies a cryptographic signature of a precomputed digest.
+ * This is the second half of BOOT_CRYPTO_Verify, used when the digest of the
+ * data block is already known.
+ * @param[in] pucDigest - BOOT_CRYPTO_DIGEST_SIZE bytes of digest
+ * @param[in] pucSignature -  points to ASN1 encoded crypto signature
+ * @param[in] ulSignatureSize - size of the ASN1 encoded crypto signature
+ * @return pdTRUE - if verification succeeds, or pdFALSE if it fails.
+ */
+BaseType_t BOOT_CRYPTO_VerifyDigest( const uint8_t * pucDigest,
+                                     const uint8_t * pucSignature,
+                                     uint32_t ulSignatureSize );
+
 #endif /* ifndef _AWS_BOOT_CRYPTO_H_ */
@@ -156,6 +156,44 @@ typedef struct
     uint8_t aucSignature[ BOOT_CRYPTO_SIGNATURE_SIZE ];      /* Signature. */
 } BOOTImageTrailer_t;
 
+/**
+ * @brief Magic code of verified digest record.
+ * @see BOOTDigestRecord_t
+ */
+#define BOOT_DIGEST_MAGIC_CODE      ( 0x54534744UL )
+
+/**
+ * @brief Size of the image start covered by the header digest.
+ * @see BOOTDigestRecord_t
+ */
+#define BOOT_DIGEST_HEADER_SIZE     ( 4096U )
+
+/**
+ * @brief Verified digest record.
+ * This structure is written by the bootloader after the image trailer, on the
+ * first quad word boundary, once the image passes full signature verification.
+ * It is not part of signed OTA image and it is written only to erased flash.
+ * The record is tied to the image bytes by a SHA-256 of the image start and a
+ * CRC-32 of the whole image, both computed again on each boot, and it carries
+ * a CRC-32 of its own fields.
+ * @see bootconfigENABLE_DIGEST_CACHE
+ */
+typedef union
+{
+    uint32_t ulAlign[ 8 + 2 * BOOT_CRYPTO_DIGEST_SIZE / sizeof( uint32_t ) ];
+    struct
+    {
+        uint32_t ulMagic;                                   /* Record magic code. */
+        uint32_t ulSequenceNum;                             /* Sequence number of verified image. */
+        uint32_t ulSignatureSize;                           /* Size of verified signature. */
+        uint32_t ulImageCrc;                                /* CRC-32 of verified image. */
+        uint8_t aucDigest[ BOOT_CRYPTO_DIGEST_SIZE ];       /* Verified image digest. */
+        uint8_t aucHeaderDigest[ BOOT_CRYPTO_DIGEST_SIZE ]; /* Digest of the image start. */
+        uint32_t ulReserved[ 3 ];                           /* Reserved. */
+        uint32_t ulRecordCrc;                               /* CRC-32 of the fields above. */
+    };
+} BOOTDigestRecord_t;
+
 /**
  * @brief Application image flags.
  * These are the flags used by bootloader to maintain the application
@@ -72,6 +72,15 @@ BaseType_t BOOT_PAL_WatchdogEnable( void );
  */
 BaseType_t BOOT_PAL_WatchdogDisable( void );
 
+/**
+ * @brief Time since reset.
+ * Free running time base used to report the boot time. It has to run before
+ * the bootloader is started and it must not wrap during the boot.
+ * @param[in] None.
+ * @return Time in microseconds.
+ */
+uint32_t BOOT_PAL_GetTimeUs( void );
+
 /**
  * @brief Boot error state notification.
  * This function is used for notifying error state in bootloader.
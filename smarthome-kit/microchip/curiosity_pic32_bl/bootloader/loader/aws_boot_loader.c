@@ -28,12 +28,18 @@
  * @brief Application loader implementation.
  */
 
+/* Standard includes.*/
+#include <stddef.h>
+#include <string.h>
+
 /* Bootloader includes.*/
 #include "aws_boot_types.h"
 #include "aws_boot_config.h"
 #include "aws_boot_log.h"
 #include "aws_boot_partition.h"
 #include "aws_boot_loader.h"
+#include "aws_boot_flash.h"
+#include "aws_boot_pal.h"
 
 /**
  * @brief Bootloader data.
@@ -48,6 +54,10 @@ static const BOOTImageDescriptor_t * pxAppDescriptorExec;
 /* Default application execution address.*/
 static const void * pvDefaultExecAddress;
 
+/* Time of bootloader start and time spent in image validation.*/
+static uint32_t ulBootStartUs;
+static uint32_t ulValidationUs;
+
 /**
  * @brief Bootloader status function prototype.
  *
@@ -90,20 +100,80 @@ static const BootStateFunction_t apfBootStateFunctionTable[] =
  */
 
 /**
- * @brief Validate an application image.
+ * @brief Validate an application image header.
  * Validates the application image present in application image slot
- * pointed by the application descriptor.
- * The image is validated in following steps -
+ * pointed by the application descriptor, except its crypto signature.
+ * The header is validated in following steps -
  * - Image signature is verified
  * - Image flags are validated
  * - HWID is verified
  * - Address entries are verified
- * - Crypto signature is verified
+ * These only read the descriptor so they are cheap enough to run for every
+ * slot on each boot.
  * @param[in] pxAppDescriptor ptr to the application descriptor of the image to
  * be validated.
  * @return pdPASS if validation successful, pdFAIL otherwise
  */
-static BaseType_t prvValidateImage( const BOOTImageDescriptor_t * pxAppDescriptor );
+static BaseType_t prvValidateHeader( const BOOTImageDescriptor_t * pxAppDescriptor );
+
+/**
+ * @brief Verify crypto signature of an application image.
+ * If bootconfigENABLE_DIGEST_CACHE is set and an intact digest record of this
+ * image is present and still matches the image start digest and the image
+ * CRC, the signature is verified against the cached digest and the image is
+ * not hashed in full. Otherwise the image is hashed and the digest is stored
+ * once the signature is verified.
+ * @param[in] pxAppDescriptor ptr to the application descriptor of the image to
+ * be verified.
+ * @return pdPASS if verification successful, pdFAIL otherwise
+ */
+static BaseType_t prvValidateSignature( const BOOTImageDescriptor_t * pxAppDescriptor );
+
+/**
+ * @brief Get verified digest record of an application image.
+ * The record follows the image trailer on the first quad word boundary.
+ * @param[in] pxImgTrailer ptr to the trailer of the image.
+ * @param[in] pxAppDescriptor ptr to the application descriptor of the image.
+ * @return ptr to the record or NULL if record does not fit in the slot.
+ */
+#if ( bootconfigENABLE_DIGEST_CACHE == 1 )
+    static const BOOTDigestRecord_t * prvGetDigestRecord( const BOOTImageDescriptor_t * pxAppDescriptor,
+                                                          const BOOTImageTrailer_t * pxImgTrailer );
+#endif
+
+/**
+ * @brief Compute the image key of a digest record.
+ * Fills the image CRC, the header digest and the record CRC of the record
+ * from the image bytes and the other record fields.
+ * @param[in,out] pxRecord ptr to the record to fill.
+ * @param[in] pucImage ptr to the signed image start.
+ * @param[in] ulSize size of the signed image.
+ * @return pdTRUE if the key was computed, pdFALSE otherwise
+ */
+#if ( bootconfigENABLE_DIGEST_CACHE == 1 )
+    static BaseType_t prvKeyDigestRecord( BOOTDigestRecord_t * pxRecord,
+                                          const uint8_t * pucImage,
+                                          uint32_t ulSize );
+#endif
+
+/**
+ * @brief CRC-32 (IEEE 802.3) of a memory block.
+ * @param[in] ulCrc CRC of the preceding data, 0 to start.
+ * @param[in] pucData ptr to data.
+ * @param[in] ulSize data size.
+ * @return updated CRC
+ */
+#if ( bootconfigENABLE_DIGEST_CACHE == 1 )
+    static uint32_t prvCrc32( uint32_t ulCrc,
+                              const uint8_t * pucData,
+                              uint32_t ulSize );
+#endif
+
+/**
+ * @brief Log boot time.
+ * Logs the time since bootloader start and the time spent in validation.
+ */
+static void prvLogBootTime( void );
 
 /**
  * @brief Invalidate an application image.
@@ -154,6 +224,8 @@ static BOOTState_t prvBOOT_Init( void )
 
     BOOTState_t xReturnState = eBootStateError;
 
+    ulBootStartUs = BOOT_PAL_GetTimeUs();
+
     BOOT_LOG_L1( "\nBootloader version %02d.", BOOTLOADER_VERSION_MAJOR );
     BOOT_LOG_L1( "%02d.", BOOTLOADER_VERSION_MINOR );
     BOOT_LOG_L1( "%02d\r\n", BOOTLOADER_VERSION_BUILD );
@@ -222,6 +294,12 @@ static BOOTState_t prvBOOT_ValidateImages( void )
     BOOTState_t xReturnState = eBootStateError;
     uint32_t ulSeqNumber = 0;
     uint8_t ucIndex = 0;
+    uint8_t ucSlot = 0;
+    uint8_t ucNumOfCandidates = 0;
+    uint32_t ulStartUs = BOOT_PAL_GetTimeUs();
+
+    /* Images which passed header validation, newest first. */
+    BOOTImageDescriptor_t * apxCandidates[ FLASH_PARTITIONS_OTA_MAX ];
 
     /* Partition Info*/
     BOOTPartition_Info_t xPartitionInfo;
@@ -234,18 +312,25 @@ static BOOTState_t prvBOOT_ValidateImages( void )
     if( pdTRUE == BOOT_FLASH_ReadPartitionTable( &xPartitionInfo ) )
     {
         /**
-         * Validate the application images and find out the newest valid
-         * image to boot.
+         * Validate the image headers first and order the images by sequence
+         * number, newest first.
          */
         for( ucIndex = 0; ucIndex < xPartitionInfo.ucNumOfApps; ucIndex++ )
         {
-            if( pdPASS == prvValidateImage( xPartitionInfo.paxOTAAppDescriptor[ ucIndex ] ) )
+            if( pdPASS == prvValidateHeader( xPartitionInfo.paxOTAAppDescriptor[ ucIndex ] ) )
             {
-                if( ulSeqNumber < xPartitionInfo.paxOTAAppDescriptor[ ucIndex ]->ulSequenceNum )
+                for( ucSlot = ucNumOfCandidates; ucSlot > 0; ucSlot-- )
                 {
-                    ulSeqNumber = xPartitionInfo.paxOTAAppDescriptor[ ucIndex ]->ulSequenceNum;
-                    pxAppDescriptorExec = xPartitionInfo.paxOTAAppDescriptor[ ucIndex ];
+                    if( apxCandidates[ ucSlot - 1 ]->ulSequenceNum >= xPartitionInfo.paxOTAAppDescriptor[ ucIndex ]->ulSequenceNum )
+                    {
+                        break;
+                    }
+
+                    apxCandidates[ ucSlot ] = apxCandidates[ ucSlot - 1 ];
                 }
+
+                apxCandidates[ ucSlot ] = xPartitionInfo.paxOTAAppDescriptor[ ucIndex ];
+                ucNumOfCandidates++;
             }
             else
             {
@@ -261,12 +346,58 @@ static BOOTState_t prvBOOT_ValidateImages( void )
                 }
             }
         }
+
+        /**
+         * Verify crypto signatures in sequence number order and find out the
+         * newest valid image to boot.
+         */
+        for( ucIndex = 0; ucIndex < ucNumOfCandidates; ucIndex++ )
+        {
+            if( pdPASS == prvValidateSignature( apxCandidates[ ucIndex ] ) )
+            {
+                if( ulSeqNumber < apxCandidates[ ucIndex ]->ulSequenceNum )
+                {
+                    ulSeqNumber = apxCandidates[ ucIndex ]->ulSequenceNum;
+                    pxAppDescriptorExec = apxCandidates[ ucIndex ];
+                }
+
+                /**
+                 * Older images are verified only if the newest one fails.
+                 */
+                #if ( bootconfigENABLE_NEWEST_FIRST_VALIDATION == 1 )
+                    {
+                        if( pxAppDescriptorExec != NULL )
+                        {
+                            BOOT_LOG_L2( "[%s] Skipped validation of %d older image(s).\r\n",
+                                         BOOT_METHOD_NAME,
+                                         ucNumOfCandidates - ucIndex - 1 );
+                            break;
+                        }
+                    }
+                #endif /* if ( bootconfigENABLE_NEWEST_FIRST_VALIDATION == 1 ) */
+            }
+            else
+            {
+                /**
+                 * The image failed validation so invalidate it by erasing header
+                 * and erasing bank if full erase is set in config.
+                 */
+                BOOT_LOG_L1( "[%s] Validation failed for image at 0x%08x \r\n", BOOT_METHOD_NAME, apxCandidates[ ucIndex ] );
+
+                if( pdPASS != prvInvalidateImage( apxCandidates[ ucIndex ] ) )
+                {
+                    BOOT_LOG_L1( "[%s] Invalidation failed.\r\n", BOOT_METHOD_NAME );
+                }
+            }
+        }
     }
     else
     {
         BOOT_LOG_L1( "[%s] Partition table error.\r\n", BOOT_METHOD_NAME );
     }
 
+    ulValidationUs = BOOT_PAL_GetTimeUs() - ulStartUs;
+
     /**
      *  check if we have an image to execute in OTA partitions.
      */
@@ -384,6 +515,8 @@ static BOOTState_t prvBOOT_ExecuteImage( void )
 
     if( xReturn == pdTRUE )
     {
+        prvLogBootTime();
+
         /* Launch, never returns from here. */
         BOOT_PAL_LaunchApplicationDesc( pxAppDescriptorExec );
     }
@@ -402,6 +535,8 @@ static BOOTState_t prvBOOT_ExecuteDefault( void )
         return eBootStateError;
     }
 
+    prvLogBootTime();
+
     /* Launch, never returns from here. */
     BOOT_PAL_LaunchApplication( pvDefaultExecAddress );
 }
@@ -420,15 +555,11 @@ static BOOTState_t prvBOOT_Error( void )
 
 /*-----------------------------------------------------------*/
 
-static BaseType_t prvValidateImage( const BOOTImageDescriptor_t * pxAppDescriptor )
+static BaseType_t prvValidateHeader( const BOOTImageDescriptor_t * pxAppDescriptor )
 {
-    DEFINE_BOOT_METHOD_NAME( "prvValidateImage" );
+    DEFINE_BOOT_METHOD_NAME( "prvValidateHeader" );
 
     BaseType_t xReturn = pdFALSE;
-    uint8_t * pucTrailerAddress = NULL;
-    uint8_t * pucStartAddress = NULL;
-    BOOTImageTrailer_t * pxImgTrailer = NULL;
-    uint32_t ulSizeApp = 0;
 
     /* Get the image flags.*/
     uint8_t ucImageFlags = pxAppDescriptor->xImageHeader.ucImageFlags;
@@ -534,45 +665,141 @@ static BaseType_t prvValidateImage( const BOOTImageDescriptor_t * pxAppDescripto
         }
     #endif /* if ( bootconfigENABLE_ADDRESS_VALIDATION == 1 ) */
 
+    return xReturn;
+}
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvValidateSignature( const BOOTImageDescriptor_t * pxAppDescriptor )
+{
+    DEFINE_BOOT_METHOD_NAME( "prvValidateSignature" );
+
+    BaseType_t xReturn = pdTRUE;
+    uint8_t * pucTrailerAddress = NULL;
+    uint8_t * pucStartAddress = NULL;
+    BOOTImageTrailer_t * pxImgTrailer = NULL;
+    uint32_t ulSizeApp = 0;
+
     /**
      * Verify the crypto signature of application image.
      */
     #if ( bootconfigENABLE_CRYPTO_SIGNATURE_VERIFICATION == 1 )
         {
-            if( xReturn == pdTRUE )
-            {
-                /* Start address of the application image after header. */
-                pucStartAddress = ( uint8_t * ) pxAppDescriptor;
-                pucStartAddress = pucStartAddress + sizeof( BOOTImageHeader_t );
+            uint8_t aucDigest[ BOOT_CRYPTO_DIGEST_SIZE ];
+            const BOOTDigestRecord_t * pxRecord = NULL;
 
-                /* Size of the application. */
-                ulSizeApp = pxAppDescriptor->pvEndAddress - pxAppDescriptor->pvStartAddress;
+            /* Start address of the application image after header. */
+            pucStartAddress = ( uint8_t * ) pxAppDescriptor;
+            pucStartAddress = pucStartAddress + sizeof( BOOTImageHeader_t );
 
-                /* Application trailer. */
-                pucTrailerAddress = pucStartAddress + ulSizeApp;
+            /* Size of the application. */
+            ulSizeApp = pxAppDescriptor->pvEndAddress - pxAppDescriptor->pvStartAddress;
 
-                /* Align it to BOOT_QUAD_WORD_SIZE. */
-                if( ( ( uint32_t ) pucTrailerAddress % BOOT_QUAD_WORD_SIZE ) != 0 )
-                {
-                    pucTrailerAddress += BOOT_QUAD_WORD_SIZE - ( ( uint32_t ) pucTrailerAddress % BOOT_QUAD_WORD_SIZE );
-                }
+            /* Application trailer. */
+            pucTrailerAddress = pucStartAddress + ulSizeApp;
+
+            /* Align it to BOOT_QUAD_WORD_SIZE. */
+            if( ( ( uint32_t ) pucTrailerAddress % BOOT_QUAD_WORD_SIZE ) != 0 )
+            {
+                pucTrailerAddress += BOOT_QUAD_WORD_SIZE - ( ( uint32_t ) pucTrailerAddress % BOOT_QUAD_WORD_SIZE );
+            }
 
-                pxImgTrailer = ( BOOTImageTrailer_t * ) pucTrailerAddress;
+            pxImgTrailer = ( BOOTImageTrailer_t * ) pucTrailerAddress;
 
-                if( pdTRUE == BOOT_CRYPTO_Verify( pucStartAddress,
-                                                  ulSizeApp,
-                                                  pxImgTrailer->aucSignature,
-                                                  pxImgTrailer->ulSignatureSize ) )
+            #if ( bootconfigENABLE_DIGEST_CACHE == 1 )
                 {
-                    BOOT_LOG_L1( "[%s] Crypto signature is valid.\r\n", BOOT_METHOD_NAME );
-                    xReturn = pdTRUE;
+                    pxRecord = prvGetDigestRecord( pxAppDescriptor, pxImgTrailer );
+
+                    /**
+                     * The cached digest is used only if the record is intact
+                     * and the image still matches it, the image start by
+                     * digest and the whole image by CRC.
+                     */
+                    if( ( pxRecord != NULL ) &&
+                        ( pxRecord->ulMagic == BOOT_DIGEST_MAGIC_CODE ) &&
+                        ( pxRecord->ulSequenceNum == pxAppDescriptor->ulSequenceNum ) &&
+                        ( pxRecord->ulSignatureSize == pxImgTrailer->ulSignatureSize ) &&
+                        ( pxRecord->ulRecordCrc == prvCrc32( 0, ( const uint8_t * ) pxRecord,
+                                                             offsetof( BOOTDigestRecord_t, ulRecordCrc ) ) ) )
+                    {
+                        BOOTDigestRecord_t xKey;
+
+                        memcpy( &xKey, pxRecord, sizeof( xKey ) );
+
+                        if( ( pdTRUE == prvKeyDigestRecord( &xKey, pucStartAddress, ulSizeApp ) ) &&
+                            ( memcmp( &xKey, pxRecord, sizeof( xKey ) ) == 0 ) &&
+                            ( pdTRUE == BOOT_CRYPTO_VerifyDigest( pxRecord->aucDigest,
+                                                                  pxImgTrailer->aucSignature,
+                                                                  pxImgTrailer->ulSignatureSize ) ) )
+                        {
+                            BOOT_LOG_L1( "[%s] Crypto signature is valid (cached digest).\r\n", BOOT_METHOD_NAME );
+                            return pdTRUE;
+                        }
+
+                        BOOT_LOG_L1( "[%s] Cached digest rejected.\r\n", BOOT_METHOD_NAME );
+                    }
                 }
-                else
+            #endif /* if ( bootconfigENABLE_DIGEST_CACHE == 1 ) */
+
+            xReturn = BOOT_CRYPTO_Digest( pucStartAddress, ulSizeApp, aucDigest );
+
+            if( xReturn == pdTRUE )
+            {
+                xReturn = BOOT_CRYPTO_VerifyDigest( aucDigest,
+                                                    pxImgTrailer->aucSignature,
+                                                    pxImgTrailer->ulSignatureSize );
+            }
+
+            if( xReturn == pdTRUE )
+            {
+                BOOT_LOG_L1( "[%s] Crypto signature is valid.\r\n", BOOT_METHOD_NAME );
+            }
+            else
+            {
+                BOOT_LOG_L1( "[%s] Crypto signature is not valid.\r\n", BOOT_METHOD_NAME );
+            }
+
+            /**
+             * Store the verified digest. Flash can only be programmed once
+             * after erase, so a stale or corrupt record is left in place and
+             * the image is simply hashed on every boot.
+             */
+            #if ( bootconfigENABLE_DIGEST_CACHE == 1 )
                 {
-                    BOOT_LOG_L1( "[%s] Crypto signature is not valid.\r\n", BOOT_METHOD_NAME );
-                    xReturn = pdFALSE;
+                    BOOTDigestRecord_t xRecord;
+
+                    memset( &xRecord, 0xff, sizeof( xRecord ) );
+
+                    if( ( xReturn == pdTRUE ) &&
+                        ( pxRecord != NULL ) &&
+                        ( memcmp( &xRecord, pxRecord, sizeof( xRecord ) ) == 0 ) )
+                    {
+                        xRecord.ulMagic = BOOT_DIGEST_MAGIC_CODE;
+                        xRecord.ulSequenceNum = pxAppDescriptor->ulSequenceNum;
+                        xRecord.ulSignatureSize = pxImgTrailer->ulSignatureSize;
+                        memcpy( xRecord.aucDigest, aucDigest, sizeof( xRecord.aucDigest ) );
+
+                        if( pdTRUE != prvKeyDigestRecord( &xRecord, pucStartAddress, ulSizeApp ) )
+                        {
+                            BOOT_LOG_L1( "[%s] Failed to key digest record.\r\n", BOOT_METHOD_NAME );
+                        }
+                        else if( BOOT_FLASH_Write( pxRecord->ulAlign,
+                                                   xRecord.ulAlign,
+                                                   sizeof( xRecord ) ) )
+                        {
+                            BOOT_LOG_L2( "[%s] Digest cached at: 0x%08x\r\n",
+                                         BOOT_METHOD_NAME,
+                                         pxRecord );
+                        }
+                        else
+                        {
+                            BOOT_LOG_L1( "[%s] Failed to cache digest at: 0x%08x\r\n",
+                                         BOOT_METHOD_NAME,
+                                         pxRecord );
+                        }
+                    }
                 }
-            }
+            #endif /* if ( bootconfigENABLE_DIGEST_CACHE == 1 ) */
         }
     #else /* if ( bootconfigENABLE_CRYPTO_SIGNATURE_VERIFICATION == 1 ) */
         {
@@ -585,6 +812,91 @@ static BaseType_t prvValidateImage( const BOOTImageDescriptor_t * pxAppDescripto
 
 /*-----------------------------------------------------------*/
 
+#if ( bootconfigENABLE_DIGEST_CACHE == 1 )
+
+static const BOOTDigestRecord_t * prvGetDigestRecord( const BOOTImageDescriptor_t * pxAppDescriptor,
+                                                      const BOOTImageTrailer_t * pxImgTrailer )
+{
+    const uint8_t * pucRecord = ( const uint8_t * ) pxImgTrailer + sizeof( BOOTImageTrailer_t );
+    const uint8_t * pucSlotEnd = ( const uint8_t * ) pxAppDescriptor + FLASH_IMAGE_SIZE_MAX;
+
+    /* Align it to BOOT_QUAD_WORD_SIZE. */
+    if( ( ( uint32_t ) pucRecord % BOOT_QUAD_WORD_SIZE ) != 0 )
+    {
+        pucRecord += BOOT_QUAD_WORD_SIZE - ( ( uint32_t ) pucRecord % BOOT_QUAD_WORD_SIZE );
+    }
+
+    if( ( pucRecord + sizeof( BOOTDigestRecord_t ) ) > pucSlotEnd )
+    {
+        return NULL;
+    }
+
+    return ( const BOOTDigestRecord_t * ) pucRecord;
+}
+
+/*-----------------------------------------------------------*/
+
+static BaseType_t prvKeyDigestRecord( BOOTDigestRecord_t * pxRecord,
+                                      const uint8_t * pucImage,
+                                      uint32_t ulSize )
+{
+    uint32_t ulHeaderSize = ( ulSize < BOOT_DIGEST_HEADER_SIZE ) ? ulSize : BOOT_DIGEST_HEADER_SIZE;
+
+    if( pdTRUE != BOOT_CRYPTO_Digest( pucImage, ulHeaderSize, pxRecord->aucHeaderDigest ) )
+    {
+        return pdFALSE;
+    }
+
+    pxRecord->ulImageCrc = prvCrc32( 0, pucImage, ulSize );
+    pxRecord->ulRecordCrc = prvCrc32( 0, ( const uint8_t * ) pxRecord,
+                                      offsetof( BOOTDigestRecord_t, ulRecordCrc ) );
+
+    return pdTRUE;
+}
+
+/*-----------------------------------------------------------*/
+
+static uint32_t prvCrc32( uint32_t ulCrc,
+                          const uint8_t * pucData,
+                          uint32_t ulSize )
+{
+    /* Half byte table, the bootloader is size constrained. */
+    static const uint32_t aulCrcTable[ 16 ] =
+    {
+        0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+        0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+        0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+        0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+    };
+
+    ulCrc = ~ulCrc;
+
+    while( ulSize-- != 0 )
+    {
+        ulCrc ^= *pucData++;
+        ulCrc = ( ulCrc >> 4 ) ^ aulCrcTable[ ulCrc & 0x0F ];
+        ulCrc = ( ulCrc >> 4 ) ^ aulCrcTable[ ulCrc & 0x0F ];
+    }
+
+    return ~ulCrc;
+}
+
+#endif /* if ( bootconfigENABLE_DIGEST_CACHE == 1 ) */
+
+/*-----------------------------------------------------------*/
+
+static void prvLogBootTime( void )
+{
+    DEFINE_BOOT_METHOD_NAME( "prvLogBootTime" );
+
+    BOOT_LOG_L1( "[%s] Boot time: %u us, validation: %u us\r\n",
+                 BOOT_METHOD_NAME,
+                 BOOT_PAL_GetTimeUs() - ulBootStartUs,
+                 ulValidationUs );
+}
+
+/*-----------------------------------------------------------*/
+
 static BaseType_t prvInvalidateImage( const BOOTImageDescriptor_t * pxAppDescriptor )
 {
     DEFINE_BOOT_METHOD_NAME( "prvInvalidateImage" );
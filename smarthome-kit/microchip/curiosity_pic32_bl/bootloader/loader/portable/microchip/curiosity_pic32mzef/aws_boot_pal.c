@@ -135,6 +135,16 @@ BaseType_t BOOT_PAL_WatchdogDisable( void )
 
 /*-----------------------------------------------------------*/
 
+uint32_t BOOT_PAL_GetTimeUs( void )
+{
+    /* Core timer is cleared by the startup code and counts at half of system clock,
+     * it wraps after ~42 s which is far beyond the boot time.
+     */
+    return _CP0_GET_COUNT() / ( SYS_CLK_FREQ / 2000000UL );
+}
+
+/*-----------------------------------------------------------*/
+
 void BOOT_PAL_NotifyBootError( void )
 {
     uint32_t ulCntr = 0;
@@ -85,5 +85,26 @@
  */
 #define bootconfigENABLE_WATCHDOG_TIMER                   ( 1U )
 
+/**
+ * @brief Validate newest image first
+ * Only the image with the highest sequence number is crypto verified, the
+ * other OTA slot is verified only if the newest image fails. When disabled
+ * every OTA slot is verified on each boot.
+ */
+#define bootconfigENABLE_NEWEST_FIRST_VALIDATION          ( 1U )
+
+/**
+ * @brief Enable verified digest cache
+ * After the first successful verification the image digest is stored next to
+ * the image trailer. Following boots verify the signature against the cached
+ * digest instead of hashing the whole image again. The record is removed
+ * together with the image when the slot is erased by OTA.
+ * The cached boot hashes only the first BOOT_DIGEST_HEADER_SIZE bytes and
+ * checks a CRC-32 of the rest of the image. This catches flash corruption but
+ * not a deliberate change made to keep the CRC, so enabling the cache trades
+ * full image verification for boot time.
+ */
+#define bootconfigENABLE_DIGEST_CACHE                     ( 0U )
+
 
 #endif /* _AWS_BOOT_CONFIG_H_ */
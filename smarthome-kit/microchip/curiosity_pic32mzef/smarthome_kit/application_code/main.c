@@ -124,6 +124,11 @@ void vApplicationDaemonTaskStartupHook( void );
  */
 static void prvMiscInitialization( void );
 
+/**
+ * @brief Waits for the next interrupt with the CPU in idle mode (rtos_idle.c).
+ */
+extern void vApplicationIdleWait( void );
+
 /*-----------------------------------------------------------*/
 
 /**
@@ -335,7 +340,6 @@ void vApplicationGetTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
 
 void vApplicationIdleHook( void )
 {
-    const uint32_t ulMSToSleep = 1;
     const TickType_t xIdleCheckPeriod = pdMS_TO_TICKS( 1000UL );
     static TickType_t xTimeNow, xLastTimeCheck = 0;
 
@@ -360,8 +364,12 @@ void vApplicationIdleHook( void )
     /* This is just a trivial example of an idle hook.  It is called on each
      * cycle of the idle task if configUSE_IDLE_HOOK is set to 1 in
      * FreeRTOSConfig.h.  It must *NOT* attempt to block.  In this case the
-     * idle task just sleeps to lower the CPU usage. */
-    Sleep( ulMSToSleep );
+     * CPU waits for the next interrupt to lower the power usage.  With the
+     * tickless idle the hook runs before portSUPPRESS_TICKS_AND_SLEEP, so
+     * waiting here would sleep through a regular tick first. */
+    #if ( configUSE_TICKLESS_IDLE == 0 )
+        vApplicationIdleWait();
+    #endif
 }
 /*-----------------------------------------------------------*/
 
@@ -0,0 +1,337 @@
+/*******************************************************************************
+ RTOS Idle File
+
+  File Name:
+    rtos_idle.c
+
+  Summary:
+    This file contains the RTOS tick and the low power idle support
+
+  Description:
+    The RTOS tick is generated by the CPU core timer: the compare register
+    is advanced by one tick period on every tick interrupt.
+    Without the tickless idle, the idle task hook waits for the next
+    interrupt in Idle mode.
+    When configUSE_TICKLESS_IDLE is enabled, the compare register is
+    reprogrammed to the end of the expected idle time and the CPU waits
+    in Idle mode without taking the intermediate tick interrupts.
+    The core timer keeps counting in Idle mode (not in Sleep mode),
+    so the ticks elapsed while waiting are recovered from the count register.
+
+    The idle residency and the wake up latency of the core timer are collected
+    and displayed by the "idle" console command.
+
+  Remarks:
+ *******************************************************************************/
+
+// DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright 2017 Microchip Technology Incorporated and its subsidiaries.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of
+this software and associated documentation files (the "Software"), to deal in
+the Software without restriction, including without limitation the rights to
+use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+of the Software, and to permit persons to whom the Software is furnished to do
+so, subject to the following conditions:
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE
+ *******************************************************************************/
+// DOM-IGNORE-END
+
+#include <string.h>
+
+#include "system_config.h"
+#include "system_definitions.h"
+
+
+// the core timer counts at half the system clock
+#define RTOS_IDLE_CYCLES_FREQ       (configCPU_CLOCK_HZ / 2UL)
+
+// core timer cycles per RTOS tick
+#define RTOS_IDLE_CYCLES_PER_TICK   (RTOS_IDLE_CYCLES_FREQ / configTICK_RATE_HZ)
+
+// a compare value closer than this to the count could be missed
+#define RTOS_IDLE_MIN_CYCLES        200UL
+
+// longest tickless sleep; the wake up time has to stay within half of the 32 bit count range
+#define RTOS_IDLE_MAX_SLEEP_TICKS   (0x7fffffffUL / RTOS_IDLE_CYCLES_PER_TICK)
+
+// compare value of the next RTOS tick
+static uint32_t                 rtosNextTickCompare;
+
+static RTOS_IDLE_STATISTICS     rtosIdleStat;
+
+// RTOS tick count when the statistics were cleared
+static TickType_t               rtosIdleStatTick;
+
+#if defined(SYS_CMD_ENABLE)
+static int  _CommandIdle(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+
+static const SYS_CMD_DESCRIPTOR    rtosIdleCmdTbl[]=
+{
+    {"idle",        _CommandIdle,           ": Idle statistics: idle <reset>"},
+};
+#endif  // defined(SYS_CMD_ENABLE)
+
+
+// sets the core timer compare, never behind the count
+static void _RTOS_IDLE_CompareSet(uint32_t compare)
+{
+    uint32_t count = _CP0_GET_COUNT();
+
+    if((int32_t)(compare - count) < (int32_t)RTOS_IDLE_MIN_CYCLES)
+    {   // late; have the interrupt right away
+        compare = count + RTOS_IDLE_MIN_CYCLES;
+    }
+
+    _CP0_SET_COMPARE(compare);
+}
+
+static void _RTOS_IDLE_StatClear(void)
+{
+    memset(&rtosIdleStat, 0, sizeof(rtosIdleStat));
+    rtosIdleStat.minWakeJitter = 0xffffffff;
+    rtosIdleStatTick = xTaskGetTickCount();
+}
+
+/*******************************************************************************
+  Function:
+    void vApplicationSetupTickTimerInterrupt ( void )
+
+  Summary:
+    Starts the RTOS tick on the core timer.
+
+  Remarks:
+    Called by the FreeRTOS port when the scheduler starts.
+    Replaces the port default Timer1 tick.
+*/
+void vApplicationSetupTickTimerInterrupt( void )
+{
+    rtosNextTickCompare = _CP0_GET_COUNT() + RTOS_IDLE_CYCLES_PER_TICK;
+    _CP0_SET_COMPARE(rtosNextTickCompare);
+
+    SYS_INT_VectorPrioritySet(INT_VECTOR_CT, (INT_PRIORITY_LEVEL)configKERNEL_INTERRUPT_PRIORITY);
+    SYS_INT_VectorSubprioritySet(INT_VECTOR_CT, INT_SUBPRIORITY_LEVEL0);
+    SYS_INT_SourceStatusClear(INT_SOURCE_TIMER_CORE);
+    SYS_INT_SourceEnable(INT_SOURCE_TIMER_CORE);
+}
+
+/*******************************************************************************
+  Function:
+    void vApplicationClearTickInterrupt ( void )
+
+  Summary:
+    Schedules the next RTOS tick.
+
+  Remarks:
+    Called from the tick interrupt: configCLEAR_TICK_TIMER_INTERRUPT().
+    The tick phase is kept: a late tick is followed by a shorter one.
+*/
+void vApplicationClearTickInterrupt( void )
+{
+    rtosNextTickCompare += RTOS_IDLE_CYCLES_PER_TICK;
+    _RTOS_IDLE_CompareSet(rtosNextTickCompare);
+    SYS_INT_SourceStatusClear(INT_SOURCE_TIMER_CORE);
+}
+
+/*******************************************************************************
+  Function:
+    void vApplicationIdleWait ( void )
+
+  Summary:
+    Waits in Idle mode for the next interrupt.
+
+  Remarks:
+    Called from the idle task hook, when configUSE_TICKLESS_IDLE is disabled.
+    The interrupts are disabled around the wait instruction: a pending
+    interrupt still ends the wait but it is serviced after the wait time
+    has been measured.
+*/
+void vApplicationIdleWait( void )
+{
+    uint32_t startCount;
+    bool intState = SYS_INT_Disable();
+
+    startCount = _CP0_GET_COUNT();
+    _wait();
+    rtosIdleStat.idleCycles += _CP0_GET_COUNT() - startCount;
+    rtosIdleStat.nWaits++;
+
+    SYS_INT_Restore(intState);
+}
+
+#if (configUSE_TICKLESS_IDLE != 0)
+/*******************************************************************************
+  Function:
+    void vApplicationSleep ( TickType_t xExpectedIdleTime )
+
+  Summary:
+    Waits in Idle mode with the RTOS tick suppressed.
+
+  Remarks:
+    Called by the idle task, with the scheduler suspended:
+    portSUPPRESS_TICKS_AND_SLEEP().
+    The core timer compare is moved to the last tick of the idle time.
+    When the timer wakes up the CPU, the pending tick interrupt counts that
+    last tick. When another interrupt wakes it up, only the complete ticks
+    are counted and the tick is rescheduled in phase.
+*/
+void vApplicationSleep( TickType_t xExpectedIdleTime )
+{
+    uint32_t wakeCompare, startCount, count, nTicks;
+    bool intState;
+
+    if(xExpectedIdleTime > RTOS_IDLE_MAX_SLEEP_TICKS)
+    {
+        xExpectedIdleTime = RTOS_IDLE_MAX_SLEEP_TICKS;
+    }
+
+    intState = SYS_INT_Disable();
+
+    // a task may have been readied or the next tick could be already due
+    if(eTaskConfirmSleepModeStatus() == eAbortSleep ||
+       (int32_t)(rtosNextTickCompare - _CP0_GET_COUNT()) < (int32_t)RTOS_IDLE_MIN_CYCLES)
+    {
+        rtosIdleStat.nAborted++;
+        SYS_INT_Restore(intState);
+        return;
+    }
+
+    // the next tick is the first one of the idle time
+    wakeCompare = rtosNextTickCompare + (xExpectedIdleTime - 1) * RTOS_IDLE_CYCLES_PER_TICK;
+    _CP0_SET_COMPARE(wakeCompare);
+
+    startCount = _CP0_GET_COUNT();
+    _wait();
+    count = _CP0_GET_COUNT();
+
+    rtosIdleStat.nSleeps++;
+    rtosIdleStat.idleCycles += count - startCount;
+
+    if((int32_t)(count - wakeCompare) >= 0)
+    {   // woken up by the core timer; the tick interrupt is pending
+        uint32_t jitter = count - wakeCompare;
+
+        nTicks = xExpectedIdleTime - 1;
+        rtosNextTickCompare = wakeCompare;
+
+        rtosIdleStat.nTimerWakes++;
+        rtosIdleStat.totWakeJitter += jitter;
+        if(jitter < rtosIdleStat.minWakeJitter)
+        {
+            rtosIdleStat.minWakeJitter = jitter;
+        }
+        if(jitter > rtosIdleStat.maxWakeJitter)
+        {
+            rtosIdleStat.maxWakeJitter = jitter;
+        }
+    }
+    else
+    {   // woken up by some other interrupt
+        nTicks = 0;
+        if((int32_t)(count - rtosNextTickCompare) >= 0)
+        {
+            nTicks = (count - rtosNextTickCompare) / RTOS_IDLE_CYCLES_PER_TICK + 1;
+        }
+        rtosNextTickCompare += nTicks * RTOS_IDLE_CYCLES_PER_TICK;
+        _RTOS_IDLE_CompareSet(rtosNextTickCompare);
+        SYS_INT_SourceStatusClear(INT_SOURCE_TIMER_CORE);
+    }
+
+    if((count - startCount) / RTOS_IDLE_CYCLES_PER_TICK > rtosIdleStat.maxSleepTicks)
+    {
+        rtosIdleStat.maxSleepTicks = (count - startCount) / RTOS_IDLE_CYCLES_PER_TICK;
+    }
+
+    vTaskStepTick(nTicks);
+    SYS_INT_Restore(intState);
+}
+#endif  // (configUSE_TICKLESS_IDLE != 0)
+
+void RTOS_IDLE_Initialize(void)
+{
+    _RTOS_IDLE_StatClear();
+
+#if defined(SYS_CMD_ENABLE)
+    SYS_CMD_ADDGRP(rtosIdleCmdTbl, sizeof(rtosIdleCmdTbl)/sizeof(*rtosIdleCmdTbl), "idle", ": idle commands");
+#endif  // defined(SYS_CMD_ENABLE)
+}
+
+bool RTOS_IDLE_StatisticsGet(RTOS_IDLE_STATISTICS* pStat, bool clear)
+{
+    // the statistics are updated by the idle task, with interrupts disabled
+    bool intState = SYS_INT_Disable();
+
+    if(pStat)
+    {
+        *pStat = rtosIdleStat;
+        pStat->totCycles = (uint64_t)(xTaskGetTickCount() - rtosIdleStatTick) * RTOS_IDLE_CYCLES_PER_TICK;
+        pStat->cyclesFreq = RTOS_IDLE_CYCLES_FREQ;
+    }
+    if(clear)
+    {
+        _RTOS_IDLE_StatClear();
+    }
+
+    SYS_INT_Restore(intState);
+    return true;
+}
+
+#if defined(SYS_CMD_ENABLE)
+static uint32_t _RTOS_IDLE_CyclesToNs(uint64_t cycles, uint32_t cyclesFreq)
+{
+    return (uint32_t)((cycles * 1000000000ull) / cyclesFreq);
+}
+
+static int _CommandIdle(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    // idle <reset>
+    const void* cmdIoParam = pCmdIO->cmdIoParam;
+    bool doReset = argc > 1 && strcmp(argv[1], "reset") == 0;
+    RTOS_IDLE_STATISTICS idleStat;
+    uint32_t residency;
+
+    if(argc > 1 && !doReset)
+    {
+        (*pCmdIO->pCmdApi->msg)(cmdIoParam, "Usage: idle <reset>\r\n");
+        return false;
+    }
+
+    RTOS_IDLE_StatisticsGet(&idleStat, doReset);
+    if(doReset)
+    {
+        (*pCmdIO->pCmdApi->msg)(cmdIoParam, "idle: statistics reset\r\n");
+        return true;
+    }
+
+    // per mille
+    residency = idleStat.totCycles != 0 ? (uint32_t)((idleStat.idleCycles * 1000) / idleStat.totCycles) : 0;
+    (*pCmdIO->pCmdApi->print)(cmdIoParam, "idle: residency %lu.%lu%% over %lu ms\r\n", residency / 10, residency % 10,
+            (uint32_t)(idleStat.totCycles / (idleStat.cyclesFreq / 1000)));
+    (*pCmdIO->pCmdApi->print)(cmdIoParam, "waits %lu, sleeps %lu, aborted %lu, timer wakes %lu, max sleep %lu ticks\r\n",
+            idleStat.nWaits, idleStat.nSleeps, idleStat.nAborted, idleStat.nTimerWakes, idleStat.maxSleepTicks);
+    if(idleStat.nTimerWakes != 0)
+    {
+        (*pCmdIO->pCmdApi->print)(cmdIoParam, "wake up jitter: min %lu, avg %lu, max %lu ns\r\n",
+                _RTOS_IDLE_CyclesToNs(idleStat.minWakeJitter, idleStat.cyclesFreq),
+                _RTOS_IDLE_CyclesToNs(idleStat.totWakeJitter / idleStat.nTimerWakes, idleStat.cyclesFreq),
+                _RTOS_IDLE_CyclesToNs(idleStat.maxWakeJitter, idleStat.cyclesFreq));
+    }
+
+    return true;
+}
+#endif  // defined(SYS_CMD_ENABLE)
+
+
+/*******************************************************************************
+ End of File
+*/
@@ -199,6 +199,15 @@ extern "C" {
 #define SYS_TMR_UNIT_RESOLUTION         10000
 #define SYS_TMR_CLIENT_TOLERANCE        10
 #define SYS_TMR_INTERRUPT_NOTIFICATION  false
+#define SYS_TMR_CLIENT_HEAP             true
+#define SYS_TMR_ALARM_STATISTICS_ENABLE false
+#define SYS_TMR_TICKLESS                true
+
+/*** System Tasks Configuration ***/
+/* longest sleep of the system task between two SYS_TMR alarms;
+ * the console and the MIIM driver are polled at least this often,
+ * so a console command can wait up to this long to be read */
+#define SYS_TASKS_MAX_SLEEP_MS          20
 
 // *****************************************************************************
 // *****************************************************************************
@@ -241,6 +250,8 @@ extern "C" {
 #define DRV_SPI_INSTANCES_NUMBER 		2
 #define DRV_SPI_CLIENTS_NUMBER 			4
 #define DRV_SPI_ELEMENTS_PER_QUEUE 		10
+#define DRV_SPI_SYS_QUEUE_SPSC 			true
+#define DRV_SPI_SETUP_STATISTICS_ENABLE true
 /*** SPI Driver DMA Options ***/
 #define DRV_SPI_DMA_TXFER_SIZE 			512
 #define DRV_SPI_DMA_DUMMY_BUFFER_SIZE 	512
@@ -500,6 +511,8 @@ extern "C" {
 #define TCPIP_STACK_ALIAS_INTERFACE_SUPPORT   false
 
 #define TCPIP_PACKET_LOG_ENABLE     0
+#define TCPIP_PACKET_RECORDER_ENABLE    1
+#define TCPIP_PKT_RECORDER_SIZE         256
 
 /* TCP/IP stack event notification */
 #define TCPIP_STACK_USE_EVENT_NOTIFICATION
@@ -529,6 +542,20 @@ extern "C" {
 
 #define TCPIP_STACK_SUPPORTED_HEAPS                  1
 
+/* fixed block pool heap; create it with tcpipHeapPoolConfig to compare
+   against the external heap. Nothing creates it on this board: the network
+   runs on FreeRTOS+TCP and the Harmony stack is not initialized */
+#define TCPIP_STACK_USE_INTERNAL_HEAP_POOL
+#define TCPIP_STACK_POOL_EXPANSION_SIZE              4096
+
+/* heap profiler: latency, per module peak and size distribution;
+   "heapprof" console command. It profiles the heaps made by TCPIP_HEAP_Create;
+   the network runs on FreeRTOS+TCP here, the Harmony stack is not initialized,
+   so there is nothing to profile and the command is not registered */
+#define TCPIP_STACK_HEAP_PROFILE_ENABLE
+#define TCPIP_STACK_HEAP_PROFILE_SLOTS               256
+#define TCPIP_STACK_HEAP_PROFILE_MODULES             16
+
 /*** ARP Configuration ***/
 #define TCPIP_ARP_CACHE_ENTRIES                 		5
 #define TCPIP_ARP_CACHE_DELETE_OLD		        	true
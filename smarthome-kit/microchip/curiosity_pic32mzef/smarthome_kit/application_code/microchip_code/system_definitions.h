@@ -126,6 +126,40 @@ typedef struct
 
 extern SYSTEM_OBJECTS sysObj;
 
+#if defined(TCPIP_STACK_USE_INTERNAL_HEAP_POOL)
+extern const TCPIP_STACK_HEAP_POOL_CONFIG tcpipHeapPoolConfig;
+#endif
+
+// *****************************************************************************
+/* RTOS Idle Statistics
+
+  Summary:
+    Time spent by the CPU waiting in the idle task.
+
+  Description:
+    Collected by rtos_idle.c: the idle hook waits and the tickless sleeps.
+    The cycles are core timer cycles, counting at cyclesFreq Hz.
+*/
+
+typedef struct
+{
+    uint32_t    nWaits;         // idle hook waits for the next interrupt
+    uint32_t    nSleeps;        // tickless sleeps
+    uint32_t    nAborted;       // tickless sleeps not started: a task was ready
+    uint32_t    nTimerWakes;    // tickless sleeps ended by the core timer
+    uint32_t    maxSleepTicks;  // longest tickless sleep, RTOS ticks
+    uint32_t    minWakeJitter;  // core timer wake up latency after the compare match, cycles
+    uint32_t    maxWakeJitter;
+    uint64_t    totWakeJitter;  // over nTimerWakes
+    uint64_t    idleCycles;     // cycles spent waiting
+    uint64_t    totCycles;      // cycles since the statistics were cleared
+    uint32_t    cyclesFreq;     // core timer frequency
+}RTOS_IDLE_STATISTICS;
+
+void RTOS_IDLE_Initialize(void);
+
+bool RTOS_IDLE_StatisticsGet(RTOS_IDLE_STATISTICS* pStat, bool clear);
+
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
 }
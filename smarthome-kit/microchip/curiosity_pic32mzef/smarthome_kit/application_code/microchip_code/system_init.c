@@ -48,6 +48,7 @@ SOFTWARE
 #include "../../../../../home_automation/aws_home_automation_demo.h"
 #include "system_config.h"
 #include "system_definitions.h"
+#include "tcpip/src/tcpip_packet.h"
 
 extern void HVAC_Initialize ( void );
 extern void LOGGER_Initialize ( void );
@@ -417,6 +418,34 @@ const TCPIP_NETWORK_CONFIG __attribute__((unused))  TCPIP_HOSTS_CONFIGURATION[]
     },
 };
 
+/*** TCPIP Pool Heap Configuration ***/
+#if defined(TCPIP_STACK_USE_INTERNAL_HEAP_POOL)
+// size classes: small control blocks, packet segments and full Wi-Fi frames
+static TCPIP_STACK_HEAP_POOL_ENTRY tcpipHeapPoolEntryTbl[] =
+{
+    { .entrySize = 32,   .nBlocks = 16, .nExpBlks = 8 },
+    { .entrySize = 64,   .nBlocks = 16, .nExpBlks = 8 },
+    { .entrySize = 128,  .nBlocks = 16, .nExpBlks = 4 },
+    { .entrySize = 256,  .nBlocks = 8,  .nExpBlks = 4 },
+    { .entrySize = 512,  .nBlocks = 8,  .nExpBlks = 2 },
+    { .entrySize = 1024, .nBlocks = 4,  .nExpBlks = 1 },
+    { .entrySize = 1792, .nBlocks = 10, .nExpBlks = 1 },
+};
+
+const TCPIP_STACK_HEAP_POOL_CONFIG tcpipHeapPoolConfig =
+{
+    .heapType = TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_POOL,
+    .heapFlags = TCPIP_STACK_HEAP_USE_FLAGS,
+    .heapUsage = TCPIP_STACK_HEAP_USAGE_CONFIG,
+    .malloc_fnc = TCPIP_STACK_MALLOC_FUNC,
+    .calloc_fnc = TCPIP_STACK_CALLOC_FUNC,
+    .free_fnc = TCPIP_STACK_FREE_FUNC,
+    .nPoolEntries = sizeof(tcpipHeapPoolEntryTbl) / sizeof(*tcpipHeapPoolEntryTbl),
+    .pEntries = tcpipHeapPoolEntryTbl,
+    .expansionHeapSize = TCPIP_STACK_POOL_EXPANSION_SIZE,
+};
+#endif  // defined(TCPIP_STACK_USE_INTERNAL_HEAP_POOL)
+
 
 #if 0
 
@@ -591,6 +620,12 @@ void SYS_Initialize ( void* data )
 
     /*** Command Service Initialization Code ***/
     SYS_CMD_Initialize((SYS_MODULE_INIT*)&sysCmdInit);
+    /*** RTOS Idle Statistics and Commands ***/
+    RTOS_IDLE_Initialize();
+#if (TCPIP_PACKET_RECORDER_ENABLE)
+    /*** Packet Recorder Commands, the TCP/IP stack is not initialized ***/
+    TCPIP_PKT_RecorderInitialize();
+#endif
     sysObj.sysConsole0 = SYS_CONSOLE_Initialize(SYS_CONSOLE_INDEX_0, (SYS_MODULE_INIT *)&consUsartInit0);
 
 
@@ -113,7 +113,22 @@ static void _SYS_Tasks ( void)
         SYS_CMD_READY_TO_READ();
 
         /* Task Delay */
+#if (configUSE_TICKLESS_IDLE != 0)
+        /* Sleep until the next SYS_TMR alarm instead of waking up every
+         * tick, so that the idle task can suppress the RTOS tick */
+        uint32_t waitMs = SYS_TMR_NextAlarmMsGet();
+        if(waitMs > SYS_TASKS_MAX_SLEEP_MS)
+        {
+            waitMs = SYS_TASKS_MAX_SLEEP_MS;
+        }
+        else if(waitMs == 0)
+        {
+            waitMs = 1;
+        }
+        vTaskDelay(waitMs / portTICK_PERIOD_MS);
+#else
         vTaskDelay(1 / portTICK_PERIOD_MS);
+#endif  // (configUSE_TICKLESS_IDLE != 0)
     }
 }
 
@@ -48,7 +48,7 @@
 
 #define configUSE_PREEMPTION                       1
 #define configUSE_PORT_OPTIMISED_TASK_SELECTION    1
-#define configUSE_TICKLESS_IDLE                    0
+#define configUSE_TICKLESS_IDLE                    2
 #define configCPU_CLOCK_HZ                         ( 200000000UL )
 #define configPERIPHERAL_CLOCK_HZ                  ( 100000000UL )
 #define configTICK_RATE_HZ                         ( ( TickType_t ) 1000 )
@@ -74,11 +74,16 @@
 #define configUSE_POSIX_ERRNO                      1
 
 /* Hook function related definitions. */
-#define configUSE_IDLE_HOOK                        0
+#define configUSE_IDLE_HOOK                        1
 #define configUSE_TICK_HOOK                        0
 #define configCHECK_FOR_STACK_OVERFLOW             2
 #define configUSE_MALLOC_FAILED_HOOK               1
 
+/* The RTOS tick is generated by the core timer (rtos_idle.c) so that it keeps
+ * running while the CPU waits in the idle task and can be suppressed by the
+ * tickless idle: configUSE_TICKLESS_IDLE 2 uses the application vApplicationSleep(). */
+#define configTICK_INTERRUPT_VECTOR                _CORE_TIMER_VECTOR
+
 /* Run time and task stats gathering related definitions. */
 #define configGENERATE_RUN_TIME_STATS              0
 #define configUSE_TRACE_FACILITY                   1
@@ -157,6 +162,12 @@
  * and a time stamp. */
     #define configLOGGING_INCLUDE_TIME_AND_TASK_NAME    1
 
+/* Core timer RTOS tick and tickless idle, see rtos_idle.c. */
+    extern void vApplicationClearTickInterrupt( void );
+    extern void vApplicationSleep( uint32_t xExpectedIdleTime );
+    #define configCLEAR_TICK_TIMER_INTERRUPT()      vApplicationClearTickInterrupt()
+    #define portSUPPRESS_TICKS_AND_SLEEP( x )       vApplicationSleep( x )
+
 #endif /* defined(__LANGUAGE_C__) */
 
 /* Application specific definitions follow. **********************************/
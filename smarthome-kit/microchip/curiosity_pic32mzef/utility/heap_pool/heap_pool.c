@@ -0,0 +1,810 @@
+/*******************************************************************************
+  TCP/IP Pool Heap Host Test
+
+  File Name:
+    heap_pool.c
+
+  Summary:
+    Checks the fixed block pool heap, its lock-free lists and expansion.
+
+  Description:
+    The pool heap source is built on the host, with the board pool
+    configuration (tcpipHeapPoolConfig, system_init.c). It runs as on a
+    single core: a higher priority task can preempt the heap calls at each
+    atomic operation, the compare-and-swap of a push, of the expansion bump
+    pointer and of the free block mark, and the free block counter updates.
+    _TestPreempt runs another heap call there, unless a critical section is
+    taken, which stands for the interrupts disabled.
+
+    The test runs:
+        - creation errors, entry sorting, size errors, expansion of an
+          entry until the expansion area is used up, the fallback to the
+          larger entries and the strict pool, free of a block twice or
+          of a pointer not from the pool, calloc, delete while in use
+        - TEST_OPERATIONS random allocations and frees with a preemption
+          after 1 of TEST_PREEMPT_RATE atomic operations. After each call
+          the free lists have to hold nFree valid, distinct blocks that are
+          not allocated, the allocated blocks must not overlap, and the
+          expansion, the low water marks and the allocation failures have
+          to match the reference model.
+        - the MIPS ll/sc pop. The assembly does not run on the host: a
+          model of the same instruction sequence pops from a list while
+          the preemptions push and pop with the pool functions, and the
+          model loses the link on a preemption, as the exception return
+          does. A preemption popping A and B and pushing A back between
+          the load of A->next and the sc must not put B back on the list;
+          the same sequence with a compare-and-swap instead of the sc
+          does, which shows that the test catches the ABA problem. Then
+          random pops and pushes have to keep every block either on the
+          list or held once.
+
+    Build and run, from this directory:
+        gcc -O2 -I. -I../../../harmony/v2.05/framework -o heap_pool heap_pool.c
+        ./heap_pool
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// host build configuration
+#define TCPIP_STACK_USE_INTERNAL_HEAP_POOL
+#define TCPIP_STACK_POOL_EXPANSION_SIZE     4096
+
+// replace the Harmony headers included by the pool heap
+#define __TCPIP_STACK_PRIVATE_H__
+// 16 bytes block alignment, as on the board
+#define __PIC32MZ__
+
+#include "tcpip/tcpip_heap.h"
+#include "tcpip/src/tcpip_heap_alloc.h"
+
+#define TEST_OPERATIONS         200000
+#define TEST_PREEMPT_RATE       4           // preempt 1 of this many atomic operations
+#define TEST_PREEMPT_DEPTH      2           // nested preemptions
+#define TEST_MAX_LIVE           256
+#define TEST_MAX_ENTRIES        8
+#define TEST_LLSC_BLOCKS        32
+#define TEST_LLSC_OPERATIONS    100000
+
+// OSAL
+typedef int     OSAL_CRITSECT_DATA_TYPE;
+typedef enum
+{
+    OSAL_CRIT_TYPE_LOW,
+    OSAL_CRIT_TYPE_HIGH,
+}OSAL_CRIT_TYPE;
+
+static int      testCritDepth;
+
+static OSAL_CRITSECT_DATA_TYPE OSAL_CRIT_Enter(OSAL_CRIT_TYPE severity)
+{
+    return testCritDepth++;
+}
+
+static void OSAL_CRIT_Leave(OSAL_CRIT_TYPE severity, OSAL_CRITSECT_DATA_TYPE status)
+{
+    if(--testCritDepth != status)
+    {
+        printf("FAIL unbalanced critical section\n");
+        exit(1);
+    }
+}
+
+// the pool storage is used as is on the host
+const void* _TCPIP_HEAP_BufferMapNonCached(const void* buffer, size_t buffSize)
+{
+    return buffer;
+}
+
+// every atomic operation of the pool is a point where a higher priority task can run
+static void     _TestPreempt(void);
+static bool     _TestCasDone(bool swapped);
+static uint32_t _TestFreeMark(volatile uint32_t* pFree, uint32_t nFree);
+
+#define __sync_bool_compare_and_swap(p, o, n)   _TestCasDone((_TestPreempt(), __sync_bool_compare_and_swap(p, o, n)))
+#define __sync_fetch_and_add(p, v)              (_TestPreempt(), __sync_fetch_and_add(p, v))
+#define __sync_sub_and_fetch(p, v)              _TestFreeMark(p, (_TestPreempt(), __sync_sub_and_fetch(p, v)))
+
+#include "tcpip/src/tcpip_heap_pool.c"
+
+typedef struct
+{
+    uint8_t*    ptr;
+    uint32_t    nBytes;
+    uint8_t     tag;
+}TEST_BLOCK;
+
+// board pool configuration, system_init.c, in a different order
+static TCPIP_STACK_HEAP_POOL_ENTRY testEntryTbl[] =
+{
+    { .entrySize = 256,  .nBlocks = 8,  .nExpBlks = 4 },
+    { .entrySize = 1792, .nBlocks = 10, .nExpBlks = 1 },
+    { .entrySize = 32,   .nBlocks = 16, .nExpBlks = 8 },
+    { .entrySize = 512,  .nBlocks = 8,  .nExpBlks = 2 },
+    { .entrySize = 64,   .nBlocks = 16, .nExpBlks = 8 },
+    { .entrySize = 1024, .nBlocks = 4,  .nExpBlks = 1 },
+    { .entrySize = 128,  .nBlocks = 16, .nExpBlks = 4 },
+};
+
+static TCPIP_STACK_HEAP_POOL_CONFIG testConfig =
+{
+    .heapType = TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_POOL,
+    .heapFlags = TCPIP_STACK_HEAP_FLAG_ALLOC_UNCACHED,
+    .heapUsage = TCPIP_STACK_HEAP_USE_DEFAULT,
+    .malloc_fnc = malloc,
+    .calloc_fnc = calloc,
+    .free_fnc = free,
+    .nPoolEntries = sizeof(testEntryTbl) / sizeof(*testEntryTbl),
+    .pEntries = testEntryTbl,
+    .expansionHeapSize = TCPIP_STACK_POOL_EXPANSION_SIZE,
+};
+
+static void         (*testPreemptFn)(void);     // what a preemption runs
+static int          testPreemptDepth;
+static uint32_t     testPreempts;
+static uint32_t     testCasRetries;
+static int          testForceAt = -1;           // preempt only at this point from now, -1 at random
+
+// pool heap under test and its reference model
+static TCPIP_STACK_HEAP_HANDLE  testHeap;
+static TCPIP_HEAP_POOL_DCPT*    testDcpt;
+static TEST_BLOCK   testLive[TEST_MAX_LIVE];
+static int          testNLive;
+static uint8_t      testTag;
+static uint32_t     modelMinFree[TEST_MAX_ENTRIES];
+static uint32_t     modelFails[TEST_MAX_ENTRIES];
+static uint32_t     modelCfgBlocks[TEST_MAX_ENTRIES];
+static uint32_t     testFallbacks;
+static uint8_t*     testSeen;                   // blocks found on the free lists
+
+// ll/sc model
+static volatile int testLlBit;
+static _poolHead    testLlBlocks[TEST_LLSC_BLOCKS];
+static _poolHead* volatile testLlHead;
+static int          testLlHeld[TEST_LLSC_BLOCKS];  // 0 on the list, 1 held by the task, 2 by the preemption
+
+static uint32_t _TestRand(void)
+{
+    static uint32_t seed = 0x2545f491;
+
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+static void _TestFail(const char* what, long val, long expected)
+{
+    printf("FAIL %s %ld, expected %ld\n", what, val, expected);
+    exit(1);
+}
+
+static void _TestPreempt(void)
+{
+    if(testCritDepth != 0 || testPreemptFn == 0 || testPreemptDepth >= TEST_PREEMPT_DEPTH)
+    {   // interrupts disabled or nothing to run
+        return;
+    }
+
+    if(testForceAt >= 0)
+    {   // scripted
+        if(testForceAt-- != 0)
+        {
+            return;
+        }
+    }
+    else if(_TestRand() % TEST_PREEMPT_RATE != 0)
+    {
+        return;
+    }
+
+    // the exception return clears the link bit
+    testLlBit = 0;
+    testPreempts++;
+    testPreemptDepth++;
+    (*testPreemptFn)();
+    testPreemptDepth--;
+}
+
+static bool _TestCasDone(bool swapped)
+{
+    if(!swapped)
+    {
+        testCasRetries++;
+    }
+    return swapped;
+}
+
+// the free counter is decremented only by an allocation; the lowest value it reaches
+static uint32_t _TestFreeMark(volatile uint32_t* pFree, uint32_t nFree)
+{
+    int eIx = (TCPIP_HEAP_POOL_ENTRY_DCPT*)((uint8_t*)pFree - offsetof(TCPIP_HEAP_POOL_ENTRY_DCPT, nFree)) - testDcpt->entryTbl;
+
+    if(nFree < modelMinFree[eIx])
+    {
+        modelMinFree[eIx] = nFree;
+    }
+    return nFree;
+}
+
+static TCPIP_STACK_HEAP_HANDLE _TestCreate(TCPIP_STACK_HEAP_FLAGS flags)
+{
+    TCPIP_STACK_HEAP_RES res;
+    TCPIP_STACK_HEAP_HANDLE heapH;
+    int eIx;
+
+    testConfig.heapFlags = flags;
+    heapH = TCPIP_HEAP_CreateInternalPool(&testConfig, &res);
+    if(heapH == 0 || res != TCPIP_STACK_HEAP_RES_OK)
+    {
+        _TestFail("create result", res, TCPIP_STACK_HEAP_RES_OK);
+    }
+
+    testHeap = heapH;
+    testDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+    for(eIx = 0; eIx < testDcpt->nEntries; eIx++)
+    {
+        modelMinFree[eIx] = modelCfgBlocks[eIx] = testDcpt->entryTbl[eIx].nBlocks;
+        modelFails[eIx] = 0;
+    }
+    free(testSeen);
+    testSeen = calloc(testDcpt->heapSize / sizeof(_poolHead), 1);
+    testNLive = 0;
+
+    return heapH;
+}
+
+static int _TestEntryIx(const void* ptr)
+{
+    return ((const _poolHead*)ptr - 1)->pEntry - testDcpt->entryTbl;
+}
+
+// allocates a block and keeps it in the model; used by the preemptions too
+static uint8_t* _TestAlloc(uint32_t nBytes, bool zero)
+{
+    TCPIP_HEAP_OBJECT* pObj = (TCPIP_HEAP_OBJECT*)testHeap;
+    TCPIP_HEAP_POOL_ENTRY_DCPT* pMatch = _TCPIP_HEAP_POOL_EntryFind(testDcpt, nBytes);
+    uint8_t* ptr;
+    uint32_t ix;
+
+    ptr = zero ? (*pObj->TCPIP_HEAP_Calloc)(testHeap, 1, nBytes) : (*pObj->TCPIP_HEAP_Malloc)(testHeap, nBytes);
+
+    if(pMatch != 0 && (ptr == 0 || _TestEntryIx(ptr) != pMatch - testDcpt->entryTbl))
+    {   // the matching entry was empty and could not expand
+        modelFails[pMatch - testDcpt->entryTbl]++;
+        if(ptr != 0)
+        {
+            testFallbacks++;
+        }
+    }
+
+    if(ptr == 0)
+    {
+        return 0;
+    }
+
+    if(((uintptr_t)ptr & (sizeof(_poolHead) - 1)) != 0 || ptr < testDcpt->heapStart ||
+       ptr >= testDcpt->heapStart + testDcpt->heapSize)
+    {
+        _TestFail("block outside the pool at offset", (long)(ptr - testDcpt->heapStart), 0);
+    }
+    if(testDcpt->entryTbl[_TestEntryIx(ptr)].entrySize < nBytes)
+    {
+        _TestFail("block size", testDcpt->entryTbl[_TestEntryIx(ptr)].entrySize, nBytes);
+    }
+    if(zero)
+    {
+        for(ix = 0; ix < nBytes; ix++)
+        {
+            if(ptr[ix] != 0)
+            {
+                _TestFail("calloc byte", ptr[ix], 0);
+            }
+        }
+    }
+
+    if(testNLive == TEST_MAX_LIVE)
+    {
+        _TestFail("live blocks", testNLive, TEST_MAX_LIVE - 1);
+    }
+
+    // a block handed out twice gets its tag overwritten
+    testTag++;
+    memset(ptr, testTag, nBytes);
+    testLive[testNLive].ptr = ptr;
+    testLive[testNLive].nBytes = nBytes;
+    testLive[testNLive].tag = testTag;
+    testNLive++;
+
+    return ptr;
+}
+
+static void _TestFree(int lIx)
+{
+    TCPIP_HEAP_OBJECT* pObj = (TCPIP_HEAP_OBJECT*)testHeap;
+    TEST_BLOCK blk = testLive[lIx];
+    size_t entrySize = testDcpt->entryTbl[_TestEntryIx(blk.ptr)].entrySize;
+    uint32_t ix;
+
+    testLive[lIx] = testLive[--testNLive];
+    for(ix = 0; ix < blk.nBytes; ix++)
+    {
+        if(blk.ptr[ix] != blk.tag)
+        {
+            _TestFail("block overwritten at byte", ix, blk.nBytes);
+        }
+    }
+
+    if((*pObj->TCPIP_HEAP_Free)(testHeap, blk.ptr) != entrySize)
+    {
+        _TestFail("free size", 0, entrySize);
+    }
+}
+
+// requests mostly small, some up to the largest entry
+static uint32_t _TestSize(void)
+{
+    return 1 + _TestRand() % ((_TestRand() % 4 == 0) ? 1792 : 200);
+}
+
+static void _TestPoolPreemption(void)
+{
+    if(testNLive != 0 && _TestRand() % 2 == 0)
+    {
+        _TestFree(_TestRand() % testNLive);
+    }
+    else if(testNLive < TEST_MAX_LIVE)
+    {
+        _TestAlloc(_TestSize(), _TestRand() % 4 == 0);
+    }
+}
+
+// checks the pool against the model when no call is running
+static void _TestCheckPool(const char* when)
+{
+    uint32_t expUsed = 0;
+    uint32_t entryLive[TEST_MAX_ENTRIES] = {0};
+    char what[80];
+    int eIx, lIx;
+
+    memset(testSeen, 0, testDcpt->heapSize / sizeof(_poolHead));
+    for(lIx = 0; lIx < testNLive; lIx++)
+    {
+        entryLive[_TestEntryIx(testLive[lIx].ptr)]++;
+        testSeen[((uint8_t*)testLive[lIx].ptr - testDcpt->heapStart) / sizeof(_poolHead) - 1] = 1;
+    }
+
+    for(eIx = 0; eIx < testDcpt->nEntries; eIx++)
+    {
+        TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry = testDcpt->entryTbl + eIx;
+        uint32_t nList = 0;
+        _poolHead* pBlk;
+
+        for(pBlk = pEntry->freeHead; pBlk != 0; pBlk = pBlk->next)
+        {
+            uint8_t* p = (uint8_t*)pBlk;
+            size_t hIx = (p - testDcpt->heapStart) / sizeof(_poolHead);
+
+            if(p < testDcpt->heapStart || p >= testDcpt->heapStart + testDcpt->heapSize ||
+               ((uintptr_t)p & (sizeof(_poolHead) - 1)) != 0 || pBlk->pEntry != pEntry || pBlk->allocMark != 0)
+            {
+                sprintf(what, "%s: entry %d invalid free block at offset", when, eIx);
+                _TestFail(what, (long)(p - testDcpt->heapStart), 0);
+            }
+            if(testSeen[hIx])
+            {
+                sprintf(what, "%s: entry %d free block listed twice or allocated, offset", when, eIx);
+                _TestFail(what, (long)(p - testDcpt->heapStart), 0);
+            }
+            testSeen[hIx] = 1;
+            nList++;
+        }
+
+        sprintf(what, "%s: entry %d", when, eIx);
+        if(nList != pEntry->nFree)
+        {
+            _TestFail(strcat(what, " free list length"), nList, pEntry->nFree);
+        }
+        if(pEntry->nFree + entryLive[eIx] != pEntry->nBlocks)
+        {
+            _TestFail(strcat(what, " free and allocated blocks"), pEntry->nFree + entryLive[eIx], pEntry->nBlocks);
+        }
+        if((pEntry->nBlocks - modelCfgBlocks[eIx]) % pEntry->nExpBlks != 0)
+        {
+            _TestFail(strcat(what, " blocks"), pEntry->nBlocks, modelCfgBlocks[eIx]);
+        }
+        if(pEntry->minFree != modelMinFree[eIx])
+        {
+            _TestFail(strcat(what, " low water mark"), pEntry->minFree, modelMinFree[eIx]);
+        }
+        if(pEntry->allocFails != modelFails[eIx])
+        {
+            _TestFail(strcat(what, " allocation failures"), pEntry->allocFails, modelFails[eIx]);
+        }
+        expUsed += (pEntry->nBlocks - modelCfgBlocks[eIx]) * pEntry->blkSize;
+    }
+
+    if(testDcpt->expUsed != expUsed || expUsed > testDcpt->expSize)
+    {
+        sprintf(what, "%s: expansion used", when);
+        _TestFail(what, testDcpt->expUsed, expUsed);
+    }
+}
+
+static void _TestFunctional(void)
+{
+    TCPIP_STACK_HEAP_POOL_ENTRY badTbl[2] = { { .entrySize = 64, .nBlocks = 1 }, { .entrySize = 64, .nBlocks = 1 } };
+    TCPIP_STACK_HEAP_POOL_CONFIG badConfig = testConfig;
+    static _poolHead foreign[2];
+    TCPIP_STACK_HEAP_RES res;
+    TCPIP_HEAP_POOL_ENTRY_LIST entryList;
+    TCPIP_HEAP_OBJECT* pObj;
+    TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry0;
+    uint8_t* ptr;
+    int eIx, n;
+
+    // creation errors
+    if(TCPIP_HEAP_CreateInternalPool(0, &res) != 0 || res != TCPIP_STACK_HEAP_RES_INIT_ERR)
+    {
+        _TestFail("create without configuration", res, TCPIP_STACK_HEAP_RES_INIT_ERR);
+    }
+    badConfig.pEntries = badTbl;
+    badConfig.nPoolEntries = 2;
+    if(TCPIP_HEAP_CreateInternalPool(&badConfig, &res) != 0 || res != TCPIP_STACK_HEAP_RES_INIT_ERR)
+    {
+        _TestFail("create with duplicate entries", res, TCPIP_STACK_HEAP_RES_INIT_ERR);
+    }
+    badTbl[1].entrySize = 0;
+    if(TCPIP_HEAP_CreateInternalPool(&badConfig, &res) != 0 || res != TCPIP_STACK_HEAP_RES_INIT_ERR)
+    {
+        _TestFail("create with a 0 size entry", res, TCPIP_STACK_HEAP_RES_INIT_ERR);
+    }
+
+    _TestCreate(TCPIP_STACK_HEAP_FLAG_ALLOC_UNCACHED);
+    pObj = (TCPIP_HEAP_OBJECT*)testHeap;
+    pEntry0 = testDcpt->entryTbl;
+
+    // sorted entries
+    if(TCPIP_HEAP_POOL_Entries(testHeap) != sizeof(testEntryTbl) / sizeof(*testEntryTbl))
+    {
+        _TestFail("entries", TCPIP_HEAP_POOL_Entries(testHeap), sizeof(testEntryTbl) / sizeof(*testEntryTbl));
+    }
+    for(eIx = 1; TCPIP_HEAP_POOL_EntryList(testHeap, eIx, &entryList); eIx++)
+    {
+        if(entryList.blockSize <= testDcpt->entryTbl[eIx - 1].entrySize || entryList.freeBlocks != entryList.nBlocks)
+        {
+            _TestFail("entry size order", entryList.blockSize, testDcpt->entryTbl[eIx - 1].entrySize);
+        }
+    }
+    if((*pObj->TCPIP_HEAP_MaxSize)(testHeap) != 1792)
+    {
+        _TestFail("max size", (*pObj->TCPIP_HEAP_MaxSize)(testHeap), 1792);
+    }
+    _TestCheckPool("created");
+
+    // size errors
+    if((*pObj->TCPIP_HEAP_Malloc)(testHeap, 0) != 0 || _TestAlloc(1793, false) != 0 ||
+       (*pObj->TCPIP_HEAP_LastError)(testHeap) != TCPIP_STACK_HEAP_RES_SIZE_ERR ||
+       (*pObj->TCPIP_HEAP_LastError)(testHeap) != TCPIP_STACK_HEAP_RES_OK)
+    {
+        _TestFail("size error", 0, TCPIP_STACK_HEAP_RES_SIZE_ERR);
+    }
+
+    // the 32 bytes entry, then its expansions until the area is used up
+    for(n = 0; n < pEntry0->nBlocks; n++)
+    {
+        _TestAlloc(32, false);
+    }
+    if(pEntry0->nFree != 0 || testDcpt->expUsed != 0)
+    {
+        _TestFail("blocks expanded early", testDcpt->expUsed, 0);
+    }
+    n = 0;
+    while(testDcpt->expUsed + pEntry0->nExpBlks * pEntry0->blkSize <= testDcpt->expSize)
+    {
+        _TestAlloc(32, false);
+        n++;
+    }
+    _TestCheckPool("expanded");
+    if(pEntry0->nBlocks != modelCfgBlocks[0] + n + pEntry0->nFree || pEntry0->allocFails != 0)
+    {
+        _TestFail("expanded blocks", pEntry0->nBlocks, modelCfgBlocks[0] + n + pEntry0->nFree);
+    }
+    while(pEntry0->nFree != 0)
+    {
+        _TestAlloc(32, false);
+    }
+
+    // no expansion left, the 64 bytes entry
+    ptr = _TestAlloc(32, false);
+    if(ptr == 0 || _TestEntryIx(ptr) != 1 || pEntry0->allocFails != 1 || pEntry0->minFree != 0)
+    {
+        _TestFail("fallback entry", ptr ? _TestEntryIx(ptr) : -1, 1);
+    }
+    _TestCheckPool("fallback");
+
+    // frees
+    _TestFree(testNLive - 1);
+    if((*pObj->TCPIP_HEAP_Free)(testHeap, ptr) != 0 || (*pObj->TCPIP_HEAP_LastError)(testHeap) != TCPIP_STACK_HEAP_RES_PTR_ERR)
+    {
+        _TestFail("double free", 0, TCPIP_STACK_HEAP_RES_PTR_ERR);
+    }
+    if((*pObj->TCPIP_HEAP_Free)(testHeap, testLive[0].ptr + 1) != 0 ||
+       (*pObj->TCPIP_HEAP_Free)(testHeap, foreign + 1) != 0 ||
+       (*pObj->TCPIP_HEAP_LastError)(testHeap) != TCPIP_STACK_HEAP_RES_PTR_ERR)
+    {
+        _TestFail("free of a pointer not from the pool", 0, TCPIP_STACK_HEAP_RES_PTR_ERR);
+    }
+    _TestCheckPool("bad frees");
+
+    // calloc gets the last freed block, zeroed
+    ptr = _TestAlloc(100, false);
+    _TestFree(testNLive - 1);
+    if(_TestAlloc(100, true) != ptr)
+    {
+        _TestFail("calloc block", 0, 0);
+    }
+
+    if((*pObj->TCPIP_HEAP_Delete)(testHeap) != TCPIP_STACK_HEAP_RES_IN_USE)
+    {
+        _TestFail("delete in use", 0, TCPIP_STACK_HEAP_RES_IN_USE);
+    }
+    while(testNLive)
+    {
+        _TestFree(testNLive - 1);
+    }
+    _TestCheckPool("freed");
+    if((*pObj->TCPIP_HEAP_Delete)(testHeap) != TCPIP_STACK_HEAP_RES_OK)
+    {
+        _TestFail("delete", 0, TCPIP_STACK_HEAP_RES_OK);
+    }
+
+    // the strict pool does not fall back
+    _TestCreate(TCPIP_STACK_HEAP_FLAG_POOL_STRICT);
+    pObj = (TCPIP_HEAP_OBJECT*)testHeap;
+    while(_TestAlloc(1024, false) != 0)
+    {
+    }
+    if((*pObj->TCPIP_HEAP_LastError)(testHeap) != TCPIP_STACK_HEAP_RES_NO_MEM || testDcpt->entryTbl[6].nFree == 0 ||
+       testDcpt->entryTbl[5].allocFails != 1)
+    {
+        _TestFail("strict pool", testDcpt->entryTbl[5].allocFails, 1);
+    }
+    _TestCheckPool("strict");
+    while(testNLive)
+    {
+        _TestFree(testNLive - 1);
+    }
+    (*pObj->TCPIP_HEAP_Delete)(testHeap);
+}
+
+static void _TestPreempted(void)
+{
+    TCPIP_HEAP_OBJECT* pObj;
+    int op;
+
+    _TestCreate(TCPIP_STACK_HEAP_FLAG_ALLOC_UNCACHED);
+    pObj = (TCPIP_HEAP_OBJECT*)testHeap;
+    testPreemptFn = _TestPoolPreemption;
+
+    for(op = 0; op < TEST_OPERATIONS; op++)
+    {
+        // fill and drain the pool
+        int allocPercent = (op / 1000) % 2 == 0 ? 65 : 35;
+
+        if(testNLive != 0 && (testNLive >= TEST_MAX_LIVE - TEST_PREEMPT_DEPTH - 1 || (int)(_TestRand() % 100) >= allocPercent))
+        {
+            _TestFree(_TestRand() % testNLive);
+        }
+        else
+        {
+            _TestAlloc(_TestSize(), _TestRand() % 4 == 0);
+        }
+        _TestCheckPool("preempted");
+    }
+
+    testPreemptFn = 0;
+    while(testNLive)
+    {
+        _TestFree(testNLive - 1);
+    }
+    _TestCheckPool("preempted, freed");
+    if((*pObj->TCPIP_HEAP_Delete)(testHeap) != TCPIP_STACK_HEAP_RES_OK)
+    {
+        _TestFail("delete", 0, TCPIP_STACK_HEAP_RES_OK);
+    }
+}
+
+// the MIPS pop: ll, beqz, lw next, sc, beqz retry
+// a compare-and-swap instead of the sc when llsc is false
+static _poolHead* _TestLlScPop(_poolHead* volatile* pHead, bool llsc)
+{
+    _poolHead* pBlk;
+    _poolHead* pNext;
+
+    while(true)
+    {
+        pBlk = *pHead;
+        testLlBit = 1;
+        if(pBlk == 0)
+        {
+            return 0;
+        }
+        _TestPreempt();
+        pNext = pBlk->next;
+        _TestPreempt();
+        if(llsc ? testLlBit != 0 : *pHead == pBlk)
+        {
+            *pHead = pNext;
+            return pBlk;
+        }
+    }
+}
+
+static void _TestLlScList(int nBlks)
+{
+    int ix;
+
+    testLlHead = 0;
+    for(ix = nBlks - 1; ix >= 0; ix--)
+    {
+        testLlHeld[ix] = 0;
+        testLlBlocks[ix].next = (_poolHead*)testLlHead;
+        testLlHead = testLlBlocks + ix;
+    }
+}
+
+// every block is either on the list once or held
+static bool _TestLlScCheck(int nBlks)
+{
+    int onList[TEST_LLSC_BLOCKS] = {0};
+    _poolHead* pBlk;
+    int ix, n = 0;
+
+    for(pBlk = (_poolHead*)testLlHead; pBlk != 0 && n <= nBlks; pBlk = pBlk->next, n++)
+    {
+        ix = pBlk - testLlBlocks;
+        if(onList[ix]++ != 0 || testLlHeld[ix] != 0)
+        {
+            return false;
+        }
+    }
+    for(ix = 0; ix < nBlks; ix++)
+    {
+        if(onList[ix] == 0 && testLlHeld[ix] == 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// pops A and B, pushes A back
+static void _TestLlScAba(void)
+{
+    testPreemptFn = 0;
+    _poolHead* pA = _TCPIP_HEAP_POOL_Pop(&testLlHead);
+    _poolHead* pB = _TCPIP_HEAP_POOL_Pop(&testLlHead);
+
+    testLlHeld[pB - testLlBlocks] = 2;
+    _TCPIP_HEAP_POOL_Push(&testLlHead, pA);
+}
+
+static void _TestLlScPreemption(void)
+{
+    _poolHead* pBlk;
+    int ix;
+
+    if(_TestRand() % 2 == 0)
+    {
+        if((pBlk = _TCPIP_HEAP_POOL_Pop(&testLlHead)) != 0)
+        {
+            testLlHeld[pBlk - testLlBlocks] = 2;
+        }
+        return;
+    }
+
+    for(ix = _TestRand() % TEST_LLSC_BLOCKS; ix < TEST_LLSC_BLOCKS; ix++)
+    {
+        if(testLlHeld[ix] == 2)
+        {
+            testLlHeld[ix] = 0;
+            _TCPIP_HEAP_POOL_Push(&testLlHead, testLlBlocks + ix);
+            return;
+        }
+    }
+}
+
+static void _TestLlSc(void)
+{
+    _poolHead* pBlk;
+    int op, ix;
+
+    // A -> B -> C -> D, the task is preempted between its lw of A->next and its sc
+    _TestLlScList(4);
+    testPreemptFn = _TestLlScAba;
+    testForceAt = 1;
+    pBlk = _TestLlScPop(&testLlHead, true);
+    testLlHeld[pBlk - testLlBlocks] = 1;
+    if(pBlk != testLlBlocks || testLlHead != testLlBlocks + 2 || !_TestLlScCheck(4))
+    {
+        _TestFail("ll/sc pop after A and B popped and A pushed, list head", testLlHead - testLlBlocks, 2);
+    }
+
+    _TestLlScList(4);
+    testPreemptFn = _TestLlScAba;
+    testForceAt = 1;
+    pBlk = _TestLlScPop(&testLlHead, false);
+    testLlHeld[pBlk - testLlBlocks] = 1;
+    if(_TestLlScCheck(4))
+    {
+        _TestFail("compare-and-swap pop not caught, list head", testLlHead - testLlBlocks, 1);
+    }
+
+    // random pops and pushes, preempted by pops and pushes
+    _TestLlScList(TEST_LLSC_BLOCKS);
+    testPreemptFn = _TestLlScPreemption;
+    for(op = 0; op < TEST_LLSC_OPERATIONS; op++)
+    {
+        if(_TestRand() % 2 == 0)
+        {
+            if((pBlk = _TestLlScPop(&testLlHead, true)) != 0)
+            {
+                if(testLlHeld[pBlk - testLlBlocks] != 0)
+                {
+                    _TestFail("ll/sc pop of a held block", pBlk - testLlBlocks, -1);
+                }
+                testLlHeld[pBlk - testLlBlocks] = 1;
+            }
+        }
+        else
+        {
+            for(ix = _TestRand() % TEST_LLSC_BLOCKS; ix < TEST_LLSC_BLOCKS; ix++)
+            {
+                if(testLlHeld[ix] == 1)
+                {
+                    testLlHeld[ix] = 0;
+                    _TCPIP_HEAP_POOL_Push(&testLlHead, testLlBlocks + ix);
+                    break;
+                }
+            }
+        }
+
+        if(!_TestLlScCheck(TEST_LLSC_BLOCKS))
+        {
+            _TestFail("ll/sc list corrupted at operation", op, -1);
+        }
+    }
+    testPreemptFn = 0;
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t preempts, retries;
+
+    _TestFunctional();
+    printf("functional: passed\n");
+
+    _TestPreempted();
+    printf("preempted: %d operations, %u preemptions, %u CAS retries, %u fallbacks\n", TEST_OPERATIONS,
+           (unsigned)testPreempts, (unsigned)testCasRetries, (unsigned)testFallbacks);
+    if(testCasRetries == 0 || testFallbacks == 0)
+    {
+        printf("FAIL the CAS retry and fallback paths were not run\n");
+        return 1;
+    }
+
+    preempts = testPreempts;
+    retries = testCasRetries;
+    _TestLlSc();
+    printf("ll/sc: %d operations, %u preemptions, %u CAS retries\n", TEST_LLSC_OPERATIONS,
+           (unsigned)(testPreempts - preempts), (unsigned)(testCasRetries - retries));
+
+    printf("passed\n");
+    return 0;
+}
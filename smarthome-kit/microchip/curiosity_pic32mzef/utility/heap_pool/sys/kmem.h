@@ -0,0 +1,17 @@
+/*******************************************************************************
+  Pool Heap Test Memory Map Header
+
+  File Name:
+    kmem.h
+
+  Summary:
+    Host replacement of the XC32 sys/kmem.h for heap_pool.c.
+
+  Description:
+    The pool heap includes it but uses none of the KSEG address macros.
+*******************************************************************************/
+
+#ifndef _HEAP_POOL_KMEM_H
+#define _HEAP_POOL_KMEM_H
+
+#endif // _HEAP_POOL_KMEM_H
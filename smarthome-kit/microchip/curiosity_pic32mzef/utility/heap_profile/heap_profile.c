@@ -0,0 +1,661 @@
+/*******************************************************************************
+  TCP/IP Heap Profiler Host Test
+
+  File Name:
+    heap_profile.c
+
+  Summary:
+    Checks the TCP/IP heap profiler accounting against a reference model.
+
+  Description:
+    The heap profiler of tcpip_heap_alloc.c is built on the host, on top of
+    a heap object backed by the C library heap with a fixed capacity, so
+    large requests fail once it fills. The core timer is a counter that the
+    heap object advances by a pseudo random latency for each call.
+
+    TEST_OPERATIONS random TCPIP_HEAP_MallocProfile, CallocProfile and
+    FreeProfile calls are made, the blocks freed by random modules. A
+    reference model keeps the expected values, checked after each call:
+        - allocations, failures, frees, current and peak blocks and bytes
+        - blocks not tracked because the profiler table was full; such a
+          block has to stay out of the accounting until it is freed
+    and every TEST_CHECK_PERIOD calls and at the end:
+        - per module allocations, failures, current and peak bytes, the
+          modules over TCPIP_STACK_HEAP_PROFILE_MODULES not accounted
+        - per size class allocations, current and peak blocks
+        - the latency percentiles, an upper bound at most 25% over the
+          exact value, and the maximum
+    Halfway the profile is reset. The heap object checks that a block is
+    untracked before it is returned, and the OSAL replacement checks that
+    the critical sections are balanced and are taken by the queries.
+
+    Build and run, from this directory:
+        gcc -O2 -I. -I../../../harmony/v2.05/framework -o heap_profile heap_profile.c
+        ./heap_profile
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+// host build configuration; a small table so that it fills up
+#define TCPIP_STACK_HEAP_PROFILE_ENABLE
+#define TCPIP_STACK_HEAP_PROFILE_SLOTS      64
+#define TCPIP_STACK_HEAP_PROFILE_MODULES    4
+#define TCPIP_STACK_SUPPORTED_HEAPS         1
+
+// replace the Harmony headers included by the heap allocator
+#define __TCPIP_STACK_PRIVATE_H__
+#define _SYS_CLK_H
+
+#include "tcpip/tcpip_heap.h"
+#include "tcpip/src/tcpip_heap_alloc.h"
+
+#define TEST_OPERATIONS         200000
+#define TEST_CHECK_PERIOD       1000
+#define TEST_PHASE_LENGTH       2000        // operations between the fill and drain phases
+#define TEST_HEAP_SIZE          (48 * 1024)
+#define TEST_MAX_LIVE           128
+#define TEST_MAX_SIZE           8192
+#define TEST_MODULES            6           // module IDs 1 - 6, 0 is no module
+
+// OSAL
+typedef int     OSAL_CRITSECT_DATA_TYPE;
+typedef enum
+{
+    OSAL_CRIT_TYPE_LOW,
+    OSAL_CRIT_TYPE_HIGH,
+}OSAL_CRIT_TYPE;
+
+static int      testCritDepth;
+static uint32_t testCritEnters;
+
+static OSAL_CRITSECT_DATA_TYPE OSAL_CRIT_Enter(OSAL_CRIT_TYPE severity)
+{
+    testCritEnters++;
+    return testCritDepth++;
+}
+
+static void OSAL_CRIT_Leave(OSAL_CRIT_TYPE severity, OSAL_CRITSECT_DATA_TYPE status)
+{
+    if(--testCritDepth != status)
+    {
+        printf("FAIL unbalanced critical section\n");
+        exit(1);
+    }
+}
+
+// core timer
+static uint32_t testClock;
+
+static uint32_t _CP0_GET_COUNT(void)
+{
+    return testClock;
+}
+
+static uint32_t SYS_CLK_SystemFrequencyGet(void)
+{
+    return 200000000;
+}
+
+#include "tcpip/src/tcpip_heap_alloc.c"
+
+// heap object
+typedef struct
+{
+    TCPIP_HEAP_OBJECT   obj;
+    size_t              used;
+}TEST_HEAP;
+
+typedef struct
+{
+    void*       ptr;
+    uint32_t    nBytes;
+    int         modIx;      // accounting module, -1 when none
+    bool        tracked;
+}TEST_BLOCK;
+
+typedef struct
+{
+    int         moduleId;
+    uint32_t    nAllocs;
+    uint32_t    nFails;
+    uint32_t    currBytes;
+    uint32_t    peakBytes;
+}TEST_MODULE;
+
+typedef struct
+{
+    uint32_t    nAllocs;
+    uint32_t    currBlocks;
+    uint32_t    peakBlocks;
+}TEST_SIZE;
+
+static TEST_HEAP        testHeap;
+static uint32_t         testLatency;        // latency of the next heap call
+
+// reference model
+static TCPIP_HEAP_PROFILE_INFO  modelInfo;
+static TEST_BLOCK       modelLive[TEST_MAX_LIVE];
+static int              modelNLive;
+static int              modelNTracked;
+static TEST_MODULE      modelMods[TCPIP_STACK_HEAP_PROFILE_MODULES];
+static TEST_SIZE        modelSizes[_TCPIP_HEAP_PROF_SIZE_CLASSES];
+static uint32_t         modelAllocLat[TEST_OPERATIONS];
+static uint32_t         modelFreeLat[TEST_OPERATIONS];
+static uint32_t         modelNAllocLat, modelNFreeLat;
+static uint32_t         testNUntracked;
+
+static uint32_t _TestRand(void)
+{
+    static uint32_t seed = 0x12345678;
+
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+static void _TestFail(int op, const char* what, uint32_t val, uint32_t expected)
+{
+    printf("FAIL operation %d: %s %u, expected %u\n", op, what, (unsigned)val, (unsigned)expected);
+    exit(1);
+}
+
+static void* _TestHeapMalloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes)
+{
+    uint8_t* pBlk;
+
+    testClock += testLatency;
+    if(testHeap.used + nBytes > TEST_HEAP_SIZE)
+    {
+        return 0;
+    }
+
+    // 16 bytes header keeps the block aligned
+    pBlk = malloc(nBytes + 16);
+    *(size_t*)pBlk = nBytes;
+    testHeap.used += nBytes;
+    return pBlk + 16;
+}
+
+static void* _TestHeapCalloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_t elemSize)
+{
+    void* ptr = _TestHeapMalloc(heapH, nElems * elemSize);
+
+    if(ptr != 0)
+    {
+        memset(ptr, 0, nElems * elemSize);
+    }
+    return ptr;
+}
+
+static size_t _TestHeapFree(TCPIP_STACK_HEAP_HANDLE heapH, const void* ptr)
+{
+    uint8_t* pBlk = (uint8_t*)ptr - 16;
+    size_t nBytes = *(size_t*)pBlk;
+    int ix;
+
+    testClock += testLatency;
+
+    // another thread could get the block as soon as it is returned
+    for(ix = 0; ix < TCPIP_STACK_HEAP_PROFILE_SLOTS; ix++)
+    {
+        if(_tcpipHeapProfDcpt[0].blockTbl[ix].ptr == ptr)
+        {
+            printf("FAIL block freed while still tracked\n");
+            exit(1);
+        }
+    }
+
+    testHeap.used -= nBytes;
+    free(pBlk);
+    return nBytes;
+}
+
+static size_t _TestHeapSize(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    return TEST_HEAP_SIZE;
+}
+
+static size_t _TestHeapFreeSize(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    return TEST_HEAP_SIZE - testHeap.used;
+}
+
+static size_t _TestHeapMaxSize(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    return (TEST_HEAP_SIZE - testHeap.used) / 2;
+}
+
+// latencies from 1 to 2^20 ticks, most of them short
+static uint32_t _TestLatency(void)
+{
+    int bits = (_TestRand() % 100) < 90 ? 6 : 20;
+
+    return 1 + _TestRand() % (1u << (_TestRand() % bits + 1));
+}
+
+// request sizes spread over the powers of 2
+static uint32_t _TestSize(void)
+{
+    uint32_t size = 1 + _TestRand() % (1u << (_TestRand() % 14));
+
+    return size < TEST_MAX_SIZE ? size : TEST_MAX_SIZE;
+}
+
+// size class containing a request size, from the profiler class limits
+static int _TestSizeClass(uint32_t nBytes)
+{
+    TCPIP_HEAP_PROFILE_SIZE_ENTRY sizeEntry;
+    int ix;
+
+    for(ix = 0; TCPIP_HEAP_ProfileGetSizeEntry(&testHeap, ix, &sizeEntry); ix++)
+    {
+        if(sizeEntry.lowLimit <= nBytes && nBytes <= sizeEntry.highLimit)
+        {
+            return ix;
+        }
+    }
+
+    printf("FAIL no size class for %u bytes\n", (unsigned)nBytes);
+    exit(1);
+}
+
+// modules get the slots in the order they allocate
+static int _TestModule(int moduleId)
+{
+    int ix;
+
+    if(moduleId == 0)
+    {
+        return -1;
+    }
+
+    for(ix = 0; ix < TCPIP_STACK_HEAP_PROFILE_MODULES; ix++)
+    {
+        if(modelMods[ix].moduleId == moduleId)
+        {
+            return ix;
+        }
+        if(modelMods[ix].moduleId == 0)
+        {
+            modelMods[ix].moduleId = moduleId;
+            return ix;
+        }
+    }
+
+    return -1;
+}
+
+static void _TestCheckInfo(int op, bool* pUntracked)
+{
+    TCPIP_HEAP_PROFILE_INFO info;
+
+    if(!TCPIP_HEAP_ProfileGetInfo(&testHeap, &info))
+    {
+        _TestFail(op, "no profile info", 0, 1);
+    }
+
+    // the table can be full, the profiler tells which blocks it skipped
+    *pUntracked = info.nUntracked != modelInfo.nUntracked;
+    if(*pUntracked)
+    {
+        modelInfo.nUntracked++;
+    }
+
+    if(info.nAllocs != modelInfo.nAllocs)
+    {
+        _TestFail(op, "allocations", info.nAllocs, modelInfo.nAllocs);
+    }
+    if(info.nFails != modelInfo.nFails)
+    {
+        _TestFail(op, "failures", info.nFails, modelInfo.nFails);
+    }
+    if(info.maxFailSize != modelInfo.maxFailSize)
+    {
+        _TestFail(op, "max failed size", info.maxFailSize, modelInfo.maxFailSize);
+    }
+    if(info.nFrees != modelInfo.nFrees)
+    {
+        _TestFail(op, "frees", info.nFrees, modelInfo.nFrees);
+    }
+    if(info.nUntracked != modelInfo.nUntracked)
+    {
+        _TestFail(op, "untracked", info.nUntracked, modelInfo.nUntracked);
+    }
+    if(info.heapSize != TEST_HEAP_SIZE || info.freeSize != TEST_HEAP_SIZE - testHeap.used ||
+       info.maxBlock != (TEST_HEAP_SIZE - testHeap.used) / 2)
+    {
+        _TestFail(op, "heap free size", info.freeSize, TEST_HEAP_SIZE - testHeap.used);
+    }
+}
+
+static void _TestCheckBytes(int op)
+{
+    TCPIP_HEAP_PROFILE_INFO info;
+
+    TCPIP_HEAP_ProfileGetInfo(&testHeap, &info);
+    if(info.currBlocks != modelInfo.currBlocks)
+    {
+        _TestFail(op, "blocks", info.currBlocks, modelInfo.currBlocks);
+    }
+    if(info.peakBlocks != modelInfo.peakBlocks)
+    {
+        _TestFail(op, "peak blocks", info.peakBlocks, modelInfo.peakBlocks);
+    }
+    if(info.currBytes != modelInfo.currBytes)
+    {
+        _TestFail(op, "bytes", info.currBytes, modelInfo.currBytes);
+    }
+    if(info.peakBytes != modelInfo.peakBytes)
+    {
+        _TestFail(op, "peak bytes", info.peakBytes, modelInfo.peakBytes);
+    }
+}
+
+static int _TestCmpU32(const void* p1, const void* p2)
+{
+    uint32_t v1 = *(const uint32_t*)p1, v2 = *(const uint32_t*)p2;
+
+    return v1 < v2 ? -1 : v1 > v2;
+}
+
+static void _TestCheckLatency(int op, const char* what, const uint32_t* pLat, uint32_t* pSamples, uint32_t nSamples)
+{
+    static const int latPercent[] = {50, 90, 99};
+    char name[32];
+    int ix;
+
+    if(nSamples == 0)
+    {
+        return;
+    }
+
+    qsort(pSamples, nSamples, sizeof(*pSamples), _TestCmpU32);
+    for(ix = 0; ix < 3; ix++)
+    {
+        uint32_t exact = pSamples[(uint32_t)(((uint64_t)nSamples * latPercent[ix] + 99) / 100) - 1];
+
+        sprintf(name, "%s p%d latency", what, latPercent[ix]);
+        if(pLat[ix] < exact || pLat[ix] - exact > exact / 4)
+        {
+            _TestFail(op, name, pLat[ix], exact);
+        }
+    }
+    sprintf(name, "%s max latency", what);
+    if(pLat[3] != pSamples[nSamples - 1])
+    {
+        _TestFail(op, name, pLat[3], pSamples[nSamples - 1]);
+    }
+}
+
+static void _TestCheckAll(int op)
+{
+    TCPIP_HEAP_PROFILE_INFO info;
+    TCPIP_HEAP_PROFILE_MODULE modEntry;
+    TCPIP_HEAP_PROFILE_SIZE_ENTRY sizeEntry;
+    uint32_t critEnters;
+    int ix;
+
+    for(ix = 0; ix < TCPIP_STACK_HEAP_PROFILE_MODULES; ix++)
+    {
+        critEnters = testCritEnters;
+        if(!TCPIP_HEAP_ProfileGetModule(&testHeap, ix, &modEntry))
+        {
+            if(modelMods[ix].moduleId != 0)
+            {
+                _TestFail(op, "no entry for module", modelMods[ix].moduleId, 0);
+            }
+            continue;
+        }
+        if(testCritEnters == critEnters)
+        {
+            _TestFail(op, "module entry read outside a critical section", ix, 0);
+        }
+        if(modEntry.moduleId != modelMods[ix].moduleId)
+        {
+            _TestFail(op, "module", modEntry.moduleId, modelMods[ix].moduleId);
+        }
+        if(modEntry.nAllocs != modelMods[ix].nAllocs)
+        {
+            _TestFail(op, "module allocations", modEntry.nAllocs, modelMods[ix].nAllocs);
+        }
+        if(modEntry.nFails != modelMods[ix].nFails)
+        {
+            _TestFail(op, "module failures", modEntry.nFails, modelMods[ix].nFails);
+        }
+        if(modEntry.currBytes != modelMods[ix].currBytes)
+        {
+            _TestFail(op, "module bytes", modEntry.currBytes, modelMods[ix].currBytes);
+        }
+        if(modEntry.peakBytes != modelMods[ix].peakBytes)
+        {
+            _TestFail(op, "module peak bytes", modEntry.peakBytes, modelMods[ix].peakBytes);
+        }
+    }
+
+    for(ix = 0; TCPIP_HEAP_ProfileGetSizeEntry(&testHeap, ix, &sizeEntry); ix++)
+    {
+        if(sizeEntry.nAllocs != modelSizes[ix].nAllocs)
+        {
+            _TestFail(op, "size class allocations", sizeEntry.nAllocs, modelSizes[ix].nAllocs);
+        }
+        if(sizeEntry.currBlocks != modelSizes[ix].currBlocks)
+        {
+            _TestFail(op, "size class blocks", sizeEntry.currBlocks, modelSizes[ix].currBlocks);
+        }
+        if(sizeEntry.peakBlocks != modelSizes[ix].peakBlocks)
+        {
+            _TestFail(op, "size class peak blocks", sizeEntry.peakBlocks, modelSizes[ix].peakBlocks);
+        }
+    }
+
+    TCPIP_HEAP_ProfileGetInfo(&testHeap, &info);
+    _TestCheckLatency(op, "alloc", info.allocLat, modelAllocLat, modelNAllocLat);
+    _TestCheckLatency(op, "free", info.freeLat, modelFreeLat, modelNFreeLat);
+}
+
+static void _TestAlloc(int op)
+{
+    uint32_t nBytes = _TestSize();
+    int moduleId = _TestRand() % (TEST_MODULES + 1);
+    int modIx = _TestModule(moduleId);
+    bool untracked;
+    void* ptr;
+
+    testLatency = _TestLatency();
+    modelAllocLat[modelNAllocLat++] = testLatency;
+    if(_TestRand() % 4 == 0 && nBytes >= 4)
+    {
+        nBytes &= ~3;
+        ptr = TCPIP_HEAP_CallocProfile(&testHeap, nBytes / 4, 4, moduleId);
+    }
+    else
+    {
+        ptr = TCPIP_HEAP_MallocProfile(&testHeap, nBytes, moduleId);
+    }
+
+    if(ptr == 0)
+    {
+        modelInfo.nFails++;
+        if(nBytes > modelInfo.maxFailSize)
+        {
+            modelInfo.maxFailSize = nBytes;
+        }
+        if(modIx >= 0)
+        {
+            modelMods[modIx].nFails++;
+        }
+        _TestCheckInfo(op, &untracked);
+        return;
+    }
+
+    TEST_BLOCK* pBlk = modelLive + modelNLive++;
+    int sIx = _TestSizeClass(nBytes);
+
+    pBlk->ptr = ptr;
+    pBlk->nBytes = nBytes;
+    pBlk->modIx = modIx;
+    modelInfo.nAllocs++;
+    modelSizes[sIx].nAllocs++;
+    if(modIx >= 0)
+    {
+        modelMods[modIx].nAllocs++;
+    }
+
+    _TestCheckInfo(op, &untracked);
+    pBlk->tracked = !untracked;
+    if(untracked)
+    {
+        // the probe limit may stop the search early, but not on a half empty table
+        if(modelNTracked < TCPIP_STACK_HEAP_PROFILE_SLOTS / 2)
+        {
+            _TestFail(op, "block not tracked, tracked blocks", modelNTracked, TCPIP_STACK_HEAP_PROFILE_SLOTS);
+        }
+        testNUntracked++;
+        return;
+    }
+
+    modelNTracked++;
+    if(++modelSizes[sIx].currBlocks > modelSizes[sIx].peakBlocks)
+    {
+        modelSizes[sIx].peakBlocks = modelSizes[sIx].currBlocks;
+    }
+    if(++modelInfo.currBlocks > modelInfo.peakBlocks)
+    {
+        modelInfo.peakBlocks = modelInfo.currBlocks;
+    }
+    if((modelInfo.currBytes += nBytes) > modelInfo.peakBytes)
+    {
+        modelInfo.peakBytes = modelInfo.currBytes;
+    }
+    if(modIx >= 0 && (modelMods[modIx].currBytes += nBytes) > modelMods[modIx].peakBytes)
+    {
+        modelMods[modIx].peakBytes = modelMods[modIx].currBytes;
+    }
+}
+
+static void _TestFree(int op)
+{
+    int bIx = _TestRand() % modelNLive;
+    TEST_BLOCK blk = modelLive[bIx];
+    bool untracked;
+
+    modelLive[bIx] = modelLive[--modelNLive];
+
+    // any module can free a block, the bytes go back to the allocating one
+    testLatency = _TestLatency();
+    modelFreeLat[modelNFreeLat++] = testLatency;
+    if(TCPIP_HEAP_FreeProfile(&testHeap, blk.ptr, 1 + _TestRand() % TEST_MODULES) != blk.nBytes)
+    {
+        _TestFail(op, "free size", 0, blk.nBytes);
+    }
+
+    modelInfo.nFrees++;
+    _TestCheckInfo(op, &untracked);
+    if(untracked == blk.tracked)
+    {
+        _TestFail(op, "untracked on free", untracked, !blk.tracked);
+    }
+    if(!blk.tracked)
+    {
+        return;
+    }
+
+    modelNTracked--;
+    modelSizes[_TestSizeClass(blk.nBytes)].currBlocks--;
+    modelInfo.currBlocks--;
+    modelInfo.currBytes -= blk.nBytes;
+    if(blk.modIx >= 0)
+    {
+        modelMods[blk.modIx].currBytes -= blk.nBytes;
+    }
+}
+
+static void _TestReset(int op)
+{
+    int ix;
+
+    if(TCPIP_HEAP_ProfileReset(&testHeap) != TCPIP_STACK_HEAP_RES_OK)
+    {
+        _TestFail(op, "reset", 0, 1);
+    }
+
+    modelInfo.nAllocs = modelInfo.nFails = modelInfo.nFrees = modelInfo.nUntracked = 0;
+    modelInfo.maxFailSize = 0;
+    modelInfo.peakBlocks = modelInfo.currBlocks;
+    modelInfo.peakBytes = modelInfo.currBytes;
+    for(ix = 0; ix < _TCPIP_HEAP_PROF_SIZE_CLASSES; ix++)
+    {
+        modelSizes[ix].nAllocs = 0;
+        modelSizes[ix].peakBlocks = modelSizes[ix].currBlocks;
+    }
+    for(ix = 0; ix < TCPIP_STACK_HEAP_PROFILE_MODULES; ix++)
+    {
+        modelMods[ix].nAllocs = modelMods[ix].nFails = 0;
+        modelMods[ix].peakBytes = modelMods[ix].currBytes;
+    }
+    modelNAllocLat = modelNFreeLat = 0;
+}
+
+int main(int argc, char* argv[])
+{
+    TCPIP_HEAP_PROFILE_INFO info;
+    int op;
+
+    testHeap.obj.TCPIP_HEAP_Malloc = _TestHeapMalloc;
+    testHeap.obj.TCPIP_HEAP_Calloc = _TestHeapCalloc;
+    testHeap.obj.TCPIP_HEAP_Free = _TestHeapFree;
+    testHeap.obj.TCPIP_HEAP_Size = _TestHeapSize;
+    testHeap.obj.TCPIP_HEAP_MaxSize = _TestHeapMaxSize;
+    testHeap.obj.TCPIP_HEAP_FreeSize = _TestHeapFreeSize;
+    _TCPIP_HEAP_ProfRegister(&testHeap);
+
+    for(op = 0; op < TEST_OPERATIONS; op++)
+    {
+        // fill the heap and the table, then drain them
+        int allocPercent = (op / TEST_PHASE_LENGTH) % 2 == 0 ? 70 : 30;
+
+        if(op == TEST_OPERATIONS / 2)
+        {
+            _TestReset(op);
+        }
+
+        if(modelNLive == 0 || (modelNLive < TEST_MAX_LIVE && (int)(_TestRand() % 100) < allocPercent))
+        {
+            _TestAlloc(op);
+        }
+        else
+        {
+            _TestFree(op);
+        }
+        _TestCheckBytes(op);
+
+        if(op % TEST_CHECK_PERIOD == 0)
+        {
+            _TestCheckAll(op);
+        }
+    }
+    _TestCheckAll(op);
+
+    if(testCritDepth != 0)
+    {
+        _TestFail(op, "critical section depth", testCritDepth, 0);
+    }
+
+    TCPIP_HEAP_ProfileGetInfo(&testHeap, &info);
+    printf("%d operations: peak %u blocks %u bytes, %u failed, %u untracked\n", TEST_OPERATIONS,
+           (unsigned)info.peakBlocks, (unsigned)info.peakBytes, (unsigned)modelInfo.nFails, (unsigned)testNUntracked);
+    if(modelInfo.nFails == 0 || testNUntracked == 0)
+    {
+        printf("FAIL the failure and full table paths were not run\n");
+        return 1;
+    }
+
+    printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,18 @@
+/*******************************************************************************
+  Heap Profiler Test Memory Map Header
+
+  File Name:
+    kmem.h
+
+  Summary:
+    Host replacement of the XC32 sys/kmem.h for heap_profile.c.
+
+  Description:
+    The KSEG address macros are used only by the PIC32MZ cache helpers,
+    which are not built on the host.
+*******************************************************************************/
+
+#ifndef _HEAP_PROFILE_KMEM_H
+#define _HEAP_PROFILE_KMEM_H
+
+#endif // _HEAP_PROFILE_KMEM_H
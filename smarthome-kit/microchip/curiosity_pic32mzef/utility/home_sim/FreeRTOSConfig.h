@@ -0,0 +1,81 @@
+/*******************************************************************************
+  Home Automation Simulation Kernel Configuration
+
+  File Name:
+    FreeRTOSConfig.h
+
+  Summary:
+    FreeRTOS configuration for the POSIX port build of home_sim.
+
+  Description:
+    Tick rate, priorities and the kernel features used by the home
+    automation modules are the ones of the board configuration, so task
+    timing in the simulation follows the target.
+    The POSIX port runs every task on its own thread; the minimal stack
+    can't go below PTHREAD_STACK_MIN.
+*******************************************************************************/
+
+#ifndef FREERTOS_CONFIG_H
+#define FREERTOS_CONFIG_H
+
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+
+#define configUSE_PREEMPTION                       1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION    0
+#define configUSE_TICKLESS_IDLE                    0
+#define configTICK_RATE_HZ                         ( ( TickType_t ) 1000 )
+#define configMAX_PRIORITIES                       ( 10UL )
+#define configMINIMAL_STACK_SIZE                   ( ( unsigned short ) PTHREAD_STACK_MIN )
+#define configSUPPORT_DYNAMIC_ALLOCATION           1
+#define configSUPPORT_STATIC_ALLOCATION            0
+#define configTOTAL_HEAP_SIZE                      ( ( size_t ) ( 1024 * 1024 ) )
+#define configMAX_TASK_NAME_LEN                    ( 16 )
+#define configUSE_16_BIT_TICKS                     0
+#define configIDLE_SHOULD_YIELD                    1
+#define configUSE_MUTEXES                          1
+#define configUSE_RECURSIVE_MUTEXES                1
+#define configUSE_COUNTING_SEMAPHORES              1
+#define configUSE_TASK_NOTIFICATIONS               1
+#define configQUEUE_REGISTRY_SIZE                  0
+#define configUSE_QUEUE_SETS                       0
+#define configUSE_TIME_SLICING                     0
+#define configUSE_NEWLIB_REENTRANT                 0
+#define configENABLE_BACKWARD_COMPATIBILITY        1
+
+/* Hook function related definitions. */
+#define configUSE_IDLE_HOOK                        0
+#define configUSE_TICK_HOOK                        0
+#define configCHECK_FOR_STACK_OVERFLOW             0
+#define configUSE_MALLOC_FAILED_HOOK               0
+
+/* Run time and task stats gathering related definitions. */
+#define configGENERATE_RUN_TIME_STATS              0
+#define configUSE_TRACE_FACILITY                   0
+
+/* Co-routine and software timer related definitions. */
+#define configUSE_CO_ROUTINES                      0
+#define configMAX_CO_ROUTINE_PRIORITIES            2
+#define configUSE_TIMERS                           0
+
+/* Optional functions. */
+#define INCLUDE_vTaskPrioritySet                   1
+#define INCLUDE_uxTaskPriorityGet                  1
+#define INCLUDE_vTaskDelete                        1
+#define INCLUDE_vTaskSuspend                       1
+#define INCLUDE_vTaskDelayUntil                    1
+#define INCLUDE_vTaskDelay                         1
+#define INCLUDE_xTaskGetSchedulerState             1
+#define INCLUDE_xTaskGetCurrentTaskHandle          1
+
+/* Assert call and printf style output, implemented by home_sim.c. */
+extern void vAssertCalled( const char * pcFile,
+                           uint32_t ulLine );
+#define configASSERT( x )    if( ( x ) == 0 ) vAssertCalled( __FILE__, __LINE__ )
+
+extern void vLoggingPrintf( const char * pcFormat,
+                            ... );
+#define configPRINTF( X )    vLoggingPrintf X
+
+#endif /* FREERTOS_CONFIG_H */
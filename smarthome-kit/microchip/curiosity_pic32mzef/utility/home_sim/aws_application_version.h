@@ -0,0 +1,17 @@
+/*******************************************************************************
+  Home Automation Simulation Application Version
+
+  File Name:
+    aws_application_version.h
+
+  Summary:
+    Empty replacement of the OTA application version header.
+
+  Description:
+    Nothing in the home automation modules reads the application version.
+*******************************************************************************/
+
+#ifndef _AWS_APPLICATION_VERSION_H_
+#define _AWS_APPLICATION_VERSION_H_
+
+#endif /* _AWS_APPLICATION_VERSION_H_ */
@@ -0,0 +1,21 @@
+/*******************************************************************************
+  Home Automation Simulation Client Credentials
+
+  File Name:
+    aws_clientcredential.h
+
+  Summary:
+    Thing name and broker endpoint of the simulated MQTT broker.
+
+  Description:
+    The broker is the mock in sim_mqtt.c, nothing is resolved or connected.
+*******************************************************************************/
+
+#ifndef __AWS_CLIENTCREDENTIAL__H__
+#define __AWS_CLIENTCREDENTIAL__H__
+
+#define clientcredentialMQTT_BROKER_ENDPOINT    "localhost"
+#define clientcredentialIOT_THING_NAME          "home_sim"
+#define clientcredentialMQTT_BROKER_PORT        8883
+
+#endif /* __AWS_CLIENTCREDENTIAL__H__ */
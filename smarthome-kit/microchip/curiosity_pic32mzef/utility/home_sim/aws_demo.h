@@ -0,0 +1,17 @@
+/*******************************************************************************
+  Home Automation Simulation Demo Runner
+
+  File Name:
+    aws_demo.h
+
+  Summary:
+    Empty replacement of the demo runner header.
+
+  Description:
+    home_sim.c starts the remote HVAC demo directly.
+*******************************************************************************/
+
+#ifndef _AWS_DEMO_H_
+#define _AWS_DEMO_H_
+
+#endif /* _AWS_DEMO_H_ */
@@ -0,0 +1,24 @@
+/*******************************************************************************
+  Home Automation Simulation Demo Configuration
+
+  File Name:
+    aws_demo_config.h
+
+  Summary:
+    Demo configuration values used by aws_remote_hvac.c.
+
+  Description:
+    Timeouts and connect flags are the ones of the board configuration.
+*******************************************************************************/
+
+#ifndef _AWS_DEMO_CONFIG_H_
+#define _AWS_DEMO_CONFIG_H_
+
+#define democonfigMQTT_ECHO_TLS_NEGOTIATION_TIMEOUT     pdMS_TO_TICKS( 12000 )
+#define democonfigMQTT_TIMEOUT                          pdMS_TO_TICKS( 3000 )
+#define democonfigMQTT_AGENT_CONNECT_FLAGS              ( mqttagentREQUIRE_TLS | mqttagentUSE_AWS_IOT_ALPN_443 )
+
+#define democonfigOTA_UPDATE_TASK_STACK_SIZE            ( configMINIMAL_STACK_SIZE * 4 )
+#define democonfigOTA_UPDATE_TASK_TASK_PRIORITY         ( tskIDLE_PRIORITY )
+
+#endif /* _AWS_DEMO_CONFIG_H_ */
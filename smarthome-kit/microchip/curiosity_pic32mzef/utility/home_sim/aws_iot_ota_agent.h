@@ -0,0 +1,66 @@
+/*******************************************************************************
+  Home Automation Simulation OTA Agent
+
+  File Name:
+    aws_iot_ota_agent.h
+
+  Summary:
+    The part of the OTA agent interface used by aws_remote_hvac.c.
+
+  Description:
+    The OTA agent is not simulated. sim_mqtt.c implements the functions
+    so vOTAUpdateDemoTask links; the agent stays in the NotReady state.
+*******************************************************************************/
+
+#ifndef _AWS_OTA_AGENT_H_
+#define _AWS_OTA_AGENT_H_
+
+#include <stdint.h>
+
+#define OTA_LOG_L1          vLoggingPrintf
+
+typedef uint32_t OTA_Err_t;
+
+#define kOTA_Err_None               0x00000000UL
+#define kOTA_Err_Uninitialized      0xFF000000UL
+
+typedef enum
+{
+    eOTA_AgentState_NotReady = 0,
+    eOTA_AgentState_Ready,
+    eOTA_AgentState_Active,
+    eOTA_AgentState_ShuttingDown,
+    eOTA_NumAgentStates
+} OTA_State_t;
+
+typedef enum
+{
+    eOTA_JobEvent_Activate,
+    eOTA_JobEvent_Fail,
+    eOTA_JobEvent_StartTest
+} OTA_JobEvent_t;
+
+typedef enum
+{
+    eOTA_ImageState_Unknown = 0,
+    eOTA_ImageState_Testing,
+    eOTA_ImageState_Accepted,
+    eOTA_ImageState_Rejected,
+    eOTA_ImageState_Aborted
+} OTA_ImageState_t;
+
+typedef void (* pxOTACompleteCallback_t)( OTA_JobEvent_t eEvent );
+
+OTA_State_t OTA_AgentInit( void * pvClient,
+                           const uint8_t * pcThingName,
+                           pxOTACompleteCallback_t xFunc,
+                           TickType_t xTicksToWait );
+OTA_State_t OTA_GetAgentState( void );
+OTA_Err_t OTA_ActivateNewImage( void );
+OTA_Err_t OTA_SetImageState( OTA_ImageState_t eState );
+uint32_t OTA_GetPacketsReceived( void );
+uint32_t OTA_GetPacketsQueued( void );
+uint32_t OTA_GetPacketsProcessed( void );
+uint32_t OTA_GetPacketsDropped( void );
+
+#endif /* _AWS_OTA_AGENT_H_ */
@@ -0,0 +1,642 @@
+/*******************************************************************************
+  Home Automation Host Simulation
+
+  File Name:
+    home_sim.c
+
+  Summary:
+    Runs the home automation modules on the FreeRTOS POSIX port against
+    simulated click boards and a mock MQTT broker.
+
+  Description:
+    The sensor, thermostat, HVAC, display and connector modules are built
+    unchanged. The click drivers run on top of device models (sim_*.c):
+    a BME280 on the Weather click, the Rotary click encoder and LED ring,
+    the SSD1351 of the OLED C click and the WILC1000 with the MQTT broker
+    behind it. SPI transfers take the time of the board SPI clocks.
+
+    The simulation task drives the scenarios and checks the results:
+        - control: target temperature and fan configuration from the
+          broker, latency to the display and to the shadow update
+        - telemetry: sensor changes reaching the display and the status
+          topic with the compensated values
+        - thermostat: Rotary click stick presses and turns, LED ring values
+          and the target temperature set by them
+        - fan button: board button 2 cycling the fan
+        - bus: release and yield of SPI2 by a client not holding it
+        - throughput: a burst of configuration messages, then the fan
+          spinning with messages coming in, frame rate and SPI2 sharing
+    At the end the display RAM has to match the display module frame
+    buffer. It prints the measured latencies and statistics, then "passed"
+    or the first failed check.
+
+    Latencies are measured in RTOS ticks, like the modules see them. The
+    POSIX port runs the tick from a host timer, a loaded host delays the
+    tasks and the tick together and the limits still hold.
+
+    Build and run, from this directory, with FREERTOS_KERNEL pointing to a
+    FreeRTOS-Kernel V10.4 or later source tree (any POSIX shell):
+        K=$FREERTOS_KERNEL
+        P=$K/portable/ThirdParty/GCC/Posix
+        H=../../../../home_automation
+        gcc -O2 -pthread -I. -I$K/include -I$P -I$P/utils \
+            -I../../../../mikroe/Weather -I../../../../mikroe/OLED_C -I../../../../mikroe/Rotary \
+            -o home_sim home_sim.c sim_weather.c sim_rotary.c sim_oled.c sim_mqtt.c \
+            $H/module_common.c $H/module_bus.c $H/module_json.c \
+            $H/remote_hvac/aws_remote_hvac.c $H/remote_hvac/module_display.c \
+            $H/remote_hvac/module_display_resources.c $H/remote_hvac/module_hvac.c \
+            $H/remote_hvac/module_sensor.c $H/remote_hvac/module_thermostat.c \
+            $K/tasks.c $K/queue.c $K/list.c $K/portable/MemMang/heap_3.c \
+            $P/port.c $P/utils/wait_for_event.c
+        ./home_sim [-v] [-p screen.ppm]
+
+    The click driver sources are included by the sim_*.c files and are not
+    built on their own. -v prints the module logs, -p writes the final
+    display content as a PPM image.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+#include <time.h>
+
+#include "system_config.h"
+#include "system_definitions.h"
+#include "queue.h"
+#include "semphr.h"
+#include "home_sim.h"
+#include "aws_clientcredential.h"
+
+#include "../../../../home_automation/module_common.h"
+#include "../../../../home_automation/module_bus.h"
+#include "../../../../home_automation/aws_home_automation_demo.h"
+#include "../../../../home_automation/remote_hvac/module_display.h"
+#include "../../../../home_automation/remote_hvac/module_display_ui_setup.h"
+#include "../../../../home_automation/remote_hvac/module_thermostat.h"
+#include "../../../../home_automation/remote_hvac/module_hvac.h"
+#include "../../../../mikroe/OLED_C/click_oled_c.h"
+
+#define SIM_TASK_PRIORITY           (configMAX_PRIORITIES - 1)
+#define SIM_TASK_STACK_SIZE         8192
+
+#define SIM_CONFIG_TOPIC            "thermostats/" clientcredentialIOT_THING_NAME "/config"
+#define SIM_STATUS_TOPIC            "thermostats/" clientcredentialIOT_THING_NAME "/status"
+#define SIM_SHADOW_TOPIC            "$aws/things/" clientcredentialIOT_THING_NAME "/shadow/update"
+
+// upper bounds of the control latencies
+#define SIM_DISPLAY_LATENCY_MS      200
+#define SIM_SHADOW_LATENCY_MS       (CONNECTOR_COALESCE_WINDOW + 1000)
+
+#define SIM_TEMPERATURE_TOLERANCE   0.1
+#define SIM_HUMIDITY_TOLERANCE      0.5
+#define SIM_TARGET_TOLERANCE        0.05
+
+#define SIM_BURST_MESSAGES          50
+#define SIM_BURST_PERIOD_MS         2
+#define SIM_FAN_RUN_MS              2000
+#define SIM_FAN_MESSAGE_PERIOD_MS   100
+
+// display regions of the values
+#define SIM_REGION_TEM_CUR          UI_TEM_CUR_VAL_XOFF, UI_TEM_CUR_VAL_YOFF, UI_TEM_CUR_VAL_W, UI_TEM_CUR_VAL_H
+#define SIM_REGION_TEM_TAR          UI_TEM_TAR_VAL_XOFF, UI_TEM_TAR_VAL_YOFF, UI_TEM_TAR_VAL_W, UI_TEM_TAR_VAL_H
+
+// module data, not exported by the module headers
+extern DISPLAY_DATA     displayData;
+extern THERMOSTAT_DATA  thermostatData;
+
+SIM_SPI_BUS     simSpi1 = { "SPI1", DRV_SPI_BAUD_RATE_IDX1 };
+SIM_SPI_BUS     simSpi2 = { "SPI2", DRV_SPI_BAUD_RATE_IDX0 };
+
+static volatile int simButtons[3];
+static bool         simVerbose;
+static const char*  simPpmPath;
+
+// core timer of the driver statistics, only printed, never checked
+uint32_t _CP0_GET_COUNT(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec) / (1000000000 / (SYS_CLK_FREQ / 2)));
+}
+
+uint32_t SIM_SpiTransfer(SIM_SPI_BUS* pBus, uint32_t nBytes)
+{
+    uint32_t ns = (uint32_t)((uint64_t)nBytes * 8 * 1000000000 / pBus->baud);
+    uint32_t tickNs = portTICK_PERIOD_MS * 1000000;
+    uint32_t ticks;
+
+    pBus->bytes += nBytes;
+    pBus->busyNs += ns;
+    pBus->carryNs += ns;
+
+    // the transferring task is delayed once the bus time adds up to a tick
+    if(pBus->carryNs >= tickNs)
+    {
+        ticks = pBus->carryNs / tickNs;
+        pBus->carryNs -= ticks * tickNs;
+        vTaskDelay(ticks);
+    }
+
+    return ns;
+}
+
+int SIM_ButtonGet(int button)
+{
+    return simButtons[button];
+}
+
+void SIM_ButtonSet(int button, int pressed)
+{
+    simButtons[button] = pressed;
+}
+
+void vAssertCalled(const char * pcFile, uint32_t ulLine)
+{
+    printf("FAIL assert: %s:%u\n", pcFile, (unsigned)ulLine);
+    exit(1);
+}
+
+void vLoggingPrintf(const char * pcFormat, ...)
+{
+    va_list args;
+
+    if(!simVerbose)
+    {
+        return;
+    }
+
+    va_start(args, pcFormat);
+    vprintf(pcFormat, args);
+    va_end(args);
+}
+
+static void _SimFail(const char* what, const char* detail)
+{
+    printf("FAIL %s: %s\n", what, detail);
+    exit(1);
+}
+
+// Rotary click stick, its INT line handler calls both modules
+static void _SimPress(void)
+{
+    THERMOSTAT_ISR_Handler();
+    DISPLAY_ISR_Handler();
+}
+
+static void _SimInjectf(const char* format, ...)
+{
+    char payload[SIM_MQTT_PAYLOAD_MAX];
+    va_list args;
+
+    va_start(args, format);
+    vsnprintf(payload, sizeof(payload), format, args);
+    va_end(args);
+
+    SIM_MqttInject(SIM_CONFIG_TOPIC, payload);
+}
+
+// value of a "KEY":"x.x" field of the record
+static bool _SimField(const SIM_MQTT_RECORD* pRec, const char* key, double* pValue)
+{
+    char pattern[32];
+    const char* p;
+
+    sprintf(pattern, "\"%s\":\"", key);
+    p = strstr(pRec->payload, pattern);
+    if(p == NULL)
+    {
+        return false;
+    }
+
+    *pValue = atof(p + strlen(pattern));
+    return true;
+}
+
+static uint32_t _SimMs(TickType_t from, TickType_t to)
+{
+    return (uint32_t)((to - from) * portTICK_PERIOD_MS);
+}
+
+static void _SimWaitStartup(void)
+{
+    SIM_MQTT_RECORD rec;
+    uint32_t mark = 0;
+    int waited;
+
+    if(!SIM_MqttWaitSubscribed(SIM_CONFIG_TOPIC, 15000))
+    {
+        _SimFail("startup", "no subscription to the config topic");
+    }
+
+    for(waited = 0; displayData.state != MODULE_STATE_ACTIVE; waited += 10)
+    {
+        if(waited > 15000)
+        {
+            _SimFail("startup", "display not active");
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    // first sample is taken after the sensor settles
+    if(!SIM_MqttWaitPublish(&mark, SIM_STATUS_TOPIC, "SENSOR_T", 15000, &rec))
+    {
+        _SimFail("startup", "no status published");
+    }
+    printf("startup: first status after %u ms\n", (unsigned)(xTaskGetTickCount() * portTICK_PERIOD_MS));
+}
+
+static void _SimControl(void)
+{
+    SIM_MQTT_RECORD rec;
+    char detail[128];
+    char pattern[32];
+    uint32_t dispMax = 0, shadowMax = 0, dispSum = 0, shadowSum = 0;
+    uint32_t hash, mark, dispMs, shadowMs;
+    TickType_t start, shown;
+    double target;
+    int ix;
+
+    for(ix = 0; ix < 10; ix++)
+    {
+        target = 20.0 + ix * 0.5;
+        hash = SIM_OledRegionHash(SIM_REGION_TEM_TAR);
+        mark = SIM_MqttMark();
+        start = xTaskGetTickCount();
+        _SimInjectf("{\"TARGET_T\":\"%.1f\"}", target);
+
+        if(!SIM_OledWaitRegion(SIM_REGION_TEM_TAR, hash, 1000, &shown))
+        {
+            sprintf(detail, "target %.1f not displayed", target);
+            _SimFail("control", detail);
+        }
+
+        sprintf(pattern, "\"TARGET_T\":\"%.1f\"", target);
+        if(!SIM_MqttWaitPublish(&mark, SIM_SHADOW_TOPIC, pattern, 2000, &rec))
+        {
+            sprintf(detail, "target %.1f not in a shadow update", target);
+            _SimFail("control", detail);
+        }
+
+        dispMs = _SimMs(start, shown);
+        shadowMs = _SimMs(start, rec.tick);
+        dispSum += dispMs;
+        shadowSum += shadowMs;
+        dispMax = dispMs > dispMax ? dispMs : dispMax;
+        shadowMax = shadowMs > shadowMax ? shadowMs : shadowMax;
+    }
+
+    printf("control: target to display avg %u ms max %u ms, to shadow avg %u ms max %u ms\n",
+           (unsigned)(dispSum / 10), (unsigned)dispMax, (unsigned)(shadowSum / 10), (unsigned)shadowMax);
+    if(dispMax > SIM_DISPLAY_LATENCY_MS || shadowMax > SIM_SHADOW_LATENCY_MS)
+    {
+        sprintf(detail, "latency %u / %u ms, limits %u / %u ms", (unsigned)dispMax, (unsigned)shadowMax,
+                SIM_DISPLAY_LATENCY_MS, SIM_SHADOW_LATENCY_MS);
+        _SimFail("control", detail);
+    }
+
+    mark = SIM_MqttMark();
+    start = xTaskGetTickCount();
+    _SimInjectf("{\"FAN\":\"high\"}");
+    if(!SIM_MqttWaitPublish(&mark, SIM_SHADOW_TOPIC, "\"FAN\":\"high\"", 2000, &rec))
+    {
+        _SimFail("control", "fan high not in a shadow update");
+    }
+    printf("control: fan to shadow %u ms\n", (unsigned)_SimMs(start, rec.tick));
+
+    _SimInjectf("{\"FAN\":\"off\"}");
+    if(!SIM_MqttWaitPublish(&mark, SIM_SHADOW_TOPIC, "\"FAN\":\"off\"", 2000, &rec))
+    {
+        _SimFail("control", "fan off not in a shadow update");
+    }
+}
+
+static void _SimTelemetry(void)
+{
+    static const double steps[2][2] = { { 21.7, 48.0 }, { -5.2, 30.0 } };
+    SIM_MQTT_RECORD rec;
+    char detail[SIM_MQTT_PAYLOAD_MAX + 64];
+    uint32_t hash, mark;
+    TickType_t read, shown;
+    double t, h;
+    int ix;
+
+    for(ix = 0; ix < 2; ix++)
+    {
+        hash = SIM_OledRegionHash(SIM_REGION_TEM_CUR);
+        SIM_WeatherSet(steps[ix][0], steps[ix][1], 1013.25);
+
+        if(!SIM_WeatherWaitRead(SENSOR_TASK_DELAY + 1000, &read))
+        {
+            _SimFail("telemetry", "sensor not read");
+        }
+        mark = SIM_MqttMark();
+
+        if(!SIM_OledWaitRegion(SIM_REGION_TEM_CUR, hash, 1000, &shown))
+        {
+            sprintf(detail, "temperature %.1f not displayed", steps[ix][0]);
+            _SimFail("telemetry", detail);
+        }
+
+        if(!SIM_MqttWaitPublish(&mark, SIM_STATUS_TOPIC, "SENSOR_T", 2000, &rec))
+        {
+            _SimFail("telemetry", "no status published");
+        }
+        if(!_SimField(&rec, "SENSOR_T", &t) || !_SimField(&rec, "SENSOR_H", &h) ||
+           fabs(t - steps[ix][0]) > SIM_TEMPERATURE_TOLERANCE ||
+           fabs(h - steps[ix][1]) > SIM_HUMIDITY_TOLERANCE)
+        {
+            sprintf(detail, "published %s, expected %.1f C %.1f %%", rec.payload, steps[ix][0], steps[ix][1]);
+            _SimFail("telemetry", detail);
+        }
+
+        printf("telemetry: %.1f C %.1f %% read to display %u ms, to status %u ms\n",
+               t, h, (unsigned)_SimMs(read, shown), (unsigned)_SimMs(read, rec.tick));
+    }
+}
+
+static void _SimCheckRing(const char* what, uint16_t expected, bool enabled)
+{
+    char detail[128];
+    bool isEnabled;
+    uint16_t ring = SIM_RotaryLedRing(&isEnabled);
+
+    if(ring != expected || isEnabled != enabled)
+    {
+        sprintf(detail, "%s: LED ring 0x%04x %s, expected 0x%04x %s", what, ring, isEnabled ? "on" : "off",
+                expected, enabled ? "on" : "off");
+        _SimFail("thermostat", detail);
+    }
+}
+
+static void _SimThermostatRound(int detents, uint16_t ring)
+{
+    SIM_MQTT_RECORD rec;
+    char detail[128];
+    uint32_t hash, mark;
+    TickType_t start, shown;
+    double target, expected;
+
+    _SimPress();
+    vTaskDelay(pdMS_TO_TICKS(20));
+    if(thermostatData.state != MODULE_STATE_ACTIVE)
+    {
+        _SimFail("thermostat", "not active after a stick press");
+    }
+    _SimCheckRing("active", 0x0001, true);
+
+    expected = HVAC_GetTargetTemperature() + detents * 0.8;
+    SIM_RotaryTurn(detents);
+    vTaskDelay(pdMS_TO_TICKS(10));
+    _SimCheckRing("turned", ring, true);
+
+    hash = SIM_OledRegionHash(SIM_REGION_TEM_TAR);
+    mark = SIM_MqttMark();
+    start = xTaskGetTickCount();
+    _SimPress();
+
+    if(!SIM_OledWaitRegion(SIM_REGION_TEM_TAR, hash, 1000, &shown))
+    {
+        _SimFail("thermostat", "target not displayed");
+    }
+    if(!SIM_MqttWaitPublish(&mark, SIM_SHADOW_TOPIC, "TARGET_T", 2000, &rec) ||
+       !_SimField(&rec, "TARGET_T", &target))
+    {
+        _SimFail("thermostat", "target not in a shadow update");
+    }
+    if(fabs(target - expected) > SIM_TARGET_TOLERANCE)
+    {
+        sprintf(detail, "%d detents: target %.1f, expected %.1f", detents, target, expected);
+        _SimFail("thermostat", detail);
+    }
+    if(thermostatData.state != MODULE_STATE_INACTIVE)
+    {
+        _SimFail("thermostat", "not inactive after a stick press");
+    }
+    _SimCheckRing("inactive", 0x0000, false);
+
+    printf("thermostat: %+d detents, target %.1f to display %u ms, to shadow %u ms\n",
+           detents, target, (unsigned)_SimMs(start, shown), (unsigned)_SimMs(start, rec.tick));
+}
+
+static void _SimThermostat(void)
+{
+    // 4 encoder edges per detent, 0.2 C each, two edges per LED
+    _SimThermostatRound(3, 0x007F);
+    _SimThermostatRound(-5, 0xFFC1);
+}
+
+static void _SimFanButton(void)
+{
+    SIM_MQTT_RECORD rec;
+    char pattern[32];
+    uint32_t mark;
+    TickType_t start;
+    FAN_STATE next = (FAN_STATE)((HVAC_GetFanState() + 1) % 3);
+
+    mark = SIM_MqttMark();
+    SIM_ButtonSet(2, 1);
+    vTaskDelay(pdMS_TO_TICKS(60));
+    start = xTaskGetTickCount();
+    SIM_ButtonSet(2, 0);
+
+    sprintf(pattern, "\"FAN\":\"%s\"", FAN_STATE_STRING[next]);
+    if(!SIM_MqttWaitPublish(&mark, SIM_SHADOW_TOPIC, pattern, 2000, &rec))
+    {
+        _SimFail("fan button", "fan change not in a shadow update");
+    }
+    printf("fan button: fan %s, release to shadow %u ms\n", FAN_STATE_STRING[next],
+           (unsigned)_SimMs(start, rec.tick));
+}
+
+static void _SimBus(void)
+{
+    if(!BUS_Acquire(BUS_CLIENT_WIFI, pdMS_TO_TICKS(1000)))
+    {
+        _SimFail("bus", "WiFi can't acquire the bus");
+    }
+    if(BUS_Release(BUS_CLIENT_DISPLAY) || BUS_Yield(BUS_CLIENT_DISPLAY, 0))
+    {
+        _SimFail("bus", "display released or yielded the bus held by WiFi");
+    }
+    if(!BUS_Release(BUS_CLIENT_WIFI))
+    {
+        _SimFail("bus", "WiFi can't release the bus");
+    }
+    if(BUS_Release(BUS_CLIENT_WIFI))
+    {
+        _SimFail("bus", "WiFi released the bus twice");
+    }
+    printf("bus: release and yield by other clients rejected\n");
+}
+
+static void _SimThroughput(void)
+{
+    SIM_MQTT_RECORD rec;
+    char detail[128];
+    xParseStats parse0, parse1;
+    xCoalescerStats coal0, coal1;
+    T_OLEDC_STATS oled0, oled1;
+    BUS_STATS wifi, display;
+    uint64_t busy0, bytes0;
+    TickType_t start;
+    uint32_t elapsedMs;
+    uint32_t mark;
+    int ix;
+
+    vGetParseStats(&parse0);
+    vGetCoalescerStats(&coal0);
+    mark = SIM_MqttMark();
+    start = xTaskGetTickCount();
+    for(ix = 0; ix < SIM_BURST_MESSAGES; ix++)
+    {
+        _SimInjectf("{\"TARGET_T\":\"%.1f\"}", 15.0 + ix * 0.1);
+        vTaskDelay(pdMS_TO_TICKS(SIM_BURST_PERIOD_MS));
+    }
+    // rate at which the connector takes the messages in
+    for(ix = 0; ix < 1000; ix++)
+    {
+        vGetParseStats(&parse1);
+        if(parse1.ulMessages - parse0.ulMessages >= SIM_BURST_MESSAGES)
+        {
+            break;
+        }
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+    elapsedMs = _SimMs(start, xTaskGetTickCount());
+
+    if(!SIM_MqttWaitPublish(&mark, SIM_SHADOW_TOPIC, "\"TARGET_T\":\"19.9\"", 3000, &rec))
+    {
+        _SimFail("throughput", "last target not in a shadow update");
+    }
+    vGetParseStats(&parse1);
+    vGetCoalescerStats(&coal1);
+
+    if(parse1.ulMessages - parse0.ulMessages != SIM_BURST_MESSAGES || parse1.ulErrors != parse0.ulErrors)
+    {
+        sprintf(detail, "%u messages parsed, %u errors, expected %u",
+                (unsigned)(parse1.ulMessages - parse0.ulMessages),
+                (unsigned)(parse1.ulErrors - parse0.ulErrors), SIM_BURST_MESSAGES);
+        _SimFail("throughput", detail);
+    }
+    if(fabs(HVAC_GetTargetTemperature() - 19.9) > SIM_TARGET_TOLERANCE)
+    {
+        sprintf(detail, "HVAC target %.1f, expected 19.9", HVAC_GetTargetTemperature());
+        _SimFail("throughput", detail);
+    }
+    printf("throughput: %u messages in %u ms, %u msg/s, parse avg %u us max %u us, "
+           "%u changes in %u publishes\n",
+           SIM_BURST_MESSAGES, (unsigned)elapsedMs,
+           (unsigned)(SIM_BURST_MESSAGES * 1000u / (elapsedMs ? elapsedMs : 1)),
+           (unsigned)((parse1.ulTotalUs - parse0.ulTotalUs) / SIM_BURST_MESSAGES), (unsigned)parse1.ulMaxUs,
+           (unsigned)(coal1.ulChanges - coal0.ulChanges), (unsigned)(coal1.ulPublishes - coal0.ulPublishes));
+
+    // spinning fan redraws the display while messages keep coming
+    oledc_get_stats(&oled0);
+    busy0 = simSpi2.busyNs;
+    bytes0 = simSpi2.bytes;
+    _SimInjectf("{\"FAN\":\"high\"}");
+    for(ix = 0; ix < SIM_FAN_RUN_MS / SIM_FAN_MESSAGE_PERIOD_MS; ix++)
+    {
+        vTaskDelay(pdMS_TO_TICKS(SIM_FAN_MESSAGE_PERIOD_MS));
+        _SimInjectf("{\"TARGET_T\":\"%.1f\"}", 20.0 + (ix & 1));
+    }
+    oledc_get_stats(&oled1);
+    BUS_GetStats(BUS_CLIENT_WIFI, &wifi);
+    BUS_GetStats(BUS_CLIENT_DISPLAY, &display);
+
+    printf("throughput: fan high, %u fps, %u bytes/s, bus hold max %u us, %u updates cut by yields\n",
+           (unsigned)((oled1.frames - oled0.frames) * 1000 / SIM_FAN_RUN_MS),
+           (unsigned)((oled1.bytes_total - oled0.bytes_total) * 1000ull / SIM_FAN_RUN_MS),
+           (unsigned)oled1.bus_hold_max_us, (unsigned)(oled1.bus_lost - oled0.bus_lost));
+    printf("throughput: SPI2 %u%% busy, %u bytes/s\n",
+           (unsigned)((simSpi2.busyNs - busy0) / (SIM_FAN_RUN_MS * 10000ull)),
+           (unsigned)((simSpi2.bytes - bytes0) * 1000 / SIM_FAN_RUN_MS));
+    printf("throughput: bus wifi %u acquired %u timeouts wait max %u us, "
+           "display %u acquired %u timeouts %u yields wait max %u us\n",
+           (unsigned)wifi.acquired, (unsigned)wifi.timeouts, (unsigned)wifi.wait_max_us,
+           (unsigned)display.acquired, (unsigned)display.timeouts, (unsigned)display.yields,
+           (unsigned)display.wait_max_us);
+    if(oled1.errors != oled0.errors)
+    {
+        sprintf(detail, "%u frame transfers failed", (unsigned)(oled1.errors - oled0.errors));
+        _SimFail("throughput", detail);
+    }
+
+    mark = SIM_MqttMark();
+    _SimInjectf("{\"FAN\":\"off\"}");
+    if(!SIM_MqttWaitPublish(&mark, SIM_SHADOW_TOPIC, "\"FAN\":\"off\"", 2000, &rec))
+    {
+        _SimFail("throughput", "fan off not in a shadow update");
+    }
+}
+
+static void _SimTask(void* pvParameters)
+{
+    char detail[128];
+
+    _SimWaitStartup();
+    _SimControl();
+    _SimTelemetry();
+    _SimThermostat();
+    _SimFanButton();
+    _SimBus();
+    _SimThroughput();
+
+    if(!SIM_OledCheck())
+    {
+        _SimFail("display", "display RAM differs from the frame buffer");
+    }
+    if(SIM_OledErrors() != 0)
+    {
+        sprintf(detail, "%u bytes sent to the OLED C click while not selected", (unsigned)SIM_OledErrors());
+        _SimFail("display", detail);
+    }
+    if(simPpmPath && !SIM_OledDump(simPpmPath))
+    {
+        _SimFail("display", "can't write the screen image");
+    }
+
+    printf("passed\n");
+    exit(0);
+}
+
+int main(int argc, char* argv[])
+{
+    int ix;
+
+    for(ix = 1; ix < argc; ix++)
+    {
+        if(strcmp(argv[ix], "-v") == 0)
+        {
+            simVerbose = true;
+        }
+        else if(strcmp(argv[ix], "-p") == 0 && ix + 1 < argc)
+        {
+            simPpmPath = argv[++ix];
+        }
+        else
+        {
+            printf("usage: %s [-v] [-p screen.ppm]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    SIM_WeatherInitialize();
+    SIM_RotaryInitialize();
+    SIM_OledInitialize();
+    SIM_WeatherSet(23.4, 45.0, 1013.25);
+
+    MODULES_Initialize();
+    vStartRemoteHVACDemo();
+    SIM_MqttInitialize();
+
+    xTaskCreate(_SimTask, "Sim", SIM_TASK_STACK_SIZE, NULL, SIM_TASK_PRIORITY, NULL);
+    vTaskStartScheduler();
+
+    return 1;
+}
@@ -0,0 +1,92 @@
+/*******************************************************************************
+  Home Automation Simulation
+
+  File Name:
+    home_sim.h
+
+  Summary:
+    Simulated click boards, buses and MQTT broker of the home_sim target.
+
+  Description:
+    SPI transfers take the time the bytes need at the configured baud rate.
+    The time is accounted per bus and the transferring task is delayed by it
+    in whole ticks, so bus contention and frame times follow the board.
+
+    The SIM_* functions are called from the simulation task. It runs at the
+    highest priority, so its calls of the module ISR handlers and its reads
+    of the simulated devices are not interleaved with the module tasks.
+*******************************************************************************/
+
+#ifndef _HOME_SIM_H
+#define _HOME_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "FreeRTOS.h"
+
+// simulated network round trip to the broker
+#define SIM_MQTT_RTT_MS                 20
+
+// bytes the WILC1000 moves over SPI2 per MQTT packet on top of the payload
+#define SIM_MQTT_PACKET_OVERHEAD        96
+
+// encoder line change period while the Rotary click is turned
+#define SIM_ROTARY_EDGE_MS              5
+
+#define SIM_MQTT_TOPIC_MAX              64
+#define SIM_MQTT_PAYLOAD_MAX            256
+
+typedef struct
+{
+    const char* name;
+    uint32_t    baud;
+    uint64_t    bytes;
+    uint64_t    busyNs;     // modeled transfer time
+    uint32_t    carryNs;    // transfer time not delayed yet, below one tick
+}SIM_SPI_BUS;
+
+// message received by the broker
+typedef struct
+{
+    TickType_t  tick;       // broker receive tick
+    char        topic[SIM_MQTT_TOPIC_MAX];
+    char        payload[SIM_MQTT_PAYLOAD_MAX];
+}SIM_MQTT_RECORD;
+
+// SPI1: Rotary and Weather clicks, SPI2: OLED C click and WILC1000
+extern SIM_SPI_BUS  simSpi1;
+extern SIM_SPI_BUS  simSpi2;
+
+// home_sim.c
+uint32_t    SIM_SpiTransfer(SIM_SPI_BUS* pBus, uint32_t nBytes);
+void        SIM_ButtonSet(int button, int pressed);
+
+// sim_weather.c, BME280 register model
+void        SIM_WeatherInitialize(void);
+void        SIM_WeatherSet(double temperature, double humidity, double pressure);
+bool        SIM_WeatherWaitRead(uint32_t timeoutMs, TickType_t* pRead);
+
+// sim_rotary.c, LED ring shift registers and encoder lines
+void        SIM_RotaryInitialize(void);
+void        SIM_RotaryTurn(int detents);
+uint16_t    SIM_RotaryLedRing(bool* pEnabled);
+
+// sim_oled.c, SSD1351 controller
+void        SIM_OledInitialize(void);
+uint32_t    SIM_OledRegionHash(int x, int y, int w, int h);
+bool        SIM_OledWaitRegion(int x, int y, int w, int h, uint32_t oldHash, uint32_t timeoutMs,
+                               TickType_t* pShown);
+bool        SIM_OledCheck(void);
+uint32_t    SIM_OledErrors(void);
+bool        SIM_OledDump(const char* path);
+
+// sim_mqtt.c, WILC1000 and broker
+void        SIM_MqttInitialize(void);
+bool        SIM_MqttWaitSubscribed(const char* topic, uint32_t timeoutMs);
+void        SIM_MqttInject(const char* topic, const char* payload);
+uint32_t    SIM_MqttMark(void);
+bool        SIM_MqttWaitPublish(uint32_t* pFrom, const char* topic, const char* pattern,
+                                uint32_t timeoutMs, SIM_MQTT_RECORD* pRec);
+
+#endif // _HOME_SIM_H
@@ -0,0 +1,21 @@
+/*******************************************************************************
+  Home Automation Simulation Logging
+
+  File Name:
+    iot_logging_task.h
+
+  Summary:
+    Logging interface used by the home automation modules.
+
+  Description:
+    vLoggingPrintf is implemented by home_sim.c, it prints only when the
+    simulation runs with -v.
+*******************************************************************************/
+
+#ifndef AWS_LOGGING_TASK_H
+#define AWS_LOGGING_TASK_H
+
+void vLoggingPrintf( const char * pcFormat,
+                     ... );
+
+#endif /* AWS_LOGGING_TASK_H */
@@ -0,0 +1,113 @@
+/*******************************************************************************
+  Home Automation Simulation MQTT Agent
+
+  File Name:
+    iot_mqtt_agent.h
+
+  Summary:
+    The part of the MQTT agent interface used by aws_remote_hvac.c.
+
+  Description:
+    Types and calls follow the Amazon FreeRTOS V1.4 MQTT agent. They are
+    implemented by sim_mqtt.c on top of the mock broker; calls block the
+    caller until the broker acknowledges or the timeout expires, publish
+    callbacks run in the agent task like on the target.
+*******************************************************************************/
+
+#ifndef _AWS_MQTT_AGENT_H_
+#define _AWS_MQTT_AGENT_H_
+
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+
+#define mqttagentURL_IS_IP_ADDRESS          0x00000001
+#define mqttagentREQUIRE_TLS                0x00000002
+#define mqttagentUSE_AWS_IOT_ALPN_443       0x00000004
+
+typedef void * MQTTAgentHandle_t;
+
+typedef enum
+{
+    eMQTTFalse = 0,
+    eMQTTTrue = 1
+} MQTTBool_t;
+
+typedef enum
+{
+    eMQTTQoS0 = 0,
+    eMQTTQoS1 = 1,
+    eMQTTQoS2 = 2
+} MQTTQoS_t;
+
+typedef enum
+{
+    eMQTTAgentSuccess,
+    eMQTTAgentFailure,
+    eMQTTAgentTimeout,
+    eMQTTAgentAPICalledFromCallback
+} MQTTAgentReturnCode_t;
+
+typedef struct MQTTPublishData
+{
+    MQTTQoS_t xQos;
+    const uint8_t * pucTopic;
+    uint16_t usTopicLength;
+    const void * pvData;
+    uint32_t ulDataLength;
+} MQTTPublishData_t;
+
+typedef MQTTBool_t ( * MQTTPublishCallback_t )( void * pvPublishCallbackContext,
+                                                const MQTTPublishData_t * const pxPublishData );
+
+typedef MQTTBool_t ( * MQTTAgentCallback_t )( void * pvUserData,
+                                              const void * const pxCallbackParams );
+
+typedef struct MQTTAgentConnectParams
+{
+    const char * pcURL;
+    BaseType_t xFlags;
+    BaseType_t xURLIsIPAddress;
+    uint16_t usPort;
+    const uint8_t * pucClientId;
+    uint16_t usClientIdLength;
+    BaseType_t xSecuredConnection;
+    void * pvUserData;
+    MQTTAgentCallback_t pxCallback;
+    char * pcCertificate;
+    uint32_t ulCertificateSize;
+} MQTTAgentConnectParams_t;
+
+typedef struct MQTTAgentSubscribeParams
+{
+    const uint8_t * pucTopic;
+    uint16_t usTopicLength;
+    MQTTQoS_t xQoS;
+    void * pvPublishCallbackContext;
+    MQTTPublishCallback_t pxPublishCallback;
+} MQTTAgentSubscribeParams_t;
+
+typedef struct MQTTAgentPublishParams
+{
+    const uint8_t * pucTopic;
+    uint16_t usTopicLength;
+    MQTTQoS_t xQoS;
+    const void * pvData;
+    uint32_t ulDataLength;
+} MQTTAgentPublishParams_t;
+
+MQTTAgentReturnCode_t MQTT_AGENT_Create( MQTTAgentHandle_t * const pxMQTTHandle );
+MQTTAgentReturnCode_t MQTT_AGENT_Delete( MQTTAgentHandle_t xMQTTHandle );
+MQTTAgentReturnCode_t MQTT_AGENT_Connect( MQTTAgentHandle_t xMQTTHandle,
+                                          const MQTTAgentConnectParams_t * const pxConnectParams,
+                                          TickType_t xTimeoutTicks );
+MQTTAgentReturnCode_t MQTT_AGENT_Disconnect( MQTTAgentHandle_t xMQTTHandle,
+                                             TickType_t xTimeoutTicks );
+MQTTAgentReturnCode_t MQTT_AGENT_Subscribe( MQTTAgentHandle_t xMQTTHandle,
+                                            const MQTTAgentSubscribeParams_t * const pxSubscribeParams,
+                                            TickType_t xTimeoutTicks );
+MQTTAgentReturnCode_t MQTT_AGENT_Publish( MQTTAgentHandle_t xMQTTHandle,
+                                          const MQTTAgentPublishParams_t * const pxPublishParams,
+                                          TickType_t xTimeoutTicks );
+
+#endif /* _AWS_MQTT_AGENT_H_ */
@@ -0,0 +1,583 @@
+/*******************************************************************************
+  Home Automation Simulation MQTT Broker
+
+  File Name:
+    sim_mqtt.c
+
+  Summary:
+    MQTT agent, WILC1000 SPI traffic and a mock broker.
+
+  Description:
+    The agent runs in its own task like the Amazon FreeRTOS one. API calls
+    post a job to it and block until the broker acknowledges the job or the
+    timeout expires. Every packet the client sends or receives is moved
+    over SPI2 through the WDRV bus arbiter hook, so it competes with the
+    display for the bus like the WILC1000 does on the board.
+
+    The broker is one network round trip away. It receives a packet half a
+    round trip after the client sent it and its acknowledge arrives after a
+    full one. Messages injected by the simulation reach the subscribed
+    client half a round trip later, the publish callback runs in the agent
+    task. Topics are matched exactly, wildcards are not supported.
+
+    Every publish received by the broker is kept in a log the simulation
+    reads with SIM_MqttWaitPublish.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "system_config.h"
+#include "system_definitions.h"
+#include "queue.h"
+#include "semphr.h"
+#include "home_sim.h"
+#include "iot_mqtt_agent.h"
+#include "aws_iot_ota_agent.h"
+
+#define SIM_MQTT_AGENT_PRIORITY     2
+#define SIM_MQTT_AGENT_STACK_SIZE   8192
+#define SIM_MQTT_JOBS               8
+#define SIM_MQTT_EVENTS             32
+#define SIM_MQTT_SUBSCRIPTIONS      4
+#define SIM_MQTT_LOG_SIZE           64
+
+// TLS handshake: bytes moved and round trips taken by the connect
+#define SIM_MQTT_CONNECT_BYTES      4096
+#define SIM_MQTT_CONNECT_RTTS       3
+
+// WILC1000 driver bus timeout, see wdrv_wilc1000_spi.c
+#define SIM_MQTT_BUS_TIMEOUT_MS     500
+
+typedef enum
+{
+    SIM_MQTT_JOB_CONNECT,
+    SIM_MQTT_JOB_DISCONNECT,
+    SIM_MQTT_JOB_SUBSCRIBE,
+    SIM_MQTT_JOB_PUBLISH,
+    SIM_MQTT_JOB_INJECT,            // broker to client, from the simulation
+}SIM_MQTT_JOB_TYPE;
+
+typedef struct
+{
+    SIM_MQTT_JOB_TYPE       type;
+    uint32_t                seq;
+    MQTTPublishCallback_t   callback;
+    void*                   context;
+    char                    topic[SIM_MQTT_TOPIC_MAX];
+    char                    payload[SIM_MQTT_PAYLOAD_MAX];
+    uint32_t                length;
+}SIM_MQTT_JOB;
+
+typedef struct
+{
+    uint32_t                seq;
+    MQTTAgentReturnCode_t   code;
+}SIM_MQTT_RESULT;
+
+typedef enum
+{
+    SIM_MQTT_EVENT_FREE,
+    SIM_MQTT_EVENT_ACK,             // acknowledge reaches the client
+    SIM_MQTT_EVENT_DELIVER,         // publish reaches the client
+}SIM_MQTT_EVENT_TYPE;
+
+typedef struct
+{
+    SIM_MQTT_EVENT_TYPE     type;
+    TickType_t              due;
+    SIM_MQTT_JOB            job;
+}SIM_MQTT_EVENT;
+
+typedef struct
+{
+    char                    topic[SIM_MQTT_TOPIC_MAX];
+    MQTTPublishCallback_t   callback;
+    void*                   context;
+}SIM_MQTT_SUBSCRIPTION;
+
+static TaskHandle_t             simAgentTask;
+static QueueHandle_t            simJobQueue;
+static QueueHandle_t            simResultQueue;
+static uint32_t                 simSeq;
+
+static SIM_MQTT_EVENT           simEvents[SIM_MQTT_EVENTS];
+static SIM_MQTT_SUBSCRIPTION    simSubs[SIM_MQTT_SUBSCRIPTIONS];
+static int                      simNSubs;
+static bool                     simConnected;
+static uint32_t                 simErrors;
+
+static SIM_MQTT_RECORD          simLog[SIM_MQTT_LOG_SIZE];
+static volatile uint32_t        simLogCount;
+static SemaphoreHandle_t        simLogAdded;
+
+static WDRV_STUB_SPI_BUS_ACQUIRE simBusAcquire;
+static WDRV_STUB_SPI_BUS_RELEASE simBusRelease;
+
+static int                      simMqttHandle;
+
+void WDRV_STUB_SPI_BusArbiterSet(WDRV_STUB_SPI_BUS_ACQUIRE acquire, WDRV_STUB_SPI_BUS_RELEASE release)
+{
+    simBusAcquire = acquire;
+    simBusRelease = release;
+}
+
+// one WILC1000 packet transfer over SPI2
+static bool _SimMqttTransfer(uint32_t nBytes)
+{
+    if(simBusAcquire && !simBusAcquire(SIM_MQTT_BUS_TIMEOUT_MS))
+    {
+        simErrors++;
+        return false;
+    }
+
+    SIM_SpiTransfer(&simSpi2, nBytes + SIM_MQTT_PACKET_OVERHEAD);
+
+    if(simBusRelease)
+    {
+        simBusRelease();
+    }
+
+    return true;
+}
+
+static void _SimMqttSchedule(SIM_MQTT_EVENT_TYPE type, uint32_t delayMs, const SIM_MQTT_JOB* pJob)
+{
+    int ix;
+
+    for(ix = 0; ix < SIM_MQTT_EVENTS; ix++)
+    {
+        if(simEvents[ix].type == SIM_MQTT_EVENT_FREE)
+        {
+            simEvents[ix].type = type;
+            simEvents[ix].due = xTaskGetTickCount() + pdMS_TO_TICKS(delayMs);
+            simEvents[ix].job = *pJob;
+            return;
+        }
+    }
+
+    simErrors++;
+}
+
+static void _SimMqttLog(const SIM_MQTT_JOB* pJob)
+{
+    SIM_MQTT_RECORD* pRec = simLog + (simLogCount % SIM_MQTT_LOG_SIZE);
+
+    pRec->tick = xTaskGetTickCount() + pdMS_TO_TICKS(SIM_MQTT_RTT_MS / 2);
+    strcpy(pRec->topic, pJob->topic);
+    strcpy(pRec->payload, pJob->payload);
+    simLogCount++;
+    xSemaphoreGive(simLogAdded);
+}
+
+static void _SimMqttDeliver(const SIM_MQTT_JOB* pJob)
+{
+    MQTTPublishData_t data;
+    int ix;
+
+    for(ix = 0; ix < simNSubs; ix++)
+    {
+        if(strcmp(simSubs[ix].topic, pJob->topic) != 0)
+        {
+            continue;
+        }
+
+        if(!_SimMqttTransfer(pJob->length))
+        {
+            return;
+        }
+
+        data.xQos = eMQTTQoS1;
+        data.pucTopic = (const uint8_t*)pJob->topic;
+        data.usTopicLength = (uint16_t)strlen(pJob->topic);
+        data.pvData = pJob->payload;
+        data.ulDataLength = pJob->length;
+        simSubs[ix].callback(simSubs[ix].context, &data);
+        return;
+    }
+}
+
+static void _SimMqttJob(const SIM_MQTT_JOB* pJob)
+{
+    switch(pJob->type)
+    {
+        case SIM_MQTT_JOB_CONNECT:
+            if(!_SimMqttTransfer(SIM_MQTT_CONNECT_BYTES))
+            {
+                break;
+            }
+            simConnected = true;
+            _SimMqttSchedule(SIM_MQTT_EVENT_ACK, SIM_MQTT_CONNECT_RTTS * SIM_MQTT_RTT_MS, pJob);
+            break;
+
+        case SIM_MQTT_JOB_DISCONNECT:
+            simConnected = false;
+            simNSubs = 0;
+            _SimMqttSchedule(SIM_MQTT_EVENT_ACK, 0, pJob);
+            break;
+
+        case SIM_MQTT_JOB_SUBSCRIBE:
+            if(!_SimMqttTransfer(strlen(pJob->topic)))
+            {
+                break;
+            }
+            if(simNSubs < SIM_MQTT_SUBSCRIPTIONS)
+            {
+                strcpy(simSubs[simNSubs].topic, pJob->topic);
+                simSubs[simNSubs].callback = pJob->callback;
+                simSubs[simNSubs].context = pJob->context;
+                simNSubs++;
+            }
+            _SimMqttSchedule(SIM_MQTT_EVENT_ACK, SIM_MQTT_RTT_MS, pJob);
+            break;
+
+        case SIM_MQTT_JOB_PUBLISH:
+            if(!_SimMqttTransfer(strlen(pJob->topic) + pJob->length))
+            {
+                break;
+            }
+            _SimMqttLog(pJob);
+            _SimMqttSchedule(SIM_MQTT_EVENT_ACK, SIM_MQTT_RTT_MS, pJob);
+            break;
+
+        case SIM_MQTT_JOB_INJECT:
+            _SimMqttSchedule(SIM_MQTT_EVENT_DELIVER, SIM_MQTT_RTT_MS / 2, pJob);
+            break;
+    }
+}
+
+static TickType_t _SimMqttNextWait(void)
+{
+    TickType_t now = xTaskGetTickCount();
+    TickType_t wait = portMAX_DELAY;
+    int ix;
+
+    for(ix = 0; ix < SIM_MQTT_EVENTS; ix++)
+    {
+        if(simEvents[ix].type == SIM_MQTT_EVENT_FREE)
+        {
+            continue;
+        }
+        if((TickType_t)(simEvents[ix].due - now) > (TickType_t)(portMAX_DELAY / 2))
+        {   // overdue
+            return 0;
+        }
+        if(simEvents[ix].due - now < wait)
+        {
+            wait = simEvents[ix].due - now;
+        }
+    }
+
+    return wait;
+}
+
+static void _SimMqttRunDue(void)
+{
+    SIM_MQTT_RESULT result;
+    SIM_MQTT_EVENT* pEvent;
+    TickType_t now;
+    int ix;
+
+    // in due order, deliveries reach the client in the order they were sent
+    while(true)
+    {
+        now = xTaskGetTickCount();
+        pEvent = NULL;
+        for(ix = 0; ix < SIM_MQTT_EVENTS; ix++)
+        {
+            if(simEvents[ix].type == SIM_MQTT_EVENT_FREE ||
+               (TickType_t)(now - simEvents[ix].due) > (TickType_t)(portMAX_DELAY / 2))
+            {
+                continue;
+            }
+            if(pEvent == NULL || (TickType_t)(simEvents[ix].due - pEvent->due) > (TickType_t)(portMAX_DELAY / 2))
+            {
+                pEvent = simEvents + ix;
+            }
+        }
+        if(pEvent == NULL)
+        {
+            return;
+        }
+
+        if(pEvent->type == SIM_MQTT_EVENT_ACK)
+        {
+            result.seq = pEvent->job.seq;
+            result.code = eMQTTAgentSuccess;
+            xQueueSendToBack(simResultQueue, &result, 0);
+        }
+        else
+        {
+            _SimMqttDeliver(&pEvent->job);
+        }
+        pEvent->type = SIM_MQTT_EVENT_FREE;
+    }
+}
+
+static void _SimMqttAgentTask(void* pvParameters)
+{
+    static SIM_MQTT_JOB job;
+
+    for( ; ; )
+    {
+        if(xQueueReceive(simJobQueue, &job, _SimMqttNextWait()) == pdTRUE)
+        {
+            _SimMqttJob(&job);
+        }
+        _SimMqttRunDue();
+    }
+}
+
+void SIM_MqttInitialize(void)
+{
+    simJobQueue = xQueueCreate(SIM_MQTT_JOBS, sizeof(SIM_MQTT_JOB));
+    simResultQueue = xQueueCreate(SIM_MQTT_JOBS, sizeof(SIM_MQTT_RESULT));
+    simLogAdded = xSemaphoreCreateBinary();
+
+    xTaskCreate(_SimMqttAgentTask, "MQTT", SIM_MQTT_AGENT_STACK_SIZE, NULL,
+                SIM_MQTT_AGENT_PRIORITY, &simAgentTask);
+}
+
+// posts the job to the agent and waits for its acknowledge
+static MQTTAgentReturnCode_t _SimMqttCall(SIM_MQTT_JOB* pJob, TickType_t timeout)
+{
+    SIM_MQTT_RESULT result;
+    TickType_t start = xTaskGetTickCount();
+    TickType_t waited;
+
+    if(xTaskGetCurrentTaskHandle() == simAgentTask)
+    {
+        return eMQTTAgentAPICalledFromCallback;
+    }
+
+    pJob->seq = ++simSeq;
+    if(xQueueSendToBack(simJobQueue, pJob, timeout) != pdTRUE)
+    {
+        return eMQTTAgentTimeout;
+    }
+
+    while(true)
+    {
+        waited = xTaskGetTickCount() - start;
+        if(waited >= timeout ||
+           xQueueReceive(simResultQueue, &result, timeout - waited) != pdTRUE)
+        {
+            return eMQTTAgentTimeout;
+        }
+        // results of calls which timed out earlier are dropped
+        if(result.seq == pJob->seq)
+        {
+            return result.code;
+        }
+    }
+}
+
+static void _SimMqttCopy(char* pDst, size_t size, const void* pSrc, size_t length)
+{
+    if(length > size - 1)
+    {
+        length = size - 1;
+    }
+    memcpy(pDst, pSrc, length);
+    pDst[length] = 0;
+}
+
+MQTTAgentReturnCode_t MQTT_AGENT_Create(MQTTAgentHandle_t * const pxMQTTHandle)
+{
+    *pxMQTTHandle = &simMqttHandle;
+    return eMQTTAgentSuccess;
+}
+
+MQTTAgentReturnCode_t MQTT_AGENT_Delete(MQTTAgentHandle_t xMQTTHandle)
+{
+    return eMQTTAgentSuccess;
+}
+
+MQTTAgentReturnCode_t MQTT_AGENT_Connect(MQTTAgentHandle_t xMQTTHandle,
+                                         const MQTTAgentConnectParams_t * const pxConnectParams,
+                                         TickType_t xTimeoutTicks)
+{
+    static SIM_MQTT_JOB job;
+
+    memset(&job, 0, sizeof(job));
+    job.type = SIM_MQTT_JOB_CONNECT;
+
+    return _SimMqttCall(&job, xTimeoutTicks);
+}
+
+MQTTAgentReturnCode_t MQTT_AGENT_Disconnect(MQTTAgentHandle_t xMQTTHandle,
+                                            TickType_t xTimeoutTicks)
+{
+    static SIM_MQTT_JOB job;
+
+    memset(&job, 0, sizeof(job));
+    job.type = SIM_MQTT_JOB_DISCONNECT;
+
+    return _SimMqttCall(&job, xTimeoutTicks);
+}
+
+MQTTAgentReturnCode_t MQTT_AGENT_Subscribe(MQTTAgentHandle_t xMQTTHandle,
+                                           const MQTTAgentSubscribeParams_t * const pxSubscribeParams,
+                                           TickType_t xTimeoutTicks)
+{
+    static SIM_MQTT_JOB job;
+
+    memset(&job, 0, sizeof(job));
+    job.type = SIM_MQTT_JOB_SUBSCRIBE;
+    job.callback = pxSubscribeParams->pxPublishCallback;
+    job.context = pxSubscribeParams->pvPublishCallbackContext;
+    _SimMqttCopy(job.topic, sizeof(job.topic), pxSubscribeParams->pucTopic, pxSubscribeParams->usTopicLength);
+
+    return _SimMqttCall(&job, xTimeoutTicks);
+}
+
+MQTTAgentReturnCode_t MQTT_AGENT_Publish(MQTTAgentHandle_t xMQTTHandle,
+                                         const MQTTAgentPublishParams_t * const pxPublishParams,
+                                         TickType_t xTimeoutTicks)
+{
+    static SIM_MQTT_JOB job;
+
+    if(!simConnected)
+    {
+        return eMQTTAgentFailure;
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.type = SIM_MQTT_JOB_PUBLISH;
+    _SimMqttCopy(job.topic, sizeof(job.topic), pxPublishParams->pucTopic, pxPublishParams->usTopicLength);
+    _SimMqttCopy(job.payload, sizeof(job.payload), pxPublishParams->pvData, pxPublishParams->ulDataLength);
+    job.length = strlen(job.payload);
+
+    return _SimMqttCall(&job, xTimeoutTicks);
+}
+
+void SIM_MqttInject(const char* topic, const char* payload)
+{
+    static SIM_MQTT_JOB job;
+
+    memset(&job, 0, sizeof(job));
+    job.type = SIM_MQTT_JOB_INJECT;
+    _SimMqttCopy(job.topic, sizeof(job.topic), topic, strlen(topic));
+    _SimMqttCopy(job.payload, sizeof(job.payload), payload, strlen(payload));
+    job.length = strlen(job.payload);
+
+    xQueueSendToBack(simJobQueue, &job, portMAX_DELAY);
+}
+
+bool SIM_MqttWaitSubscribed(const char* topic, uint32_t timeoutMs)
+{
+    uint32_t waited;
+    int ix;
+
+    for(waited = 0; waited <= timeoutMs; waited += 10)
+    {
+        for(ix = 0; ix < simNSubs; ix++)
+        {
+            if(strcmp(simSubs[ix].topic, topic) == 0)
+            {
+                return true;
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    return false;
+}
+
+uint32_t SIM_MqttMark(void)
+{
+    return simLogCount;
+}
+
+bool SIM_MqttWaitPublish(uint32_t* pFrom, const char* topic, const char* pattern,
+                         uint32_t timeoutMs, SIM_MQTT_RECORD* pRec)
+{
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(timeoutMs);
+    TickType_t waited;
+    TickType_t now;
+    uint32_t ix;
+
+    while(true)
+    {
+        // older records were overwritten
+        if(simLogCount - *pFrom > SIM_MQTT_LOG_SIZE)
+        {
+            *pFrom = simLogCount - SIM_MQTT_LOG_SIZE;
+        }
+
+        for(ix = *pFrom; ix != simLogCount; ix++)
+        {
+            const SIM_MQTT_RECORD* pLog = simLog + (ix % SIM_MQTT_LOG_SIZE);
+
+            if(strcmp(pLog->topic, topic) != 0 || (pattern && strstr(pLog->payload, pattern) == NULL))
+            {
+                continue;
+            }
+
+            *pRec = *pLog;
+            *pFrom = ix + 1;
+
+            // the record is made when the client sends, wait for the broker to get it
+            now = xTaskGetTickCount();
+            if((int32_t)(pRec->tick - now) > 0)
+            {
+                vTaskDelay(pRec->tick - now);
+            }
+            return true;
+        }
+        *pFrom = simLogCount;
+
+        waited = xTaskGetTickCount() - start;
+        if(waited >= timeout)
+        {
+            return false;
+        }
+        xSemaphoreTake(simLogAdded, timeout - waited);
+    }
+}
+
+// the OTA agent is not simulated, it never leaves NotReady
+OTA_State_t OTA_AgentInit(void * pvClient, const uint8_t * pcThingName,
+                          pxOTACompleteCallback_t xFunc, TickType_t xTicksToWait)
+{
+    return eOTA_AgentState_NotReady;
+}
+
+OTA_State_t OTA_GetAgentState(void)
+{
+    return eOTA_AgentState_NotReady;
+}
+
+OTA_Err_t OTA_ActivateNewImage(void)
+{
+    return kOTA_Err_Uninitialized;
+}
+
+OTA_Err_t OTA_SetImageState(OTA_ImageState_t eState)
+{
+    return kOTA_Err_Uninitialized;
+}
+
+uint32_t OTA_GetPacketsReceived(void)
+{
+    return 0;
+}
+
+uint32_t OTA_GetPacketsQueued(void)
+{
+    return 0;
+}
+
+uint32_t OTA_GetPacketsProcessed(void)
+{
+    return 0;
+}
+
+uint32_t OTA_GetPacketsDropped(void)
+{
+    return 0;
+}
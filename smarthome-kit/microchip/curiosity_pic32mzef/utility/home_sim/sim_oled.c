@@ -0,0 +1,395 @@
+/*******************************************************************************
+  Home Automation Simulation OLED C Click
+
+  File Name:
+    sim_oled.c
+
+  Summary:
+    SSD1351 controller model behind the OLED C click driver.
+
+  Description:
+    Bytes are decoded like the controller does it, D/C low is a command and
+    D/C high its arguments or display data. Column and row address windows
+    and RAM writes go to the 128 x 128 display RAM, 16 bit pixels high byte
+    first; the 96 x 96 panel starts at column 0x10. Other commands are
+    accepted and ignored.
+
+    Chained jobs run their segment start hooks before the segment bytes,
+    like the SPI driver interrupt does, so D/C switching inside a chain is
+    checked byte by byte.
+
+    The simulation compares the display RAM with the frame buffer of the
+    driver to tell when a change drawn by the display module reached the
+    panel.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "system_config.h"
+#include "system_definitions.h"
+#include "semphr.h"
+#include "home_sim.h"
+#include "../click_spi_stats.h"
+
+#define SIM_OLED_RAM_SIZE       128
+#define SIM_OLED_PANEL_SIZE     96
+#define SIM_OLED_COL_OFFSET     0x10
+
+#define SIM_OLED_MAX_JOBS       8
+
+// the SPI HAL of click_common.h, implemented by the model
+static int      hal_spiChainStart(const DRV_SPI_BUFFER_SEGMENT *pSeg, uint8_t nSeg);
+static int      hal_spiWait(void);
+static void     hal_spiStats(T_CLICK_SPI_STATS *stats);
+
+#include "click_oled_c.c"
+
+typedef struct
+{
+    const DRV_SPI_BUFFER_SEGMENT*   pSeg;
+    uint8_t                         nSeg;
+}SIM_OLED_JOB;
+
+static uint16_t         simRam[SIM_OLED_RAM_SIZE][SIM_OLED_RAM_SIZE];
+
+static int              simCs = 1;
+static int              simDc;
+static bool             simEnabled;
+static uint8_t          simCmd;
+static uint8_t          simArgs[2];
+static int              simNArgs;
+static uint8_t          simColStart, simColEnd, simRowStart, simRowEnd;
+static uint8_t          simCol, simRow;
+static int              simPixelHi = -1;    // first byte of a pixel, -1 when none
+static uint32_t         simErrors;          // bytes sent while not selected
+
+static SIM_OLED_JOB     simJobs[SIM_OLED_MAX_JOBS];
+static int              simNJobs;
+static T_CLICK_SPI_STATS simStats;
+
+static SemaphoreHandle_t simWindowDone;     // given on chip select release
+
+static void _SimOledReset(void)
+{
+    simCmd = 0;
+    simNArgs = 0;
+    simPixelHi = -1;
+    simColStart = 0;
+    simColEnd = SIM_OLED_RAM_SIZE - 1;
+    simRowStart = 0;
+    simRowEnd = SIM_OLED_RAM_SIZE - 1;
+    simCol = 0;
+    simRow = 0;
+}
+
+void SIM_OledInitialize(void)
+{
+    memset(simRam, 0, sizeof(simRam));
+    _SimOledReset();
+    simWindowDone = xSemaphoreCreateBinary();
+}
+
+void SIM_OledCsSet(int level)
+{
+    if(level != 0 && simCs == 0)
+    {
+        xSemaphoreGive(simWindowDone);
+    }
+    simCs = level;
+}
+
+void SIM_OledDcSet(int level)
+{
+    simDc = level;
+}
+
+void SIM_OledRstSet(int level)
+{
+    if(level == 0)
+    {
+        _SimOledReset();
+    }
+}
+
+void SIM_OledEnableSet(int level)
+{
+    simEnabled = level != 0;
+}
+
+static void _SimOledByte(uint8_t b)
+{
+    if(simCs != 0)
+    {
+        simErrors++;
+        return;
+    }
+
+    if(simDc == 0)
+    {
+        simCmd = b;
+        simNArgs = 0;
+        simPixelHi = -1;
+        if(simCmd == _OLEDC_WRITE_RAM)
+        {
+            simCol = simColStart;
+            simRow = simRowStart;
+        }
+        return;
+    }
+
+    switch(simCmd)
+    {
+        case _OLEDC_SET_COL_ADDRESS:
+        case _OLEDC_SET_ROW_ADDRESS:
+            if(simNArgs < 2)
+            {
+                simArgs[simNArgs++] = b & (SIM_OLED_RAM_SIZE - 1);
+            }
+            if(simNArgs == 2)
+            {
+                if(simCmd == _OLEDC_SET_COL_ADDRESS)
+                {
+                    simColStart = simArgs[0];
+                    simColEnd = simArgs[1];
+                }
+                else
+                {
+                    simRowStart = simArgs[0];
+                    simRowEnd = simArgs[1];
+                }
+            }
+            break;
+
+        case _OLEDC_WRITE_RAM:
+            if(simPixelHi < 0)
+            {
+                simPixelHi = b;
+                break;
+            }
+            simRam[simRow][simCol] = (uint16_t)((simPixelHi << 8) | b);
+            simPixelHi = -1;
+            // the address wraps inside the window
+            if(simCol++ >= simColEnd)
+            {
+                simCol = simColStart;
+                if(simRow++ >= simRowEnd)
+                {
+                    simRow = simRowStart;
+                }
+            }
+            break;
+
+        default:    // configuration, not modeled
+            break;
+    }
+}
+
+static void hal_spiMap(T_HAL_P spiObj)
+{
+}
+
+static int hal_spiChainStart(const DRV_SPI_BUFFER_SEGMENT *pSeg, uint8_t nSeg)
+{
+    if(simNJobs == SIM_OLED_MAX_JOBS)
+    {
+        hal_spiWait();
+    }
+
+    simJobs[simNJobs].pSeg = pSeg;
+    simJobs[simNJobs].nSeg = nSeg;
+    simNJobs++;
+    simStats.jobs++;
+
+    return 0;
+}
+
+static int hal_spiWait(void)
+{
+    uint32_t start, cycles;
+    uint32_t nBytes = 0;
+    int jIx, sIx;
+    size_t bIx;
+
+    if(simNJobs == 0)
+    {
+        return 0;
+    }
+
+    start = _CP0_GET_COUNT();
+    for(jIx = 0; jIx < simNJobs; jIx++)
+    {
+        for(sIx = 0; sIx < simJobs[jIx].nSeg; sIx++)
+        {
+            nBytes += simJobs[jIx].pSeg[sIx].size;
+        }
+    }
+    SIM_SpiTransfer(&simSpi2, nBytes);
+
+    for(jIx = 0; jIx < simNJobs; jIx++)
+    {
+        for(sIx = 0; sIx < simJobs[jIx].nSeg; sIx++)
+        {
+            const DRV_SPI_BUFFER_SEGMENT* pSeg = simJobs[jIx].pSeg + sIx;
+            if(pSeg->segmentStart)
+            {
+                pSeg->segmentStart(DRV_SPI_BUFFER_EVENT_PROCESSING, (DRV_SPI_BUFFER_HANDLE)jIx, pSeg->context);
+            }
+            for(bIx = 0; bIx < pSeg->size; bIx++)
+            {
+                _SimOledByte(((const uint8_t*)pSeg->txBuffer)[bIx]);
+            }
+        }
+    }
+    simNJobs = 0;
+
+    cycles = _CP0_GET_COUNT() - start;
+    simStats.waits++;
+    simStats.wait_cycles += cycles;
+    if(cycles > simStats.wait_max_cycles)
+    {
+        simStats.wait_max_cycles = cycles;
+    }
+
+    return 0;
+}
+
+static void hal_spiWrite(uint8_t *pBuf, uint16_t nBytes)
+{
+    uint16_t ix;
+
+    simStats.jobs++;
+    SIM_SpiTransfer(&simSpi2, nBytes);
+    for(ix = 0; ix < nBytes; ix++)
+    {
+        _SimOledByte(pBuf[ix]);
+    }
+}
+
+static void hal_spiStats(T_CLICK_SPI_STATS *stats)
+{
+    *stats = simStats;
+    stats->errors = simErrors;
+    stats->cycles_freq = SYS_CLK_FREQ / 2;
+}
+
+uint32_t SIM_OledErrors(void)
+{
+    return simErrors;
+}
+
+static uint16_t _SimOledFramePixel(int x, int y)
+{
+    const uint8_t* p = frame_buffer + (y * SIM_OLED_PANEL_SIZE + x) * 2;
+
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+uint32_t SIM_OledRegionHash(int x, int y, int w, int h)
+{
+    uint32_t hash = 2166136261u;
+    int row, col;
+
+    for(row = y; row < y + h; row++)
+    {
+        for(col = x; col < x + w; col++)
+        {
+            uint16_t pixel = simRam[row][SIM_OLED_COL_OFFSET + col];
+            hash = (hash ^ (pixel >> 8)) * 16777619u;
+            hash = (hash ^ (pixel & 0xFF)) * 16777619u;
+        }
+    }
+
+    return hash;
+}
+
+static bool _SimOledRegionShown(int x, int y, int w, int h)
+{
+    int row, col;
+
+    for(row = y; row < y + h; row++)
+    {
+        for(col = x; col < x + w; col++)
+        {
+            if(simRam[row][SIM_OLED_COL_OFFSET + col] != _SimOledFramePixel(col, row))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool SIM_OledWaitRegion(int x, int y, int w, int h, uint32_t oldHash, uint32_t timeoutMs,
+                        TickType_t* pShown)
+{
+    TickType_t start = xTaskGetTickCount();
+    TickType_t timeout = pdMS_TO_TICKS(timeoutMs);
+    TickType_t waited;
+
+    while(true)
+    {
+        if(SIM_OledRegionHash(x, y, w, h) != oldHash && _SimOledRegionShown(x, y, w, h))
+        {
+            *pShown = xTaskGetTickCount();
+            return true;
+        }
+
+        waited = xTaskGetTickCount() - start;
+        if(waited >= timeout)
+        {
+            return false;
+        }
+        xSemaphoreTake(simWindowDone, timeout - waited);
+    }
+}
+
+bool SIM_OledCheck(void)
+{
+    int tries;
+
+    // the display task may be in the middle of drawing, give it time to send
+    for(tries = 0; tries < 100; tries++)
+    {
+        if(dirty_cnt == 0 && _SimOledRegionShown(0, 0, SIM_OLED_PANEL_SIZE, SIM_OLED_PANEL_SIZE))
+        {
+            return true;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    return false;
+}
+
+bool SIM_OledDump(const char* path)
+{
+    FILE* pFile = fopen(path, "wb");
+    int row, col;
+
+    if(pFile == NULL)
+    {
+        return false;
+    }
+
+    fprintf(pFile, "P6\n%d %d\n255\n", SIM_OLED_PANEL_SIZE, SIM_OLED_PANEL_SIZE);
+    for(row = 0; row < SIM_OLED_PANEL_SIZE; row++)
+    {
+        for(col = 0; col < SIM_OLED_PANEL_SIZE; col++)
+        {
+            uint16_t pixel = simRam[row][SIM_OLED_COL_OFFSET + col];
+            uint8_t rgb[3];
+
+            // 65k colors, 5 6 5 bits
+            rgb[0] = (uint8_t)(((pixel >> 11) & 0x1F) * 255 / 0x1F);
+            rgb[1] = (uint8_t)(((pixel >> 5) & 0x3F) * 255 / 0x3F);
+            rgb[2] = (uint8_t)((pixel & 0x1F) * 255 / 0x1F);
+            fwrite(rgb, 1, sizeof(rgb), pFile);
+        }
+    }
+
+    return fclose(pFile) == 0;
+}
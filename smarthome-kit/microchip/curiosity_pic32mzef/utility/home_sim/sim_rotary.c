@@ -0,0 +1,148 @@
+/*******************************************************************************
+  Home Automation Simulation Rotary Click
+
+  File Name:
+    sim_rotary.c
+
+  Summary:
+    Encoder lines and LED ring shift registers behind the Rotary click driver.
+
+  Description:
+    The ring is two chained 8 bit shift registers, the bytes shifted in
+    while chip select is low are latched to the LEDs when it goes high. The
+    LEDs are lit only while RST (output enable) is high.
+
+    The encoder has two quadrature lines, both high in a detent. A detent
+    turned clockwise takes A low first, one turned counter clockwise takes
+    B low first.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "system_config.h"
+#include "system_definitions.h"
+#include "home_sim.h"
+#include "../click_spi_stats.h"
+
+// the SPI HAL of click_common.h, implemented by the model
+static void hal_spiStats(T_CLICK_SPI_STATS *stats);
+
+#include "click_rotary.c"
+
+// A and B line levels of one detent, starting from both high
+static const uint8_t simCwSteps[4][2] = { { 0, 1 }, { 0, 0 }, { 1, 0 }, { 1, 1 } };
+static const uint8_t simCcwSteps[4][2] = { { 1, 0 }, { 0, 0 }, { 0, 1 }, { 1, 1 } };
+
+static volatile int     simEncA = 1;
+static volatile int     simEncB = 1;
+
+static int              simCs = 1;
+static bool             simEnabled;
+static uint16_t         simShift;
+static uint16_t         simLatch;
+static uint32_t         simErrors;      // bytes sent while not selected
+
+static T_CLICK_SPI_STATS simStats;
+
+void SIM_RotaryInitialize(void)
+{
+    simEncA = 1;
+    simEncB = 1;
+    simShift = 0;
+    simLatch = 0;
+}
+
+void SIM_RotaryTurn(int detents)
+{
+    const uint8_t (*pSteps)[2] = (detents < 0) ? simCcwSteps : simCwSteps;
+    int n = abs(detents);
+    int dIx, sIx;
+
+    for(dIx = 0; dIx < n; dIx++)
+    {
+        for(sIx = 0; sIx < 4; sIx++)
+        {
+            simEncA = pSteps[sIx][0];
+            simEncB = pSteps[sIx][1];
+            vTaskDelay(pdMS_TO_TICKS(SIM_ROTARY_EDGE_MS));
+        }
+    }
+}
+
+uint16_t SIM_RotaryLedRing(bool* pEnabled)
+{
+    if(pEnabled)
+    {
+        *pEnabled = simEnabled;
+    }
+
+    return simLatch;
+}
+
+void SIM_RotaryCsSet(int level)
+{
+    if(level != 0 && simCs == 0)
+    {
+        simLatch = simShift;
+    }
+    simCs = level;
+}
+
+void SIM_RotaryEnableSet(int level)
+{
+    simEnabled = level != 0;
+}
+
+int SIM_RotaryEncA(void)
+{
+    return simEncA;
+}
+
+int SIM_RotaryEncB(void)
+{
+    return simEncB;
+}
+
+static void hal_spiMap(T_HAL_P spiObj)
+{
+}
+
+static void hal_spiWrite(uint8_t *pBuf, uint16_t nBytes)
+{
+    uint32_t start, cycles;
+    uint16_t ix;
+
+    start = _CP0_GET_COUNT();
+    simStats.jobs++;
+    SIM_SpiTransfer(&simSpi1, nBytes);
+
+    // the last two bytes stay in the registers, the first one sent in the low half
+    for(ix = 0; ix < nBytes; ix++)
+    {
+        if(simCs != 0)
+        {
+            simErrors++;
+            continue;
+        }
+        simShift = (uint16_t)((simShift >> 8) | ((uint16_t)pBuf[ix] << 8));
+    }
+
+    cycles = _CP0_GET_COUNT() - start;
+    simStats.waits++;
+    simStats.wait_cycles += cycles;
+    if(cycles > simStats.wait_max_cycles)
+    {
+        simStats.wait_max_cycles = cycles;
+    }
+}
+
+static void hal_spiStats(T_CLICK_SPI_STATS *stats)
+{
+    *stats = simStats;
+    stats->errors = simErrors;
+    stats->cycles_freq = SYS_CLK_FREQ / 2;
+}
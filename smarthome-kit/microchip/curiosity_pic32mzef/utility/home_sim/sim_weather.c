@@ -0,0 +1,428 @@
+/*******************************************************************************
+  Home Automation Simulation Weather Click
+
+  File Name:
+    sim_weather.c
+
+  Summary:
+    BME280 register model behind the Weather click driver.
+
+  Description:
+    The Weather click driver is built with its SPI HAL replaced by the
+    model. Bytes are handed to the model in chip select windows like on the
+    wire: address byte with the read bit, then data bytes from auto
+    incremented registers or address / value pairs.
+
+    Calibration registers hold the trim values of the BME280 datasheet
+    example. SIM_WeatherSet inverts the datasheet floating point
+    compensation to get the raw ADC values of the wanted conditions; the
+    data registers return them while the sensor is in normal or forced mode,
+    the reset values otherwise.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "system_config.h"
+#include "system_definitions.h"
+#include "semphr.h"
+#include "home_sim.h"
+#include "../click_spi_stats.h"
+
+#define SIM_WEATHER_MAX_JOBS        8
+
+// register index, the SPI address drops bit 7
+#define SIM_WEATHER_REG(addr)       ((addr) & 0x7F)
+
+// the SPI HAL of click_common.h, implemented by the model
+static int  hal_spiWriteStart(uint8_t *pBuf, uint16_t nBytes);
+static int  hal_spiReadStart(uint8_t *pBuf, uint16_t nBytes);
+static int  hal_spiWait(void);
+static void hal_spiStats(T_CLICK_SPI_STATS *stats);
+
+#include "click_weather.c"
+
+typedef struct
+{
+    uint8_t*    pBuf;
+    uint16_t    nBytes;
+    bool        read;
+}SIM_WEATHER_JOB;
+
+// BME280 datasheet trim values
+static const uint16_t   simDigT1 = 27504;
+static const int16_t    simDigT2 = 26435;
+static const int16_t    simDigT3 = -1000;
+static const uint16_t   simDigP1 = 36477;
+static const int16_t    simDigP[8] = { -10685, 3024, 2855, 140, -7, 15500, -14600, 6000 };
+static const uint8_t    simDigH1 = 75;
+static const int16_t    simDigH2 = 362;
+static const uint8_t    simDigH3 = 0;
+static const int16_t    simDigH4 = 313;
+static const int16_t    simDigH5 = 50;
+static const int8_t     simDigH6 = 30;
+
+static uint8_t          simRegs[128];
+static uint32_t         simAdcT = 0x80000;
+static uint32_t         simAdcP = 0x80000;
+static uint32_t         simAdcH = 0x8000;
+
+static int              simCs = 1;
+static int              simAddr = -1;       // -1 while the address byte is expected
+static bool             simRead;
+static bool             simDataRead;        // data registers read in this window
+static uint32_t         simErrors;          // bytes sent while not selected
+
+static SIM_WEATHER_JOB  simJobs[SIM_WEATHER_MAX_JOBS];
+static int              simNJobs;
+static T_CLICK_SPI_STATS simStats;
+
+static SemaphoreHandle_t simReadDone;
+static TickType_t       simReadTick;
+
+static void _SimWeatherPut16(uint8_t addr, uint16_t value)
+{
+    simRegs[SIM_WEATHER_REG(addr)] = (uint8_t)value;
+    simRegs[SIM_WEATHER_REG(addr) + 1] = (uint8_t)(value >> 8);
+}
+
+static void _SimWeatherReset(void)
+{
+    simRegs[SIM_WEATHER_REG(0xF2)] = 0;
+    simRegs[SIM_WEATHER_REG(0xF4)] = 0;
+    simRegs[SIM_WEATHER_REG(0xF5)] = 0;
+}
+
+void SIM_WeatherInitialize(void)
+{
+    int ix;
+
+    memset(simRegs, 0, sizeof(simRegs));
+    simRegs[SIM_WEATHER_REG(0xD0)] = 0x60;      // chip id
+
+    _SimWeatherPut16(0x88, simDigT1);
+    _SimWeatherPut16(0x8A, (uint16_t)simDigT2);
+    _SimWeatherPut16(0x8C, (uint16_t)simDigT3);
+    _SimWeatherPut16(0x8E, simDigP1);
+    for(ix = 0; ix < 8; ix++)
+    {
+        _SimWeatherPut16(0x90 + 2 * ix, (uint16_t)simDigP[ix]);
+    }
+    simRegs[SIM_WEATHER_REG(0xA1)] = simDigH1;
+    _SimWeatherPut16(0xE1, (uint16_t)simDigH2);
+    simRegs[SIM_WEATHER_REG(0xE3)] = simDigH3;
+    // H4 and H5 are 12 bit, sharing the nibbles of 0xE5
+    simRegs[SIM_WEATHER_REG(0xE4)] = (uint8_t)(simDigH4 >> 4);
+    simRegs[SIM_WEATHER_REG(0xE5)] = (uint8_t)((simDigH4 & 0x0F) | ((simDigH5 & 0x0F) << 4));
+    simRegs[SIM_WEATHER_REG(0xE6)] = (uint8_t)(simDigH5 >> 4);
+    simRegs[SIM_WEATHER_REG(0xE7)] = (uint8_t)simDigH6;
+
+    simReadDone = xSemaphoreCreateBinary();
+}
+
+// datasheet floating point compensation, section 8.1
+static double _SimWeatherTFine(uint32_t adcT)
+{
+    double var1 = ((double)adcT / 16384.0 - (double)simDigT1 / 1024.0) * (double)simDigT2;
+    double var2 = (double)adcT / 131072.0 - (double)simDigT1 / 8192.0;
+
+    return var1 + var2 * var2 * (double)simDigT3;
+}
+
+static double _SimWeatherPressure(uint32_t adcP, double tFine)
+{
+    double var1 = tFine / 2.0 - 64000.0;
+    double var2 = var1 * var1 * (double)simDigP[4] / 32768.0;
+    double p;
+
+    var2 = var2 + var1 * (double)simDigP[3] * 2.0;
+    var2 = var2 / 4.0 + (double)simDigP[2] * 65536.0;
+    var1 = ((double)simDigP[1] * var1 * var1 / 524288.0 + (double)simDigP[0] * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * (double)simDigP1;
+    if(var1 == 0.0)
+    {
+        return 0.0;
+    }
+
+    p = 1048576.0 - (double)adcP;
+    p = (p - var2 / 4096.0) * 6250.0 / var1;
+    var1 = (double)simDigP[7] * p * p / 2147483648.0;
+    var2 = p * (double)simDigP[6] / 32768.0;
+
+    return p + (var1 + var2 + (double)simDigP[5]) / 16.0;
+}
+
+static double _SimWeatherHumidity(uint32_t adcH, double tFine)
+{
+    double h = tFine - 76800.0;
+
+    h = ((double)adcH - ((double)simDigH4 * 64.0 + (double)simDigH5 / 16384.0 * h)) *
+        ((double)simDigH2 / 65536.0 * (1.0 + (double)simDigH6 / 67108864.0 * h *
+        (1.0 + (double)simDigH3 / 67108864.0 * h)));
+    h = h * (1.0 - (double)simDigH1 * h / 524288.0);
+
+    return (h < 0.0) ? 0.0 : (h > 100.0) ? 100.0 : h;
+}
+
+void SIM_WeatherSet(double temperature, double humidity, double pressure)
+{
+    uint32_t lo, hi, mid;
+    double tFine;
+
+    // the compensated values are monotonic in the raw ones, bisect them
+    lo = 0;
+    hi = (1u << 20) - 1;
+    while(lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if(_SimWeatherTFine(mid) / 5120.0 < temperature)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    simAdcT = lo;
+    tFine = _SimWeatherTFine(simAdcT);
+
+    lo = 0;
+    hi = 0xFFFF;
+    while(lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if(_SimWeatherHumidity(mid, tFine) < humidity)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    simAdcH = lo;
+
+    // pressure falls with the raw value, hPa
+    lo = 0;
+    hi = (1u << 20) - 1;
+    while(lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if(_SimWeatherPressure(mid, tFine) / 100.0 > pressure)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    simAdcP = lo;
+
+    // SIM_WeatherWaitRead waits for the first read of the new values
+    xSemaphoreTake(simReadDone, 0);
+}
+
+bool SIM_WeatherWaitRead(uint32_t timeoutMs, TickType_t* pRead)
+{
+    if(xSemaphoreTake(simReadDone, pdMS_TO_TICKS(timeoutMs)) != pdTRUE)
+    {
+        return false;
+    }
+
+    *pRead = simReadTick;
+    return true;
+}
+
+void SIM_WeatherCsSet(int level)
+{
+    if(level == 0 && simCs != 0)
+    {
+        simAddr = -1;
+        simDataRead = false;
+    }
+    simCs = level;
+}
+
+static uint8_t _SimWeatherReadReg(uint8_t reg)
+{
+    uint8_t data[8];
+
+    if(reg < SIM_WEATHER_REG(0xF7) || reg > SIM_WEATHER_REG(0xFE))
+    {
+        return simRegs[reg];
+    }
+
+    if((simRegs[SIM_WEATHER_REG(0xF4)] & 0x03) == 0)
+    {   // sleep mode, no conversion done since reset
+        static const uint8_t resetData[8] = { 0x80, 0x00, 0x00, 0x80, 0x00, 0x00, 0x80, 0x00 };
+        return resetData[reg - SIM_WEATHER_REG(0xF7)];
+    }
+
+    data[0] = (uint8_t)(simAdcP >> 12);
+    data[1] = (uint8_t)(simAdcP >> 4);
+    data[2] = (uint8_t)(simAdcP << 4);
+    data[3] = (uint8_t)(simAdcT >> 12);
+    data[4] = (uint8_t)(simAdcT >> 4);
+    data[5] = (uint8_t)(simAdcT << 4);
+    data[6] = (uint8_t)(simAdcH >> 8);
+    data[7] = (uint8_t)simAdcH;
+
+    return data[reg - SIM_WEATHER_REG(0xF7)];
+}
+
+static void _SimWeatherWriteReg(uint8_t reg, uint8_t value)
+{
+    switch(reg)
+    {
+        case SIM_WEATHER_REG(0xF2):
+        case SIM_WEATHER_REG(0xF4):
+        case SIM_WEATHER_REG(0xF5):
+            simRegs[reg] = value;
+            break;
+
+        case SIM_WEATHER_REG(0xE0):
+            if(value == 0xB6)
+            {
+                _SimWeatherReset();
+            }
+            break;
+
+        default:    // read only
+            break;
+    }
+}
+
+static uint8_t _SimWeatherByte(uint8_t tx)
+{
+    uint8_t rx = 0xFF;
+
+    if(simCs != 0)
+    {
+        simErrors++;
+        return rx;
+    }
+
+    if(simAddr < 0)
+    {
+        simRead = (tx & 0x80) != 0;
+        simAddr = SIM_WEATHER_REG(tx);
+        if(simRead && simAddr == SIM_WEATHER_REG(0xF7))
+        {
+            simDataRead = true;
+        }
+    }
+    else if(simRead)
+    {   // burst read, address auto incremented
+        rx = _SimWeatherReadReg((uint8_t)simAddr);
+        simAddr = SIM_WEATHER_REG(simAddr + 1);
+    }
+    else
+    {   // address / value pairs
+        _SimWeatherWriteReg((uint8_t)simAddr, tx);
+        simAddr = -1;
+    }
+
+    return rx;
+}
+
+static void hal_spiMap(T_HAL_P spiObj)
+{
+}
+
+static int _SimWeatherQueue(uint8_t *pBuf, uint16_t nBytes, bool read)
+{
+    if(simNJobs == SIM_WEATHER_MAX_JOBS)
+    {
+        hal_spiWait();
+    }
+
+    simJobs[simNJobs].pBuf = pBuf;
+    simJobs[simNJobs].nBytes = nBytes;
+    simJobs[simNJobs].read = read;
+    simNJobs++;
+    simStats.jobs++;
+
+    return 0;
+}
+
+static int hal_spiWriteStart(uint8_t *pBuf, uint16_t nBytes)
+{
+    return _SimWeatherQueue(pBuf, nBytes, false);
+}
+
+static int hal_spiReadStart(uint8_t *pBuf, uint16_t nBytes)
+{
+    return _SimWeatherQueue(pBuf, nBytes, true);
+}
+
+static int hal_spiWait(void)
+{
+    uint32_t start, cycles;
+    uint32_t nBytes = 0;
+    int jIx, bIx;
+
+    if(simNJobs == 0)
+    {
+        return 0;
+    }
+
+    start = _CP0_GET_COUNT();
+    for(jIx = 0; jIx < simNJobs; jIx++)
+    {
+        nBytes += simJobs[jIx].nBytes;
+    }
+    SIM_SpiTransfer(&simSpi1, nBytes);
+
+    // the wire sees the bytes once they were clocked out
+    for(jIx = 0; jIx < simNJobs; jIx++)
+    {
+        SIM_WEATHER_JOB* pJob = simJobs + jIx;
+        for(bIx = 0; bIx < pJob->nBytes; bIx++)
+        {
+            if(pJob->read)
+            {
+                pJob->pBuf[bIx] = _SimWeatherByte(0x00);
+            }
+            else
+            {
+                _SimWeatherByte(pJob->pBuf[bIx]);
+            }
+        }
+    }
+    simNJobs = 0;
+
+    cycles = _CP0_GET_COUNT() - start;
+    simStats.waits++;
+    simStats.wait_cycles += cycles;
+    if(cycles > simStats.wait_max_cycles)
+    {
+        simStats.wait_max_cycles = cycles;
+    }
+
+    if(simDataRead)
+    {
+        simDataRead = false;
+        simReadTick = xTaskGetTickCount();
+        xSemaphoreGive(simReadDone);
+    }
+
+    return 0;
+}
+
+static void hal_spiWrite(uint8_t *pBuf, uint16_t nBytes)
+{
+    hal_spiWriteStart(pBuf, nBytes);
+    hal_spiWait();
+}
+
+static void hal_spiStats(T_CLICK_SPI_STATS *stats)
+{
+    *stats = simStats;
+    stats->errors = simErrors;
+    stats->cycles_freq = SYS_CLK_FREQ / 2;
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************
+  Home Automation Simulation Configuration
+
+  File Name:
+    system_config.h
+
+  Summary:
+    Host build configuration for home_sim.
+
+  Description:
+    The mikroBUS pins, the SPI driver open call and the board buttons used
+    by the click drivers and the home automation modules, routed to the
+    simulated click boards.
+    Clocks and SPI baud rates are the ones of the PIC32MZ EF Curiosity
+    configuration, the simulated buses take their transfer times from them.
+*******************************************************************************/
+
+#ifndef _SYSTEM_CONFIG_H
+#define _SYSTEM_CONFIG_H
+
+#include <stdint.h>
+
+#define SYS_CLK_FREQ                    200000000ul
+
+// SPI2: OLED C click and WILC1000, SPI1: Rotary and Weather clicks
+#define DRV_SPI_BAUD_RATE_IDX0          8000000
+#define DRV_SPI_BAUD_RATE_IDX1          8000000
+
+#define DRV_SPI_INDEX_0                 0
+#define DRV_SPI_INDEX_1                 1
+#define DRV_IO_INTENT_READWRITE         0
+#define DRV_IO_INTENT_BLOCKING          0
+#define DRV_SPI_Open(index, intent)     ((uintptr_t)(index))
+
+// mikroBUS 2: OLED C click, PWM is D/C, INT is the panel enable
+void SIM_OledCsSet(int level);
+void SIM_OledDcSet(int level);
+void SIM_OledRstSet(int level);
+void SIM_OledEnableSet(int level);
+
+#define MIKROBUS2_CSOn()                SIM_OledCsSet(1)
+#define MIKROBUS2_CSOff()               SIM_OledCsSet(0)
+#define MIKROBUS2_ANOn()                ((void)0)
+#define MIKROBUS2_ANOff()               ((void)0)
+#define MIKROBUS2_RSTOn()               SIM_OledRstSet(1)
+#define MIKROBUS2_RSTOff()              SIM_OledRstSet(0)
+#define MIKROBUS2_PWMOn()               SIM_OledDcSet(1)
+#define MIKROBUS2_PWMOff()              SIM_OledDcSet(0)
+#define MIKROBUS2_INTOn()               SIM_OledEnableSet(1)
+#define MIKROBUS2_INTOff()              SIM_OledEnableSet(0)
+
+// mikroBUS 3: Rotary click, PWM is ENCA, AN is ENCB, RST enables the ring
+void SIM_RotaryCsSet(int level);
+void SIM_RotaryEnableSet(int level);
+int  SIM_RotaryEncA(void);
+int  SIM_RotaryEncB(void);
+
+#define MIKROBUS3_CSOn()                SIM_RotaryCsSet(1)
+#define MIKROBUS3_CSOff()               SIM_RotaryCsSet(0)
+#define MIKROBUS3_RSTOn()               SIM_RotaryEnableSet(1)
+#define MIKROBUS3_RSTOff()              SIM_RotaryEnableSet(0)
+#define MIKROBUS3_PWMStateGet()         SIM_RotaryEncA()
+#define MIKROBUS3_ANStateGet()          SIM_RotaryEncB()
+
+// mikroBUS 4: Weather click
+void SIM_WeatherCsSet(int level);
+
+#define MIKROBUS4_CSOn()                SIM_WeatherCsSet(1)
+#define MIKROBUS4_CSOff()               SIM_WeatherCsSet(0)
+
+// board buttons, see module_common.h
+int  SIM_ButtonGet(int button);
+
+#define MODULE_BUTTON_1()               SIM_ButtonGet(1)
+#define MODULE_BUTTON_2()               SIM_ButtonGet(2)
+
+// The POSIX port runs each task on a thread using the task stack,
+// stack sizes are in 8 byte words and can't go below PTHREAD_STACK_MIN.
+#define SENSOR_TASK_STACK_SIZE          8192
+#define THERMOSTAT_TASK_STACK_SIZE      8192
+#define HVAC_TASK_STACK_SIZE            8192
+#define DISPLAY_TASK_STACK_SIZE         20480
+#define CONNECTOR_TASK_STACK_SIZE       8192
+
+#endif // _SYSTEM_CONFIG_H
@@ -0,0 +1,60 @@
+/*******************************************************************************
+  Home Automation Simulation System Definitions
+
+  File Name:
+    system_definitions.h
+
+  Summary:
+    Host replacement of the system definitions for home_sim.
+
+  Description:
+    The kernel headers, the SPI driver chained job types used by the OLED C
+    click driver and the WILC1000 SPI bus arbiter hook registered by the
+    SPI2 bus arbiter (module_bus.c). The hook is implemented by the
+    simulated Wi-Fi module in sim_mqtt.c.
+*******************************************************************************/
+
+#ifndef _SYSTEM_DEFINITIONS_H
+#define _SYSTEM_DEFINITIONS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <xc.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+// drv_spi_definitions.h
+typedef uintptr_t DRV_SPI_BUFFER_HANDLE;
+
+typedef enum
+{
+    DRV_SPI_BUFFER_EVENT_PENDING,
+    DRV_SPI_BUFFER_EVENT_PROCESSING,
+    DRV_SPI_BUFFER_EVENT_COMPLETE,
+    DRV_SPI_BUFFER_EVENT_ERROR
+}DRV_SPI_BUFFER_EVENT;
+
+typedef void (*DRV_SPI_BUFFER_EVENT_HANDLER)(DRV_SPI_BUFFER_EVENT event, DRV_SPI_BUFFER_HANDLE bufferHandle, void *context);
+
+typedef struct
+{
+    void                            *txBuffer;
+    void                            *rxBuffer;
+    size_t                          size;
+    DRV_SPI_BUFFER_EVENT_HANDLER    segmentStart;
+    void                            *context;
+}DRV_SPI_BUFFER_SEGMENT;
+
+// wdrv_wilc1000_stub.h
+typedef bool (*WDRV_STUB_SPI_BUS_ACQUIRE)(uint32_t timeoutMs);
+typedef void (*WDRV_STUB_SPI_BUS_RELEASE)(void);
+
+void WDRV_STUB_SPI_BusArbiterSet(WDRV_STUB_SPI_BUS_ACQUIRE acquire, WDRV_STUB_SPI_BUS_RELEASE release);
+
+#endif // _SYSTEM_DEFINITIONS_H
@@ -0,0 +1,25 @@
+/*******************************************************************************
+  Home Automation Simulation Compiler Header
+
+  File Name:
+    xc.h
+
+  Summary:
+    Host replacement of the XC32 device header for home_sim.
+
+  Description:
+    __XC_H is left undefined so the click HAL headers don't pull in
+    click_common.h; the sim_*.c files supply the SPI HAL functions.
+    The core timer is implemented by home_sim.c.
+*******************************************************************************/
+
+#ifndef _HOME_SIM_XC_H
+#define _HOME_SIM_XC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// core timer, runs at half of SYS_CLK_FREQ
+uint32_t _CP0_GET_COUNT(void);
+
+#endif // _HOME_SIM_XC_H
@@ -0,0 +1,364 @@
+/*******************************************************************************
+  IP Checksum Host Test and Benchmark
+
+  File Name:
+    ip_checksum_bench.c
+
+  Summary:
+    Checks TCPIP_Helper_CalcIPChecksum and TCPIP_Helper_PacketChecksum against
+    a byte-wise reference and measures the checksum throughput.
+
+  Description:
+    The TCP/IP checksum helpers source, tcpip_checksum.c, is built on the
+    host. The packet structures and the segment search are replaced by the
+    minimal versions below.
+
+    The property test compares the checksum with a byte-wise RFC 1071
+    reference for random lengths, buffer offsets 0-7 and seeds, and checks
+    that a buffer carrying its own checksum sums to 0.
+    The packet test splits random data into 1 to BENCH_MAX_SEGMENTS
+    segments of random, mostly odd, lengths at buffer offsets 0-7, chained
+    into 1 or 2 packets, and compares TCPIP_Helper_PacketChecksum with the
+    reference over the same data in one buffer. A segment starting at an
+    odd offset of the checksummed data has its sum byte swapped.
+    The benchmark prints the time per call for the usual packet sizes and
+    offsets, for the helpers version and for the previous 16-bit loop.
+
+    Build and run, from this directory:
+        gcc -O2 -fno-strict-aliasing -I../../../harmony/v2.05/framework -o ip_checksum_bench ip_checksum_bench.c
+        ./ip_checksum_bench [iterations] [seed]
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_ITERATIONS    200000
+#define BENCH_MAX_LEN       1600
+#define BENCH_MAX_SEGMENTS  6
+#define BENCH_CALLS         2000000
+
+// host build configuration
+#define TCPIP_IPV4_FRAGMENTATION    1
+
+// replace the TCP/IP stack definitions used by the checksum helpers
+#define __TCPIP_STACK_PRIVATE_H__
+
+typedef union
+{
+    uint32_t Val;
+    uint16_t w[2];
+    uint8_t  v[4];
+}TCPIP_UINT32_VAL;
+
+typedef struct _tag_TCPIP_MAC_DATA_SEGMENT
+{
+    struct _tag_TCPIP_MAC_DATA_SEGMENT* next;
+    uint8_t*    segLoad;
+    uint16_t    segLen;
+    uint16_t    segSize;
+}TCPIP_MAC_DATA_SEGMENT;
+
+typedef struct _tag_TCPIP_MAC_PACKET
+{
+    struct _tag_TCPIP_MAC_PACKET* pkt_next;
+    TCPIP_MAC_DATA_SEGMENT* pDSeg;
+    uint8_t*    pNetLayer;
+}TCPIP_MAC_PACKET;
+
+static inline uint16_t TCPIP_Helper_htons(uint16_t hShort)
+{
+    return (uint16_t)((hShort << 8) | (hShort >> 8));
+}
+
+// the segment holding dataAddress; the transport search is not needed here
+static TCPIP_MAC_DATA_SEGMENT* TCPIP_PKT_DataSegmentGet(TCPIP_MAC_PACKET* pPkt, const uint8_t* dataAddress, bool srchTransport)
+{
+    TCPIP_MAC_DATA_SEGMENT* pSeg;
+
+    for(pSeg = pPkt->pDSeg; pSeg != 0; pSeg = pSeg->next)
+    {
+        if(pSeg->segLoad <= dataAddress && dataAddress < pSeg->segLoad + pSeg->segSize)
+        {
+            return pSeg;
+        }
+    }
+
+    return 0;
+}
+
+uint16_t TCPIP_Helper_CalcIPChecksum(uint8_t* buffer, uint16_t count, uint16_t seed);
+uint16_t TCPIP_Helper_ChecksumFold(uint32_t rawChksum);
+
+#include "tcpip/src/tcpip_checksum.c"
+
+// the data buffer; 8 bytes of room for the start offsets
+static uint8_t benchBuffer[BENCH_MAX_LEN + 8] __attribute__((aligned(8)));
+
+// the packet test segments and the same data in one buffer
+static uint8_t benchSegBuffer[BENCH_MAX_SEGMENTS][BENCH_MAX_LEN + 8] __attribute__((aligned(8)));
+static uint8_t benchLinear[BENCH_MAX_SEGMENTS * BENCH_MAX_LEN];
+
+static uint32_t benchRandom;
+
+static uint32_t _BenchRandom(void)
+{   // xorshift32
+    benchRandom ^= benchRandom << 13;
+    benchRandom ^= benchRandom >> 17;
+    benchRandom ^= benchRandom << 5;
+    return benchRandom;
+}
+
+static uint32_t _BenchNanoSec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+// RFC 1071 reference
+// little endian 16 bit words, starting at buffer[0] whatever its alignment;
+// an odd last byte is padded with 0
+static uint16_t _BenchChecksumRef(const uint8_t* buffer, uint16_t count, uint16_t seed)
+{
+    uint32_t sum = seed;
+    uint16_t ix;
+
+    for(ix = 0; ix + 1 < count; ix += 2)
+    {
+        sum += (uint32_t)buffer[ix] | ((uint32_t)buffer[ix + 1] << 8);
+    }
+    if(count & 0x1)
+    {
+        sum += buffer[count - 1];
+    }
+
+    while(sum >> 16)
+    {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+
+    return (uint16_t)~sum;
+}
+
+// the previous helpers version: 16 bits at a time
+static uint16_t _BenchChecksum16(uint8_t* buffer, uint16_t count, uint16_t seed)
+{
+    uint16_t i;
+    uint16_t *val;
+    union
+    {
+        uint8_t  b[4];
+        uint16_t w[2];
+        uint32_t dw;
+    } sum;
+
+    val = (uint16_t*)buffer;
+
+    sum.dw = (uint32_t)seed;
+    if ((uintptr_t)buffer % 2)
+    {
+        sum.w[0] += (*(uint8_t *)buffer) << 8;
+        val = (uint16_t *)(buffer + 1);
+        count--;
+    }
+
+    i = count >> 1;
+
+    while(i--)
+        sum.dw += (uint32_t)*val++;
+
+    if(count & 0x1)
+        sum.dw += (uint32_t)*(uint8_t*)val;
+
+    sum.dw = (uint32_t)sum.w[0] + (uint32_t)sum.w[1];
+    sum.w[0] += sum.w[1];
+
+    if ((uintptr_t)buffer % 2)
+    {
+        sum.w[0] = ((uint16_t)sum.b[0] << 8 ) | (uint16_t)sum.b[1];
+    }
+
+    return ~sum.w[0];
+}
+
+static bool _BenchFail(const char* what, uint16_t len, int offset, uint16_t seed, uint16_t chk, uint16_t ref)
+{
+    printf("FAIL %s: len %u, offset %d, seed 0x%04x: 0x%04x, expected 0x%04x\n",
+            what, len, offset, seed, chk, ref);
+    return false;
+}
+
+static bool _BenchProperties(int iterations)
+{
+    int iter, ix;
+
+    for(iter = 0; iter < iterations; iter++)
+    {
+        int offset = iter & 0x7;
+        uint8_t* pData = benchBuffer + offset;
+        uint16_t len;
+        uint16_t seed;
+
+        // short buffers take the alignment and tail paths only; weigh them more
+        len = (iter & 0x8) ? _BenchRandom() % 40 : _BenchRandom() % (BENCH_MAX_LEN + 1);
+        seed = (iter & 0x10) ? (uint16_t)_BenchRandom() : 0;
+        // all ones data piles up the carries
+        for(ix = 0; ix < len; ix++)
+        {
+            pData[ix] = (iter & 0x20) ? (uint8_t)_BenchRandom() : 0xff;
+        }
+
+        uint16_t ref = _BenchChecksumRef(pData, len, seed);
+        uint16_t chk = TCPIP_Helper_CalcIPChecksum(pData, len, seed);
+        if(chk != ref)
+        {
+            return _BenchFail("reference", len, offset, seed, chk, ref);
+        }
+
+        if(len >= 2)
+        {   // store the checksum in the 1st word; the data has to verify
+            pData[0] = 0;
+            pData[1] = 0;
+            chk = TCPIP_Helper_CalcIPChecksum(pData, len, 0);
+            pData[0] = (uint8_t)chk;
+            pData[1] = (uint8_t)(chk >> 8);
+            chk = TCPIP_Helper_CalcIPChecksum(pData, len, 0);
+            if(chk != 0 && chk != 0xffff)
+            {
+                return _BenchFail("verify", len, offset, 0, chk, 0);
+            }
+        }
+    }
+
+    printf("properties: %d buffers\n", iterations);
+    return true;
+}
+
+static bool _BenchPacket(int iterations)
+{
+    TCPIP_MAC_DATA_SEGMENT segs[BENCH_MAX_SEGMENTS];
+    TCPIP_MAC_PACKET pkts[2];
+    int iter, sIx, nSegs, nPkt1, ix;
+    uint8_t* pStart;
+    uint16_t startOffset, total, len, seed;
+    uint16_t chk, ref;
+
+    for(iter = 0; iter < iterations; iter++)
+    {
+        nSegs = 1 + _BenchRandom() % BENCH_MAX_SEGMENTS;
+        total = 0;
+        for(sIx = 0; sIx < nSegs; sIx++)
+        {
+            TCPIP_MAC_DATA_SEGMENT* pSeg = segs + sIx;
+            // odd lengths move the following segments to odd data offsets
+            uint16_t segLen = 1 + _BenchRandom() % ((iter & 0x1) ? 9u : BENCH_MAX_LEN / BENCH_MAX_SEGMENTS);
+
+            pSeg->segLoad = benchSegBuffer[sIx] + _BenchRandom() % 8;
+            pSeg->segLen = pSeg->segSize = segLen;
+            for(ix = 0; ix < segLen; ix++)
+            {
+                pSeg->segLoad[ix] = (iter & 0x2) ? (uint8_t)_BenchRandom() : 0xff;
+            }
+            memcpy(benchLinear + total, pSeg->segLoad, segLen);
+            total += segLen;
+        }
+
+        // the 2nd packet, if any, starts at its network layer
+        nPkt1 = (nSegs > 1 && (iter & 0x4)) ? 1 + _BenchRandom() % (nSegs - 1) : nSegs;
+        for(sIx = 0; sIx < nSegs; sIx++)
+        {
+            segs[sIx].next = (sIx + 1 == nPkt1 || sIx + 1 == nSegs) ? 0 : segs + sIx + 1;
+        }
+        pkts[0].pDSeg = segs;
+        pkts[0].pNetLayer = segs[0].segLoad;
+        pkts[0].pkt_next = 0;
+        if(nPkt1 != nSegs)
+        {
+            pkts[0].pkt_next = pkts + 1;
+            pkts[1].pDSeg = segs + nPkt1;
+            pkts[1].pNetLayer = segs[nPkt1].segLoad;
+            pkts[1].pkt_next = 0;
+        }
+
+        startOffset = _BenchRandom() % segs[0].segLen;
+        pStart = segs[0].segLoad + startOffset;
+        len = 1 + _BenchRandom() % (total - startOffset);
+        seed = (iter & 0x8) ? (uint16_t)_BenchRandom() : 0;
+
+        ref = _BenchChecksumRef(benchLinear + startOffset, len, seed);
+        chk = TCPIP_Helper_PacketChecksum(pkts, pStart, len, seed);
+        if(chk != ref)
+        {
+            printf("%d segments, %d in the 1st packet, start at %u\n", nSegs, nPkt1, startOffset);
+            return _BenchFail("packet", len, (int)((uintptr_t)pStart & 0x7), seed, chk, ref);
+        }
+    }
+
+    printf("packets: %d packets\n", iterations);
+    return true;
+}
+
+static void _BenchRun(uint16_t len, int offset)
+{
+    static uint16_t (* const benchFncs[])(uint8_t* buffer, uint16_t count, uint16_t seed) =
+    {
+        _BenchChecksum16,
+        TCPIP_Helper_CalcIPChecksum,
+    };
+
+    int fIx, call;
+    uint8_t* pData = benchBuffer + offset;
+    int nCalls = BENCH_CALLS / (len / 64 + 1);
+
+    printf("%6u %6d", len, offset);
+    for(fIx = 0; fIx < sizeof(benchFncs) / sizeof(*benchFncs); fIx++)
+    {
+        volatile uint16_t sink = 0;
+        uint32_t startNs = _BenchNanoSec();
+        for(call = 0; call < nCalls; call++)
+        {
+            sink += (*benchFncs[fIx])(pData, len, (uint16_t)call);
+        }
+        uint32_t ns = _BenchNanoSec() - startNs;
+        printf(" %9.1f %8.1f", (double)ns / nCalls, (double)len * nCalls * 1000.0 / ns);
+    }
+    printf("\n");
+}
+
+int main(int argc, char* argv[])
+{
+    static const uint16_t benchLens[] = { 20, 64, 576, 1460 };
+    int iterations = argc > 1 ? atoi(argv[1]) : BENCH_ITERATIONS;
+    int lIx, offset;
+
+    benchRandom = argc > 2 ? (uint32_t)strtoul(argv[2], 0, 0) : 0x2545f491;
+    if(benchRandom == 0)
+    {
+        benchRandom = 1;
+    }
+
+    if(!_BenchProperties(iterations) || !_BenchPacket(iterations))
+    {
+        return 1;
+    }
+
+    for(lIx = 0; lIx < sizeof(benchBuffer); lIx++)
+    {
+        benchBuffer[lIx] = (uint8_t)_BenchRandom();
+    }
+
+    printf("%6s %6s %9s %8s %9s %8s\n", "bytes", "offset", "16b ns", "MB/s", "new ns", "MB/s");
+    for(lIx = 0; lIx < sizeof(benchLens) / sizeof(*benchLens); lIx++)
+    {
+        for(offset = 0; offset < 3; offset++)
+        {
+            _BenchRun(benchLens[lIx], offset);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,646 @@
+/*
+    json_bench.c
+
+    Host fuzz and throughput harness of the JSON key extractor
+    ( home_automation/module_json.c ).
+
+    1. Fixed documents : expected values and rejects.
+    2. Generated documents : random well formed documents with random nesting,
+       white space and key order. Extracted values are compared with the
+       values recorded by the generator, for "state.desired" path and for
+       any depth search.
+    3. Mutations : generated documents with flipped, inserted and deleted
+       bytes. Extractor may accept or reject them, but returned values have
+       to stay inside of the source buffer. Truncated documents have to be
+       rejected.
+    4. Throughput of the two shadow documents handled by the connector.
+
+    Every document is copied to a buffer of its exact size, without string
+    terminator, so reads past the end are caught by the address sanitizer.
+
+    Build and run, from this directory:
+        gcc -O2 -g -Wall -Wextra -fsanitize=address,undefined \
+            -I../../../../home_automation -o json_bench json_bench.c
+        ./json_bench [iterations] [seed]
+
+    Drop the sanitizer options to measure the throughput.
+
+----------------------------------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "module_json.c"
+
+/* ------------------------------------------------------------------- MACROS */
+
+#define BENCH_ITERATIONS            200000
+#define BENCH_DOC_SIZE              2048
+#define BENCH_MUTATIONS             8
+#define BENCH_TIME_NS               1000000000ull
+
+#define FIELD_CNT                   3
+
+/* -------------------------------------------------------------------- TYPES */
+
+typedef struct
+{
+    char        text[ BENCH_DOC_SIZE ];
+    size_t      len;
+
+    //  Expected values, index of the field in bench_keys.
+
+    char        path_value[ FIELD_CNT ][ 32 ];
+    bool        path_found[ FIELD_CNT ];
+    char        any_value[ FIELD_CNT ][ 32 ];
+    bool        any_found[ FIELD_CNT ];
+
+} BENCH_DOC;
+
+/* ---------------------------------------------------------------- VARIABLES */
+
+static const char *bench_keys[ FIELD_CNT ] = { "TARGET_T", "FAN", "AIRCON" };
+
+static const char *bench_other_keys[ ] = { "state", "desired", "reported",
+        "metadata", "version", "timestamp", "clientId", "TARGET", "FAN_",
+        "fan", "SENSOR_T", "" };
+
+static const char *bench_values[ ] = { "\"LOW\"", "\"HIGH\"", "\"OFF\"",
+        "21.5", "-3", "1.5E+2", "0", "true", "false", "null", "\"\"",
+        "\"a\\\"b\"", "\"x y\"", "\"\\\\\"" };
+
+static uint32_t bench_seed = 1;
+
+static uint32_t fail_cnt;
+
+/* -------------------------------------------------------- PRIVATE FUNCTIONS */
+
+static uint32_t bench_rand ( void )
+{
+    //  xorshift32, same sequence for the same seed on every host.
+
+    bench_seed ^= bench_seed << 13;
+    bench_seed ^= bench_seed >> 17;
+    bench_seed ^= bench_seed << 5;
+
+    return bench_seed;
+}
+
+static uint64_t bench_ns ( void )
+{
+    struct timespec ts;
+
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+
+    return ( uint64_t ) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void fail ( const char *what, const char *doc, size_t len )
+{
+    if ( ++fail_cnt <= 10 )
+    {
+        printf( "FAIL %s : %.*s\n", what, ( int ) len, doc );
+    }
+}
+
+/*
+    Runs the extractor on a copy of exactly len bytes. Returns the result and
+    the values copied to NUL terminated strings ( NULL if not found ).
+*/
+
+static JSON_RETURN extract_copy ( const char *doc, size_t len,
+        const char *path, char values[ FIELD_CNT ][ 32 ], bool *found )
+{
+    JSON_FIELD  fields[ FIELD_CNT ];
+    JSON_RETURN ret;
+    char        *buf = malloc( len ? len : 1 );
+    uint8_t     i;
+
+    memcpy( buf, doc, len );
+
+    for ( i = 0; i < FIELD_CNT; i++ )
+    {
+        fields[ i ].key = bench_keys[ i ];
+    }
+
+    ret = JSON_Extract( buf, len, path, fields, FIELD_CNT );
+
+    for ( i = 0; i < FIELD_CNT; i++ )
+    {
+        found[ i ] = ( fields[ i ].value != NULL );
+
+        if ( !found[ i ] )
+        {
+            continue;
+        }
+
+        if ( ( ret != JSON_OK ) || ( fields[ i ].value < buf ) ||
+                ( fields[ i ].value + fields[ i ].length > buf + len ) )
+        {
+            fail( "value outside of the document", doc, len );
+            found[ i ] = false;
+            continue;
+        }
+
+        snprintf( values[ i ], 32, "%.*s", fields[ i ].length,
+                fields[ i ].value );
+    }
+
+    free( buf );
+
+    return ret;
+}
+
+/* ------------------------------------------------------- FIXED DOCUMENTS */
+
+typedef struct
+{
+    const char  *doc;
+    const char  *path;
+    JSON_RETURN ret;
+    const char  *target;    //  NULL when not found
+    const char  *fan;
+    size_t      len;        //  0 for strlen( doc )
+
+} BENCH_CASE;
+
+static const BENCH_CASE bench_cases[ ] =
+{
+    { "{\"state\":{\"desired\":{\"TARGET_T\":\"22.5\",\"FAN\":\"LOW\"}}}",
+            "state.desired", JSON_OK, "22.5", "LOW", 0 },
+    { "{\"state\":{\"desired\":{\"FAN\":\"HIGH\",\"TARGET_T\":19}}}",
+            NULL, JSON_OK, "19", "HIGH", 0 },
+    { "{\"state\":{\"TARGET_T\":20},\"version\":7}",
+            "state", JSON_OK, "20", NULL, 0 },
+    { "{\"state\":{\"reported\":{\"FAN\":\"OFF\"}}}",
+            "state.desired", JSON_OK, NULL, NULL, 0 },
+    { "{\"FAN\":\"LOW\",\"x\":{\"FAN\":\"HIGH\"}}",
+            "", JSON_OK, NULL, "LOW", 0 },
+    { "{\"FAN\":\"LOW\",\"x\":{\"FAN\":\"HIGH\"}}",
+            NULL, JSON_OK, NULL, "HIGH", 0 },
+    { "{\"FAN\":{\"TARGET_T\":1},\"TARGET_T\":[2,{\"FAN\":3}]}",
+            "", JSON_OK, NULL, NULL, 0 },
+    { " \r\n{ \"TARGET_T\" : -1.5E+1 } \n", "", JSON_OK, "-1.5E+1", NULL, 0 },
+    { "{\"TARGET_T\":1}\0\0", "", JSON_OK, "1", NULL, 16 },
+    { "{}", NULL, JSON_OK, NULL, NULL, 0 },
+    { "", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "[]", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":\"LOW\"", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":\"LOW}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\" \"LOW\"}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":\"LOW\",}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":\"LOW\"}}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":\"LO\nW\"}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":\"LOW\\", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"a\":[1,2}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"a\":}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"a\":1 2}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"a\":{\"b\":{\"c\":{\"d\":{\"e\":{\"f\":{\"g\":{\"FAN\":1}}}}}}}}",
+            NULL, JSON_OK, NULL, "1", 0 },
+    { "{\"a\":{\"b\":{\"c\":{\"d\":{\"e\":{\"f\":{\"g\":{\"h\":{}}}}}}}}}",
+            NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"a\":[[[[[[[1]]]]]]]}", NULL, JSON_OK, NULL, NULL, 0 },
+    { "{\"a\":[[[[[[[[1]]]]]]]]}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":true,\"TARGET_T\":null}", NULL, JSON_OK, "null", "true", 0 },
+    { "{\"FAN\":false}", NULL, JSON_OK, NULL, "false", 0 },
+    { "{\"TARGET_T\":2e-1}", NULL, JSON_OK, "2e-1", NULL, 0 },
+    { "{\"FAN\":tru}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":fals}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":nul}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":truex}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":[true,nulll]}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":1a}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":abc}", NULL, JSON_ERROR, NULL, NULL, 0 },
+    { "{\"FAN\":tru", NULL, JSON_ERROR, NULL, NULL, 0 },
+};
+
+static void run_cases ( void )
+{
+    size_t  i;
+
+    for ( i = 0; i < sizeof( bench_cases ) / sizeof( bench_cases[ 0 ] ); i++ )
+    {
+        const BENCH_CASE    *c = &bench_cases[ i ];
+        char                values[ FIELD_CNT ][ 32 ];
+        bool                found[ FIELD_CNT ];
+        size_t              len = c->len ? c->len : strlen( c->doc );
+        JSON_RETURN         ret;
+
+        ret = extract_copy( c->doc, len, c->path, values, found );
+
+        if ( ( ret != c->ret ) ||
+             ( ( c->target == NULL ) != !found[ 0 ] ) ||
+             ( c->target && strcmp( c->target, values[ 0 ] ) ) ||
+             ( ( c->fan == NULL ) != !found[ 1 ] ) ||
+             ( c->fan && strcmp( c->fan, values[ 1 ] ) ) )
+        {
+            fail( "fixed document", c->doc, strlen( c->doc ) );
+        }
+    }
+
+    printf( "fixed documents   : %u cases\n",
+            ( unsigned ) ( sizeof( bench_cases ) /
+                           sizeof( bench_cases[ 0 ] ) ) );
+}
+
+/* --------------------------------------------------- GENERATED DOCUMENTS */
+
+static void gen_put ( BENCH_DOC *d, const char *s )
+{
+    size_t  n = strlen( s );
+
+    if ( d->len + n < BENCH_DOC_SIZE )
+    {
+        memcpy( &d->text[ d->len ], s, n );
+        d->len += n;
+    }
+}
+
+static void gen_ws ( BENCH_DOC *d )
+{
+    static const char *ws[ ] = { "", "", "", " ", "\n", "\r\n  ", "\t" };
+
+    gen_put( d, ws[ bench_rand( ) % 7 ] );
+}
+
+static void gen_record ( BENCH_DOC *d, const char *key, const char *value,
+        bool on_path )
+{
+    uint8_t i;
+    size_t  n = strlen( value );
+
+    //  Extractor reports strings without quotes.
+
+    if ( value[ 0 ] == '\"' )
+    {
+        ++value;
+        n -= 2;
+    }
+
+    for ( i = 0; i < FIELD_CNT; i++ )
+    {
+        if ( strcmp( key, bench_keys[ i ] ) != 0 )
+        {
+            continue;
+        }
+
+        snprintf( d->any_value[ i ], 32, "%.*s", ( int ) n, value );
+        d->any_found[ i ] = true;
+
+        if ( on_path )
+        {
+            snprintf( d->path_value[ i ], 32, "%.*s", ( int ) n, value );
+            d->path_found[ i ] = true;
+        }
+    }
+}
+
+static void gen_value ( BENCH_DOC *d, uint8_t depth );
+
+/*
+    path_pos : number of "state.desired" segments matched by this object,
+    2 for the target object itself, -1 when off the path.
+*/
+
+static void gen_object ( BENCH_DOC *d, uint8_t depth, int path_pos )
+{
+    uint32_t    n = bench_rand( ) % 5;
+    uint32_t    i;
+
+    gen_put( d, "{" );
+    gen_ws( d );
+
+    for ( i = 0; i < n; i++ )
+    {
+        const char  *key;
+        uint32_t    r = bench_rand( ) % 16;
+        int         next = -1;
+
+        if ( r < 6 )
+        {
+            key = bench_keys[ r % FIELD_CNT ];
+        }
+        else if ( ( r < 9 ) && ( path_pos == 0 ) )
+        {
+            key = "state";
+        }
+        else if ( ( r < 9 ) && ( path_pos == 1 ) )
+        {
+            key = "desired";
+        }
+        else
+        {
+            key = bench_other_keys[ bench_rand( ) %
+                    ( sizeof( bench_other_keys ) / sizeof( char * ) ) ];
+        }
+
+        if ( ( path_pos == 0 ) && ( strcmp( key, "state" ) == 0 ) )
+        {
+            next = 1;
+        }
+        else if ( ( path_pos == 1 ) && ( strcmp( key, "desired" ) == 0 ) )
+        {
+            next = 2;
+        }
+
+        if ( i != 0 )
+        {
+            gen_put( d, "," );
+            gen_ws( d );
+        }
+
+        gen_put( d, "\"" );
+        gen_put( d, key );
+        gen_put( d, "\"" );
+        gen_ws( d );
+        gen_put( d, ":" );
+        gen_ws( d );
+
+        if ( ( depth < JSON_MAX_DEPTH ) && ( ( next > 0 ) ||
+                    ( bench_rand( ) % 4 == 0 ) ) )
+        {
+            if ( ( next < 0 ) && ( bench_rand( ) & 1 ) )
+            {
+                gen_value( d, depth + 1 );
+            }
+            else
+            {
+                gen_object( d, depth + 1, next );
+            }
+        }
+        else
+        {
+            const char *value = bench_values[ bench_rand( ) %
+                    ( sizeof( bench_values ) / sizeof( char * ) ) ];
+
+            gen_put( d, value );
+            gen_record( d, key, value, path_pos == 2 );
+        }
+
+        gen_ws( d );
+    }
+
+    gen_put( d, "}" );
+}
+
+static void gen_value ( BENCH_DOC *d, uint8_t depth )
+{
+    uint32_t    n = bench_rand( ) % 4;
+    uint32_t    i;
+
+    //  Array, scalars and objects in it are never on the path.
+
+    gen_put( d, "[" );
+    gen_ws( d );
+
+    for ( i = 0; i < n; i++ )
+    {
+        if ( i != 0 )
+        {
+            gen_put( d, "," );
+        }
+
+        if ( ( depth < JSON_MAX_DEPTH ) && ( bench_rand( ) % 3 == 0 ) )
+        {
+            gen_object( d, depth + 1, -1 );
+        }
+        else
+        {
+            gen_put( d, bench_values[ bench_rand( ) %
+                    ( sizeof( bench_values ) / sizeof( char * ) ) ] );
+        }
+
+        gen_ws( d );
+    }
+
+    gen_put( d, "]" );
+}
+
+static void gen_doc ( BENCH_DOC *d )
+{
+    memset( d, 0, sizeof( *d ) );
+
+    gen_ws( d );
+    gen_object( d, 1, 0 );
+    gen_ws( d );
+}
+
+static bool check_values ( const char exp[ FIELD_CNT ][ 32 ],
+        const bool *exp_found, char values[ FIELD_CNT ][ 32 ],
+        const bool *found )
+{
+    uint8_t i;
+
+    for ( i = 0; i < FIELD_CNT; i++ )
+    {
+        if ( ( exp_found[ i ] != found[ i ] ) ||
+                ( found[ i ] && strcmp( exp[ i ], values[ i ] ) ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void run_generated ( uint32_t iterations )
+{
+    static BENCH_DOC    d;
+    char                values[ FIELD_CNT ][ 32 ];
+    bool                found[ FIELD_CNT ];
+    uint32_t            it;
+    uint32_t            accepted = 0;
+    uint32_t            rejected = 0;
+
+    for ( it = 0; it < iterations; it++ )
+    {
+        uint32_t    m;
+
+        gen_doc( &d );
+
+        if ( d.len >= BENCH_DOC_SIZE - 1 )
+        {
+            //  Generator ran out of buffer, document is incomplete.
+
+            continue;
+        }
+
+        if ( ( extract_copy( d.text, d.len, "state.desired", values,
+                        found ) != JSON_OK ) ||
+             !check_values( d.path_value, d.path_found, values, found ) )
+        {
+            fail( "generated document, path", d.text, d.len );
+        }
+
+        if ( ( extract_copy( d.text, d.len, NULL, values, found ) !=
+                        JSON_OK ) ||
+             !check_values( d.any_value, d.any_found, values, found ) )
+        {
+            fail( "generated document, any depth", d.text, d.len );
+        }
+
+        //  Every strict prefix ending before the last brace is incomplete.
+
+        {
+            size_t  last = d.len;
+
+            while ( d.text[ --last ] != '}' )
+            {
+            }
+
+            if ( extract_copy( d.text, bench_rand( ) % ( last + 1 ), NULL,
+                        values, found ) != JSON_ERROR )
+            {
+                fail( "truncated document accepted", d.text, d.len );
+            }
+        }
+
+        //  Mutated copies only have to be handled safely.
+
+        for ( m = 0; m < BENCH_MUTATIONS; m++ )
+        {
+            static char mut[ BENCH_DOC_SIZE + BENCH_MUTATIONS ];
+            size_t      len = d.len;
+            uint32_t    k;
+            uint32_t    n = 1 + bench_rand( ) % 3;
+
+            memcpy( mut, d.text, len );
+
+            for ( k = 0; ( k < n ) && ( len > 0 ); k++ )
+            {
+                size_t  pos = bench_rand( ) % len;
+                char    c = ( char ) ( bench_rand( ) & 0xFF );
+
+                switch ( bench_rand( ) % 3 )
+                {
+                    case 0:
+                        mut[ pos ] = c;
+                        break;
+                    case 1:
+                        memmove( &mut[ pos + 1 ], &mut[ pos ], len - pos );
+                        mut[ pos ] = c;
+                        ++len;
+                        break;
+                    default:
+                        memmove( &mut[ pos ], &mut[ pos + 1 ],
+                                len - pos - 1 );
+                        --len;
+                        break;
+                }
+            }
+
+            if ( extract_copy( mut, len, ( m & 1 ) ? NULL : "state.desired",
+                        values, found ) == JSON_OK )
+            {
+                ++accepted;
+            }
+            else
+            {
+                ++rejected;
+            }
+        }
+    }
+
+    printf( "generated         : %u documents, %u mutations ( %u accepted, "
+            "%u rejected )\n", iterations, accepted + rejected, accepted,
+            rejected );
+}
+
+/* ------------------------------------------------------------ THROUGHPUT */
+
+static const char bench_delta[ ] =
+    "{\"version\":1021,\"timestamp\":1550063418,\"state\":{\"TARGET_T\":"
+    "\"23.5\",\"FAN\":\"HIGH\"},\"metadata\":{\"TARGET_T\":{\"timestamp\":"
+    "1550063418},\"FAN\":{\"timestamp\":1550063418}}}";
+
+static const char bench_shadow[ ] =
+    "{\"state\":{\"desired\":{\"TARGET_T\":\"23.5\",\"FAN\":\"HIGH\","
+    "\"AIRCON\":\"OFF\"},\"reported\":{\"TARGET_T\":\"21.0\",\"FAN\":\"LOW\","
+    "\"AIRCON\":\"OFF\",\"SENSOR_T\":\"20.7\",\"SENSOR_H\":\"41.3\"}},"
+    "\"metadata\":{\"desired\":{\"TARGET_T\":{\"timestamp\":1550063418},"
+    "\"FAN\":{\"timestamp\":1550063418},\"AIRCON\":{\"timestamp\":"
+    "1550063410}},\"reported\":{\"TARGET_T\":{\"timestamp\":1550063401},"
+    "\"FAN\":{\"timestamp\":1550063401},\"AIRCON\":{\"timestamp\":"
+    "1550063401},\"SENSOR_T\":{\"timestamp\":1550063417},\"SENSOR_H\":{"
+    "\"timestamp\":1550063417}}},\"version\":1021,\"timestamp\":1550063418,"
+    "\"clientToken\":\"curiosity-pic32mzef\"}";
+
+static void run_throughput ( const char *name, const char *doc,
+        const char *path )
+{
+    JSON_FIELD  fields[ FIELD_CNT ];
+    size_t      len = strlen( doc );
+    uint64_t    start = bench_ns( );
+    uint64_t    elapsed;
+    uint32_t    n = 0;
+    uint8_t     i;
+
+    for ( i = 0; i < FIELD_CNT; i++ )
+    {
+        fields[ i ].key = bench_keys[ i ];
+    }
+
+    do
+    {
+        uint32_t    k;
+
+        for ( k = 0; k < 1000; k++ )
+        {
+            if ( JSON_Extract( doc, len, path, fields, FIELD_CNT ) != JSON_OK )
+            {
+                fail( "throughput document", doc, len );
+                return;
+            }
+        }
+
+        n += 1000;
+        elapsed = bench_ns( ) - start;
+
+    } while ( elapsed < BENCH_TIME_NS );
+
+    printf( "%-18s: %4u bytes, %7.1f ns/message, %7.1f MB/s\n", name,
+            ( unsigned ) len, ( double ) elapsed / n,
+            ( double ) len * n * 1000.0 / elapsed );
+}
+
+/* ------------------------------------------------------------------ MAIN */
+
+int main ( int argc, char *argv[ ] )
+{
+    uint32_t    iterations = BENCH_ITERATIONS;
+
+    if ( argc > 1 )
+    {
+        iterations = ( uint32_t ) strtoul( argv[ 1 ], NULL, 0 );
+    }
+
+    if ( argc > 2 )
+    {
+        bench_seed = ( uint32_t ) strtoul( argv[ 2 ], NULL, 0 );
+    }
+
+    if ( bench_seed == 0 )
+    {
+        bench_seed = 1;
+    }
+
+    run_cases( );
+    run_generated( iterations );
+    run_throughput( "delta, state", bench_delta, "state" );
+    run_throughput( "shadow, any depth", bench_shadow, NULL );
+    run_throughput( "shadow, desired", bench_shadow, "state.desired" );
+
+    if ( fail_cnt != 0 )
+    {
+        printf( "%u failures\n", fail_cnt );
+        return 1;
+    }
+
+    printf( "passed\n" );
+
+    return 0;
+}
+
+/* -------------------------------------------------------------------------- */
@@ -0,0 +1,174 @@
+import sys
+import struct
+import argparse
+
+# Decodes the TCP/IP packet recorder dump ("pktrec dump" console command)
+# and rebuilds per-packet lifetimes and latencies.
+
+REC_FORMAT = '<IIHHBbH'
+REC_SIZE = struct.calcsize(REC_FORMAT)
+REC_PREFIX = 'pktrec: '
+REC_VERSION = 1
+
+EVENT_NAMES = {1: 'ALLOC', 2: 'FREE', 3: 'RX', 4: 'TX', 5: 'ACK'}
+EV_ALLOC, EV_FREE, EV_RX, EV_TX, EV_ACK = 1, 2, 3, 4, 5
+
+
+def parseParams():
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument('log', nargs='?', help="Console log containing the dump; stdin if missing.")
+    parser.add_argument('-e', '--events', action='store_true', help="Print every decoded record.")
+    parser.add_argument('-p', '--packets', action='store_true', help="Print the lifetime of every packet.")
+
+    args = vars(parser.parse_args())
+    return args
+
+
+def readDump(lines):
+    """
+    extract the last complete dump from a console log
+
+    :param lines: console log lines
+    :return: (tsFreq, recCount, list of raw records)
+    """
+    dump = None
+    header = None
+    result = None
+    for line in lines:
+        pos = line.find(REC_PREFIX)
+        if pos < 0:
+            continue
+        line = line[pos + len(REC_PREFIX):].strip()
+        fields = line.split()
+        if len(fields) == 4 and fields[0] == str(REC_VERSION):
+            header = (int(fields[1]), int(fields[3]))
+            dump = bytearray()
+        elif line == 'end' and dump is not None:
+            result = (header[0], header[1], dump)
+            dump = None
+        elif dump is not None:
+            dump += bytes.fromhex(line)
+
+    if result is None:
+        sys.exit('no complete packet recorder dump found')
+
+    tsFreq, recCount, raw = result
+    recs = [struct.unpack_from(REC_FORMAT, raw, off) for off in range(0, len(raw) - REC_SIZE + 1, REC_SIZE)]
+    return tsFreq, recCount, recs
+
+
+def validRecords(recCount, recs):
+    """
+    number the records and drop the ones overwritten while being dumped
+
+    :return: list of (recNo, timeStamp, pktId, moduleId, pktLen, event, arg)
+    """
+    valid = []
+    recNo = recCount - len(recs)
+    for ts, pktId, moduleId, pktLen, event, arg, seq in recs:
+        if seq == (recNo & 0xffff) and event in EVENT_NAMES:
+            valid.append((recNo, ts, pktId, moduleId, pktLen, event, arg))
+        recNo += 1
+
+    return valid
+
+
+def percentile(values, pct):
+    idx = min(len(values) - 1, int(len(values) * pct / 100))
+    return values[idx]
+
+
+def printStats(title, values):
+    if not values:
+        return
+    values.sort()
+    print('{:<14} n={:<5} min={:9.1f} avg={:9.1f} p50={:9.1f} p99={:9.1f} max={:9.1f} us'.format(
+        title, len(values), values[0], sum(values) / len(values),
+        percentile(values, 50), percentile(values, 99), values[-1]))
+
+
+def main():
+    args = parseParams()
+
+    if args['log']:
+        with open(args['log'], errors='replace') as f:
+            lines = f.readlines()
+    else:
+        lines = sys.stdin.readlines()
+
+    tsFreq, recCount, raw = readDump(lines)
+    recs = validRecords(recCount, raw)
+    print('{} records made, {} dumped, {} valid, time base {} Hz'.format(recCount, len(raw), len(recs), tsFreq))
+    if not recs:
+        return
+
+    usPerTick = 1000000.0 / tsFreq
+    t0 = recs[0][1]
+
+    # the time stamps are 32 bit counters; unwrap them in record order
+    # the deltas are signed: a record can carry a stamp slightly older than the previous one
+    elapsed = 0
+    prevTs = t0
+    timeline = []
+    for recNo, ts, pktId, moduleId, pktLen, event, arg in recs:
+        delta = (ts - prevTs) & 0xffffffff
+        if delta >= 0x80000000:
+            delta -= 0x100000000
+        elapsed += delta
+        prevTs = ts
+        timeline.append((recNo, elapsed * usPerTick, pktId, moduleId, pktLen, event, arg))
+
+    if args['events']:
+        for recNo, us, pktId, moduleId, pktLen, event, arg in timeline:
+            print('{:8d} {:12.1f} {:08x} {:5s} mod 0x{:04x} len {:5d} arg {:4d}'.format(
+                recNo, us, pktId, EVENT_NAMES[event], moduleId, pktLen, arg))
+
+    # a packet life starts with its first record after an ALLOC and ends with FREE;
+    # the same address is reused by later packets
+    live = {}
+    lives = []
+    for recNo, us, pktId, moduleId, pktLen, event, arg in timeline:
+        if event == EV_ALLOC or pktId not in live:
+            if pktId in live:
+                lives.append(live[pktId])
+            live[pktId] = {'id': pktId, 'events': []}
+        live[pktId]['events'].append((us, event, moduleId, pktLen, arg))
+        if event == EV_FREE:
+            lives.append(live.pop(pktId))
+    lives.extend(live.values())
+
+    lifetime = []
+    txAck = []
+    rxAck = []
+    ackErrors = 0
+    for life in lives:
+        events = life['events']
+        first = events[0]
+        last = events[-1]
+        if first[1] == EV_ALLOC and last[1] == EV_FREE:
+            lifetime.append(last[0] - first[0])
+        start = {}
+        for us, event, moduleId, pktLen, arg in events:
+            if event in (EV_TX, EV_RX) and event not in start:
+                start[event] = us
+            elif event == EV_ACK:
+                if arg < 0:
+                    ackErrors += 1
+                if EV_TX in start:
+                    txAck.append(us - start.pop(EV_TX))
+                elif EV_RX in start:
+                    rxAck.append(us - start.pop(EV_RX))
+
+        if args['packets']:
+            print('{:08x}: {}'.format(life['id'], ' '.join(
+                '{}@{:.1f}'.format(EVENT_NAMES[e[1]], e[0] - first[0]) for e in events)))
+
+    print('{} packets, {} ack errors'.format(len(lives), ackErrors))
+    printStats('alloc->free', lifetime)
+    printStats('tx->ack', txAck)
+    printStats('rx->ack', rxAck)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,452 @@
+/*******************************************************************************
+  System Timer Service Host Benchmark
+
+  File Name:
+    sys_tmr_bench.c
+
+  Summary:
+    Measures the SYS_TMR alarm processing time against the number of clients.
+
+  Description:
+    The system timer service source is built on the host, on top of minimal
+    timer driver, clock and OSAL replacements.
+    The system ticks are generated by calling the timer alarm callback directly.
+    For 4 up to SYS_TMR_MAX_CLIENT_OBJECTS clients the benchmark runs
+    BENCH_TICKS system ticks and prints the alarm processing statistics
+    (SYS_TMR_AlarmStatisticsGet) in nanoseconds.
+    3/4 of the clients are periodic, the rest are single shot, auto delete
+    timers that are created again as soon as they fire.
+
+    Build and run, from this directory:
+        gcc -O2 -I. -I../../../harmony/v2.05/framework -o sys_tmr_bench sys_tmr_bench.c
+        ./sys_tmr_bench
+
+    Add -DSYS_TMR_CLIENT_HEAP=false to measure the client array scan,
+    -DSYS_TMR_INTERRUPT_NOTIFICATION=false for the TMR thread processing and
+    -DSYS_TMR_MAX_CLIENT_OBJECTS=n to change the client array size.
+    Both client processing methods should print the same callbacks checksum.
+
+    Add -DSYS_TMR_TICKLESS=true to run the tickless mode. The timer driver is
+    then a model of the 16 bit TMR2: the counter matches on the period
+    register, the alarm is serviced as soon as it is enabled, and the period
+    can be changed while the counter runs. The time advances in pseudo random
+    steps of up to BENCH_TICKLESS_MAX_STEP counts; after each step the tick
+    count has to match the elapsed time. The callbacks checksum has to match
+    the per tick modes, the alarms column shows the timer interrupts taken.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "system_config.h"
+
+// replace the Harmony headers included by the SYS_TMR
+#define _SYS_COMMON_H_
+#define _SYS_MODULE_H
+#define _SYS_CLK_H
+#define _DRV_TMR_H
+#define _OSAL_H
+
+#define BENCH_TICKS         60000
+
+#define BENCH_TICKLESS_MAX_STEP     1500
+
+// system
+typedef unsigned short int  SYS_MODULE_INDEX;
+typedef uintptr_t           SYS_MODULE_OBJ;
+typedef union
+{
+    uint8_t         value;
+}SYS_MODULE_INIT;
+
+typedef enum
+{
+    SYS_STATUS_ERROR            = -1,
+    SYS_STATUS_UNINITIALIZED    = 0,
+    SYS_STATUS_BUSY             = 1,
+    SYS_STATUS_READY            = 2,
+}SYS_STATUS;
+
+#define SYS_MODULE_OBJ_INVALID      ((SYS_MODULE_OBJ) -1 )
+#define SYS_MODULE_POWER_RUN_FULL   2
+
+// the statistics cycles counter: 1 ns resolution
+static uint32_t _BenchNanoSec(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+#define _CP0_GET_COUNT()    _BenchNanoSec()
+
+static uint32_t SYS_CLK_SystemFrequencyGet(void)
+{
+    return 2000000000;
+}
+
+// timer driver
+typedef uintptr_t   DRV_HANDLE;
+typedef void ( *DRV_TMR_CALLBACK ) ( uintptr_t context, uint32_t alarmCount );
+
+#define DRV_HANDLE_INVALID          ((DRV_HANDLE)(-1))
+#define DRV_IO_INTENT_EXCLUSIVE     0
+#define DRV_TMR_INDEX_0             0
+#define DRV_TMR_FREQUENCY           1000000
+
+static bool                 drvAlarmEnabled;
+static uintptr_t            drvAlarmContext;
+static DRV_TMR_CALLBACK     drvAlarmCallback;
+
+static DRV_HANDLE DRV_TMR_Open(SYS_MODULE_INDEX index, int intent)
+{
+    return 1;
+}
+
+static void DRV_TMR_Close(DRV_HANDLE handle)
+{
+}
+
+static uint32_t DRV_TMR_CounterFrequencyGet(DRV_HANDLE handle)
+{
+    return DRV_TMR_FREQUENCY;
+}
+
+#if (SYS_TMR_TICKLESS)
+// TMR2 model
+static uint32_t             drvPeriodReg;   // period register
+static uint32_t             drvCounter;     // counter register
+static bool                 drvPending;     // interrupt flag
+static uint32_t             drvIsrCount;    // alarms serviced
+#endif  // (SYS_TMR_TICKLESS)
+
+static bool DRV_TMR_AlarmRegister(DRV_HANDLE handle, uint32_t divider, bool isPeriodic, uintptr_t context, DRV_TMR_CALLBACK callBack)
+{
+    drvAlarmContext = context;
+    drvAlarmCallback = callBack;
+#if (SYS_TMR_TICKLESS)
+    drvPeriodReg = divider - 1;
+    drvCounter = 0;
+    drvPending = false;
+#endif  // (SYS_TMR_TICKLESS)
+    return true;
+}
+
+static bool DRV_TMR_AlarmDisable(DRV_HANDLE handle)
+{
+    bool wasEnabled = drvAlarmEnabled;
+    drvAlarmEnabled = false;
+    return wasEnabled;
+}
+
+static void DRV_TMR_AlarmEnable(DRV_HANDLE handle, bool enable)
+{
+    drvAlarmEnabled = enable;
+}
+
+static bool DRV_TMR_Start(DRV_HANDLE handle)
+{
+    return true;
+}
+
+#if (SYS_TMR_TICKLESS)
+static uint32_t DRV_TMR_CounterValueGet(DRV_HANDLE handle)
+{
+    return drvCounter;
+}
+
+static bool DRV_TMR_AlarmPeriodUpdate(DRV_HANDLE handle, uint32_t value)
+{
+    if(drvPending)
+    {   // the current period is over; too late to change it
+        return false;
+    }
+
+    if(value > 0xffff || value < drvCounter)
+    {   // the counter would run past the period
+        fprintf(stderr, "period 0x%x set with the counter at 0x%x\n", value, drvCounter);
+        exit(1);
+    }
+
+    drvPeriodReg = value;
+    return true;
+}
+
+static bool DRV_TMR_AlarmPendingGet(DRV_HANDLE handle)
+{
+    return drvPending;
+}
+
+// services a pending alarm, if enabled
+static bool BenchTimerIsr(void)
+{
+    if(!drvPending || !drvAlarmEnabled)
+    {
+        return false;
+    }
+
+    drvPending = false;
+    drvIsrCount++;
+    drvAlarmCallback(drvAlarmContext, drvIsrCount);
+    return true;
+}
+#else
+static uint32_t DRV_TMR_CounterValueGet(DRV_HANDLE handle)
+{
+    return 0;
+}
+#endif  // (SYS_TMR_TICKLESS)
+
+// OSAL
+typedef int     OSAL_SEM_HANDLE_TYPE;
+typedef int     OSAL_CRITSECT_DATA_TYPE;
+
+#define OSAL_RESULT_TRUE        1
+#define OSAL_SEM_TYPE_BINARY    0
+#define OSAL_WAIT_FOREVER       (-1)
+#define OSAL_CRIT_TYPE_LOW      0
+
+static int OSAL_SEM_Create(OSAL_SEM_HANDLE_TYPE* pSem, int type, int maxCount, int initialCount)
+{
+    *pSem = initialCount;
+    return OSAL_RESULT_TRUE;
+}
+
+static void OSAL_SEM_Delete(OSAL_SEM_HANDLE_TYPE* pSem)
+{
+}
+
+static void OSAL_SEM_Pend(OSAL_SEM_HANDLE_TYPE* pSem, int waitMs)
+{
+    if(*pSem == 0)
+    {
+        fprintf(stderr, "SYS_TMR lock is taken\n");
+        exit(1);
+    }
+    *pSem = 0;
+}
+
+static void OSAL_SEM_Post(OSAL_SEM_HANDLE_TYPE* pSem)
+{
+    *pSem = 1;
+}
+
+static OSAL_CRITSECT_DATA_TYPE OSAL_CRIT_Enter(int type)
+{
+    return 0;
+}
+
+static void OSAL_CRIT_Leave(int type, OSAL_CRITSECT_DATA_TYPE status)
+{
+}
+
+#include "system/tmr/src/sys_tmr.c"
+
+typedef struct
+{
+    SYS_TMR_HANDLE  handle;
+    uint32_t        periodMs;
+    uint32_t        nCallbacks;
+    bool            periodic;
+    bool            fired;
+}BENCH_CLIENT;
+
+static BENCH_CLIENT benchClients[SYS_TMR_MAX_CLIENT_OBJECTS];
+
+static void BenchCallback(uintptr_t context, uint32_t currTick)
+{
+    BENCH_CLIENT* pClient = benchClients + context;
+
+    pClient->nCallbacks++;
+    pClient->fired = true;
+}
+
+static SYS_TMR_HANDLE BenchClientStart(int ix)
+{
+    BENCH_CLIENT* pClient = benchClients + ix;
+
+    pClient->fired = false;
+    if(pClient->periodic)
+    {
+        return SYS_TMR_CallbackPeriodic(pClient->periodMs, ix, BenchCallback);
+    }
+
+    return SYS_TMR_CallbackSingle(pClient->periodMs, ix, BenchCallback);
+}
+
+static void BenchRestart(int nClients)
+{
+    int ix;
+
+    for(ix = 0; ix < nClients; ix++)
+    {   // the single shot timers were deleted; start them again
+        BENCH_CLIENT* pClient = benchClients + ix;
+        if(!pClient->periodic && pClient->fired)
+        {
+            pClient->handle = BenchClientStart(ix);
+        }
+    }
+}
+
+#if (SYS_TMR_TICKLESS)
+// runs the timer for BENCH_TICKS system ticks
+// returns the number of tick count errors
+static uint32_t BenchRunTicks(SYS_MODULE_OBJ tmrObj, int nClients)
+{
+    uint64_t elapsed = 0;
+    uint64_t end = (uint64_t)BENCH_TICKS * (DRV_TMR_FREQUENCY / SYS_TMR_FREQUENCY);
+    uint32_t seed = 1;
+    uint32_t nErrors = 0;
+
+    drvIsrCount = 0;
+    while(elapsed < end)
+    {
+        uint32_t step;
+
+        seed = seed * 1103515245 + 12345;
+        step = 1 + (seed >> 16) % BENCH_TICKLESS_MAX_STEP;
+        if(step > end - elapsed)
+        {
+            step = (uint32_t)(end - elapsed);
+        }
+
+        while(step != 0)
+        {   // the counter matches the period, then starts over from 0
+            uint32_t toMatch = drvPeriodReg + 1 - drvCounter;
+            if(step < toMatch)
+            {
+                drvCounter += step;
+                elapsed += step;
+                break;
+            }
+
+            drvCounter = 0;
+            drvPending = true;
+            elapsed += toMatch;
+            step -= toMatch;
+            if(BenchTimerIsr())
+            {
+                SYS_TMR_Tasks(tmrObj);
+                BenchRestart(nClients);
+            }
+        }
+
+        if(SYS_TMR_TickCountGet() != (uint32_t)(elapsed / (DRV_TMR_FREQUENCY / SYS_TMR_FREQUENCY)))
+        {
+            nErrors++;
+        }
+    }
+
+    return nErrors;
+}
+#else
+static uint32_t BenchRunTicks(SYS_MODULE_OBJ tmrObj, int nClients)
+{
+    uint32_t tick;
+
+    for(tick = 1; tick <= BENCH_TICKS; tick++)
+    {
+        if(drvAlarmEnabled)
+        {
+            drvAlarmCallback(drvAlarmContext, tick);
+        }
+        SYS_TMR_Tasks(tmrObj);
+        BenchRestart(nClients);
+    }
+
+    return 0;
+}
+#endif  // (SYS_TMR_TICKLESS)
+
+static bool BenchRun(int nClients)
+{
+    int ix;
+    uint32_t tickErrors;
+    uint32_t checksum;
+    SYS_MODULE_OBJ tmrObj;
+    SYS_TMR_INIT tmrInit;
+    SYS_TMR_ALARM_STATISTICS tmrStat;
+
+    memset(&tmrInit, 0, sizeof(tmrInit));
+    tmrInit.drvIndex = DRV_TMR_INDEX_0;
+    tmrInit.tmrFreq = SYS_TMR_FREQUENCY;
+
+    tmrObj = SYS_TMR_Initialize(SYS_TMR_INDEX_0, (SYS_MODULE_INIT*)&tmrInit);
+    // open the driver and start the alarm
+    SYS_TMR_Tasks(tmrObj);
+    if(SYS_TMR_Status(tmrObj) != SYS_STATUS_READY)
+    {
+        fprintf(stderr, "SYS_TMR failed to start\n");
+        return false;
+    }
+
+    for(ix = 0; ix < nClients; ix++)
+    {
+        BENCH_CLIENT* pClient = benchClients + ix;
+        memset(pClient, 0, sizeof(*pClient));
+        pClient->periodic = (ix & 3) != 3;
+        pClient->periodMs = 5 + (ix * 37) % 500;
+        if((pClient->handle = BenchClientStart(ix)) == SYS_TMR_HANDLE_INVALID)
+        {
+            fprintf(stderr, "failed to create client %d\n", ix);
+            return false;
+        }
+    }
+
+    SYS_TMR_AlarmStatisticsGet(0, true);
+    tickErrors = BenchRunTicks(tmrObj, nClients);
+    SYS_TMR_AlarmStatisticsGet(&tmrStat, false);
+
+    if(tickErrors != 0)
+    {
+        fprintf(stderr, "%u tick count errors\n", tickErrors);
+        return false;
+    }
+
+    // check the periodic clients did not miss any alarm
+    checksum = 0;
+    for(ix = 0; ix < nClients; ix++)
+    {
+        BENCH_CLIENT* pClient = benchClients + ix;
+        if(pClient->periodic && pClient->nCallbacks != BENCH_TICKS / pClient->periodMs)
+        {
+            fprintf(stderr, "client %d: %u callbacks, expected %u\n", ix, pClient->nCallbacks, BENCH_TICKS / pClient->periodMs);
+            return false;
+        }
+        checksum = checksum * 31 + pClient->nCallbacks;
+    }
+
+    printf("%8d %8u %9.2f %9.2f %9.1f %9.1f %9u %08x\n", nClients, tmrStat.nAlarms,
+            (double)tmrStat.nExpired / tmrStat.nAlarms, (double)tmrStat.nVisited / tmrStat.nAlarms,
+            (double)tmrStat.totCycles * 1e9 / tmrStat.cyclesFreq / tmrStat.nAlarms,
+            (double)tmrStat.maxCycles * 1e9 / tmrStat.cyclesFreq, tmrStat.maxExpired, checksum);
+
+    SYS_TMR_Deinitialize(tmrObj);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    int nClients;
+
+    printf("SYS_TMR: %d client objects, %s, %s notification%s\n", SYS_TMR_MAX_CLIENT_OBJECTS,
+            (SYS_TMR_CLIENT_HEAP) ? "client heap" : "client scan",
+            (SYS_TMR_INTERRUPT_NOTIFICATION) ? "ISR" : "thread",
+            (SYS_TMR_TICKLESS) ? ", tickless" : "");
+    printf("%8s %8s %9s %9s %9s %9s %9s %8s\n", "clients", "alarms", "exp/alrm", "vis/alrm",
+            "avg ns", "max ns", "max exp", "checksum");
+
+    for(nClients = 4; nClients <= SYS_TMR_MAX_CLIENT_OBJECTS; nClients *= 2)
+    {
+        if(!BenchRun(nClients))
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,42 @@
+/*******************************************************************************
+  System Timer Benchmark Configuration
+
+  File Name:
+    system_config.h
+
+  Summary:
+    Host build configuration for sys_tmr_bench.c.
+
+  Description:
+    The values not defined on the compiler command line default
+    to the ones used by the benchmark.
+*******************************************************************************/
+
+#ifndef _SYSTEM_CONFIG_H
+#define _SYSTEM_CONFIG_H
+
+#ifndef SYS_TMR_MAX_CLIENT_OBJECTS
+#define SYS_TMR_MAX_CLIENT_OBJECTS      256
+#endif
+
+#ifndef SYS_TMR_CLIENT_HEAP
+#define SYS_TMR_CLIENT_HEAP             true
+#endif
+
+#ifndef SYS_TMR_INTERRUPT_NOTIFICATION
+#define SYS_TMR_INTERRUPT_NOTIFICATION  true
+#endif
+
+#ifndef SYS_TMR_TICKLESS
+#define SYS_TMR_TICKLESS                false
+#endif
+
+#define SYS_TMR_ALARM_STATISTICS_ENABLE true
+#define SYS_TMR_POWER_STATE             SYS_MODULE_POWER_RUN_FULL
+#define SYS_TMR_DRIVER_INDEX            DRV_TMR_INDEX_0
+#define SYS_TMR_FREQUENCY               1000
+#define SYS_TMR_FREQUENCY_TOLERANCE     10
+#define SYS_TMR_UNIT_RESOLUTION         10000
+#define SYS_TMR_CLIENT_TOLERANCE        10
+
+#endif // _SYSTEM_CONFIG_H
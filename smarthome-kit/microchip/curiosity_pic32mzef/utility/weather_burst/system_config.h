@@ -0,0 +1,29 @@
+/*******************************************************************************
+  Weather Burst Test Configuration
+
+  File Name:
+    system_config.h
+
+  Summary:
+    Host build configuration for weather_burst.c.
+
+  Description:
+    The mikroBUS 4 chip select and the SPI driver open call used by the
+    Weather click driver, routed to the weather_burst.c recorder.
+*******************************************************************************/
+
+#ifndef _SYSTEM_CONFIG_H
+#define _SYSTEM_CONFIG_H
+
+#include <stdint.h>
+
+void BURST_CsSet(int level);
+
+#define MIKROBUS4_CSOn()                BURST_CsSet(1)
+#define MIKROBUS4_CSOff()               BURST_CsSet(0)
+
+#define DRV_SPI_INDEX_1                 1
+#define DRV_IO_INTENT_READWRITE         0
+#define DRV_SPI_Open(index, intent)     ((uintptr_t)(index))
+
+#endif // _SYSTEM_CONFIG_H
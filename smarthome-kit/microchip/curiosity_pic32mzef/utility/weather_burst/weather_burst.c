@@ -0,0 +1,300 @@
+/*******************************************************************************
+  Weather Click Burst Write Host Test
+
+  File Name:
+    weather_burst.c
+
+  Summary:
+    Checks the SPI bytes and chip select windows of the Weather click
+    register writes.
+
+  Description:
+    The Weather click driver source is built on the host. The SPI HAL
+    functions and the mikroBUS 4 chip select are replaced by a recorder that
+    keeps the bytes written in each chip select window.
+
+    The register writes (write_register, weather_writeRegisters,
+    weather_writeData and weather_configure) are checked for:
+        - one chip select window and one hal_spiWrite per
+          _WEATHER_BURST_MAX_PAIRS address / value pairs
+        - address / value pairs in call order, bit 7 of the address cleared
+        - no SPI traffic while the chip select is high
+        - the driver SPI byte counter
+
+    Build and run, from this directory:
+        gcc -O2 -I. -I../../../../mikroe/Weather -o weather_burst weather_burst.c
+        ./weather_burst
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "system_config.h"
+#include "../click_spi_stats.h"
+
+#define BURST_MAX_WINDOWS       16
+#define BURST_MAX_BYTES         64
+
+// the SPI HAL of click_common.h, implemented by the recorder
+static int  hal_spiWriteStart(uint8_t *pBuf, uint16_t nBytes);
+static int  hal_spiReadStart(uint8_t *pBuf, uint16_t nBytes);
+static int  hal_spiWait(void);
+static void hal_spiStats(T_CLICK_SPI_STATS *stats);
+
+#include "click_weather.c"
+
+typedef struct
+{
+    uint8_t     bytes[BURST_MAX_BYTES];
+    int         nBytes;
+    int         nWrites;    // hal_spiWrite calls
+}BURST_WINDOW;
+
+static BURST_WINDOW burstWindows[BURST_MAX_WINDOWS];
+static int          burstNWindows;
+static int          burstCs = 1;
+static bool         burstError;
+
+static bool _BurstFail(const char* what, const char* detail)
+{
+    printf("FAIL %s: %s\n", what, detail);
+    return false;
+}
+
+void BURST_CsSet(int level)
+{
+    if(level == 0 && burstCs != 0)
+    {
+        if(burstNWindows == BURST_MAX_WINDOWS)
+        {
+            burstError = true;
+        }
+        else
+        {
+            memset(burstWindows + burstNWindows, 0, sizeof(*burstWindows));
+            burstNWindows++;
+        }
+    }
+    burstCs = level;
+}
+
+static void _BurstRecord(const uint8_t* pBuf, uint16_t nBytes)
+{
+    if(burstCs != 0 || burstNWindows == 0)
+    {   // SPI traffic outside of a chip select window
+        burstError = true;
+        return;
+    }
+
+    BURST_WINDOW* pWin = burstWindows + burstNWindows - 1;
+    if(pWin->nBytes + nBytes > BURST_MAX_BYTES)
+    {
+        burstError = true;
+        return;
+    }
+
+    memcpy(pWin->bytes + pWin->nBytes, pBuf, nBytes);
+    pWin->nBytes += nBytes;
+}
+
+static void hal_spiMap(T_HAL_P spiObj)
+{
+}
+
+static void hal_spiWrite(uint8_t *pBuf, uint16_t nBytes)
+{
+    _BurstRecord(pBuf, nBytes);
+    if(burstNWindows != 0)
+    {
+        burstWindows[burstNWindows - 1].nWrites++;
+    }
+}
+
+static int hal_spiWriteStart(uint8_t *pBuf, uint16_t nBytes)
+{
+    _BurstRecord(pBuf, nBytes);
+    return 0;
+}
+
+static int hal_spiReadStart(uint8_t *pBuf, uint16_t nBytes)
+{
+    memset(pBuf, 0, nBytes);
+    return 0;
+}
+
+static int hal_spiWait(void)
+{
+    return 0;
+}
+
+static void hal_spiStats(T_CLICK_SPI_STATS *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+
+static void _BurstStart(void)
+{
+    burstNWindows = 0;
+    burstError = false;
+}
+
+// checks the recorded windows against the expected pairs
+static bool _BurstCheck(const char* what, const T_WEATHER_REG* pRegs, int nRegs, uint32_t startBytes)
+{
+    char detail[80];
+    int wIx, pIx;
+    int nExpWindows = (nRegs + _WEATHER_BURST_MAX_PAIRS - 1) / _WEATHER_BURST_MAX_PAIRS;
+
+    if(burstError)
+    {
+        return _BurstFail(what, "SPI traffic outside of the chip select window");
+    }
+    if(burstCs == 0)
+    {
+        return _BurstFail(what, "chip select left low");
+    }
+    if(burstNWindows != nExpWindows)
+    {
+        sprintf(detail, "%d chip select windows, expected %d", burstNWindows, nExpWindows);
+        return _BurstFail(what, detail);
+    }
+    if(spi_bytes - startBytes != 2 * nRegs)
+    {
+        sprintf(detail, "SPI byte counter %u, expected %d", spi_bytes - startBytes, 2 * nRegs);
+        return _BurstFail(what, detail);
+    }
+
+    for(wIx = 0; wIx < burstNWindows; wIx++)
+    {
+        BURST_WINDOW* pWin = burstWindows + wIx;
+        int nPairs = nRegs - wIx * _WEATHER_BURST_MAX_PAIRS;
+        if(nPairs > _WEATHER_BURST_MAX_PAIRS)
+        {
+            nPairs = _WEATHER_BURST_MAX_PAIRS;
+        }
+
+        if(pWin->nWrites != 1 || pWin->nBytes != 2 * nPairs)
+        {
+            sprintf(detail, "window %d: %d writes, %d bytes, expected 1 write, %d bytes",
+                    wIx, pWin->nWrites, pWin->nBytes, 2 * nPairs);
+            return _BurstFail(what, detail);
+        }
+
+        for(pIx = 0; pIx < nPairs; pIx++)
+        {
+            const T_WEATHER_REG* pReg = pRegs + wIx * _WEATHER_BURST_MAX_PAIRS + pIx;
+            uint8_t addr = pWin->bytes[2 * pIx];
+            uint8_t value = pWin->bytes[2 * pIx + 1];
+            if(addr != (pReg->address & 0x7F) || value != pReg->value)
+            {
+                sprintf(detail, "window %d pair %d: 0x%02x = 0x%02x, expected 0x%02x = 0x%02x",
+                        wIx, pIx, addr, value, pReg->address & 0x7F, pReg->value);
+                return _BurstFail(what, detail);
+            }
+        }
+    }
+
+    return true;
+}
+
+// consecutive registers from a single buffer
+static bool _BurstRegisterWrite(void)
+{
+    T_WEATHER_REG regs[20];
+    uint8_t buf[20];
+    uint8_t reg;
+    int len, ix;
+
+    for(len = 1; len <= sizeof(buf); len++)
+    {
+        reg = 0xA0 + len;
+        for(ix = 0; ix < len; ix++)
+        {
+            buf[ix] = (uint8_t)rand();
+            regs[ix].address = reg + ix;
+            regs[ix].value = buf[ix];
+        }
+
+        uint32_t startBytes = spi_bytes;
+        _BurstStart();
+        write_register(reg, buf, len);
+        if(!_BurstCheck("write_register", regs, len, startBytes))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// arbitrary address / value pairs
+static bool _BurstPairsWrite(void)
+{
+    T_WEATHER_REG regs[20];
+    int count, ix;
+
+    for(count = 0; count <= sizeof(regs) / sizeof(*regs); count++)
+    {
+        for(ix = 0; ix < count; ix++)
+        {   // SPI read addresses included; the driver has to clear bit 7
+            regs[ix].address = (uint8_t)rand();
+            regs[ix].value = (uint8_t)rand();
+        }
+
+        uint32_t startBytes = spi_bytes;
+        _BurstStart();
+        weather_writeRegisters(regs, count);
+        if(!_BurstCheck("weather_writeRegisters", regs, count, startBytes))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool _BurstConfigure(void)
+{
+    // CTRL_HUM has to go before CTRL_MEAS to take effect
+    static const T_WEATHER_REG expRegs[] =
+    {
+        { 0xF2, 0x01 },             // osrs_h x1
+        { 0xF5, (5 << 5) | (2 << 2) },  // t_sb 1000 ms, filter 4
+        { 0xF4, (2 << 5) | (5 << 2) | 3 },  // osrs_t x2, osrs_p x16, normal mode
+    };
+    static const T_WEATHER_REG resetReg[] =
+    {
+        { 0xE0, 0xB6 },
+    };
+
+    uint32_t startBytes = spi_bytes;
+    _BurstStart();
+    weather_configure(5, 2, 2, 1, 5, 3);
+    if(!_BurstCheck("weather_configure", expRegs, 3, startBytes))
+    {
+        return false;
+    }
+
+    startBytes = spi_bytes;
+    _BurstStart();
+    weather_writeData(0xE0, 0xB6);
+    return _BurstCheck("weather_writeData", resetReg, 1, startBytes);
+}
+
+int main(int argc, char* argv[])
+{
+    srand(argc > 1 ? atoi(argv[1]) : 1);
+
+    weather_spiDriverInit(0, 0);
+
+    if(!_BurstRegisterWrite() || !_BurstPairsWrite() || !_BurstConfigure())
+    {
+        return 1;
+    }
+
+    printf("passed\n");
+    return 0;
+}
@@ -0,0 +1,21 @@
+/*******************************************************************************
+  Weather Burst Test Compiler Header
+
+  File Name:
+    xc.h
+
+  Summary:
+    Host replacement of the XC32 device header for weather_burst.c.
+
+  Description:
+    __XC_H is left undefined so the Weather HAL header doesn't pull in
+    click_common.h; weather_burst.c supplies the SPI HAL functions.
+*******************************************************************************/
+
+#ifndef _WEATHER_BURST_XC_H
+#define _WEATHER_BURST_XC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#endif // _WEATHER_BURST_XC_H
@@ -0,0 +1,27 @@
+/*******************************************************************************
+  Weather Compensation Test Configuration
+
+  File Name:
+    system_config.h
+
+  Summary:
+    Host build configuration for weather_compensation.c.
+
+  Description:
+    The mikroBUS 4 chip select and the SPI driver open call used by the
+    Weather click driver. The test does no SPI transfers.
+*******************************************************************************/
+
+#ifndef _SYSTEM_CONFIG_H
+#define _SYSTEM_CONFIG_H
+
+#include <stdint.h>
+
+#define MIKROBUS4_CSOn()                ((void)0)
+#define MIKROBUS4_CSOff()               ((void)0)
+
+#define DRV_SPI_INDEX_1                 1
+#define DRV_IO_INTENT_READWRITE         0
+#define DRV_SPI_Open(index, intent)     ((uintptr_t)(index))
+
+#endif // _SYSTEM_CONFIG_H
@@ -0,0 +1,18 @@
+/*******************************************************************************
+  Weather Compensation Test System Definitions
+
+  File Name:
+    system_definitions.h
+
+  Summary:
+    Host replacement of the system definitions for weather_compensation.c.
+
+  Description:
+    The Weather click driver needs nothing from the system objects;
+    the SPI driver names it uses are in system_config.h.
+*******************************************************************************/
+
+#ifndef _SYSTEM_DEFINITIONS_H
+#define _SYSTEM_DEFINITIONS_H
+
+#endif // _SYSTEM_DEFINITIONS_H
@@ -0,0 +1,273 @@
+/*******************************************************************************
+  Weather Click Compensation Host Test
+
+  File Name:
+    weather_compensation.c
+
+  Summary:
+    Checks the BME280 integer compensation of the Weather click driver
+    against the floating point formulas of the datasheet.
+
+  Description:
+    The Weather click driver source is built on the host with the BME280
+    datasheet example trim values. For temperatures from -40 to 85 C,
+    humidity from 0 to 100 %RH and pressure from 300 to 1100 hPa the raw
+    ADC values are found by bisecting the floating point formulas, loaded
+    into the driver and compensated by compensate_T, compensate_H and
+    compensate_P. The results have to match the floating point values
+    within COMP_T_TOLERANCE, COMP_H_TOLERANCE and COMP_P_TOLERANCE.
+
+    Temperatures below the dig_T1 point (about 11 C with these trim values)
+    make the raw differences negative, the range covers them.
+
+    Build and run, from this directory:
+        gcc -O2 -I. -I../../../../mikroe/Weather -o weather_compensation weather_compensation.c
+        ./weather_compensation
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "system_config.h"
+#include "../click_spi_stats.h"
+
+#define COMP_T_TOLERANCE        0.02    // C
+#define COMP_H_TOLERANCE        0.1     // %RH
+#define COMP_P_TOLERANCE        8.0     // Pa, the 32 bit formula is off by a few Pa
+
+// the SPI HAL of click_common.h, not used by the compensation
+static int  hal_spiWriteStart(uint8_t *pBuf, uint16_t nBytes);
+static int  hal_spiReadStart(uint8_t *pBuf, uint16_t nBytes);
+static int  hal_spiWait(void);
+static void hal_spiStats(T_CLICK_SPI_STATS *stats);
+
+#include "click_weather.c"
+
+// BME280 datasheet trim values
+static const uint16_t   compDigT1 = 27504;
+static const int16_t    compDigT2 = 26435;
+static const int16_t    compDigT3 = -1000;
+static const uint16_t   compDigP1 = 36477;
+static const int16_t    compDigP[8] = { -10685, 3024, 2855, 140, -7, 15500, -14600, 6000 };
+static const uint8_t    compDigH1 = 75;
+static const int16_t    compDigH2 = 362;
+static const uint8_t    compDigH3 = 0;
+static const int16_t    compDigH4 = 313;
+static const int16_t    compDigH5 = 50;
+static const int8_t     compDigH6 = 30;
+
+static void hal_spiMap(T_HAL_P spiObj)
+{
+}
+
+static void hal_spiWrite(uint8_t *pBuf, uint16_t nBytes)
+{
+}
+
+static int hal_spiWriteStart(uint8_t *pBuf, uint16_t nBytes)
+{
+    return 0;
+}
+
+static int hal_spiReadStart(uint8_t *pBuf, uint16_t nBytes)
+{
+    memset(pBuf, 0, nBytes);
+    return 0;
+}
+
+static int hal_spiWait(void)
+{
+    return 0;
+}
+
+static void hal_spiStats(T_CLICK_SPI_STATS *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+}
+
+static void _CompTrimLoad(void)
+{
+    dig_T1 = compDigT1;
+    dig_T2 = compDigT2;
+    dig_T3 = compDigT3;
+    dig_P1 = compDigP1;
+    dig_P2 = compDigP[0];
+    dig_P3 = compDigP[1];
+    dig_P4 = compDigP[2];
+    dig_P5 = compDigP[3];
+    dig_P6 = compDigP[4];
+    dig_P7 = compDigP[5];
+    dig_P8 = compDigP[6];
+    dig_P9 = compDigP[7];
+    dig_H1 = compDigH1;
+    dig_H2 = compDigH2;
+    dig_H3 = compDigH3;
+    dig_H4 = compDigH4;
+    dig_H5 = compDigH5;
+    dig_H6 = compDigH6;
+}
+
+// datasheet floating point compensation
+static double _CompTFine(uint32_t adcT)
+{
+    double var1 = ((double)adcT / 16384.0 - (double)compDigT1 / 1024.0) * (double)compDigT2;
+    double var2 = (double)adcT / 131072.0 - (double)compDigT1 / 8192.0;
+
+    return var1 + var2 * var2 * (double)compDigT3;
+}
+
+static double _CompPressure(uint32_t adcP, double tFine)
+{
+    double var1 = tFine / 2.0 - 64000.0;
+    double var2 = var1 * var1 * (double)compDigP[4] / 32768.0;
+    double p;
+
+    var2 = var2 + var1 * (double)compDigP[3] * 2.0;
+    var2 = var2 / 4.0 + (double)compDigP[2] * 65536.0;
+    var1 = ((double)compDigP[1] * var1 * var1 / 524288.0 + (double)compDigP[0] * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * (double)compDigP1;
+    if(var1 == 0.0)
+    {
+        return 0.0;
+    }
+    p = 1048576.0 - (double)adcP;
+    p = (p - var2 / 4096.0) * 6250.0 / var1;
+    var1 = (double)compDigP[7] * p * p / 2147483648.0;
+    var2 = p * (double)compDigP[6] / 32768.0;
+
+    return p + (var1 + var2 + (double)compDigP[5]) / 16.0;
+}
+
+static double _CompHumidity(uint32_t adcH, double tFine)
+{
+    double h = tFine - 76800.0;
+
+    h = ((double)adcH - ((double)compDigH4 * 64.0 + (double)compDigH5 / 16384.0 * h)) *
+        ((double)compDigH2 / 65536.0 * (1.0 + (double)compDigH6 / 67108864.0 * h *
+        (1.0 + (double)compDigH3 / 67108864.0 * h)));
+    h = h * (1.0 - (double)compDigH1 * h / 524288.0);
+
+    return (h < 0.0) ? 0.0 : (h > 100.0) ? 100.0 : h;
+}
+
+// the compensated values are monotonic in the raw ones, bisect them
+static uint32_t _CompAdcT(double temperature)
+{
+    uint32_t lo = 0, hi = (1u << 20) - 1, mid;
+
+    while(lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if(_CompTFine(mid) / 5120.0 < temperature)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static uint32_t _CompAdcH(double humidity, double tFine)
+{
+    uint32_t lo = 0, hi = 0xFFFF, mid;
+
+    while(lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if(_CompHumidity(mid, tFine) < humidity)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+// pressure falls with the raw value
+static uint32_t _CompAdcP(double pressure, double tFine)
+{
+    uint32_t lo = 0, hi = (1u << 20) - 1, mid;
+
+    while(lo < hi)
+    {
+        mid = (lo + hi) / 2;
+        if(_CompPressure(mid, tFine) > pressure)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+static bool _CompCheck(double temperature, double humidity, double pressure)
+{
+    double tFine, expT, expH, expP;
+    double valT, valH, valP;
+
+    adc_t = _CompAdcT(temperature);
+    tFine = _CompTFine(adc_t);
+    adc_h = _CompAdcH(humidity, tFine);
+    adc_p = _CompAdcP(pressure * 100.0, tFine);
+
+    expT = tFine / 5120.0;
+    expH = _CompHumidity(adc_h, tFine);
+    expP = _CompPressure(adc_p, tFine);
+
+    // t_fine is shared, the temperature goes first
+    valT = (double)compensate_T() / 100.0;
+    valH = (double)compensate_H() / 1024.0;
+    valP = (double)compensate_P();
+
+    if(valT < expT - COMP_T_TOLERANCE || valT > expT + COMP_T_TOLERANCE ||
+       valH < expH - COMP_H_TOLERANCE || valH > expH + COMP_H_TOLERANCE ||
+       valP < expP - COMP_P_TOLERANCE || valP > expP + COMP_P_TOLERANCE)
+    {
+        printf("FAIL %.2f C %.1f %%RH %.0f hPa: got %.2f C %.3f %%RH %.1f Pa, expected %.2f C %.3f %%RH %.1f Pa\n",
+                temperature, humidity, pressure, valT, valH, valP, expT, expH, expP);
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    double temperature, humidity, pressure;
+    int nChecks = 0;
+
+    _CompTrimLoad();
+
+    for(temperature = -40.0; temperature <= 85.0; temperature += 0.25)
+    {
+        for(humidity = 0.0; humidity <= 100.0; humidity += 12.5)
+        {
+            for(pressure = 300.0; pressure <= 1100.0; pressure += 100.0)
+            {
+                if(!_CompCheck(temperature, humidity, pressure))
+                {
+                    return 1;
+                }
+                nChecks++;
+            }
+        }
+    }
+
+    printf("%d points, passed\n", nChecks);
+    return 0;
+}
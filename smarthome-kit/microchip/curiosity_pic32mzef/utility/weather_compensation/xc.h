@@ -0,0 +1,21 @@
+/*******************************************************************************
+  Weather Compensation Test Compiler Header
+
+  File Name:
+    xc.h
+
+  Summary:
+    Host replacement of the XC32 device header for weather_compensation.c.
+
+  Description:
+    __XC_H is left undefined so the Weather HAL header doesn't pull in
+    click_common.h; weather_compensation.c supplies the SPI HAL functions.
+*******************************************************************************/
+
+#ifndef _WEATHER_COMPENSATION_XC_H
+#define _WEATHER_COMPENSATION_XC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#endif // _WEATHER_COMPENSATION_XC_H
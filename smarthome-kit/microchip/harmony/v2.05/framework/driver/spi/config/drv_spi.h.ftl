@@ -99,6 +99,12 @@ SUBSTITUTE  GOODS,  TECHNOLOGY,  SERVICES,  OR  ANY  CLAIMS  BY  THIRD   PARTIES
 #define DRV_SPI_INSTANCES_NUMBER 		${CONFIG_DRV_SPI_INSTANCES_NUMBER}
 #define DRV_SPI_CLIENTS_NUMBER 			${CONFIG_DRV_SPI_CLIENT_NUMBER}
 #define DRV_SPI_ELEMENTS_PER_QUEUE 		${CONFIG_DRV_SPI_NUM_ELEMENTS_PER_INSTANCE}
+<#if CONFIG_DRV_SPI_SYS_QUEUE_SPSC == true>
+#define DRV_SPI_SYS_QUEUE_SPSC 			true
+</#if>
+<#if CONFIG_DRV_SPI_SETUP_STATISTICS == true>
+#define DRV_SPI_SETUP_STATISTICS_ENABLE true
+</#if>
 <#if CONFIG_DRV_SPI_USE_DMA == true>
 /*** SPI Driver DMA Options ***/
 #define DRV_SPI_DMA_TXFER_SIZE 			${CONFIG_DRV_SPI_DMA_TXFER_SIZE}
@@ -95,6 +95,62 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 
 #define DRV_SPI_ELEMENTS_PER_QUEUE                      10
 
+// *****************************************************************************
+/* SPI Buffer Queue Lock-free Mode
+
+  Summary:
+    Selects the single producer/single consumer ring buffer queue.
+
+  Description:
+    With this definition set to true each job queue preallocates its
+    elements and keeps them in two lock-free rings (free and pending jobs).
+    The driver interrupt or task side takes no lock and does not disable the
+    interrupts to dequeue and free a job.
+    The client side is still serialized by the queue semaphore.
+    With it set to false the shared element pool queue is used.
+
+  Remarks:
+    Optional definition. Default is false.
+    The jobs of a queue must be dequeued from one context only.
+*/
+
+#define DRV_SPI_SYS_QUEUE_SPSC                          false
+
+// *****************************************************************************
+/* SPI Buffer Queue Ring Size
+
+  Summary:
+    Number of slots of the lock-free queue rings.
+
+  Description:
+    Has to be a power of 2 and at least the number of elements of a queue.
+    When not defined it is derived from DRV_SPI_ELEMENTS_PER_QUEUE.
+
+  Remarks:
+    Optional definition, used only when DRV_SPI_SYS_QUEUE_SPSC is true.
+*/
+
+#define DRV_SPI_SYS_QUEUE_SPSC_SLOTS                    16
+
+// *****************************************************************************
+/* SPI Job Setup Statistics
+
+  Summary:
+    Enables the measurement of the job and chain segment setup time.
+
+  Description:
+    With this definition set to true the ISR master 8 bit task measures, in
+    core timer cycles, the time from the end of a job (or from its dequeue when
+    the driver was idle) to the start of the next job transfer, and the time
+    from the end of a chained job segment to the start of the next one.
+    The results are returned by DRV_SPI_SetupStatisticsGet.
+
+  Remarks:
+    Optional definition. Default is false.
+*/
+
+#define DRV_SPI_SETUP_STATISTICS_ENABLE                 false
+
 // *****************************************************************************
 /* SPI Master Mode Enable
 
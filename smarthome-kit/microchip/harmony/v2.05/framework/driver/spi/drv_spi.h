@@ -943,6 +943,108 @@ DRV_SPI_BUFFER_HANDLE DRV_SPI_BufferAddWriteRead2 ( DRV_HANDLE handle, void *txB
                                                    void * context,  DRV_SPI_BUFFER_HANDLE * jobHandle);
 
 
+/*******************************************************************************
+  Function:
+       DRV_SPI_BUFFER_HANDLE DRV_SPI_BufferAddChain( DRV_HANDLE handle,
+                                        const DRV_SPI_BUFFER_SEGMENT * segments,
+                                        size_t nSegments,
+                                        DRV_SPI_BUFFER_EVENT_HANDLER completeCB,
+                                        void * context, DRV_SPI_BUFFER_HANDLE * jobHandle )
+
+  Summary:
+    Registers a chain of buffer segments that is transferred as one job.
+	<p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    Registers a command/parameter/data like sequence of transfers.  The
+    segments are started one after the other by the driver task, from the
+    same interrupt that saw the end of the previous segment, without going
+    through the job queue and without calling the completion callback or
+    the operation starting/ended functions in between.  The status of the
+    whole chain can be monitored using DRV_SPI_BufferStatus and completeCB
+    is called once, when the last segment is complete.
+
+  Precondition:
+    The DRV_SPI_Initialize routine must have been called for the specified
+    SPI driver instance.
+
+    DRV_SPI_Open must have been called to obtain a valid opened device
+    handle.
+
+  Parameters:
+    handle -    A valid open-instance handle, returned from the driver's
+                open routine
+    segments -  Array of segments, see DRV_SPI_BUFFER_SEGMENT
+    nSegments - Number of segments in the array
+    completeCB - Pointer to a function to be called when the last segment is complete
+    context - unused by the driver but this is passed to the callback when it is called
+    jobHandle - pointer to the buffer handle, this will be set before the function returns and can be used in the ISR callback.
+
+   Returns:
+    If the buffer add request is successful, a valid buffer handle is returned.
+    If request is not queued up, DRV_SPI_BUFFER_HANDLE_INVALID is returned.
+
+  Example:
+	<code>
+	DRV_HANDLE      handle;    // Returned from DRV_SPI_Open
+	uint8_t cmd = MY_WRITE_CMD;
+	DRV_SPI_BUFFER_SEGMENT chain[2] =
+	{
+	    { &cmd, NULL, 1, NULL, NULL },
+	    { myWriteBuffer, NULL, MY_BUFFER_SIZE, MY_DataMode, NULL },
+	};
+
+	bufferHandle = DRV_SPI_BufferAddChain( handle, chain, 2, MY_ChainDone, NULL, NULL );
+	</code>
+
+  Remarks:
+    Segments and buffers are accessed by the driver until the job completes.
+
+    Only the interrupt driven master, standard buffer, 8-bit task advances
+    the segments; DRV_SPI_BUFFER_HANDLE_INVALID is returned for any other
+    task mode, slave mode, enhanced buffer or 16/32-bit configuration.  DMA
+    is used by that task as well, segments above the DMA threshold are
+    moved by DMA, and the next segment is loaded from the SPI interrupt
+    that follows the DMA transfer of the previous one.  There is no hardware linked
+    descriptor chaining on PIC32MZ.
+*/
+
+DRV_SPI_BUFFER_HANDLE DRV_SPI_BufferAddChain ( DRV_HANDLE handle,
+                                               const DRV_SPI_BUFFER_SEGMENT * segments,
+                                               size_t nSegments,
+                                               DRV_SPI_BUFFER_EVENT_HANDLER completeCB,
+                                               void * context, DRV_SPI_BUFFER_HANDLE * jobHandle );
+
+
+// *****************************************************************************
+/* Function:
+    bool DRV_SPI_SetupStatisticsGet( DRV_HANDLE handle,
+                                     DRV_SPI_SETUP_STATISTICS* pStat, bool clear )
+
+  Summary:
+    Returns the transfer setup statistics of the driver instance.
+	<p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    Copies the DRV_SPI_SETUP_STATISTICS of the instance the client is
+    open on and optionally clears them.
+
+  Parameters:
+    handle -    A valid open-instance handle
+    pStat -     Address to store the statistics, can be NULL
+    clear -     Clear the statistics after the copy
+
+  Returns:
+    - true  - statistics returned
+    - false - invalid handle or DRV_SPI_SETUP_STATISTICS_ENABLE is false
+
+  Remarks:
+    None.
+*/
+
+bool DRV_SPI_SetupStatisticsGet( DRV_HANDLE handle, DRV_SPI_SETUP_STATISTICS* pStat, bool clear );
+
+
 
 // *****************************************************************************
 /* Function:
@@ -430,6 +430,87 @@ typedef void ( *DRV_SPI_BUFFER_EVENT_HANDLER )  (DRV_SPI_BUFFER_EVENT event,
         DRV_SPI_BUFFER_HANDLE bufferHandle, void * context );
 
 
+// *****************************************************************************
+/* SPI Driver Buffer Segment
+
+  Summary:
+    One stage of a chained buffer job.
+
+  Description:
+    A chained job, added with DRV_SPI_BufferAddChain, runs its segments back
+    to back as one driver job: there is no completion callback, no queue
+    operation and no operation starting/ended call between the segments, so
+    the slave select line stays as set for the whole chain.
+
+    A segment sends txBuffer, or dummy bytes when txBuffer is NULL, and
+    stores the received bytes in rxBuffer, or drops them when rxBuffer is
+    NULL.
+
+    segmentStart, when not NULL, is called by the driver task before the
+    first byte of the segment is sent, with the DRV_SPI_BUFFER_EVENT_PROCESSING
+    event and the segment context.  All the bytes of the previous segment have
+    been received by then, so it can switch a data/command line.
+
+  Remarks:
+    The segment array and the buffers have to stay valid until the job
+    completes.
+    segmentStart executes in an interrupt context when the driver is
+    configured for interrupt mode operation.
+*/
+
+typedef struct
+{
+    /* Data to send, NULL to send dummy bytes */
+    void *                                      txBuffer;
+
+    /* Buffer for the received data, NULL to drop it */
+    void *                                      rxBuffer;
+
+    /* Number of bytes to transfer */
+    size_t                                      size;
+
+    /* Called before the segment is started, can be NULL */
+    DRV_SPI_BUFFER_EVENT_HANDLER                segmentStart;
+
+    /* Passed to segmentStart */
+    void *                                      context;
+
+} DRV_SPI_BUFFER_SEGMENT;
+
+
+// *****************************************************************************
+/* SPI Driver Setup Statistics
+
+  Summary:
+    Time the driver needs to start a transfer.
+
+  Description:
+    A job setup is measured from the end of the previous job (or from the
+    dequeue when the driver was idle) until the first byte or DMA transfer
+    of the new job is started: completion callbacks, queue operations,
+    operation starting call and baud rate check included.
+    A segment setup is measured from the end of a segment of a chained job
+    until the next segment is started.
+
+    The cycles are core timer cycles, counting at cyclesFreq Hz.
+
+  Remarks:
+    Collected only when DRV_SPI_SETUP_STATISTICS_ENABLE is true.
+*/
+
+typedef struct
+{
+    uint32_t                                    nJobSetups;
+    uint32_t                                    nSegmentSetups;
+    uint32_t                                    maxJobCycles;
+    uint32_t                                    maxSegmentCycles;
+    uint64_t                                    totJobCycles;
+    uint64_t                                    totSegmentCycles;
+    uint32_t                                    cyclesFreq;
+
+} DRV_SPI_SETUP_STATISTICS;
+
+
 // *****************************************************************************
 /* SPI Driver Initialization Data
 
@@ -72,9 +72,19 @@ int32_t DRV_SPI_ISRMasterRM8BitTasks ( struct DRV_SPI_DRIVER_OBJECT * pDrvInstan
             if (pDrvInstance->currentJob == NULL)
             {
                 pDrvInstance->txEnabled = false;
+#if (DRV_SPI_SETUP_STATISTICS_ENABLE)
+                pDrvInstance->setupPending = false;
+#endif
                 return 0;
             }
             currentJob = pDrvInstance->currentJob;
+#if (DRV_SPI_SETUP_STATISTICS_ENABLE)
+            /* A job following a completed one is timed from that completion */
+            if (!pDrvInstance->setupPending)
+            {
+                DRV_SPI_SetupTimeStart(pDrvInstance, false);
+            }
+#endif
 
             pDrvInstance->symbolsInProgress = 0;
 
@@ -107,6 +117,11 @@ int32_t DRV_SPI_ISRMasterRM8BitTasks ( struct DRV_SPI_DRIVER_OBJECT * pDrvInstan
             currentJob->status = DRV_SPI_BUFFER_EVENT_PROCESSING;
             /* Flush out the Receive buffer */
             PLIB_SPI_BufferClear(spiId);
+            /* First segment of a chained job */
+            if ((currentJob->pSegment != NULL) && (currentJob->pSegment->segmentStart != NULL))
+            {
+                (*currentJob->pSegment->segmentStart)(DRV_SPI_BUFFER_EVENT_PROCESSING, (DRV_SPI_BUFFER_HANDLE)currentJob, currentJob->pSegment->context);
+            }
         }
 
         /* Set up DMA Receive job.  This is done here to ensure that the RX job is ready to receive when TXing starts*/
@@ -166,6 +181,13 @@ int32_t DRV_SPI_ISRMasterRM8BitTasks ( struct DRV_SPI_DRIVER_OBJECT * pDrvInstan
         {
             DRV_SPI_MasterRMSend8BitISR(pDrvInstance);
         }
+#if (DRV_SPI_SETUP_STATISTICS_ENABLE)
+        /* The first symbols of the job or segment are on their way */
+        if (pDrvInstance->setupPending)
+        {
+            DRV_SPI_SetupTimeEnd(pDrvInstance);
+        }
+#endif
         
         DRV_SPI_ISRErrorTasks(pDrvInstance);
         
@@ -181,6 +203,27 @@ int32_t DRV_SPI_ISRMasterRM8BitTasks ( struct DRV_SPI_DRIVER_OBJECT * pDrvInstan
      
         if ((bytesLeft == 0) && !rxDMAInProgress && !txDMAInProgress)
         {
+                    if (currentJob->segmentsLeft != 0)
+                    {
+                        /* Chained job: all the symbols of the segment have been received.
+                           Load the next segment and keep going, without releasing the
+                           slave select or going through the queue */
+#if (DRV_SPI_SETUP_STATISTICS_ENABLE)
+                        DRV_SPI_SetupTimeStart(pDrvInstance, true);
+#endif
+                        currentJob->segmentsLeft--;
+                        DRV_SPI_JobSegmentLoad(pDrvInstance, currentJob, currentJob->pSegment + 1);
+                        pDrvInstance->symbolsInProgress = 0;
+                        if (currentJob->pSegment->segmentStart != NULL)
+                        {
+                            (*currentJob->pSegment->segmentStart)(DRV_SPI_BUFFER_EVENT_PROCESSING, (DRV_SPI_BUFFER_HANDLE)currentJob, currentJob->pSegment->context);
+                        }
+                        continueLoop = true;
+                        continue;
+                    }
+#if (DRV_SPI_SETUP_STATISTICS_ENABLE)
+                    DRV_SPI_SetupTimeStart(pDrvInstance, false);
+#endif
                     // Disable the interrupt, or more correctly don't re-enable it later*/
                     pDrvInstance->rxEnabled = false;
                     /* Job is complete*/
@@ -214,6 +257,9 @@ int32_t DRV_SPI_ISRMasterRM8BitTasks ( struct DRV_SPI_DRIVER_OBJECT * pDrvInstan
                     }
                     else
                     {
+#if (DRV_SPI_SETUP_STATISTICS_ENABLE)
+                        pDrvInstance->setupPending = false;
+#endif
                         break;
                     }
                 }
@@ -53,9 +53,56 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 extern "C" {
 #endif
 
+// *****************************************************************************
+/* SPI Driver Queue Implementation
+
+  Summary:
+    Selects the single producer, single consumer ring queue.
+
+  Description:
+    With DRV_SPI_SYS_QUEUE_SPSC true, drv_spi_sys_queue_spsc.c implements this
+    interface instead of drv_spi_sys_queue_fifo.c.  Each queue takes all of
+    its elements from the manager buffer when it is created and passes them
+    around in two rings: free elements and enqueued jobs.  The clients
+    allocate and enqueue, the driver task or ISR dequeues and frees, so no
+    interrupts are masked.
+
+    A ring has DRV_SPI_SYS_QUEUE_SPSC_SLOTS slots, a power of 2 which bounds
+    the maxElements of a queue.
+
+  Remarks:
+    The client side calls must be serialized, the queue lock does that.
+    The driver side calls must all come from one context: the driver task or
+    the SPI and DMA interrupts of one priority level.
+*/
+
+#ifndef DRV_SPI_SYS_QUEUE_SPSC
+#define DRV_SPI_SYS_QUEUE_SPSC false
+#endif
+
+#ifndef DRV_SPI_SYS_QUEUE_SPSC_SLOTS
+#if !defined(DRV_SPI_ELEMENTS_PER_QUEUE) || (DRV_SPI_ELEMENTS_PER_QUEUE > 16)
+#define DRV_SPI_SYS_QUEUE_SPSC_SLOTS 32
+#elif (DRV_SPI_ELEMENTS_PER_QUEUE > 8)
+#define DRV_SPI_SYS_QUEUE_SPSC_SLOTS 16
+#else
+#define DRV_SPI_SYS_QUEUE_SPSC_SLOTS 8
+#endif
+#endif
+
+#if (DRV_SPI_SYS_QUEUE_SPSC)
+#if (DRV_SPI_SYS_QUEUE_SPSC_SLOTS & (DRV_SPI_SYS_QUEUE_SPSC_SLOTS - 1)) != 0
+#error "DRV_SPI_SYS_QUEUE_SPSC_SLOTS must be a power of 2"
+#endif
+// queues carry their rings; elements need no header
+#define _DRV_SPI_QM_SIZE 72
+#define _DRV_SPI_Q_SIZE (80 + (8 * DRV_SPI_SYS_QUEUE_SPSC_SLOTS))
+#define _DRV_SPI_QE_SIZE 0
+#else
 #define _DRV_SPI_QM_SIZE 72
 #define _DRV_SPI_Q_SIZE 80
 #define _DRV_SPI_QE_SIZE 4
+#endif
 
 #define DRV_SPI_SYS_QUEUE_BUFFER_SIZE(queues, elementSize, desiredElements) \
     ( _DRV_SPI_QM_SIZE + \
@@ -133,6 +180,8 @@ typedef struct _DRV_SPI_SYS_QUEUE_SETUP
     OSAL_SEM_HANDLE_TYPE semaphoreToUse;
 }DRV_SPI_SYS_QUEUE_SETUP;
 
+// The queue statistics are always collected. A counter is only written from
+// one side of the queue, so keeping it costs a store and no locking.
 typedef struct _DRV_SPI_SYS_QUEUE_MANAGER_STATUS
 {
     size_t numAllocOps;
@@ -160,6 +209,7 @@ typedef struct _DRV_SPI_SYS_QUEUE_STATUS
     size_t numReserveLW;
     size_t numAllocHW;
     size_t numEnqueuedHW;
+    size_t outOfMemoryErrors;
 }DRV_SPI_SYS_QUEUE_STATUS;
 
 DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_Initialize(DRV_SPI_SYS_QUEUE_MANAGER_SETUP * initParams, DRV_SPI_SYS_QUEUE_MANAGER_HANDLE * handle);
@@ -45,6 +45,8 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #include "system/int/sys_int.h"
 #include <string.h>
 
+#if !(DRV_SPI_SYS_QUEUE_SPSC)   // else drv_spi_sys_queue_spsc.c
+
 DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_LockQueue(DRV_SPI_SYS_QUEUE_HANDLE queue, bool freeList);
 DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_UnlockQueue(DRV_SPI_SYS_QUEUE_HANDLE queue, bool freeList);
 DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_LockQueueManager(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager);
@@ -127,9 +129,7 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_Initialize(DRV_SPI_SYS_QUEUE_MANAGER_
         pQueueManager->pFreeElementTail = pElement;
     }
     pQueueManager->numFreeElements = numberOfElements;
-#if _SPI_DRV_SYS_QUEUE_TRACKING   
     pQueueManager->freeElementsLW = numberOfElements;
-#endif
     *handle = (DRV_SPI_SYS_QUEUE_MANAGER_HANDLE)pQueueManager;
     return DRV_SPI_SYS_QUEUE_SUCCESS;
 }
@@ -194,7 +194,6 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_CreateQueue(DRV_SPI_SYS_QUEUE_MANAGER
 
     pQueueManager->numReserveElements += initParams->reserveElements;
     
-#if _SPI_DRV_SYS_QUEUE_TRACKING
     pQueueManager->numQueueCreateOps++;
     pQueueManager->numQueues++;
     pQueueManager->reserveElementsLW += initParams->reserveElements;
@@ -202,7 +201,6 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_CreateQueue(DRV_SPI_SYS_QUEUE_MANAGER
     {
         pQueueManager->numQueuesHW = pQueueManager->numQueues;
     }
-#endif
     
    *handle =  (DRV_SPI_SYS_QUEUE_HANDLE)pQueue;
    return DRV_SPI_SYS_QUEUE_SUCCESS;
@@ -246,11 +244,9 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_DestroyQueue(DRV_SPI_SYS_QUEUE_HANDLE
         pQueueManager->pFreeQueueHead = pQueue;
     }
     
-#if _SPI_DRV_SYS_QUEUE_TRACKING  
     pQueueManager->numQueueDestroyOps++;
     pQueueManager->numQueues--;
     pQueueManager->reserveElementsLW -= pQueueManager->numReserveElements;
-#endif
 
     return DRV_SPI_SYS_QUEUE_SUCCESS;
 }
@@ -277,19 +273,15 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_AllocElement(DRV_SPI_SYS_QUEUE_HANDLE
 
     if (pQueueManager->pFreeElementHead== NULL)
     {
-#if _SPI_DRV_SYS_QUEUE_TRACKING  
         pQueueManager->outOfMemoryErrors++;
         pQueue->outOfMemoryErrors++;
-#endif
         return DRV_SPI_SYS_QUEUE_OUT_OF_MEMORY;
     }
     
     if (pQueue->numAlloc == pQueue->maxElements)
     {
-#if _SPI_DRV_SYS_QUEUE_TRACKING  
         pQueueManager->outOfMemoryErrors++;
         pQueue->outOfMemoryErrors++;
-#endif
         return DRV_SPI_SYS_QUEUE_OUT_OF_MEMORY;
     }
     
@@ -299,10 +291,8 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_AllocElement(DRV_SPI_SYS_QUEUE_HANDLE
     }
     else if (pQueueManager->numFreeElements == pQueueManager->numReserveElements)
     {
-#if _SPI_DRV_SYS_QUEUE_TRACKING  
         pQueueManager->outOfMemoryErrors++;
         pQueue->outOfMemoryErrors++;
-#endif
         return DRV_SPI_SYS_QUEUE_OUT_OF_MEMORY;
     }
     intStatus = SYS_INT_StatusGetAndDisable();
@@ -317,7 +307,6 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_AllocElement(DRV_SPI_SYS_QUEUE_HANDLE
     pQueue->numAlloc++;
 	SYS_INT_StatusRestore(intStatus);
     
-#if _SPI_DRV_SYS_QUEUE_TRACKING  
     pQueue->numAllocOps ++;
     pQueueManager->numAllocOps ++;
     if (pQueueManager->numFreeElements < pQueueManager->freeElementsLW)
@@ -332,7 +321,6 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_AllocElement(DRV_SPI_SYS_QUEUE_HANDLE
     {
         pQueue->numAllocHW = pQueue->numAlloc;
     }
-#endif
     *element = (void *)((uint32_t)pEntry + sizeof(DRV_SPI_SYS_QUEUE_FIFO_ELEMENT_DATA));
     return DRV_SPI_SYS_QUEUE_SUCCESS;
 }
@@ -373,10 +361,8 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_FreeElement(DRV_SPI_SYS_QUEUE_HANDLE
         pQueueManager->numReserveElements++;
     }
     
-#if _SPI_DRV_SYS_QUEUE_TRACKING  
     pQueue->numFreeOps ++;
     pQueueManager->numFreeOps ++;
-#endif
     SYS_INT_StatusRestore(intStatus);
     return DRV_SPI_SYS_QUEUE_SUCCESS;
 }
@@ -408,14 +394,13 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_Enqueue(DRV_SPI_SYS_QUEUE_HANDLE queu
         pQueue->pTail = pEntry;
     }
 
-#if _SPI_DRV_SYS_QUEUE_TRACKING
-    pQueue->numEnqueued++;
-    if (pQueue->numEnqueued > pQueue->numEnqueuedHW)
+    // the enqueued count is derived from the counters, Dequeue() may run in an ISR
+    pQueue->numEnqueueOps++;
+    size_t numEnqueued = pQueue->numEnqueueOps - pQueue->numDequeueOps;
+    if (numEnqueued > pQueue->numEnqueuedHW)
     {
-        pQueue->numEnqueuedHW = pQueue->numEnqueued;
+        pQueue->numEnqueuedHW = numEnqueued;
     }
-    pQueue->numEnqueueOps++;
-#endif
     return DRV_SPI_SYS_QUEUE_SUCCESS;
 }
 
@@ -450,10 +435,7 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_Dequeue(DRV_SPI_SYS_QUEUE_HANDLE queu
 
     pEntry->pNext = NULL;
     
-#if _SPI_DRV_SYS_QUEUE_TRACKING
-    pQueue->numEnqueued--;
     pQueue->numDequeueOps++;
-#endif
     *element = (void *)((uint32_t)pEntry + sizeof(DRV_SPI_SYS_QUEUE_FIFO_ELEMENT_DATA));
     return DRV_SPI_SYS_QUEUE_SUCCESS;
 }
@@ -546,10 +528,10 @@ DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_UnlockQueue(DRV_SPI_SYS_QUEUE_HANDLE
     {
         return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;        
     }
-    if (OSAL_SEM_Post(&pQueue->semaphore) != OSAL_RESULT_TRUE) {/*report error*/}
+    DRV_SPI_SYS_QUEUE_RESULT ret = DRV_SPI_SYS_QUEUE_SUCCESS;
     if (freeList)
     {
-        return _DRV_SPI_SYS_QUEUE_UnlockQueueManager((DRV_SPI_SYS_QUEUE_MANAGER_HANDLE)pQueueManager);
+        ret = _DRV_SPI_SYS_QUEUE_UnlockQueueManager((DRV_SPI_SYS_QUEUE_MANAGER_HANDLE)pQueueManager);
     }
     else
     {
@@ -558,8 +540,9 @@ DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_UnlockQueue(DRV_SPI_SYS_QUEUE_HANDLE
             (*pQueue->fptrIntChange)(queue, false);
         }
     }
+    if (OSAL_SEM_Post(&pQueue->semaphore) != OSAL_RESULT_TRUE) {/*report error*/}
 
-    return DRV_SPI_SYS_QUEUE_SUCCESS;
+    return ret;
 }
 
 DRV_SPI_SYS_QUEUE_HANDLE DRV_SPI_SYS_QUEUE_CreateQueueLock(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager, DRV_SPI_SYS_QUEUE_SETUP * initParams, DRV_SPI_SYS_QUEUE_HANDLE * queue)
@@ -685,11 +668,14 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_DequeueLock(DRV_SPI_SYS_QUEUE_HANDLE
 
 DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_QueueManagerStatus(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager, DRV_SPI_SYS_QUEUE_MANAGER_STATUS * status)
 {
-#if _SPI_DRV_SYS_QUEUE_TRACKING
     if ((queueManager <= 0) && (queueManager >= DRV_SPI_SYS_QUEUE_MAX_ERROR))
     {
         return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
     }
+    if (status == NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
     DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA * pQueueManager = (DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA *)queueManager;
 
     status->numAllocOps = pQueueManager->numAllocOps;
@@ -704,14 +690,10 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_QueueManagerStatus(DRV_SPI_SYS_QUEUE_
     status->numQueues = pQueueManager->numQueues;
     status->numQueuesHW = pQueueManager->numQueuesHW;
     return DRV_SPI_SYS_QUEUE_SUCCESS;
-#else
-    return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
-#endif
 }
 
 DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_QueueStatus(DRV_SPI_SYS_QUEUE_HANDLE queue, DRV_SPI_SYS_QUEUE_STATUS * status)
 {
-#if _SPI_DRV_SYS_QUEUE_TRACKING
     if ((queue <= 0) && (queue >= DRV_SPI_SYS_QUEUE_MAX_ERROR))
     {
         return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
@@ -734,24 +716,42 @@ DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_QueueStatus(DRV_SPI_SYS_QUEUE_HANDLE
     status->numEnqueueOps = pQueue->numEnqueueOps;
     status->numReserved = pQueue->numReserved;
     status->numAlloc = pQueue->numAlloc;
-    status->numEnqueued = pQueue->numEnqueued;
+    status->numEnqueued = pQueue->numEnqueueOps - pQueue->numDequeueOps;
     status->numReserveLW = pQueue->numReserveLW;
     status->numAllocHW = pQueue->numAllocHW;
     status->numEnqueuedHW = pQueue->numEnqueuedHW;
+    status->outOfMemoryErrors = pQueue->outOfMemoryErrors;
     return DRV_SPI_SYS_QUEUE_SUCCESS;
-#else
-    return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
-#endif
     
 }
 
+// The queues and the manager share one OSAL semaphore (DRV_SPI passes its
+// managerSemaphore to both) and _LockQueue holds it when it gets here, so
+// the manager is locked by masking the interrupts instead. The lock does
+// not nest, the status is kept in the manager until the unlock.
 DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_LockQueueManager(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager)
 {
+    if (queueManager == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA * pQueueManager = (DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA *)queueManager;
+    SYS_INT_PROCESSOR_STATUS intStatus = SYS_INT_StatusGetAndDisable();
+    pQueueManager->intStatus = intStatus;
     return DRV_SPI_SYS_QUEUE_SUCCESS;
 }
+
 DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_UnlockQueueManager(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager)
 {
+    if (queueManager == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA * pQueueManager = (DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA *)queueManager;
+    SYS_INT_StatusRestore(pQueueManager->intStatus);
     return DRV_SPI_SYS_QUEUE_SUCCESS;
 }
 
-
+#endif  // !(DRV_SPI_SYS_QUEUE_SPSC)
@@ -45,15 +45,12 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #include <stdbool.h>
 #include "system_config.h"
 #include "osal/osal.h"
+#include "system/int/sys_int.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-#ifndef _SPI_DRV_SYS_QUEUE_TRACKING
-#define _SPI_DRV_SYS_QUEUE_TRACKING 0
-#endif
-
 typedef struct _DRV_SPI_SYS_QUEUE_FIFO_ELEMENT_DATA
 {
     struct _DRV_SPI_SYS_QUEUE_FIFO_ELEMENT_DATA * pNext;
@@ -73,8 +70,6 @@ typedef struct _DRV_SPI_SYS_QUEUE_QUEUE_DATA
     
     struct _DRV_SPI_SYS_QUEUE_QUEUE_DATA * pNext;
     
-#if _SPI_DRV_SYS_QUEUE_TRACKING
-    size_t numEnqueued;
     size_t numAllocOps;
     size_t numFreeOps;
     size_t numDequeueOps;
@@ -83,7 +78,6 @@ typedef struct _DRV_SPI_SYS_QUEUE_QUEUE_DATA
     size_t numAllocHW;
     size_t numEnqueuedHW;    
     size_t outOfMemoryErrors;
-#endif
 }DRV_SPI_SYS_QUEUE_QUEUE_DATA;
 
 typedef struct _DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA
@@ -100,10 +94,10 @@ typedef struct _DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA
 
     OSAL_SEM_HANDLE_TYPE semaphore;
     bool createdSemaphore;
+    SYS_INT_PROCESSOR_STATUS intStatus;     // saved by _LockQueueManager
     size_t numFreeElements;
 
     
-#if _SPI_DRV_SYS_QUEUE_TRACKING   
     size_t numAllocOps;
     size_t numFreeOps;
     size_t numQueueCreateOps;
@@ -113,7 +107,6 @@ typedef struct _DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA
     size_t outOfMemoryErrors;
     uint8_t numQueues;
     uint8_t numQueuesHW;
-#endif
 }DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA;
 
 
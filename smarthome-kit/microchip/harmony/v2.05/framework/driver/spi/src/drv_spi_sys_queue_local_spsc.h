@@ -0,0 +1,129 @@
+/*******************************************************************************
+  SPI Driver Interface
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+    drv_spi_sys_queue_local_spsc.h
+
+  Summary:
+    SPI command queue, single producer single consumer rings
+
+  Description:
+    This file contains the data of the queue model that the SPI driver uses
+    when DRV_SPI_SYS_QUEUE_SPSC is enabled.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright (c) 2014 released Microchip Technology Inc.  All rights reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+*******************************************************************************/
+//DOM-IGNORE-END
+
+#ifndef _SPI_DRV_SYS_QUEUE_LOCAL_SPSC_H_
+#define _SPI_DRV_SYS_QUEUE_LOCAL_SPSC_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "system_config.h"
+#include "osal/osal.h"
+#include "system/int/sys_int.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define _DRV_SPI_SYS_QUEUE_SPSC_MASK    (DRV_SPI_SYS_QUEUE_SPSC_SLOTS - 1)
+
+// element sitting in the manager pool, not owned by any queue
+typedef struct _DRV_SPI_SYS_QUEUE_SPSC_ELEMENT_DATA
+{
+    struct _DRV_SPI_SYS_QUEUE_SPSC_ELEMENT_DATA * pNext;
+}DRV_SPI_SYS_QUEUE_SPSC_ELEMENT_DATA;
+
+// Ring of element pointers. Head is only written by the side which puts
+// elements in and tail only by the side which takes them out. The counters
+// run freely and are masked on access. A queue owns maxElements elements,
+// never more than the slots, so its rings cannot overflow.
+typedef struct
+{
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    void * volatile items[DRV_SPI_SYS_QUEUE_SPSC_SLOTS];
+}DRV_SPI_SYS_QUEUE_SPSC_RING;
+
+typedef struct _DRV_SPI_SYS_QUEUE_QUEUE_DATA
+{
+    void * pQueueManager;
+    DRV_SPI_SYS_QUEUE_INTERUPT_CHANGE fptrIntChange;
+    size_t numReserved;
+    size_t maxElements;
+    OSAL_SEM_HANDLE_TYPE semaphore;
+    bool createdSemaphore;
+
+    struct _DRV_SPI_SYS_QUEUE_QUEUE_DATA * pNext;
+
+    DRV_SPI_SYS_QUEUE_SPSC_RING freeRing;   // FreeElement() -> AllocElement()
+    DRV_SPI_SYS_QUEUE_SPSC_RING jobRing;    // Enqueue() -> Dequeue()
+
+    // client side counters
+    size_t numAllocOps;
+    size_t numEnqueueOps;
+    size_t numAllocHW;
+    size_t numEnqueuedHW;
+    size_t outOfMemoryErrors;
+
+    // driver side counters
+    size_t numFreeOps;
+    size_t numDequeueOps;
+}DRV_SPI_SYS_QUEUE_QUEUE_DATA;
+
+typedef struct _DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA
+{
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueueArea;
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pFreeQueueHead;
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pFreeQueueTail;
+
+    DRV_SPI_SYS_QUEUE_SPSC_ELEMENT_DATA * pFreeElementHead;
+
+    OSAL_SEM_HANDLE_TYPE semaphore;
+    bool createdSemaphore;
+    SYS_INT_PROCESSOR_STATUS intStatus;     // saved by _LockQueueManager
+    uint8_t numQueueObjects;
+    size_t numFreeElements;
+
+    size_t numQueueCreateOps;
+    size_t numQueueDestroyOps;
+    size_t freeElementsLW;
+    size_t outOfMemoryErrors;
+    uint8_t numQueues;
+    uint8_t numQueuesHW;
+}DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA;
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif
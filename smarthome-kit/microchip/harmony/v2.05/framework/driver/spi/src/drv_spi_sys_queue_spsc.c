@@ -0,0 +1,711 @@
+/*******************************************************************************
+  SPI Driver Interface Implementation
+
+  Company:
+    Microchip Technology Inc.
+
+  File Name:
+   drv_spi_sys_queue_spsc.c
+
+  Summary:
+    SPI Driver implementation of the queuing system, using single producer,
+    single consumer rings
+
+  Description:
+    Each queue owns its elements and moves them through a free ring and a job
+    ring.  The clients allocate and enqueue, the driver task or ISR dequeues
+    and frees.  Each ring index is written from one side only, so the element
+    operations need neither interrupt masking nor a shared free list.
+    Selected with DRV_SPI_SYS_QUEUE_SPSC, see drv_spi_sys_queue.h.
+*******************************************************************************/
+
+//DOM-IGNORE-BEGIN
+/*******************************************************************************
+Copyright (c) 2014 released Microchip Technology Inc.  All rights reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+*******************************************************************************/
+//DOM-IGNORE-END
+#include "driver/spi/src/drv_spi_sys_queue.h"
+
+#if (DRV_SPI_SYS_QUEUE_SPSC)   // else drv_spi_sys_queue_fifo.c
+
+#include "driver/spi/src/drv_spi_sys_queue_local_spsc.h"
+#include <string.h>
+
+DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_LockQueue(DRV_SPI_SYS_QUEUE_HANDLE queue, bool freeList);
+DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_UnlockQueue(DRV_SPI_SYS_QUEUE_HANDLE queue, bool freeList);
+DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_LockQueueManager(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager);
+DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_UnlockQueueManager(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager);
+
+// producer side only
+static void _DRV_SPI_SYS_QUEUE_RingPut(DRV_SPI_SYS_QUEUE_SPSC_RING * pRing, void * element)
+{
+    uint32_t head = pRing->head;
+
+    pRing->items[head & _DRV_SPI_SYS_QUEUE_SPSC_MASK] = element;
+    // the element contents and the slot are stored before the slot is published
+    __sync_synchronize();
+    pRing->head = head + 1;
+}
+
+// consumer side only
+static void * _DRV_SPI_SYS_QUEUE_RingGet(DRV_SPI_SYS_QUEUE_SPSC_RING * pRing)
+{
+    uint32_t tail = pRing->tail;
+    void * element;
+
+    if (tail == pRing->head)
+    {
+        return NULL;
+    }
+
+    element = pRing->items[tail & _DRV_SPI_SYS_QUEUE_SPSC_MASK];
+    pRing->tail = tail + 1; // release the slot after the element is read
+    return element;
+}
+
+static uint32_t _DRV_SPI_SYS_QUEUE_RingCount(DRV_SPI_SYS_QUEUE_SPSC_RING * pRing)
+{
+    return pRing->head - pRing->tail;
+}
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_Initialize(DRV_SPI_SYS_QUEUE_MANAGER_SETUP * initParams, DRV_SPI_SYS_QUEUE_MANAGER_HANDLE * handle)
+{
+    if (initParams == NULL || initParams->pBuffer == NULL || handle == NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    if (initParams->type != DRV_SPI_SYS_QUEUE_Fifo || initParams->numQueues == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    // pool elements are linked through their first word while free
+    size_t elementSize = (initParams->elementSize + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+    if (elementSize < sizeof(DRV_SPI_SYS_QUEUE_SPSC_ELEMENT_DATA))
+    {
+        elementSize = sizeof(DRV_SPI_SYS_QUEUE_SPSC_ELEMENT_DATA);
+    }
+
+    size_t sizeNeeded = sizeof(DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA) +
+                        (sizeof(DRV_SPI_SYS_QUEUE_QUEUE_DATA) * initParams->numQueues) +
+                        elementSize;
+
+    if (initParams->bufferLen < sizeNeeded)
+    {
+        return DRV_SPI_SYS_QUEUE_OUT_OF_MEMORY;
+    }
+
+    // Blank the memory area
+    memset(initParams->pBuffer, 0, initParams->bufferLen);
+
+    // Set up the Queue Manager Area
+    DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA * pQueueManager = (DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA *)initParams->pBuffer;
+    pQueueManager->pQueueArea = (DRV_SPI_SYS_QUEUE_QUEUE_DATA*)((uintptr_t)pQueueManager + sizeof(DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA));
+    pQueueManager->numQueueObjects = initParams->numQueues;
+    if (initParams->createOsalLock == true)
+    {
+        if (OSAL_SEM_Create(&pQueueManager->semaphore, OSAL_SEM_TYPE_BINARY, 1, 1) != OSAL_RESULT_TRUE) {/*report error*/}
+        pQueueManager->createdSemaphore = true;
+    }
+    else
+    {
+        pQueueManager->semaphore = initParams->semaphoreToUse;
+        pQueueManager->createdSemaphore = false;
+    }
+
+    //Set up the Queue Handles
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = pQueueManager->pQueueArea;
+    pQueueManager->pFreeQueueHead = pQueue;
+    pQueueManager->pFreeQueueTail = pQueue;
+    pQueue->pQueueManager = pQueueManager;
+    uint8_t counter;
+    for (counter = 1; counter < initParams->numQueues; counter++)
+    {
+        pQueueManager->pFreeQueueTail->pNext = &(pQueue[counter]);
+        pQueueManager->pFreeQueueTail = &(pQueue[counter]);
+        pQueue[counter].pQueueManager = pQueueManager;
+    }
+
+    // Set up the element pool
+    uint8_t * pElementArea = (uint8_t *)&pQueue[initParams->numQueues];
+    size_t numberOfElements = (initParams->bufferLen - (pElementArea - (uint8_t *)pQueueManager)) / elementSize;
+    size_t elementIx;
+
+    for (elementIx = numberOfElements; elementIx != 0; elementIx--)
+    {
+        DRV_SPI_SYS_QUEUE_SPSC_ELEMENT_DATA * pElement = (DRV_SPI_SYS_QUEUE_SPSC_ELEMENT_DATA *)(pElementArea + (elementIx - 1) * elementSize);
+        pElement->pNext = pQueueManager->pFreeElementHead;
+        pQueueManager->pFreeElementHead = pElement;
+    }
+    pQueueManager->numFreeElements = numberOfElements;
+    pQueueManager->freeElementsLW = numberOfElements;
+
+    *handle = (DRV_SPI_SYS_QUEUE_MANAGER_HANDLE)pQueueManager;
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_Deinitialize(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager)
+{
+    if (queueManager == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+    DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA * pQueueManager = (DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA *)queueManager;
+    if (pQueueManager->createdSemaphore == true)
+    {
+        if (OSAL_SEM_Delete(&(pQueueManager->semaphore)) != OSAL_RESULT_TRUE) {/*report error*/}
+    }
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_CreateQueue(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager, DRV_SPI_SYS_QUEUE_SETUP * initParams, DRV_SPI_SYS_QUEUE_HANDLE * handle)
+{
+    if (queueManager == 0 || initParams == NULL || handle == NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+    DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA * pQueueManager = (DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA *)queueManager;
+
+    if (initParams->maxElements == 0 || initParams->reserveElements > initParams->maxElements)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+    if (pQueueManager->pFreeQueueHead == NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_OUT_OF_QUEUES;
+    }
+
+    // the queue takes all its elements now, so they are all reserved
+    if (initParams->maxElements > DRV_SPI_SYS_QUEUE_SPSC_SLOTS || initParams->maxElements > pQueueManager->numFreeElements)
+    {
+        pQueueManager->outOfMemoryErrors++;
+        return DRV_SPI_SYS_QUEUE_OUT_OF_MEMORY;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = pQueueManager->pFreeQueueHead;
+    pQueueManager->pFreeQueueHead = pQueue->pNext;
+    if (pQueueManager->pFreeQueueHead == NULL)
+    {
+        pQueueManager->pFreeQueueTail = NULL;
+    }
+    memset(pQueue, 0, sizeof(DRV_SPI_SYS_QUEUE_QUEUE_DATA));
+    pQueue->pQueueManager = pQueueManager;
+
+    pQueue->fptrIntChange = initParams->fptrIntChange;
+    pQueue->numReserved = initParams->reserveElements;
+    pQueue->maxElements = initParams->maxElements;
+    if (initParams->createOsalLock == true)
+    {
+        if (OSAL_SEM_Create(&pQueue->semaphore, OSAL_SEM_TYPE_BINARY, 1, 1) != OSAL_RESULT_TRUE) {/*report error*/}
+        pQueue->createdSemaphore = true;
+    }
+    else
+    {
+        pQueue->semaphore = initParams->semaphoreToUse;
+        pQueue->createdSemaphore = false;
+    }
+
+    size_t elementIx;
+    for (elementIx = 0; elementIx < pQueue->maxElements; elementIx++)
+    {
+        DRV_SPI_SYS_QUEUE_SPSC_ELEMENT_DATA * pElement = pQueueManager->pFreeElementHead;
+        pQueueManager->pFreeElementHead = pElement->pNext;
+        pQueue->freeRing.items[elementIx] = pElement;
+    }
+    pQueue->freeRing.head = pQueue->maxElements;
+
+    pQueueManager->numFreeElements -= pQueue->maxElements;
+    if (pQueueManager->numFreeElements < pQueueManager->freeElementsLW)
+    {
+        pQueueManager->freeElementsLW = pQueueManager->numFreeElements;
+    }
+    pQueueManager->numQueueCreateOps++;
+    pQueueManager->numQueues++;
+    if (pQueueManager->numQueues > pQueueManager->numQueuesHW)
+    {
+        pQueueManager->numQueuesHW = pQueueManager->numQueues;
+    }
+
+    *handle = (DRV_SPI_SYS_QUEUE_HANDLE)pQueue;
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_DestroyQueue(DRV_SPI_SYS_QUEUE_HANDLE queue)
+{
+    if (queue == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = (DRV_SPI_SYS_QUEUE_QUEUE_DATA *)queue;
+    DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA * pQueueManager = pQueue->pQueueManager;
+
+    if (pQueue->pNext != NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    // the jobs still queued are dropped; elements held by clients are lost
+    void * pElement;
+    while ((pElement = _DRV_SPI_SYS_QUEUE_RingGet(&pQueue->jobRing)) != NULL)
+    {
+        _DRV_SPI_SYS_QUEUE_RingPut(&pQueue->freeRing, pElement);
+    }
+    while ((pElement = _DRV_SPI_SYS_QUEUE_RingGet(&pQueue->freeRing)) != NULL)
+    {
+        ((DRV_SPI_SYS_QUEUE_SPSC_ELEMENT_DATA *)pElement)->pNext = pQueueManager->pFreeElementHead;
+        pQueueManager->pFreeElementHead = (DRV_SPI_SYS_QUEUE_SPSC_ELEMENT_DATA *)pElement;
+        pQueueManager->numFreeElements++;
+    }
+    pQueue->maxElements = 0;
+
+    if (pQueue->createdSemaphore == true)
+    {
+        if (OSAL_SEM_Delete(&(pQueue->semaphore)) != OSAL_RESULT_TRUE) {/*report error*/}
+    }
+
+    if (pQueueManager->pFreeQueueTail == NULL)
+    {
+        pQueueManager->pFreeQueueTail = pQueue;
+        pQueueManager->pFreeQueueHead = pQueue;
+    }
+    else
+    {
+        pQueue->pNext = pQueueManager->pFreeQueueHead;
+        pQueueManager->pFreeQueueHead = pQueue;
+    }
+
+    pQueueManager->numQueueDestroyOps++;
+    pQueueManager->numQueues--;
+
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+// client side
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_AllocElement(DRV_SPI_SYS_QUEUE_HANDLE queue, void ** element)
+{
+    if (element == NULL || queue == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = (DRV_SPI_SYS_QUEUE_QUEUE_DATA *)queue;
+
+    if (pQueue->pNext != NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    void * pElement = _DRV_SPI_SYS_QUEUE_RingGet(&pQueue->freeRing);
+    if (pElement == NULL)
+    {
+        pQueue->outOfMemoryErrors++;
+        return DRV_SPI_SYS_QUEUE_OUT_OF_MEMORY;
+    }
+
+    pQueue->numAllocOps++;
+    size_t numAlloc = pQueue->numAllocOps - pQueue->numFreeOps;
+    if (numAlloc > pQueue->numAllocHW)
+    {
+        pQueue->numAllocHW = numAlloc;
+    }
+
+    *element = pElement;
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+// driver side
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_FreeElement(DRV_SPI_SYS_QUEUE_HANDLE queue, void * element)
+{
+    if (element == NULL || queue == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = (DRV_SPI_SYS_QUEUE_QUEUE_DATA *)queue;
+
+    if (pQueue->pNext != NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+    if (_DRV_SPI_SYS_QUEUE_RingCount(&pQueue->freeRing) >= pQueue->maxElements)
+    {   // freed twice
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    _DRV_SPI_SYS_QUEUE_RingPut(&pQueue->freeRing, element);
+    pQueue->numFreeOps++;
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+// client side
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_Enqueue(DRV_SPI_SYS_QUEUE_HANDLE queue, void * element)
+{
+    if (element == NULL || queue == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = (DRV_SPI_SYS_QUEUE_QUEUE_DATA *)queue;
+
+    if (pQueue->pNext != NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    _DRV_SPI_SYS_QUEUE_RingPut(&pQueue->jobRing, element);
+    pQueue->numEnqueueOps++;
+    size_t numEnqueued = pQueue->numEnqueueOps - pQueue->numDequeueOps;
+    if (numEnqueued > pQueue->numEnqueuedHW)
+    {
+        pQueue->numEnqueuedHW = numEnqueued;
+    }
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+// driver side
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_Dequeue(DRV_SPI_SYS_QUEUE_HANDLE queue, void ** element)
+{
+    if (element == NULL || queue == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = (DRV_SPI_SYS_QUEUE_QUEUE_DATA *)queue;
+
+    if (pQueue->pNext != NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    *element = _DRV_SPI_SYS_QUEUE_RingGet(&pQueue->jobRing);
+    if (*element != NULL)
+    {
+        pQueue->numDequeueOps++;
+    }
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+// driver side
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_Peek(DRV_SPI_SYS_QUEUE_HANDLE queue, void ** element)
+{
+    if (element == NULL || queue == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = (DRV_SPI_SYS_QUEUE_QUEUE_DATA *)queue;
+
+    if (pQueue->pNext != NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    uint32_t tail = pQueue->jobRing.tail;
+    *element = tail == pQueue->jobRing.head ? NULL : pQueue->jobRing.items[tail & _DRV_SPI_SYS_QUEUE_SPSC_MASK];
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+bool DRV_SPI_SYS_QUEUE_IsEmpty(DRV_SPI_SYS_QUEUE_HANDLE queue)
+{
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = (DRV_SPI_SYS_QUEUE_QUEUE_DATA *)queue;
+    return pQueue->jobRing.head == pQueue->jobRing.tail;
+}
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_Lock(DRV_SPI_SYS_QUEUE_HANDLE queue)
+{
+    return _DRV_SPI_SYS_QUEUE_LockQueue(queue, false);
+}
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_Unlock(DRV_SPI_SYS_QUEUE_HANDLE queue)
+{
+    return _DRV_SPI_SYS_QUEUE_UnlockQueue(queue, false);
+}
+
+DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_LockQueue(DRV_SPI_SYS_QUEUE_HANDLE queue, bool freeList)
+{
+    if (queue == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = (DRV_SPI_SYS_QUEUE_QUEUE_DATA *)queue;
+    DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA * pQueueManager = pQueue->pQueueManager;
+
+    if (pQueue->pNext != NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    if (OSAL_SEM_Pend(&pQueue->semaphore, OSAL_WAIT_FOREVER) != OSAL_RESULT_TRUE) {/*report error*/}
+    if (freeList)
+    {
+        return _DRV_SPI_SYS_QUEUE_LockQueueManager((DRV_SPI_SYS_QUEUE_MANAGER_HANDLE)pQueueManager);
+    }
+    else
+    {
+        if (pQueue->fptrIntChange != NULL)
+        {
+            (*pQueue->fptrIntChange)(queue, true);
+        }
+    }
+
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_UnlockQueue(DRV_SPI_SYS_QUEUE_HANDLE queue, bool freeList)
+{
+    if (queue == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = (DRV_SPI_SYS_QUEUE_QUEUE_DATA *)queue;
+    DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA * pQueueManager = pQueue->pQueueManager;
+
+    if (pQueue->pNext != NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+    DRV_SPI_SYS_QUEUE_RESULT ret = DRV_SPI_SYS_QUEUE_SUCCESS;
+    if (freeList)
+    {
+        ret = _DRV_SPI_SYS_QUEUE_UnlockQueueManager((DRV_SPI_SYS_QUEUE_MANAGER_HANDLE)pQueueManager);
+    }
+    else
+    {
+        if (pQueue->fptrIntChange != NULL)
+        {
+            (*pQueue->fptrIntChange)(queue, false);
+        }
+    }
+    if (OSAL_SEM_Post(&pQueue->semaphore) != OSAL_RESULT_TRUE) {/*report error*/}
+
+    return ret;
+}
+
+DRV_SPI_SYS_QUEUE_HANDLE DRV_SPI_SYS_QUEUE_CreateQueueLock(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager, DRV_SPI_SYS_QUEUE_SETUP * initParams, DRV_SPI_SYS_QUEUE_HANDLE * queue)
+{
+    DRV_SPI_SYS_QUEUE_RESULT ret;
+    DRV_SPI_SYS_QUEUE_HANDLE  ret2;
+    ret = _DRV_SPI_SYS_QUEUE_LockQueueManager(queueManager);
+    if (ret != DRV_SPI_SYS_QUEUE_SUCCESS)
+    {
+        return ret;
+    }
+
+    ret2 = DRV_SPI_SYS_QUEUE_CreateQueue(queueManager, initParams, queue);
+    
+    ret = _DRV_SPI_SYS_QUEUE_UnlockQueueManager(queueManager);
+    if (ret != DRV_SPI_SYS_QUEUE_SUCCESS)
+    {
+        return ret;
+    }
+    return ret2;
+}
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_DestroyQueueLock(DRV_SPI_SYS_QUEUE_HANDLE queue)
+{
+    DRV_SPI_SYS_QUEUE_RESULT ret;
+    DRV_SPI_SYS_QUEUE_RESULT  ret2;
+    ret = _DRV_SPI_SYS_QUEUE_LockQueue(queue, true);
+    if (ret != DRV_SPI_SYS_QUEUE_SUCCESS)
+    {
+        return ret;
+    }
+
+    ret2 = DRV_SPI_SYS_QUEUE_DestroyQueue(queue);
+    
+    ret = _DRV_SPI_SYS_QUEUE_UnlockQueue(queue, true);
+    if (ret != DRV_SPI_SYS_QUEUE_SUCCESS)
+    {
+        return ret;
+    }
+    return ret2;
+}
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_AllocElementLock(DRV_SPI_SYS_QUEUE_HANDLE queue, void  ** element)
+{
+    DRV_SPI_SYS_QUEUE_RESULT ret;
+    if (queue == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    // the element comes from the queue's own ring, the manager is not locked
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = (DRV_SPI_SYS_QUEUE_QUEUE_DATA *)queue;
+    if (OSAL_SEM_Pend(&pQueue->semaphore, OSAL_WAIT_FOREVER) != OSAL_RESULT_TRUE) {/*report error*/}
+    ret = DRV_SPI_SYS_QUEUE_AllocElement(queue, element);
+    if (OSAL_SEM_Post(&pQueue->semaphore) != OSAL_RESULT_TRUE) {/*report error*/}
+    return ret;
+}
+
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_FreeElementLock(DRV_SPI_SYS_QUEUE_HANDLE queue, void * element)
+{
+    DRV_SPI_SYS_QUEUE_RESULT ret;
+    if (queue == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    // the element goes back to the queue's own ring, the manager is not locked
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = (DRV_SPI_SYS_QUEUE_QUEUE_DATA *)queue;
+    if (OSAL_SEM_Pend(&pQueue->semaphore, OSAL_WAIT_FOREVER) != OSAL_RESULT_TRUE) {/*report error*/}
+    ret = DRV_SPI_SYS_QUEUE_FreeElement(queue, element);
+    if (OSAL_SEM_Post(&pQueue->semaphore) != OSAL_RESULT_TRUE) {/*report error*/}
+    return ret;
+}
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_EnqueueLock(DRV_SPI_SYS_QUEUE_HANDLE queue, void * element)
+{
+    DRV_SPI_SYS_QUEUE_RESULT ret;
+    DRV_SPI_SYS_QUEUE_RESULT  ret2;
+    ret = _DRV_SPI_SYS_QUEUE_LockQueue(queue, false);
+    if (ret != DRV_SPI_SYS_QUEUE_SUCCESS)
+    {
+        return ret;
+    }
+
+    ret2 = DRV_SPI_SYS_QUEUE_Enqueue(queue, element);
+    
+    ret = _DRV_SPI_SYS_QUEUE_UnlockQueue(queue, false);
+    if (ret != DRV_SPI_SYS_QUEUE_SUCCESS)
+    {
+        return ret;
+    }
+    return ret2;
+}
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_DequeueLock(DRV_SPI_SYS_QUEUE_HANDLE queue, void ** element)
+{
+    DRV_SPI_SYS_QUEUE_RESULT ret;
+    DRV_SPI_SYS_QUEUE_RESULT  ret2;
+    ret = _DRV_SPI_SYS_QUEUE_LockQueue(queue, false);
+    if (ret != DRV_SPI_SYS_QUEUE_SUCCESS)
+    {
+        return ret;
+    }
+
+    ret2 = DRV_SPI_SYS_QUEUE_Dequeue(queue, element);
+    
+    ret = _DRV_SPI_SYS_QUEUE_UnlockQueue(queue, false);
+    if (ret != DRV_SPI_SYS_QUEUE_SUCCESS)
+    {
+        return ret;
+    }
+    return ret2; 
+}
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_QueueManagerStatus(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager, DRV_SPI_SYS_QUEUE_MANAGER_STATUS * status)
+{
+    if (queueManager == 0 || status == NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+    DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA * pQueueManager = (DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA *)queueManager;
+
+    memset(status, 0, sizeof(*status));
+    // the element counters live in the queues; destroyed queues keep theirs until reused
+    uint8_t queueIx;
+    for (queueIx = 0; queueIx < pQueueManager->numQueueObjects; queueIx++)
+    {
+        DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = pQueueManager->pQueueArea + queueIx;
+        status->numAllocOps += pQueue->numAllocOps;
+        status->numFreeOps += pQueue->numFreeOps;
+        status->outOfMemoryErrors += pQueue->outOfMemoryErrors;
+        if (pQueue->maxElements != 0)
+        {   // in use
+            status->numReserveElements += _DRV_SPI_SYS_QUEUE_RingCount(&pQueue->freeRing);
+            status->reserveElementsLW += pQueue->maxElements - pQueue->numAllocHW;
+        }
+    }
+    status->numQueueCreateOps = pQueueManager->numQueueCreateOps;
+    status->numQueueDestroyOps = pQueueManager->numQueueDestroyOps;
+    status->numFreeElements = pQueueManager->numFreeElements;
+    status->freeElementsLW = pQueueManager->freeElementsLW;
+    status->outOfMemoryErrors += pQueueManager->outOfMemoryErrors;
+    status->numQueues = pQueueManager->numQueues;
+    status->numQueuesHW = pQueueManager->numQueuesHW;
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+DRV_SPI_SYS_QUEUE_RESULT DRV_SPI_SYS_QUEUE_QueueStatus(DRV_SPI_SYS_QUEUE_HANDLE queue, DRV_SPI_SYS_QUEUE_STATUS * status)
+{
+    if (queue == 0 || status == NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_DATA * pQueue = (DRV_SPI_SYS_QUEUE_QUEUE_DATA *)queue;
+
+    if (pQueue->pNext != NULL)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    // each counter is read once; the two sides may be running
+    status->numAllocOps = pQueue->numAllocOps;
+    status->numFreeOps = pQueue->numFreeOps;
+    status->numDequeueOps = pQueue->numDequeueOps;
+    status->numEnqueueOps = pQueue->numEnqueueOps;
+    status->numReserved = pQueue->numReserved;
+    status->numAlloc = pQueue->maxElements - _DRV_SPI_SYS_QUEUE_RingCount(&pQueue->freeRing);
+    status->numEnqueued = _DRV_SPI_SYS_QUEUE_RingCount(&pQueue->jobRing);
+    status->numReserveLW = pQueue->maxElements - pQueue->numAllocHW;
+    status->numAllocHW = pQueue->numAllocHW;
+    status->numEnqueuedHW = pQueue->numEnqueuedHW;
+    status->outOfMemoryErrors = pQueue->outOfMemoryErrors;
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+// The queues and the manager share one OSAL semaphore (DRV_SPI passes its
+// managerSemaphore to both) and _LockQueue holds it when it gets here, so
+// the manager is locked by masking the interrupts instead. The lock does
+// not nest, the status is kept in the manager until the unlock.
+DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_LockQueueManager(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager)
+{
+    if (queueManager == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA * pQueueManager = (DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA *)queueManager;
+    SYS_INT_PROCESSOR_STATUS intStatus = SYS_INT_StatusGetAndDisable();
+    pQueueManager->intStatus = intStatus;
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+DRV_SPI_SYS_QUEUE_RESULT _DRV_SPI_SYS_QUEUE_UnlockQueueManager(DRV_SPI_SYS_QUEUE_MANAGER_HANDLE queueManager)
+{
+    if (queueManager == 0)
+    {
+        return DRV_SPI_SYS_QUEUE_INVALID_PARAMETER;
+    }
+
+    DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA * pQueueManager = (DRV_SPI_SYS_QUEUE_QUEUE_MANAGER_DATA *)queueManager;
+    SYS_INT_StatusRestore(pQueueManager->intStatus);
+    return DRV_SPI_SYS_QUEUE_SUCCESS;
+}
+
+#endif  // (DRV_SPI_SYS_QUEUE_SPSC)
@@ -407,6 +407,17 @@ void DRV_SPI_Close ( DRV_HANDLE handle )
         PLIB_SPI_Disable(pDrvObject->spiId);
 
         pDrvObject->isExclusive = 0;
+        /* Stop the ISR before draining the queue: the queue may only be
+           dequeued from one context at a time */
+        if (pDrvObject->taskMode == DRV_SPI_TASK_MODE_ISR)
+        {
+            SYS_INT_SourceDisable(pDrvObject->txInterruptSource);
+            SYS_INT_SourceDisable(pDrvObject->rxInterruptSource);
+            SYS_INT_SourceDisable(pDrvObject->errInterruptSource);
+            SYS_INT_SourceStatusClear(pDrvObject->txInterruptSource);
+            SYS_INT_SourceStatusClear(pDrvObject->rxInterruptSource);
+            SYS_INT_SourceStatusClear(pDrvObject->errInterruptSource);
+        }
         while (!DRV_SPI_SYS_QUEUE_IsEmpty(pDrvObject->queue))
         {
             void * queueEntry = NULL;
@@ -429,15 +440,6 @@ void DRV_SPI_Close ( DRV_HANDLE handle )
                 return;
             }
         }
-        if (pDrvObject->taskMode == DRV_SPI_TASK_MODE_ISR)
-        {
-            SYS_INT_SourceDisable(pDrvObject->txInterruptSource);
-            SYS_INT_SourceDisable(pDrvObject->rxInterruptSource);
-            SYS_INT_SourceDisable(pDrvObject->errInterruptSource);
-            SYS_INT_SourceStatusClear(pDrvObject->txInterruptSource);
-            SYS_INT_SourceStatusClear(pDrvObject->rxInterruptSource);
-            SYS_INT_SourceStatusClear(pDrvObject->errInterruptSource);
-        }
     }
     memset(pClient, 0, sizeof(DRV_SPI_CLIENT_OBJECT));
     pClient->pNext = sSPIManager.pFreeClientHead;
@@ -739,6 +741,202 @@ DRV_SPI_BUFFER_HANDLE DRV_SPI_BufferAddWriteRead2 ( DRV_HANDLE handle, void *txB
     return (DRV_SPI_BUFFER_HANDLE)pJob;
 }
 
+void DRV_SPI_JobSegmentLoad(struct DRV_SPI_DRIVER_OBJECT * pDrvInstance, DRV_SPI_JOB_OBJECT * pJob, const DRV_SPI_BUFFER_SEGMENT * pSegment)
+{
+    pJob->pSegment = pSegment;
+    pJob->txBuffer = (uint8_t *)pSegment->txBuffer;
+    pJob->rxBuffer = (uint8_t *)pSegment->rxBuffer;
+    pJob->dataTxed = 0;
+    pJob->dataRxed = 0;
+    pJob->dataLeftToTx = 0;
+    pJob->dummyLeftToTx = 0;
+    pJob->dataLeftToRx = 0;
+    pJob->dummyLeftToRx = 0;
+    pJob->txDMAProgressStage = DRV_SPI_DMA_NONE;
+    pJob->rxDMAProgressStage = DRV_SPI_DMA_NONE;
+
+    if (pJob->txBuffer != NULL)
+    {
+        pJob->dataLeftToTx = pSegment->size;
+    }
+    else if (pDrvInstance->spiMode == DRV_SPI_MODE_MASTER)
+    {
+        pJob->dummyLeftToTx = pSegment->size;
+    }
+
+    if (pJob->rxBuffer != NULL)
+    {
+        pJob->dataLeftToRx = pSegment->size;
+    }
+    else
+    {
+        pJob->dummyLeftToRx = pSegment->size;
+    }
+}
+
+DRV_SPI_BUFFER_HANDLE DRV_SPI_BufferAddChain ( DRV_HANDLE handle,
+                                               const DRV_SPI_BUFFER_SEGMENT * segments,
+                                               size_t nSegments,
+                                               DRV_SPI_BUFFER_EVENT_HANDLER completeCB,
+                                               void * context, DRV_SPI_BUFFER_HANDLE * jobHandle )
+{
+    DRV_SPI_CLIENT_OBJECT * pClient = (DRV_SPI_CLIENT_OBJECT *)handle;
+    size_t ix;
+
+    if ((pClient > &sSPIClientInstances[DRV_SPI_CLIENTS_NUMBER-1]) || (pClient < &sSPIClientInstances[0]))
+    {
+        SYS_ASSERT(false, "\r\nSPI Driver: Trying to access a client to a driver that is outside the range of client handles.")
+        return (DRV_SPI_BUFFER_HANDLE)DRV_SPI_BUFFER_HANDLE_INVALID;
+    }
+
+    if (pClient->pNext != NULL)
+    {
+        SYS_ASSERT(false, "\r\nSPI Driver: Trying to access a client to a driver that isn't being used.");
+        return (DRV_SPI_BUFFER_HANDLE)DRV_SPI_BUFFER_HANDLE_INVALID;
+    }
+
+    struct DRV_SPI_DRIVER_OBJECT * pDrvObject = pClient->driverObject;
+
+    /* Segments are advanced by the ISR master RM 8 bit task only, DMA
+       segments included; the polled, slave, EBM and 16/32 bit tasks don't */
+    if (pDrvObject->vfMainTask != DRV_SPI_ISRMasterRM8BitTasks)
+    {
+        SYS_ASSERT(false, "\r\nSPI Driver: Chained jobs are not supported by this configuration.");
+        return (DRV_SPI_BUFFER_HANDLE)DRV_SPI_BUFFER_HANDLE_INVALID;
+    }
+
+    if ((segments == NULL) || (nSegments == 0))
+    {
+        SYS_ASSERT(false, "\r\nSPI Driver: Empty chain.");
+        return (DRV_SPI_BUFFER_HANDLE)DRV_SPI_BUFFER_HANDLE_INVALID;
+    }
+
+    for (ix = 0; ix < nSegments; ix++)
+    {
+        if (segments[ix].size == 0)
+        {
+            SYS_ASSERT(false, "\r\nSPI Driver: Empty chain segment.");
+            return (DRV_SPI_BUFFER_HANDLE)DRV_SPI_BUFFER_HANDLE_INVALID;
+        }
+        if ((segments[ix].txBuffer != NULL) && !(pClient->intent & DRV_IO_INTENT_WRITE))
+        {
+            SYS_ASSERT(false, "\r\nSPI Driver: Driver is not open in WRITE mode.");
+            return (DRV_SPI_BUFFER_HANDLE)DRV_SPI_BUFFER_HANDLE_INVALID;
+        }
+        if ((segments[ix].rxBuffer != NULL) && !(pClient->intent & DRV_IO_INTENT_READ))
+        {
+            SYS_ASSERT(false, "\r\nSPI Driver: Driver is not open in READ mode.");
+            return (DRV_SPI_BUFFER_HANDLE)DRV_SPI_BUFFER_HANDLE_INVALID;
+        }
+    }
+
+    DRV_SPI_JOB_OBJECT * pJob = NULL;
+    if (DRV_SPI_SYS_QUEUE_AllocElementLock(pDrvObject->queue, (void **)&pJob) != DRV_SPI_SYS_QUEUE_SUCCESS)
+    {
+        SYS_ASSERT(false, "\r\nSPI Driver: Error trying to get a free entry.");
+        return (DRV_SPI_BUFFER_HANDLE)DRV_SPI_BUFFER_HANDLE_INVALID;
+    }
+
+    memset(pJob, 0, sizeof(DRV_SPI_JOB_OBJECT));
+    DRV_SPI_JobSegmentLoad(pDrvObject, pJob, segments);
+    pJob->segmentsLeft = nSegments - 1;
+    pJob->completeCB = completeCB;
+    pJob->context = context;
+    pJob->status = DRV_SPI_BUFFER_EVENT_PENDING;
+    pJob->pClient = pClient;
+    if (jobHandle != NULL )
+    {
+        *jobHandle = (DRV_SPI_BUFFER_HANDLE)pJob;
+    }
+
+	/* Set a flag if it is first task in the queue */
+    _DRV_SPI_QUEUE_STATUS_CHECK(pDrvObject->queue);
+
+    if (DRV_SPI_SYS_QUEUE_EnqueueLock(pDrvObject->queue, (void*)pJob) != DRV_SPI_SYS_QUEUE_SUCCESS)
+    {
+        SYS_ASSERT(false, "\r\nSPI Driver: Error enqueing new job.");
+        return (DRV_SPI_BUFFER_HANDLE)DRV_SPI_BUFFER_HANDLE_INVALID;
+    }
+
+    pDrvObject->txEnabled = true;
+    pDrvObject->rxEnabled = true;
+    SYS_INT_SourceEnable(pDrvObject->txInterruptSource);
+    SYS_INT_SourceEnable(pDrvObject->rxInterruptSource);
+    SYS_INT_SourceEnable(pDrvObject->errInterruptSource);
+
+    /* Trigger SPI interrupt for the first time for the devices which don't have persistent interrupt */
+    _DRV_SPI_INTERRUPT_TRIGGER(pDrvObject->txInterruptSource);
+
+    return (DRV_SPI_BUFFER_HANDLE)pJob;
+}
+
+#if (DRV_SPI_SETUP_STATISTICS_ENABLE)
+void DRV_SPI_SetupTimeStart(struct DRV_SPI_DRIVER_OBJECT * pDrvInstance, bool segment)
+{
+    pDrvInstance->setupStart = _CP0_GET_COUNT();
+    pDrvInstance->setupPending = true;
+    pDrvInstance->setupSegment = segment;
+}
+
+void DRV_SPI_SetupTimeEnd(struct DRV_SPI_DRIVER_OBJECT * pDrvInstance)
+{
+    DRV_SPI_SETUP_STATISTICS * pStat = &pDrvInstance->setupStat;
+    uint32_t cycles = _CP0_GET_COUNT() - pDrvInstance->setupStart;
+
+    pDrvInstance->setupPending = false;
+    if (pDrvInstance->setupSegment)
+    {
+        pStat->nSegmentSetups++;
+        pStat->totSegmentCycles += cycles;
+        if (cycles > pStat->maxSegmentCycles)
+        {
+            pStat->maxSegmentCycles = cycles;
+        }
+    }
+    else
+    {
+        pStat->nJobSetups++;
+        pStat->totJobCycles += cycles;
+        if (cycles > pStat->maxJobCycles)
+        {
+            pStat->maxJobCycles = cycles;
+        }
+    }
+}
+#endif  // (DRV_SPI_SETUP_STATISTICS_ENABLE)
+
+bool DRV_SPI_SetupStatisticsGet( DRV_HANDLE handle, DRV_SPI_SETUP_STATISTICS* pStat, bool clear )
+{
+#if (DRV_SPI_SETUP_STATISTICS_ENABLE)
+    DRV_SPI_CLIENT_OBJECT * pClient = (DRV_SPI_CLIENT_OBJECT *)handle;
+
+    if ((pClient > &sSPIClientInstances[DRV_SPI_CLIENTS_NUMBER-1]) || (pClient < &sSPIClientInstances[0]) || (pClient->pNext != NULL))
+    {
+        return false;
+    }
+
+    struct DRV_SPI_DRIVER_OBJECT * pDrvObject = pClient->driverObject;
+
+    /* The driver task updates the statistics from the SPI and DMA interrupts */
+    OSAL_CRITSECT_DATA_TYPE critStat = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+    if (pStat != NULL)
+    {
+        *pStat = pDrvObject->setupStat;
+        /* Core timer runs at half of the system clock */
+        pStat->cyclesFreq = SYS_CLK_SystemFrequencyGet() / 2;
+    }
+    if (clear)
+    {
+        memset(&pDrvObject->setupStat, 0, sizeof(pDrvObject->setupStat));
+    }
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, critStat);
+
+    return true;
+#else
+    return false;
+#endif  // (DRV_SPI_SETUP_STATISTICS_ENABLE)
+}
+
 DRV_SPI_BUFFER_HANDLE DRV_SPI_BufferAddRead ( DRV_HANDLE handle,
                                               void *rxBuffer,
                                               size_t size,
@@ -27,6 +27,11 @@
 #define MAX(a,b) ((a<b) ? b : a)
 #define MIN(a,b) ((b<a) ? b : a)
 
+// collect DRV_SPI_SETUP_STATISTICS in the driver task
+#ifndef DRV_SPI_SETUP_STATISTICS_ENABLE
+#define DRV_SPI_SETUP_STATISTICS_ENABLE     false
+#endif
+
 struct DRV_SPI_DRIVER_OBJECT;
 
 typedef int32_t (*DRV_SPI_TasksFptr)(struct DRV_SPI_DRIVER_OBJECT * pDrvInstance);
@@ -62,6 +67,11 @@ typedef struct _DRV_SPI_JOB_OBJECT
     void * context;
     void * pClient;
 
+    /* Chained job: segment in progress and segments still to go.
+       pSegment is NULL for the single buffer jobs */
+    const DRV_SPI_BUFFER_SEGMENT * pSegment;
+    size_t segmentsLeft;
+
 }DRV_SPI_JOB_OBJECT;
 
 struct DRV_SPI_DRIVER_OBJECT
@@ -116,6 +126,14 @@ struct DRV_SPI_DRIVER_OBJECT
 
 
     uint8_t                                     symbolsInProgress;
+
+#if (DRV_SPI_SETUP_STATISTICS_ENABLE)
+    /* Core timer count at the end of the previous transfer */
+    uint32_t                                    setupStart;
+    bool                                        setupPending;
+    bool                                        setupSegment;
+    DRV_SPI_SETUP_STATISTICS                    setupStat;
+#endif
 #if DRV_SPI_DMA
     SYS_DMA_CHANNEL_TRANSFER_EVENT_HANDLER      sendDMAHander;
     SYS_DMA_CHANNEL_TRANSFER_EVENT_HANDLER      receiveDMAHander;
@@ -204,6 +222,11 @@ int32_t DRV_SPI_PolledSlaveRM32BitTasks ( struct DRV_SPI_DRIVER_OBJECT * pDrvIns
 
 int32_t DRV_SPI_PolledErrorTasks(struct DRV_SPI_DRIVER_OBJECT * pDrvInstance);
 int32_t DRV_SPI_ISRErrorTasks(struct DRV_SPI_DRIVER_OBJECT * pDrvInstance);
+void DRV_SPI_JobSegmentLoad(struct DRV_SPI_DRIVER_OBJECT * pDrvInstance, DRV_SPI_JOB_OBJECT * pJob, const DRV_SPI_BUFFER_SEGMENT * pSegment);
+#if (DRV_SPI_SETUP_STATISTICS_ENABLE)
+void DRV_SPI_SetupTimeStart(struct DRV_SPI_DRIVER_OBJECT * pDrvInstance, bool segment);
+void DRV_SPI_SetupTimeEnd(struct DRV_SPI_DRIVER_OBJECT * pDrvInstance);
+#endif
 
 #if DRV_SPI_DMA
 void DRV_SPI_ISRDMAMasterSendEventHandler8bit(SYS_DMA_TRANSFER_EVENT event, SYS_DMA_CHANNEL_HANDLE handle, uintptr_t contextHandle);
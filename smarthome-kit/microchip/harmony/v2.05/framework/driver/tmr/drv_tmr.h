@@ -1073,6 +1073,105 @@ void DRV_TMR_AlarmPeriodSet ( DRV_HANDLE handle, uint32_t value );
 
 uint32_t DRV_TMR_AlarmPeriodGet ( DRV_HANDLE handle );
 
+// *****************************************************************************
+/* Function:
+    bool DRV_TMR_AlarmPeriodUpdate ( DRV_HANDLE handle, uint32_t value )
+
+  Summary:
+    Updates the period of a running alarm, without stopping the timer.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    This function updates the Timer's period while the timer keeps counting.
+    Unlike DRV_TMR_AlarmPeriodSet, the timer counter is not stopped and
+    a pending alarm is not cleared, so no alarm is lost.
+    The new period applies to the period currently running.
+
+  Precondition:
+    The DRV_TMR_Initialize function must have been called.
+
+    DRV_TMR_Open must have been called to obtain a valid opened device handle.
+
+    The timer must be running.
+
+  Parameters:
+    handle       - A valid open-instance handle, returned from the driver's
+                   open routine
+
+    value        - Period value
+                      - a 16 bit value if the timer is configured in 16 bit mode
+                      - a 32 bit value if the timer is configured in 32 bit mode
+
+  Returns:
+    - true  - The period has been updated
+    - false - The timer is not running or the current period already
+              elapsed and the alarm is pending
+
+  Example:
+    <code>
+    DRV_HANDLE handle;  // Returned from DRV_TMR_Open
+
+    if(DRV_TMR_CounterValueGet ( handle ) + margin < 0x1000)
+    {
+        DRV_TMR_AlarmPeriodUpdate ( handle, 0x1000 );
+    }
+    </code>
+
+  Remarks:
+    - The caller has to make sure the new period value is greater than
+      the counter value. Otherwise the counter runs up to its maximum value
+      and wraps around before the alarm occurs.
+    - The caller should disable the alarm (DRV_TMR_AlarmDisable)
+      around the counter check and the update.
+*/
+
+bool DRV_TMR_AlarmPeriodUpdate ( DRV_HANDLE handle, uint32_t value );
+
+// *****************************************************************************
+/* Function:
+    bool DRV_TMR_AlarmPendingGet ( DRV_HANDLE handle )
+
+  Summary:
+    Checks if the current alarm period elapsed and the alarm is pending.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    This function returns the status of the timer alarm interrupt flag.
+    The alarm is pending when the period elapsed but the alarm was not
+    processed yet, for example because the alarm is disabled.
+
+  Precondition:
+    The DRV_TMR_Initialize function must have been called.
+
+    DRV_TMR_Open must have been called to obtain a valid opened device handle.
+
+  Parameters:
+    handle       - A valid open-instance handle, returned from the driver's
+                   open routine
+
+  Returns:
+    - true  - The alarm is pending
+    - false - No alarm is pending or the handle is invalid
+
+  Example:
+    <code>
+    DRV_HANDLE tmrHandle;  // Returned from DRV_TMR_Open
+    bool alarmLock;
+
+    alarmLock = DRV_TMR_AlarmDisable ( tmrHandle );
+    if(DRV_TMR_AlarmPendingGet ( tmrHandle ))
+    {
+        // the counter wrapped around; the period is over
+    }
+    DRV_TMR_AlarmEnable ( tmrHandle, alarmLock );
+    </code>
+
+  Remarks:
+    None.
+*/
+
+bool DRV_TMR_AlarmPendingGet ( DRV_HANDLE handle );
+
 // *****************************************************************************
 /* Function:
     void DRV_TMR_AlarmDeregister ( DRV_HANDLE handle )
@@ -897,6 +897,74 @@ uint32_t DRV_TMR_AlarmPeriodGet ( DRV_HANDLE handle )
     return 0;
 } 
 
+// *****************************************************************************
+/* Function:
+    bool DRV_TMR_AlarmPeriodUpdate ( DRV_HANDLE handle, uint32_t value )
+
+  Summary:
+    Updates the period of a running alarm.
+
+  Description:
+    This function updates the Timer's period without stopping the timer
+    and without clearing a pending alarm.
+
+  Remarks:
+    Refer to drv_tmr.h for usage information.
+*/
+
+bool DRV_TMR_AlarmPeriodUpdate ( DRV_HANDLE handle, uint32_t   period )
+{
+    DRV_TMR_CLIENT_OBJ *dObj = _DRV_TMR_ClientObj(handle);
+
+    if(dObj == 0 || dObj->clientStatus != DRV_TMR_CLIENT_OBJ_RUNNING)
+    {
+        return false;
+    }
+
+    if(tmr_interrupt_status ( dObj->pModInst->tmrId ) != false)
+    {   // the current period is over; too late to change it
+        return false;
+    }
+
+    dObj->pModInst->timerPeriod = period;
+    if(dObj->pModInst->operMode == DRV_TMR_OPERATION_MODE_16_BIT)
+    {
+        tmr_period_set ( dObj->pModInst->tmrId, (uint16_t)period);
+    }
+    else
+    {
+        tmr_period_32bit_set ( dObj->pModInst->tmrId, period);
+    }
+
+    return true;
+}
+
+// *****************************************************************************
+/* Function:
+    bool DRV_TMR_AlarmPendingGet ( DRV_HANDLE handle )
+
+  Summary:
+    Checks if the alarm is pending.
+
+  Description:
+    This function returns the status of the Timer's interrupt flag.
+
+  Remarks:
+    Refer to drv_tmr.h for usage information.
+*/
+
+bool DRV_TMR_AlarmPendingGet ( DRV_HANDLE handle )
+{
+    DRV_TMR_CLIENT_OBJ *dObj = _DRV_TMR_ClientObj(handle);
+
+    if(dObj)
+    {
+        return tmr_interrupt_status ( dObj->pModInst->tmrId ) != false;
+    }
+
+    return false;
+}
+
 // *****************************************************************************
 /* Function:
     void DRV_TMR_AlarmDeregister ( DRV_HANDLE handle )
@@ -72,6 +72,8 @@ static volatile bool s_Spi_Tx_Done = true;
 static volatile bool s_Spi_Rx_Done = true;
 OSAL_SEM_HANDLE_TYPE s_dmaTxSync;
 OSAL_SEM_HANDLE_TYPE s_dmaRxSync;
+static WDRV_STUB_SPI_BUS_ACQUIRE s_SpiBusAcquire = NULL;
+static WDRV_STUB_SPI_BUS_RELEASE s_SpiBusRelease = NULL;
 
 #if defined(__PIC32MZ__)
 extern void SYS_DEVCON_DataCacheClean(uint32_t addr, size_t len);
@@ -175,17 +177,37 @@ static bool _Spi_Rx(unsigned char *const buf, uint32_t size)
     return ret;
 }
 
-extern SemaphoreHandle_t smphrSPI2;
+/* Maximum time to wait for the bus if the application shares it. */
+#define WDRV_SPI_BUS_TIMEOUT_MS 500
 
+static bool _Spi_BusAcquire(void)
+{
+    if (s_SpiBusAcquire == NULL)
+        return true;
+
+    return s_SpiBusAcquire(WDRV_SPI_BUS_TIMEOUT_MS);
+}
+
+static void _Spi_BusRelease(void)
+{
+    if (s_SpiBusRelease != NULL)
+        s_SpiBusRelease();
+}
+
+void WDRV_STUB_SPI_BusArbiterSet(WDRV_STUB_SPI_BUS_ACQUIRE acquire, WDRV_STUB_SPI_BUS_RELEASE release)
+{
+    s_SpiBusAcquire = acquire;
+    s_SpiBusRelease = release;
+}
 
 bool WDRV_STUB_SPI_Out(unsigned char *const buf, uint32_t size)
 {
     bool ret = true;
     int c = 0;
-    
-    if (xSemaphoreTake(smphrSPI2, 500 / portTICK_PERIOD_MS))
-    {
-    
+
+    if (!_Spi_BusAcquire())
+        return false;
+
     CS_Assert();
 
     while (size > SPI_DMA_MAX_TX_SIZE) {
@@ -198,10 +220,46 @@ bool WDRV_STUB_SPI_Out(unsigned char *const buf, uint32_t size)
         ret = _Spi_Tx((buf + c * SPI_DMA_MAX_TX_SIZE), size);
 
     CS_Deassert();
-    
-    xSemaphoreGive(smphrSPI2);
+    _Spi_BusRelease();
+
+    return ret;
+}
+
+bool WDRV_STUB_SPI_OutChain(const WDRV_STUB_SPI_SEGMENT *segments, int nSegments)
+{
+    DRV_SPI_BUFFER_SEGMENT chain[WDRV_STUB_SPI_CHAIN_MAX];
+    bool ret = true;
+    int i;
+
+    if (nSegments <= 0 || nSegments > WDRV_STUB_SPI_CHAIN_MAX)
+        return false;
+
+    /* The driver moves segments above the DMA threshold in DMA sized parts
+     * itself, so they are not split here. */
+    for (i = 0; i < nSegments; i++) {
+        SPI_DMA_DCACHE_CLEAN(segments[i].buf, segments[i].size);
+        chain[i].txBuffer = segments[i].buf;
+        chain[i].rxBuffer = NULL;
+        chain[i].size = segments[i].size;
+        chain[i].segmentStart = NULL;
+        chain[i].context = NULL;
     }
 
+    if (!_Spi_BusAcquire())
+        return false;
+
+    CS_Assert();
+
+    s_Spi_Tx_Done = false;
+    s_SpiBufferHandleTx = DRV_SPI_BufferAddChain(s_SpiHandle, chain, nSegments, SPI_TxComplete, 0, NULL);
+    if (s_SpiBufferHandleTx == (DRV_SPI_BUFFER_HANDLE)-1)
+        ret = false;
+    else
+        SPI_WAIT_FOR_TX_COMPLETION();
+
+    CS_Deassert();
+    _Spi_BusRelease();
+
     return ret;
 }
 
@@ -209,28 +267,24 @@ bool WDRV_STUB_SPI_In(unsigned char *const buf, uint32_t size)
 {
     bool ret = true;
     int c = 0;
-    
-    if (xSemaphoreTake(smphrSPI2, 500 / portTICK_PERIOD_MS))
-    {
-    
-        CS_Assert();
 
-        while (size > SPI_DMA_MAX_RX_SIZE) 
-        {
-            ret = _Spi_Rx(buf + c * SPI_DMA_MAX_RX_SIZE, SPI_DMA_MAX_RX_SIZE);
-            size -= SPI_DMA_MAX_RX_SIZE;
-            ++c;
-        }
+    if (!_Spi_BusAcquire())
+        return false;
 
-        if (size > 0)
-        {
-            ret = _Spi_Rx(buf + c * SPI_DMA_MAX_RX_SIZE, size);
-        }
+    CS_Assert();
 
-        CS_Deassert();
-        xSemaphoreGive(smphrSPI2);
+    while (size > SPI_DMA_MAX_RX_SIZE) {
+        ret = _Spi_Rx(buf + c * SPI_DMA_MAX_RX_SIZE, SPI_DMA_MAX_RX_SIZE);
+        size -= SPI_DMA_MAX_RX_SIZE;
+        ++c;
     }
 
+    if (size > 0)
+        ret = _Spi_Rx(buf + c * SPI_DMA_MAX_RX_SIZE, size);
+
+    CS_Deassert();
+    _Spi_BusRelease();
+
     return ret;
 }
 
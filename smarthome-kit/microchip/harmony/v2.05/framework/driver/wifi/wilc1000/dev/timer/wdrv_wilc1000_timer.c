@@ -54,4 +54,9 @@ void WDRV_STUB_HardDelay(uint16_t delay)
 		;
 }
 
+uint32_t WDRV_STUB_MsecCountGet(void)
+{
+	return (uint32_t)((SYS_TMR_TickCountGetLong() * 1000) / SYS_TMR_TickCounterFrequencyGet());
+}
+
 //DOM-IGNORE-END
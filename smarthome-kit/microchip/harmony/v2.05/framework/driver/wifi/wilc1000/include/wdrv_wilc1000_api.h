@@ -122,6 +122,35 @@ void WDRV_EXT_Deinitialize(void);
  */
 uint32_t WDRV_EXT_DataSend(uint16_t segSize, uint8_t *p_segData);
 
+//*******************************************************************************
+/*
+  Function:
+        uint32_t WDRV_EXT_DataSendSegments(WDRV_TX_SEGMENT const *segs, uint8_t segCnt)
+
+  Summary:
+    Sends a packet made of several segments.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    This function sends a packet whose data is scattered over several
+    buffers. Each segment is written straight to WILC1000 in turn.
+
+  Precondition:
+    Wi-Fi initialization must be complete.
+
+  Parameters:
+    segs - segments in packet order
+    segCnt - number of segments, at most WDRV_TX_MAX_SEGMENTS
+
+  Returns:
+    - 0              - Indicates success
+    - Non-zero value - Indicates failure
+
+  Remarks:
+    None.
+ */
+uint32_t WDRV_EXT_DataSendSegments(WDRV_TX_SEGMENT const *segs, uint8_t segCnt);
+
 //*******************************************************************************
 /*
   Function:
@@ -989,6 +1018,31 @@ void WDRV_EXT_ModuleUpDown(uint32_t up);
  */
 void WDRV_EXT_HWInterruptHandler(void);
 
+//*******************************************************************************
+/*
+  Function:
+        void WDRV_EXT_PowerSaveIdleNotify(void)
+
+  Summary:
+    Wakes the driver task to time the chip power save.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    This function is called by the host interface when it leaves the chip
+    awake after an access, so that the driver task puts the chip to sleep
+    once the idle time has passed.
+
+  Precondition:
+    Wi-Fi initialization must be complete.
+
+  Returns:
+    None.
+
+  Remarks:
+    None.
+ */
+void WDRV_EXT_PowerSaveIdleNotify(void);
+
 //*******************************************************************************
 /*
   Function:
@@ -1039,6 +1093,169 @@ bool WDRV_CLI_Init(void);
  */
 void WDRV_WILC1000_ISR();
 
+//*******************************************************************************
+/*
+  Function:
+        uint32_t WDRV_EXT_IrqTimestampGet(void)
+
+  Summary:
+    Returns the time of the last WILC1000 interrupt.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    This function returns the core timer count captured by the interrupt
+    service routine when the WILC1000 raised its interrupt line.
+
+  Precondition:
+    Wi-Fi initialization must be complete.
+
+  Returns:
+    Core timer count of the last interrupt.
+
+  Remarks:
+    Interrupt stays disabled until the driver task handles the event, so
+    during event handling the value belongs to the event being handled.
+ */
+uint32_t WDRV_EXT_IrqTimestampGet(void);
+
+//*******************************************************************************
+/*
+  Function:
+        void WDRV_RxLatencyGet(WDRV_RX_LATENCY *stats)
+
+  Summary:
+    Returns Rx latency statistics.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    This function returns time from the WILC1000 interrupt until the stack
+    releases the received packet, collected since initialization.
+
+  Precondition:
+    Wi-Fi initialization must be complete.
+
+  Parameters:
+    stats - pointer to the statistics structure to fill
+
+  Returns:
+    None.
+
+  Remarks:
+    None.
+ */
+void WDRV_RxLatencyGet(WDRV_RX_LATENCY *stats);
+
+//*******************************************************************************
+/*
+  Function:
+        void WDRV_RxPoolStatisticsGet(WDRV_RX_POOL_STATISTICS *stats)
+
+  Summary:
+    Returns Rx buffer pool statistics.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    This function returns current use and high water marks of the Rx buffer
+    pool, and the number of frames dropped since initialization.
+
+  Precondition:
+    Wi-Fi initialization must be complete.
+
+  Parameters:
+    stats - pointer to the statistics structure to fill
+
+  Returns:
+    None.
+
+  Remarks:
+    Counters are updated without locking, a snapshot taken while frames
+    arrive may be off by one.
+ */
+void WDRV_RxPoolStatisticsGet(WDRV_RX_POOL_STATISTICS *stats);
+
+//*******************************************************************************
+/*
+  Function:
+        void WDRV_TxStatisticsGet(WDRV_TX_STATISTICS *stats)
+
+  Summary:
+    Returns Tx path statistics.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    This function returns counters of packets sent with and without copying,
+    collected since initialization.
+
+  Precondition:
+    Wi-Fi initialization must be complete.
+
+  Parameters:
+    stats - pointer to the statistics structure to fill
+
+  Returns:
+    None.
+
+  Remarks:
+    None.
+ */
+void WDRV_TxStatisticsGet(WDRV_TX_STATISTICS *stats);
+
+//*******************************************************************************
+/*
+  Function:
+        void WDRV_EXT_HifStatisticsGet(WDRV_HIF_STATISTICS *stats)
+
+  Summary:
+    Returns host interface traffic statistics.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    This function returns the number of messages exchanged with WILC1000
+    firmware and the SPI transactions it took, counted since initialization.
+
+  Precondition:
+    Wi-Fi initialization must be complete.
+
+  Parameters:
+    stats - pointer to the statistics structure to fill
+
+  Returns:
+    None.
+
+  Remarks:
+    None.
+ */
+void WDRV_EXT_HifStatisticsGet(WDRV_HIF_STATISTICS *stats);
+
+//*******************************************************************************
+/*
+  Function:
+        void WDRV_EXT_PowerSaveIdleTimeSet(uint32_t idleMs)
+
+  Summary:
+    Sets how long WILC1000 stays awake after the last access.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    In power save modes the driver leaves the chip awake for idleMs after
+    the last message, so a burst of messages pays the wake up latency once.
+    Zero puts the chip back to sleep right after every message.
+
+  Precondition:
+    Wi-Fi initialization must be complete.
+
+  Parameters:
+    idleMs - idle time in milliseconds
+
+  Returns:
+    None.
+
+  Remarks:
+    Default is CONF_WILC_SLEEP_IDLE_MS. Use WDRV_EXT_HifStatisticsGet to
+    weigh wake ups saved against time awake.
+ */
+void WDRV_EXT_PowerSaveIdleTimeSet(uint32_t idleMs);
+
 //*******************************************************************************
 /*
   Function:
@@ -435,6 +435,15 @@ typedef union
 #define WDRV_TIME_DELAY(msec)           WDRV_MSecDelay(msec)
 #endif /* (OSAL_USE_RTOS == 1 || OSAL_USE_RTOS == 9) */
 
+/* Core timer runs at half of the system clock. */
+#if defined(__PIC32MZ__)
+#define WDRV_CYCLE_COUNT()              _CP0_GET_COUNT()
+#define WDRV_CYCLES_PER_US              (SYS_CLK_FREQ / 2000000ul)
+#else /* !defined(__PIC32MZ__) */
+#define WDRV_CYCLE_COUNT()              0
+#define WDRV_CYCLES_PER_US              1
+#endif /* defined(__PIC32MZ__) */
+
 #define WDRV_DBG_NONE    0
 #define WDRV_DBG_ERROR   1
 #define WDRV_DBG_INFORM  2
@@ -508,6 +517,155 @@ typedef struct {
 	bool isSerialFwUpdateRequested;
 } WDRV_HOOKS;
 
+/*******************************************************************************
+  Summary:
+    Contains Rx latency statistics.
+
+  Description:
+    Wi-Fi Rx latency statistics
+
+    Latency is measured from the WILC1000 interrupt which announced a frame
+    until the stack hands the Rx packet back to the driver.
+*/
+typedef struct
+{
+    /* number of frames measured */
+    uint32_t count;
+
+    /* latency of the last frame, in microseconds */
+    uint32_t lastUs;
+
+    /* lowest and highest latency seen, in microseconds */
+    uint32_t minUs;
+    uint32_t maxUs;
+
+    /* sum of all latencies, divide by count for average */
+    uint64_t totalUs;
+
+} WDRV_RX_LATENCY;
+
+/*******************************************************************************
+  Summary:
+    Contains Rx buffer pool statistics.
+
+  Description:
+    Wi-Fi Rx buffer pool statistics
+
+    Frames are dropped when the stack holds every Rx buffer, so the high
+    water marks tell whether WDRV_RX_BUFFER_COUNT is sized right.
+*/
+typedef struct
+{
+    /* number of buffers in the pool */
+    uint32_t buffers;
+
+    /* buffers free and buffers waiting for the stack, right now */
+    uint32_t free;
+    uint32_t pending;
+
+    /* most buffers ever taken out of the pool at once */
+    uint32_t inUseHigh;
+
+    /* most buffers ever waiting for the stack at once */
+    uint32_t pendingHigh;
+
+    /* frames handed to the stack */
+    uint32_t received;
+
+    /* frames dropped because no buffer was free */
+    uint32_t dropNoBuffer;
+
+    /* frames dropped because they did not fit a buffer */
+    uint32_t dropTooLong;
+
+} WDRV_RX_POOL_STATISTICS;
+
+/* Tx packets with more segments than this are copied to one buffer */
+#define WDRV_TX_MAX_SEGMENTS 4
+
+/*******************************************************************************
+  Summary:
+    Contains one segment of a Tx packet.
+
+  Description:
+    Wi-Fi Tx segment
+
+    Segments of a packet are sent to WILC1000 one after another, without
+    gathering them in host memory first.
+*/
+typedef struct
+{
+    /* segment data */
+    uint8_t *data;
+
+    /* segment length */
+    uint16_t size;
+
+} WDRV_TX_SEGMENT;
+
+/*******************************************************************************
+  Summary:
+    Contains Tx path statistics.
+
+  Description:
+    Wi-Fi Tx statistics
+
+    Shows how many packets were sent without copying.
+*/
+typedef struct
+{
+    /* packets handed to WILC1000 */
+    uint32_t packets;
+
+    /* multi-segment packets sent segment by segment */
+    uint32_t gathered;
+
+    /* packets which had to be copied to the Tx buffer */
+    uint32_t copied;
+
+    /* bytes copied to the Tx buffer */
+    uint32_t copiedBytes;
+
+} WDRV_TX_STATISTICS;
+
+/*******************************************************************************
+  Summary:
+    Contains host interface traffic statistics.
+
+  Description:
+    Wi-Fi host interface statistics
+
+    Divide busTransactions by the number of messages to get the SPI
+    transactions spent per host interface message.
+*/
+typedef struct
+{
+    /* messages sent to WILC1000 firmware */
+    uint32_t txMessages;
+
+    /* messages received from WILC1000 firmware */
+    uint32_t rxMessages;
+
+    /* SPI transactions, including register polling */
+    uint32_t busTransactions;
+
+    /* times the chip was woken up from power save */
+    uint32_t wakes;
+
+    /* accesses which found the chip still awake, each saved a wake up */
+    uint32_t wakesSaved;
+
+    /* wake up latency, in microseconds */
+    uint32_t wakeLastUs;
+    uint32_t wakeMaxUs;
+    uint32_t wakeAvgUs;
+
+    /* share of time the host kept the chip out of power save, zero in
+       M2M_NO_PS where the firmware keeps it awake by itself */
+    uint32_t awakePercent;
+
+} WDRV_HIF_STATISTICS;
+
 void WDRV_Assert(int condition, const char *msg, const char *file, int line);
 bool WDRV_SemInit(OSAL_SEM_HANDLE_TYPE *SemID);
 void WDRV_SemTake(OSAL_SEM_HANDLE_TYPE *SemID, uint16_t timeout);
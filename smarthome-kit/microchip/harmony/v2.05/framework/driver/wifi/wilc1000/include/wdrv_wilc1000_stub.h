@@ -137,6 +137,54 @@ void WDRV_STUB_INTR_Init(void (*isr)(void));
  */
 void WDRV_STUB_INTR_Deinit(void);
 
+// *****************************************************************************
+/* SPI Bus Arbiter Functions
+
+  Summary:
+    Functions the application supplies when the SPI bus is shared.
+
+  Description:
+    acquire is called before each chip select window of the module, with the
+    maximum time in milliseconds to wait for the bus. It returns true if the
+    bus is acquired. release is called after the chip select window is
+    closed.
+
+  Remarks:
+    None.
+*/
+typedef bool (*WDRV_STUB_SPI_BUS_ACQUIRE)(uint32_t timeoutMs);
+typedef void (*WDRV_STUB_SPI_BUS_RELEASE)(void);
+
+//*******************************************************************************
+/*
+  Function:
+      void WDRV_STUB_SPI_BusArbiterSet(WDRV_STUB_SPI_BUS_ACQUIRE acquire,
+                                       WDRV_STUB_SPI_BUS_RELEASE release)
+
+  Summary:
+    Sets the arbiter of the SPI bus shared with other devices.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    This function sets the functions called around each chip select window
+    of the module. The driver does not arbitrate the bus if they are not set.
+
+  Precondition:
+    None.
+
+  Parameters:
+    acquire - function acquiring the bus, NULL for none
+    release - function releasing the bus, NULL for none
+
+  Returns:
+    None.
+
+  Remarks:
+    Has to be called before the Wi-Fi driver is initialized, or while no
+    SPI transfer to the module is in progress.
+ */
+void WDRV_STUB_SPI_BusArbiterSet(WDRV_STUB_SPI_BUS_ACQUIRE acquire, WDRV_STUB_SPI_BUS_RELEASE release);
+
 //*******************************************************************************
 /*
   Function:
@@ -161,10 +209,61 @@ void WDRV_STUB_INTR_Deinit(void);
     False - Indicates failure
 
   Remarks:
-    None.
+    False is also returned if the bus arbiter does not grant the bus.
  */
 bool WDRV_STUB_SPI_Out(unsigned char *const buf, uint32_t size);
 
+// *****************************************************************************
+/* SPI Output Segment
+
+  Summary:
+    One buffer of a chained SPI output.
+
+  Description:
+    See WDRV_STUB_SPI_OutChain.
+
+  Remarks:
+    None.
+*/
+typedef struct {
+    unsigned char *buf;
+    uint32_t size;
+} WDRV_STUB_SPI_SEGMENT;
+
+/* Maximum number of segments of WDRV_STUB_SPI_OutChain */
+#define WDRV_STUB_SPI_CHAIN_MAX 4
+
+//*******************************************************************************
+/*
+  Function:
+      bool WDRV_STUB_SPI_OutChain(const WDRV_STUB_SPI_SEGMENT *segments, int nSegments)
+
+  Summary:
+    Sends several buffers out to the module in one SPI transfer.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    This function sends the segments back to back, in one chip select window
+    and as one chained SPI driver job, so a command, its data and its CRC
+    need neither a copy nor a transfer each.
+
+  Precondition:
+    SPI driver should be initialized.
+
+  Parameters:
+    segments - array of output buffers
+    nSegments - number of segments, up to WDRV_STUB_SPI_CHAIN_MAX
+
+  Returns:
+    True - Indicates success
+    False - Indicates failure
+
+  Remarks:
+    The SPI driver instance has to run the interrupt master 8-bit task, see
+    DRV_SPI_BufferAddChain.
+ */
+bool WDRV_STUB_SPI_OutChain(const WDRV_STUB_SPI_SEGMENT *segments, int nSegments);
+
 //*******************************************************************************
 /*
   Function:
@@ -452,4 +551,31 @@ void WDRV_STUB_Assert(int condition, const char *msg, const char *file, int line
  */
 void WDRV_STUB_HardDelay(uint16_t delay);
 
+//*******************************************************************************
+/*
+  Function:
+        uint32_t WDRV_STUB_MsecCountGet(void)
+
+  Summary:
+    Returns a free running millisecond count.
+    <p><b>Implementation:</b> Dynamic</p>
+
+  Description:
+    This function returns the time since system start in milliseconds. It
+    is used to time chip power save.
+
+  Precondition:
+    The system timer should be initialized.
+
+  Parameters:
+    None.
+
+  Returns:
+    Milliseconds since system start, wrapping at 32 bits.
+
+  Remarks:
+    None.
+ */
+uint32_t WDRV_STUB_MsecCountGet(void);
+
 #endif /* _WDRV_WILC1000_STUB_H */
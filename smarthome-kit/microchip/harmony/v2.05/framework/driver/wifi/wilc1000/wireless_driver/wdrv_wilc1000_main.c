@@ -41,7 +41,14 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #define TCPIP_THIS_MODULE_ID TCPIP_MODULE_MAC_WILC1000
 
 #define ETH_HEADER_SIZE 14
-#define NUM_PREALLOCATED_RX_PACKETS 4
+// Rx packets preallocated at init. Must be a power of two, use the pool high
+// water marks from WDRV_RxPoolStatisticsGet() to size it.
+#ifndef WDRV_RX_BUFFER_COUNT
+#define WDRV_RX_BUFFER_COUNT 4
+#endif
+#if (WDRV_RX_BUFFER_COUNT & (WDRV_RX_BUFFER_COUNT - 1)) != 0
+#error "WDRV_RX_BUFFER_COUNT must be a power of two"
+#endif
 #define MAX_IP_PACKET_SIZE 1564 // including header
 #define MAX_RX_PACKET_SIZE 1518
 #define MAX_TX_PACKET_SIZE 1518
@@ -49,13 +56,16 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 
 #define WAIT_FOR_DISCONNECT_COMPLETE() WDRV_SEM_TAKE(&g_wdrv_priv.disconnectDoneSync, OSAL_WAIT_FOREVER)
 
-// used to keep track of RX packets queued for stack
+// Ring of Rx packets. Head is only written by the side which puts packets in
+// and tail only by the side which takes them out, so one producer and one
+// consumer need no lock. Counters run freely and are masked on access. Every
+// packet of the pool is in at most one ring, so a ring can never overflow.
 typedef struct
 {
-    int front;
-    int rear;
-    TCPIP_MAC_PACKET *items[NUM_PREALLOCATED_RX_PACKETS + 1];
-} t_fifo;
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    TCPIP_MAC_PACKET *volatile items[WDRV_RX_BUFFER_COUNT];
+} t_rx_ring;
 
 // WILC1000 wireless driver descriptor
 typedef struct
@@ -70,15 +80,16 @@ typedef struct
 static TCPIP_MAC_PKT_AllocF s_pktAllocF = 0;
 static TCPIP_MAC_PKT_FreeF s_pktFreeF = 0;
 static TCPIP_MAC_PKT_AckF s_pktAckF = 0;
-static t_fifo s_rxFifo;
-static SINGLE_LIST s_dataRxQueue; // queue of data rx packets waiting to be processed by stack from host
-static TCPIP_MAC_PACKET *s_rxpacket_buffer[NUM_PREALLOCATED_RX_PACKETS];
+static t_rx_ring s_rxReady; // received packets waiting for the stack, WILC1000 task -> stack
+static t_rx_ring s_rxFree;  // packets released by the stack, stack -> WILC1000 task
+static TCPIP_MAC_PACKET *s_rxpacket_buffer[WDRV_RX_BUFFER_COUNT];
 static uint8_t s_txpacket_buffer[MAX_IP_PACKET_SIZE];
 static TCPIP_MAC_MODULE_CTRL s_stackData;
 static TCPIP_MAC_ADDR s_MulticastFilter[MAX_MULTICAST_FILTER_SIZE];
 static OSAL_MUTEX_HANDLE_TYPE s_multicastFilterLock;
-static OSAL_MUTEX_HANDLE_TYPE s_rxFifoLock;
-static OSAL_MUTEX_HANDLE_TYPE s_dataQueueLock;
+static WDRV_RX_LATENCY s_rxLatency;
+static WDRV_RX_POOL_STATISTICS s_rxPoolStats;
+static WDRV_TX_STATISTICS s_txStats;
 
 WDRV_WILC1000_PRIV g_wdrv_priv =
 {
@@ -114,12 +125,14 @@ static size_t WDRV_WILC1000_GetConfig(TCPIP_MODULE_MAC_ID modId, void *configBuf
         size_t *pConfigSize);
 static void PowerDown(void);
 static void PowerUp(void);
-static void FifoInit(t_fifo *const p_fifo);
-static bool isFifoEmpty(t_fifo *const p_fifo);
-static void FifoInsert(t_fifo *const p_fifo, TCPIP_MAC_PACKET *p_packet);
-static TCPIP_MAC_PACKET *FifoRemove(t_fifo *const p_fifo);
+static void RingInit(t_rx_ring *const p_ring);
+static uint32_t RingCount(t_rx_ring const *const p_ring);
+static void RingPut(t_rx_ring *const p_ring, TCPIP_MAC_PACKET *p_packet);
+static TCPIP_MAC_PACKET *RingGet(t_rx_ring *const p_ring);
 static TCPIP_MAC_PACKET *GetRxPacket(void);
 static bool RxDataCallback(TCPIP_MAC_PACKET *pktHandle, const void *ackParam);
+static void RxLatencyUpdate(uint32_t irqStamp);
+static void RxPacketQueue(TCPIP_MAC_PACKET *p_packet);
 static void InitRxBuffer(void);
 static void DeInitRxBuffer(void);
 bool isWdrvExtReady(void);
@@ -268,6 +281,11 @@ static TCPIP_MAC_RES WDRV_WILC1000_TxPacket(TCPIP_MAC_HANDLE hMac, TCPIP_MAC_PAC
     uint8_t *p_segData;
     uint32_t sendResult;
     uint16_t curIndex = 0;
+    WDRV_TX_SEGMENT segs[WDRV_TX_MAX_SEGMENTS];
+    uint32_t segCnt = 0;
+    uint32_t pktLen = 0;
+
+    TCPIP_PKT_FlightLogTx(ptrPacket, TCPIP_THIS_MODULE_ID);
 
     if (isLinkUp() == false) {
         WDRV_DBG_INFORM_MESSAGE(("WILC1000 is in unconnected state, dropped the Tx packet\r\n"));
@@ -309,27 +327,41 @@ static TCPIP_MAC_RES WDRV_WILC1000_TxPacket(TCPIP_MAC_HANDLE hMac, TCPIP_MAC_PAC
          }
          sendResult = WDRV_EXT_DataSend(p_seg->segLen, p_segData);
     } else {
-        memcpy(s_txpacket_buffer, p_segData, p_seg->segLen);
-        curIndex += p_seg->segLen;
-        while (p_seg->next != NULL) {
-            if (curIndex > MAX_TX_PACKET_SIZE) {
-                WDRV_DBG_ERROR_PRINT(("Invalid packet length %d, dropped the Tx packet\r\n", curIndex));
-                res = TCPIP_MAC_RES_PACKET_ERR;
-                // call stack ack function to let it know packet was transmitted
-                if (s_pktAckF) {
-                    s_pktAckF(ptrPacket, TCPIP_MAC_PKT_ACK_TX_OK, TCPIP_THIS_MODULE_ID);
-                } else {
-                    WDRV_ASSERT(false, "Should never happen");
-                }
-                return res;
+        // describe the segments first, they are written to WILC1000 in place
+        for (; p_seg != NULL; p_seg = p_seg->next) {
+            if (segCnt < WDRV_TX_MAX_SEGMENTS) {
+                segs[segCnt].data = p_seg->segLoad;
+                segs[segCnt].size = p_seg->segLen;
             }
-            p_seg = p_seg->next;
-            p_segData = p_seg->segLoad;
-            memcpy(s_txpacket_buffer + curIndex, p_segData, p_seg->segLen);
-            curIndex += p_seg->segLen;
+            ++segCnt;
+            pktLen += p_seg->segLen;
+        }
+        if (pktLen > MAX_TX_PACKET_SIZE) {
+            WDRV_DBG_ERROR_PRINT(("Invalid packet length %d, dropped the Tx packet\r\n", (int)pktLen));
+            res = TCPIP_MAC_RES_PACKET_ERR;
+            // call stack ack function to let it know packet was transmitted
+            if (s_pktAckF) {
+                s_pktAckF(ptrPacket, TCPIP_MAC_PKT_ACK_TX_OK, TCPIP_THIS_MODULE_ID);
+            } else {
+                WDRV_ASSERT(false, "Should never happen");
+            }
+            return res;
+        }
+        if (segCnt <= WDRV_TX_MAX_SEGMENTS) {
+            sendResult = WDRV_EXT_DataSendSegments(segs, segCnt);
+            ++s_txStats.gathered;
+        } else {
+            // too fragmented, gather into the Tx buffer
+            for (p_seg = p_packet->pDSeg; p_seg != NULL; p_seg = p_seg->next) {
+                memcpy(s_txpacket_buffer + curIndex, p_seg->segLoad, p_seg->segLen);
+                curIndex += p_seg->segLen;
+            }
+            sendResult = WDRV_EXT_DataSend(curIndex, s_txpacket_buffer);
+            ++s_txStats.copied;
+            s_txStats.copiedBytes += curIndex;
         }
-        sendResult = WDRV_EXT_DataSend(curIndex, s_txpacket_buffer);
     }
+    ++s_txStats.packets;
 
     if (sendResult != 0) {
         res = TCPIP_MAC_RES_PACKET_ERR;
@@ -406,86 +438,61 @@ static void PowerUp(void)
     WDRV_EXT_ModuleUpDown(true);
 }
 
-static void FifoInit(t_fifo *const p_fifo)
-{
-    memset(p_fifo, 0x00, sizeof(t_fifo));
-    p_fifo->front = p_fifo->rear = NUM_PREALLOCATED_RX_PACKETS - 1;
-}
-
-static bool isFifoEmpty(t_fifo *const p_fifo)
+static void RingInit(t_rx_ring *const p_ring)
 {
-    return p_fifo->front == p_fifo->rear;
+    memset((void *)p_ring, 0x00, sizeof(t_rx_ring));
 }
 
-static bool isFifoFull(t_fifo *const p_fifo)
+static uint32_t RingCount(t_rx_ring const *const p_ring)
 {
-    if ((p_fifo->front == 0) && (p_fifo->rear == NUM_PREALLOCATED_RX_PACKETS - 1))
-        return true;
-    else if (p_fifo->front == p_fifo->rear + 1)
-        return true;
-    else
-        return false;
+    return p_ring->head - p_ring->tail;
 }
 
-static void FifoInsert(t_fifo *const p_fifo, TCPIP_MAC_PACKET *p_packet)
+// producer side only
+static void RingPut(t_rx_ring *const p_ring, TCPIP_MAC_PACKET *p_packet)
 {
-    WDRV_MUTEX_LOCK(&s_rxFifoLock, OSAL_WAIT_FOREVER);
-
-    if (isFifoFull(p_fifo))
-    {
-        if ((*p_packet->ackFunc)(p_packet, p_packet->ackParam))
-        {
-            p_packet->pktFlags &= ~TCPIP_MAC_PKT_FLAG_QUEUED;
-        }
-    }
+    uint32_t head = p_ring->head;
 
-    if (p_fifo->rear == NUM_PREALLOCATED_RX_PACKETS - 1)
-        p_fifo->rear = 0;
-    else
-        ++p_fifo->rear;
-
-    p_fifo->items[p_fifo->rear] = p_packet;
-
-    WDRV_MUTEX_UNLOCK(&s_rxFifoLock);
+    WDRV_ASSERT((head - p_ring->tail) < WDRV_RX_BUFFER_COUNT, "Rx ring overflow");
+    p_ring->items[head & (WDRV_RX_BUFFER_COUNT - 1)] = p_packet;
+    p_ring->head = head + 1; // publish after the item is stored
 }
 
-static TCPIP_MAC_PACKET *FifoRemove(t_fifo *const p_fifo)
+// consumer side only
+static TCPIP_MAC_PACKET *RingGet(t_rx_ring *const p_ring)
 {
-    if (p_fifo->front == NUM_PREALLOCATED_RX_PACKETS - 1)
-        p_fifo->front = 0;
-    else
-        ++p_fifo->front;
+    uint32_t tail = p_ring->tail;
+    TCPIP_MAC_PACKET *p_packet;
+
+    if (tail == p_ring->head)
+        return NULL;
 
-    return p_fifo->items[p_fifo->front];
+    p_packet = p_ring->items[tail & (WDRV_RX_BUFFER_COUNT - 1)];
+    p_ring->tail = tail + 1; // release the slot after the item is read
+    return p_packet;
 }
 
 // retrieve the oldest of the queued Rx packets to deliver to the stack
 static TCPIP_MAC_PACKET *GetRxPacket(void)
 {
-    TCPIP_MAC_PACKET *ret;
-
-    WDRV_MUTEX_LOCK(&s_rxFifoLock, OSAL_WAIT_FOREVER);
-
-    if (!isFifoEmpty(&s_rxFifo))
-        ret = FifoRemove(&s_rxFifo);
-    else
-        ret = NULL; // signals no rx packet available.
-
-    WDRV_MUTEX_UNLOCK(&s_rxFifoLock);
-
-    return ret;
+    return RingGet(&s_rxReady); // NULL signals no rx packet available.
 }
+// ackParam of a queued Rx packet carries the core timer count of the interrupt
+// which announced it, see PushFrameToFifo()
 static bool RxDataCallback(TCPIP_MAC_PACKET *pktHandle, const void *ackParam)
 {
-    ackParam = ackParam; // ignore warning
-
     if (pktHandle){
         // if this is packet allocated at init and is going to be reused
         if ((pktHandle->pDSeg->segFlags & TCPIP_MAC_SEG_FLAG_RX_STICKY) == TCPIP_MAC_SEG_FLAG_RX_STICKY) {
+            OSAL_CRITSECT_DATA_TYPE crit;
+
             pktHandle->pktFlags &= ~TCPIP_MAC_PKT_FLAG_QUEUED;
-            WDRV_MUTEX_LOCK(&s_dataQueueLock, OSAL_WAIT_FOREVER);
-            TCPIP_Helper_SingleListTailAdd(&s_dataRxQueue, (SGL_LIST_NODE *)pktHandle); // add packet back to free list
-            WDRV_MUTEX_UNLOCK(&s_dataQueueLock);
+            // stack may release packets from more than one task, keep the
+            // free ring single producer by not letting them interleave
+            crit = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+            RxLatencyUpdate((uint32_t)(uintptr_t)ackParam);
+            RingPut(&s_rxFree, pktHandle); // add packet back to free ring
+            OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, crit);
         }
     } else {
         WDRV_ASSERT(false, "pktHandle cannot be null");
@@ -494,13 +501,49 @@ static bool RxDataCallback(TCPIP_MAC_PACKET *pktHandle, const void *ackParam)
     return false;
 }
 
+static void RxLatencyUpdate(uint32_t irqStamp)
+{
+    uint32_t us = (WDRV_CYCLE_COUNT() - irqStamp) / WDRV_CYCLES_PER_US;
+
+    s_rxLatency.count++;
+    s_rxLatency.lastUs = us;
+    s_rxLatency.totalUs += us;
+    if (us < s_rxLatency.minUs)
+        s_rxLatency.minUs = us;
+    if (us > s_rxLatency.maxUs)
+        s_rxLatency.maxUs = us;
+}
+
+void WDRV_TxStatisticsGet(WDRV_TX_STATISTICS *stats)
+{
+    *stats = s_txStats;
+}
+
+void WDRV_RxLatencyGet(WDRV_RX_LATENCY *stats)
+{
+    OSAL_CRITSECT_DATA_TYPE crit;
+
+    crit = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    *stats = s_rxLatency;
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, crit);
+}
+
+void WDRV_RxPoolStatisticsGet(WDRV_RX_POOL_STATISTICS *stats)
+{
+    *stats = s_rxPoolStats;
+    stats->free = RingCount(&s_rxFree);
+    stats->pending = RingCount(&s_rxReady);
+}
+
 static void InitRxBuffer(void)
 {
     int32_t i;
-    // create a queue to hold pointers to preallocated Rx packets
-    TCPIP_Helper_SingleListInitialize(&s_dataRxQueue);
 
-    for (i = 0; i < NUM_PREALLOCATED_RX_PACKETS; ++i) {
+    RingInit(&s_rxFree);
+    RingInit(&s_rxReady);
+    memset(&s_rxPoolStats, 0, sizeof(s_rxPoolStats));
+
+    for (i = 0; i < WDRV_RX_BUFFER_COUNT; ++i) {
         // preallocate Rx buffers to store Rx packets as they come in (1500 bytes data plus header and checksum)
         s_rxpacket_buffer[i] = s_pktAllocF ? s_pktAllocF(sizeof(TCPIP_MAC_PACKET), MAX_RX_PACKET_SIZE, 0) : 0; //_TCPIP_PKT_PacketAllocDebug
 
@@ -510,13 +553,15 @@ static void InitRxBuffer(void)
             s_rxpacket_buffer[i]->ackParam = NULL;
             s_rxpacket_buffer[i]->pktFlags = 0;
             s_rxpacket_buffer[i]->pDSeg->segFlags |= TCPIP_MAC_SEG_FLAG_RX_STICKY;
-            TCPIP_Helper_SingleListTailAdd(&s_dataRxQueue, (SGL_LIST_NODE *)s_rxpacket_buffer[i]);
+            RingPut(&s_rxFree, s_rxpacket_buffer[i]);
+            ++s_rxPoolStats.buffers;
         } else {
             WDRV_ASSERT(false, "");
         }
     }
 
-    FifoInit(&s_rxFifo);
+    memset(&s_rxLatency, 0, sizeof(s_rxLatency));
+    s_rxLatency.minUs = UINT32_MAX;
 }
 
 static void DeInitRxBuffer(void)
@@ -524,7 +569,7 @@ static void DeInitRxBuffer(void)
     int i;
 
     if (s_pktFreeF != NULL) {
-        for (i = 0; i < NUM_PREALLOCATED_RX_PACKETS; ++i) {
+        for (i = 0; i < WDRV_RX_BUFFER_COUNT; ++i) {
             if (s_rxpacket_buffer[i] != NULL) {
                 s_pktFreeF(s_rxpacket_buffer[i]);
                 s_rxpacket_buffer[i] = NULL;
@@ -533,22 +578,43 @@ static void DeInitRxBuffer(void)
     }
 }
 
-// Finds an available RX packet structure from the list that was allocated and
-// queued up at initialization process.
+// Takes a free RX packet from the pool that was allocated at initialization.
+// Called from WILC1000 task only, returns NULL when the stack holds all of them.
 static void *GetAvailRxBuf(void)
 {
-    TCPIP_MAC_PACKET *p_packet = NULL;
+    TCPIP_MAC_PACKET *p_packet;
+    uint32_t inUse;
 
-    WDRV_MUTEX_LOCK(&s_dataQueueLock, OSAL_WAIT_FOREVER);
-    if (s_dataRxQueue.nNodes > 0) {
-        p_packet = (TCPIP_MAC_PACKET *)TCPIP_Helper_SingleListHeadRemove(&s_dataRxQueue);
-        WDRV_ASSERT(p_packet != NULL, "Should never happen");
+    p_packet = RingGet(&s_rxFree);
+    if (p_packet == NULL) {
+        ++s_rxPoolStats.dropNoBuffer;
+        return NULL;
     }
-    WDRV_MUTEX_UNLOCK(&s_dataQueueLock);
+
+    inUse = s_rxPoolStats.buffers - RingCount(&s_rxFree);
+    if (inUse > s_rxPoolStats.inUseHigh)
+        s_rxPoolStats.inUseHigh = inUse;
 
     return p_packet;
 }
 
+// Hands a received packet to the stack. Called from WILC1000 task only.
+static void RxPacketQueue(TCPIP_MAC_PACKET *p_packet)
+{
+    uint32_t pending;
+
+    TCPIP_PKT_FlightLogRx(p_packet, TCPIP_THIS_MODULE_ID);
+    RingPut(&s_rxReady, p_packet);
+    ++s_rxPoolStats.received;
+
+    pending = RingCount(&s_rxReady);
+    if (pending > s_rxPoolStats.pendingHigh)
+        s_rxPoolStats.pendingHigh = pending;
+
+    // notify stack of Rx packet has arrived.
+    WDRV_TrafficEventReq(TCPIP_EV_RX_DONE, 0);
+}
+
 #ifdef ETH_RX_ZERO_COPY
 void PushFrameToFifo(uint32_t len, uint8_t const *const frame)
 {
@@ -560,17 +626,15 @@ void PushFrameToFifo(uint32_t len, uint8_t const *const frame)
     p_packet->pDSeg->segLen = len - ETH_HEADER_SIZE;
     p_packet->pktFlags |= TCPIP_MAC_PKT_FLAG_QUEUED;
     p_packet->tStamp = SYS_TMR_TickCountGet();
+    p_packet->ackParam = (const void *)(uintptr_t)WDRV_EXT_IrqTimestampGet();
 
     // Note: re-set pMacLayer and pNetLayer; IPv6 changes these pointers inside the packet, so
     //       when Rx packets are reused this is needed.
     p_packet->pMacLayer = p_packet->pDSeg->segLoad;
     p_packet->pNetLayer = p_packet->pMacLayer + sizeof(TCPIP_MAC_ETHERNET_HEADER);
 
-    // store packet pointer in FIFO and signal stack that rx packet ready to process
-    FifoInsert(&s_rxFifo, p_packet);
-
-    // notify stack of Rx packet has arrived.
-    WDRV_TrafficEventReq(TCPIP_EV_RX_DONE, 0);
+    // store packet pointer in ring and signal stack that rx packet ready to process
+    RxPacketQueue(p_packet);
 }
 #else /* !ETH_RX_ZERO_COPY */
 void PushFrameToFifo(uint32_t len, uint8_t const *const frame)
@@ -579,6 +643,12 @@ void PushFrameToFifo(uint32_t len, uint8_t const *const frame)
 
     WDRV_DBG_TRACE_MESSAGE(("Received packet\r\n"));
 
+    if (len > MAX_RX_PACKET_SIZE) {
+        ++s_rxPoolStats.dropTooLong;
+        return;
+    }
+
+    // drop rather than wait, WILC1000 task must keep servicing the chip
 	p_packet = GetAvailRxBuf();
 	if (p_packet == NULL)
 		return;
@@ -587,6 +657,7 @@ void PushFrameToFifo(uint32_t len, uint8_t const *const frame)
     p_packet->pDSeg->segLen = len - ETH_HEADER_SIZE;
     p_packet->pktFlags |= TCPIP_MAC_PKT_FLAG_QUEUED;
     p_packet->tStamp = SYS_TMR_TickCountGet();
+    p_packet->ackParam = (const void *)(uintptr_t)WDRV_EXT_IrqTimestampGet();
 
 	memcpy(p_packet->pDSeg->segLoad, frame, len);
 
@@ -595,11 +666,8 @@ void PushFrameToFifo(uint32_t len, uint8_t const *const frame)
     p_packet->pMacLayer = p_packet->pDSeg->segLoad;
     p_packet->pNetLayer = p_packet->pMacLayer + sizeof(TCPIP_MAC_ETHERNET_HEADER);
 
-    // store packet pointer in FIFO and signal stack that rx packet ready to process
-    FifoInsert(&s_rxFifo, p_packet);
-
-    // notify stack of Rx packet has arrived.
-    WDRV_TrafficEventReq(TCPIP_EV_RX_DONE, 0);
+    // store packet pointer in ring and signal stack that rx packet ready to process
+    RxPacketQueue(p_packet);
 }
 #endif /* ETH_RX_ZERO_COPY */
 
@@ -649,12 +717,8 @@ static SYS_MODULE_OBJ WDRV_WILC1000_Initialize(const SYS_MODULE_INDEX index, con
     WDRV_SEM_INIT(&g_wdrv_priv.disconnectDoneSync);
 
 #if (OSAL_USE_RTOS == 1 || OSAL_USE_RTOS == 9)
-    s_dataQueueLock = NULL;
-    s_rxFifoLock = NULL;
     s_multicastFilterLock = NULL;
 #endif    
-    WDRV_MUTEX_CREATE(&s_dataQueueLock);
-    WDRV_MUTEX_CREATE(&s_rxFifoLock);
     WDRV_MUTEX_CREATE(&s_multicastFilterLock);
     memset(g_wdrv_priv.macAddr, 0, sizeof(uint8_t) * 6);
 
@@ -772,8 +836,6 @@ static void WDRV_WILC1000_Deinitialize(SYS_MODULE_OBJ object)
 	WDRV_TrafficEventDeinit();
 	DeInitRxBuffer();
 	WDRV_EXT_Deinitialize();
-	WDRV_MUTEX_DELETE(&s_dataQueueLock);
-	WDRV_MUTEX_DELETE(&s_rxFifoLock);
 	WDRV_MUTEX_DELETE(&s_multicastFilterLock);
 	WDRV_SEM_DEINIT(&g_wdrv_priv.disconnectDoneSync);
 }
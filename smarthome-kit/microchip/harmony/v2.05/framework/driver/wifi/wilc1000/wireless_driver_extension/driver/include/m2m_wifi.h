@@ -43,6 +43,7 @@ INCLUDES
 
 #include "driver/wifi/wilc1000/wireless_driver_extension/common/include/nm_common.h"
 #include "driver/wifi/wilc1000/wireless_driver_extension/driver/include/m2m_types.h"
+#include "driver/wifi/wilc1000/wireless_driver_extension/driver/source/m2m_hif.h"
 #ifdef CONF_WILC_USE_3000_REV_A
 #include "driver/include/m2m_coex.h"
 #endif
@@ -1889,6 +1890,21 @@ NMI_API sint8 m2m_wifi_send_wlan_pkt(uint8 *pu8WlanPacket, uint16 u16WlanHeaderL
 
  */
 NMI_API sint8 m2m_wifi_send_ethernet_pkt(uint8* pu8Packet,uint16 u16PacketSize, uint8 u8IfcId);
+/*!
+ * @fn           NMI_API sint8 m2m_wifi_send_ethernet_pkt_sg(const tstrHifSeg *pstrSeg, uint8 u8SegCnt, uint8 u8IfcId)
+ * @param [in]     pstrSeg
+ *                  Ethernet frame split in segments, in frame order. Each segment is written
+ *                  straight into the chip buffer, the frame is never gathered in host memory.
+ * @param [in]     u8SegCnt
+ * 		            Number of segments.
+ * @param [in]     u8IfcId
+ *				    The interface selected to send Ethernet packet	(AP_INTERFACE, STATION_INTERFACE OR P2P_INTERFACE)
+ * 		                
+ * @note             Every segment costs one bus transaction, see @ref m2m_wifi_send_ethernet_pkt.
+ * @return         The function returns @ref M2M_SUCCESS for successful operations and a negative value otherwise.
+
+ */
+NMI_API sint8 m2m_wifi_send_ethernet_pkt_sg(const tstrHifSeg *pstrSeg, uint8 u8SegCnt, uint8 u8IfcId);
 /**@}*/
 /** @defgroup WifiSetCustInfoElementFn m2m_wifi_set_cust_InfoElement
  *   @ingroup WLANAPI
@@ -59,12 +59,34 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #define INTERRUPT_CORTUS_3_3000D0	(0x10b4)
 #endif
 
+/*
+	In power save modes the chip is left awake for this long after the last
+	access, so a burst of messages pays the wake up only once. Zero puts it
+	to sleep right after every access.
+*/
+#ifndef CONF_WILC_SLEEP_IDLE_MS
+#define CONF_WILC_SLEEP_IDLE_MS		(20)
+#endif
+
 static volatile uint8 gu8ChipMode = 0;
 static volatile uint8 gu8ChipSleep = 0;
 static volatile uint8 gu8HifSizeDone = 0;
 volatile uint8 gu8Interrupt = 0;
 
+static volatile uint8 gu8ChipAwake = 0;	/* woken by host and not put back to sleep yet */
+static uint8 gu8SleepPending = 0;		/* driver task told to time the sleep */
+static uint32 gu32SleepIdleMs = CONF_WILC_SLEEP_IDLE_MS;
+static uint32 gu32LastAccessMs;
+static uint32 gu32AwakeSinceMs;
+static uint32 gu32StatsSinceMs;
+#if (OSAL_USE_RTOS == 1 || OSAL_USE_RTOS == 9)
+static OSAL_MUTEX_HANDLE_TYPE s_hifPsLock = NULL;
+#else
+static OSAL_MUTEX_HANDLE_TYPE s_hifPsLock = 0;
+#endif
+
 static volatile tstrHifHdr gstrHif __M2M_DMA_BUF_ATT__;
+static tstrHifStats gstrHifStats;
 
 tpfHifCallBack pfWifiCb = NULL;		/*!< pointer to Wi-Fi call back function */
 tpfHifCallBack pfHifCb = NULL;
@@ -167,6 +189,39 @@ static void m2m_hif_cb(uint8 u8OpCode, uint16 u16DataSize, uint8* pu8Buff)
 
 
 }
+static sint8 hif_chip_wake_now(void)
+{
+	sint8 ret;
+	uint32 u32Start, u32Us;
+
+	u32Start = WDRV_CYCLE_COUNT();
+	ret = chip_wake();
+	if(ret != M2M_SUCCESS) return ret;
+	u32Us = (WDRV_CYCLE_COUNT() - u32Start) / WDRV_CYCLES_PER_US;
+
+	gu8ChipAwake = 1;
+	gu32AwakeSinceMs = WDRV_STUB_MsecCountGet();
+	gstrHifStats.u32Wakes++;
+	gstrHifStats.u32WakeUsLast = u32Us;
+	gstrHifStats.u32WakeUsTotal += u32Us;
+	if(u32Us > gstrHifStats.u32WakeUsMax)
+		gstrHifStats.u32WakeUsMax = u32Us;
+	return ret;
+}
+
+static sint8 hif_chip_sleep_now(void)
+{
+	sint8 ret;
+
+	ret = chip_sleep();
+	if(ret != M2M_SUCCESS) return ret;
+
+	gu8ChipAwake = 0;
+	gu8SleepPending = 0;
+	gstrHifStats.u32AwakeMs += WDRV_STUB_MsecCountGet() - gu32AwakeSinceMs;
+	return ret;
+}
+
 /**
 *	@fn		NMI_API sint8 hif_chip_wake(void);
 *	@brief	To Wakeup the chip.
@@ -181,12 +236,21 @@ sint8 hif_chip_wake(void)
 		/*chip already wake for the rx not done no need to send wake request*/
 		return ret;
 	}
+	WDRV_MUTEX_LOCK(&s_hifPsLock, OSAL_WAIT_FOREVER);
 	if(gu8ChipSleep == 0)
 	{
 		if(gu8ChipMode != M2M_NO_PS)
 		{
-			ret = chip_wake();
-			if(ret != M2M_SUCCESS)goto ERR1;
+			if(gu8ChipAwake)
+			{
+				/*still awake from the last access of this burst*/
+				gstrHifStats.u32WakesSaved++;
+			}
+			else
+			{
+				ret = hif_chip_wake_now();
+				if(ret != M2M_SUCCESS)goto ERR1;
+			}
 		}
 		else
 		{
@@ -194,6 +258,7 @@ sint8 hif_chip_wake(void)
 	}
 	gu8ChipSleep++;
 ERR1:
+	WDRV_MUTEX_UNLOCK(&s_hifPsLock);
 	return ret;
 }
 /*!
@@ -212,7 +277,16 @@ ERR1:
 
 void hif_set_sleep_mode(uint8 u8Pstype)
 {
+	WDRV_MUTEX_LOCK(&s_hifPsLock, OSAL_WAIT_FOREVER);
+	if((u8Pstype == M2M_NO_PS) && gu8ChipAwake)
+	{
+		/*firmware keeps the chip awake from now on*/
+		gu8ChipAwake = 0;
+		gu8SleepPending = 0;
+		gstrHifStats.u32AwakeMs += WDRV_STUB_MsecCountGet() - gu32AwakeSinceMs;
+	}
 	gu8ChipMode = u8Pstype;
+	WDRV_MUTEX_UNLOCK(&s_hifPsLock);
 }
 /*!
 @fn	\
@@ -254,6 +328,7 @@ sint8 hif_chip_sleep(void)
 {
 	sint8 ret = M2M_SUCCESS;
 
+	WDRV_MUTEX_LOCK(&s_hifPsLock, OSAL_WAIT_FOREVER);
 	if(gu8ChipSleep >= 1)
 	{
 		gu8ChipSleep--;
@@ -263,17 +338,76 @@ sint8 hif_chip_sleep(void)
 	{
 		if(gu8ChipMode != M2M_NO_PS)
 		{
-			ret = chip_sleep();
-			if(ret != M2M_SUCCESS)goto ERR1;
-
+			if(gu32SleepIdleMs != 0)
+			{
+				/*left awake, hif_chip_idle puts it to sleep once the burst is over*/
+				gu32LastAccessMs = WDRV_STUB_MsecCountGet();
+				if(!gu8SleepPending)
+				{
+					gu8SleepPending = 1;
+					WDRV_EXT_PowerSaveIdleNotify();
+				}
+			}
+			else
+			{
+				ret = hif_chip_sleep_now();
+				if(ret != M2M_SUCCESS)goto ERR1;
+			}
 		}
 		else
 		{
 		}
 	}
 ERR1:
+	WDRV_MUTEX_UNLOCK(&s_hifPsLock);
 	return ret;
 }
+
+/**
+*	@fn		NMI_API uint32 hif_chip_idle(void);
+*	@brief	Put the chip to sleep once it has been idle for the sleep idle time.
+*			Called by the driver task whenever it has no event to handle.
+*    @return		Milliseconds until the chip is due to sleep, HIF_IDLE_NONE if
+*				nothing is pending.
+*/
+
+uint32 hif_chip_idle(void)
+{
+	uint32 u32Ret = HIF_IDLE_NONE;
+	uint32 u32IdleMs;
+
+	WDRV_MUTEX_LOCK(&s_hifPsLock, OSAL_WAIT_FOREVER);
+	if(gu8ChipAwake && (gu8ChipSleep == 0) && (!gu8HifSizeDone))
+	{
+		u32IdleMs = WDRV_STUB_MsecCountGet() - gu32LastAccessMs;
+		if(u32IdleMs < gu32SleepIdleMs)
+		{
+			u32Ret = gu32SleepIdleMs - u32IdleMs;
+		}
+		else if(hif_chip_sleep_now() != M2M_SUCCESS)
+		{
+			M2M_ERR("(HIF)Fail to put the chip to sleep\n");
+		}
+	}
+	WDRV_MUTEX_UNLOCK(&s_hifPsLock);
+	return u32Ret;
+}
+
+/**
+*	@fn		NMI_API void hif_set_sleep_idle_time(uint32 u32IdleMs);
+*	@brief	Set how long the chip stays awake after the last access in power save modes.
+*	@param [in]	u32IdleMs
+*				Idle time in milliseconds, zero to sleep right after every access.
+*/
+
+void hif_set_sleep_idle_time(uint32 u32IdleMs)
+{
+	WDRV_MUTEX_LOCK(&s_hifPsLock, OSAL_WAIT_FOREVER);
+	gu32SleepIdleMs = u32IdleMs;
+	/* let the next hif_chip_idle() call apply the new time */
+	gu32LastAccessMs = WDRV_STUB_MsecCountGet();
+	WDRV_MUTEX_UNLOCK(&s_hifPsLock);
+}
 /**
 *   @fn		NMI_API sint8 hif_init(void * arg);
 *   @brief	To initialize HIF layer.
@@ -290,6 +424,11 @@ sint8 hif_init(tstrHifinitParam * pstrInitParam)
 	gu8ChipMode = M2M_NO_PS;
 
 	gu8Interrupt = 0;
+	gu8ChipAwake = 0;
+	gu8SleepPending = 0;
+	m2m_memset((uint8*)&gstrHifStats, 0, sizeof(gstrHifStats));
+	gu32StatsSinceMs = WDRV_STUB_MsecCountGet();
+	WDRV_MUTEX_CREATE(&s_hifPsLock);
 	nm_register_isr();
 
 	hif_register_cb(M2M_REQ_GRP_HIF,m2m_hif_cb);
@@ -323,6 +462,7 @@ sint8 hif_deinit(void * arg)
 #endif
 	ret = hif_chip_wake();
 	nm_deregister_isr();
+	WDRV_MUTEX_DELETE(&s_hifPsLock);
 	
 	return ret;
 }
@@ -350,17 +490,41 @@ sint8 hif_deinit(void * arg)
 
 sint8 hif_send(uint8 u8Gid,uint8 u8Opcode,uint8 *pu8CtrlBuf,uint16 u16CtrlBufSize,
 			   uint8 *pu8DataBuf,uint16 u16DataSize, uint16 u16DataOffset)
+{
+	tstrHifSeg	strSeg;
+
+	if(pu8DataBuf == NULL)
+	{
+		return hif_send_sg(u8Gid, u8Opcode, pu8CtrlBuf, u16CtrlBufSize, NULL, 0, u16DataOffset);
+	}
+	strSeg.pu8Buf	= pu8DataBuf;
+	strSeg.u16Sz	= u16DataSize;
+	return hif_send_sg(u8Gid, u8Opcode, pu8CtrlBuf, u16CtrlBufSize, &strSeg, 1, u16DataOffset);
+}
+
+/**
+*	@fn		NMI_API sint8 hif_send_sg(uint8 u8Gid,uint8 u8Opcode,uint8 *pu8CtrlBuf,uint16 u16CtrlBufSize,
+					   const tstrHifSeg *pstrSeg,uint8 u8SegCnt, uint16 u16DataOffset)
+*	@brief	Send packet with scattered data using host interface.
+*    @return		The function shall return ZERO for successful operation and a negative value otherwise. 
+*/
+
+sint8 hif_send_sg(uint8 u8Gid,uint8 u8Opcode,uint8 *pu8CtrlBuf,uint16 u16CtrlBufSize,
+			   const tstrHifSeg *pstrSeg,uint8 u8SegCnt, uint16 u16DataOffset)
 {
 	sint8		ret = M2M_ERR_SEND;
+	uint8		i;
 #ifndef INT_BASED_TX
 	int count = 0;
 #endif
 	gstrHif.u8Opcode		= u8Opcode&(~NBIT7);
 	gstrHif.u8Gid		= u8Gid;
 	gstrHif.u16Length	= M2M_HIF_HDR_OFFSET;
-	if(pu8DataBuf != NULL)
+	if(pstrSeg != NULL)
 	{
-		gstrHif.u16Length += u16DataOffset + u16DataSize;
+		gstrHif.u16Length += u16DataOffset;
+		for(i = 0; i < u8SegCnt; i++)
+			gstrHif.u16Length += pstrSeg[i].u16Sz;
 	}
 	else
 	{
@@ -391,12 +555,16 @@ sint8 hif_send(uint8 u8Gid,uint8 u8Opcode,uint8 *pu8CtrlBuf,uint16 u16CtrlBufSiz
 				if(M2M_SUCCESS != ret) goto ERR1;
 				u32CurrAddr += u16CtrlBufSize;
 			}
-			if(pu8DataBuf != NULL)
+			if(pstrSeg != NULL)
 			{
 				u32CurrAddr += (u16DataOffset - u16CtrlBufSize);
-				ret = nm_write_block(u32CurrAddr, pu8DataBuf, u16DataSize);
-				if(M2M_SUCCESS != ret) goto ERR1;
-				u32CurrAddr += u16DataSize;
+				for(i = 0; i < u8SegCnt; i++)
+				{
+					if(pstrSeg[i].u16Sz == 0) continue;
+					ret = nm_write_block(u32CurrAddr, pstrSeg[i].pu8Buf, pstrSeg[i].u16Sz);
+					if(M2M_SUCCESS != ret) goto ERR1;
+					u32CurrAddr += pstrSeg[i].u16Sz;
+				}
 			}
 			reg = dma_addr << 2;
 			reg |= (1 << 1);
@@ -406,6 +574,7 @@ sint8 hif_send(uint8 u8Gid,uint8 u8Opcode,uint8 *pu8CtrlBuf,uint16 u16CtrlBufSiz
 			ret = nm_write_reg(INTERRUPT_CORTUS_2_3000D0, 1);
 			if(M2M_SUCCESS != ret) goto ERR1;
 #endif
+			gstrHifStats.u32TxMsg++;
 		}
 		else
 		{
@@ -487,6 +656,7 @@ sint8 hif_send_optimized(uint8 u8Gid, uint8 u8Opcode, uint8* buffer, uint16 u16D
 			ret = nm_write_reg(INTERRUPT_CORTUS_2_3000D0, 1);
 			if(M2M_SUCCESS != ret) return ret;
 #endif
+			gstrHifStats.u32TxMsg++;
 		} else {
 			M2M_DBG("Failed to alloc rx size\r\n");
 			ret = M2M_ERR_MEM_ALLOC;
@@ -535,17 +705,21 @@ static sint8 hif_isr(void)
 		if(int_stat & 0x1)	/* New interrupt has been received */
 		{
 			uint16 size;
-			/*read packet size*/
-			ret = nm_read_reg_with_ret(WIFI_HOST_RCV_CTRL_0, &reg);
+			/*read packet size and address in one go*/
+			tstrNmRegOp strOps[2] = {
+				{WIFI_HOST_RCV_CTRL_0, 0, 0},
+				{WIFI_HOST_RCV_CTRL_1, 0, 0},
+			};
+			ret = nm_reg_batch(strOps, 2);
+			reg = strOps[0].u32Val;
 			nm_interrupt_ctrl(0);				
 			gu8HifSizeDone = 1;
 			size = (uint16)((reg >> 2) & 0xfff);	
 			if (size > 0) {
-				uint32 address = 0;
+				uint32 address = strOps[1].u32Val;
 				/**
 				start bus transfer
 				**/
-				ret = nm_read_reg_with_ret(WIFI_HOST_RCV_CTRL_1, &address);
 				if((M2M_SUCCESS != ret) || (size > strHifInitParam.u32RcvBuffSize))
 				{
 					M2M_ERR("(hif) WIFI_HOST_RCV_CTRL_1 bus fail or buffer is too small. packet Discarded\n");
@@ -579,6 +753,7 @@ static sint8 hif_isr(void)
 
 				if(M2M_REQ_GRP_WIFI == pstrHif->u8Gid)
 				{
+					gstrHifStats.u32RxMsg++;
 					if(pfWifiCb)
 						pfWifiCb(pstrHif->u8Opcode,pstrHif->u16Length - M2M_HIF_HDR_OFFSET, strHifInitParam.pu8RcvBuff + M2M_HIF_HDR_OFFSET);
 					
@@ -667,17 +842,19 @@ sint8 hif_handle_isr(void)
 */
 sint8 hif_receive(uint32 u32Addr, uint8 *pu8Buf, uint16 u16Sz, uint8 isDone)
 {
-	uint32 address, reg;
+	uint32 address;
 	uint16 size;
 	sint8 ret = M2M_SUCCESS;
+	tstrNmRegOp strOps[2] = {
+		{WIFI_HOST_RCV_CTRL_0, 0, 0},
+		{WIFI_HOST_RCV_CTRL_1, 0, 0},
+	};
 
-	ret = nm_read_reg_with_ret(WIFI_HOST_RCV_CTRL_0,&reg);
+	ret = nm_reg_batch(strOps, 2);
 	if(ret != M2M_SUCCESS)goto ERR1;	
 
-
-	size = (uint16)((reg >> 2) & 0xfff);	
-	ret = nm_read_reg_with_ret(WIFI_HOST_RCV_CTRL_1,&address);
-	if(ret != M2M_SUCCESS)goto ERR1;	
+	size = (uint16)((strOps[0].u32Val >> 2) & 0xfff);	
+	address = strOps[1].u32Val;
 
 	/* Receive the payload */
 	ret = nm_read_block(u32Addr, pu8Buf, u16Sz);
@@ -749,3 +926,17 @@ sint8 hif_set_receive_buffer(void* pvBuffer,uint16 u16BufferLen)
 	strHifInitParam.u32RcvBuffSize = u16BufferLen;
 	return 0;
 }
+
+void hif_get_stats(tstrHifStats *pstrStats)
+{
+	uint32 u32Now;
+
+	WDRV_MUTEX_LOCK(&s_hifPsLock, OSAL_WAIT_FOREVER);
+	u32Now = WDRV_STUB_MsecCountGet();
+	*pstrStats = gstrHifStats;
+	if(gu8ChipAwake)
+		pstrStats->u32AwakeMs += u32Now - gu32AwakeSinceMs;
+	pstrStats->u32ElapsedMs = u32Now - gu32StatsSinceMs;
+	WDRV_MUTEX_UNLOCK(&s_hifPsLock);
+	pstrStats->u32BusTrx = nm_bus_get_trx_count();
+}
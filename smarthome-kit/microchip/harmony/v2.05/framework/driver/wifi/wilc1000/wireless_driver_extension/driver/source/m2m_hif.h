@@ -61,6 +61,10 @@ MACROS
 
 #define M2M_HIF_HDR_OFFSET (sizeof(tstrHifHdr) + 4)
 
+#define HIF_IDLE_NONE	(0xFFFFFFFFul)
+/*!< Returned by hif_chip_idle when no sleep is pending.
+*/
+
 /**
 *	@struct		tstrHifHdr
 *	@brief		Structure to hold HIF header
@@ -82,6 +86,35 @@ typedef struct
     uint32   u32RcvBuffSize;/*!< Receive Buffer Size */
 }tstrHifinitParam;
 
+/**
+*	@struct		tstrHifSeg
+*	@brief		One piece of scattered packet data
+*/ 
+typedef struct 
+{
+    uint8   * pu8Buf;	/*!< Segment data */
+    uint16   u16Sz;		/*!< Segment size */
+}tstrHifSeg;
+
+/**
+*	@struct		tstrHifStats
+*	@brief		HIF traffic counters, divide u32BusTrx by the message
+*				count to get bus transactions per HIF message
+*/ 
+typedef struct 
+{
+    uint32   u32TxMsg;	/*!< Messages sent to the firmware */
+    uint32   u32RxMsg;	/*!< Messages received from the firmware */
+    uint32   u32BusTrx;	/*!< Bus transactions since initialization */
+    uint32   u32Wakes;		/*!< Times the chip was woken up */
+    uint32   u32WakesSaved;	/*!< Accesses which found the chip still awake */
+    uint32   u32WakeUsLast;	/*!< Wake up latency of the last wake up, in us */
+    uint32   u32WakeUsMax;	/*!< Highest wake up latency, in us */
+    uint32   u32WakeUsTotal;	/*!< Sum of wake up latencies, in us */
+    uint32   u32AwakeMs;	/*!< Time the host kept the chip awake, in ms */
+    uint32   u32ElapsedMs;	/*!< Time since initialization, in ms */
+}tstrHifStats;
+
 #ifdef __cplusplus
      extern "C" {
 #endif
@@ -142,6 +175,32 @@ NMI_API sint8 hif_deinit(void * arg);
 */
 NMI_API sint8 hif_send(uint8 u8Gid,uint8 u8Opcode,uint8 *pu8CtrlBuf,uint16 u16CtrlBufSize,
 					   uint8 *pu8DataBuf,uint16 u16DataSize, uint16 u16DataOffset);
+
+/**
+*	@fn		NMI_API sint8 hif_send_sg(uint8 u8Gid,uint8 u8Opcode,uint8 *pu8CtrlBuf,uint16 u16CtrlBufSize,
+					   const tstrHifSeg *pstrSeg,uint8 u8SegCnt, uint16 u16DataOffset)
+*	@brief	Send packet with scattered data using host interface.
+			Segments are written one after another into the chip DMA buffer
+			so the data does not have to be gathered in host memory first.
+
+*	@param [in]	u8Gid
+*				Group ID.
+*	@param [in]	u8Opcode
+*				Operation ID.
+*	@param [in]	pu8CtrlBuf
+*				Pointer to the Control buffer.
+*	@param [in]	u16CtrlBufSize
+				Control buffer size.
+*	@param [in]	pstrSeg
+*				Data segments in packet order, NULL if there is no data.
+*	@param [in]	u8SegCnt
+				Number of data segments.
+*	@param [in]	u16DataOffset
+				Packet Data offset.
+*    @return	The function shall return ZERO for successful operation and a negative value otherwise. 
+*/
+NMI_API sint8 hif_send_sg(uint8 u8Gid,uint8 u8Opcode,uint8 *pu8CtrlBuf,uint16 u16CtrlBufSize,
+					   const tstrHifSeg *pstrSeg,uint8 u8SegCnt, uint16 u16DataOffset);
 					   
  /**
  *	@fn sint8 hif_send_optimized(uint8 u8Gid,uint8 u8Opcode,uint8 *buffer,uint16 u16CtrlBufSize,
@@ -222,6 +281,22 @@ NMI_API sint8 hif_chip_sleep_sc(void);
 */
 
 NMI_API sint8 hif_chip_wake(void);
+/**
+*	@fn		NMI_API uint32 hif_chip_idle(void);
+*	@brief
+			Put the chip to sleep once it has been idle for the sleep idle time.
+*   @return	
+			Milliseconds until the chip is due to sleep, HIF_IDLE_NONE if nothing is pending.
+*/
+NMI_API uint32 hif_chip_idle(void);
+/**
+*	@fn		NMI_API void hif_set_sleep_idle_time(uint32 u32IdleMs);
+*	@brief
+			Set how long the chip stays awake after the last access in power save modes.
+*	@param [in]	u32IdleMs
+			Idle time in milliseconds, zero to sleep right after every access.
+*/
+NMI_API void hif_set_sleep_idle_time(uint32 u32IdleMs);
 /*!
 @fn	\
 			NMI_API void hif_set_sleep_mode(uint8 u8Pstype);
@@ -290,6 +365,15 @@ NMI_API sint8 hif_handle_isr(void);
 */
 NMI_API sint8 hif_set_receive_buffer(void* pvBuffer,uint16 u16BufferLen);
 
+/**
+*	@fn		hif_get_stats(tstrHifStats *pstrStats)
+*	@brief
+			Get HIF traffic counters.
+*	@param [out]	pstrStats
+				Pointer to the structure to fill.
+*/
+NMI_API void hif_get_stats(tstrHifStats *pstrStats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -648,6 +648,30 @@ sint8 m2m_wifi_send_ethernet_pkt(uint8* pu8Packet, uint16 u16PacketSize, uint8	u
 	}
 	return s8Ret;
 }
+
+sint8 m2m_wifi_send_ethernet_pkt_sg(const tstrHifSeg *pstrSeg, uint8 u8SegCnt, uint8 u8IfcId)
+{
+	sint8 s8Ret = -1;
+	uint16 u16PacketSize = 0;
+	uint8 i;
+
+	if (pstrSeg != NULL)
+	{
+		for (i = 0; i < u8SegCnt; i++)
+			u16PacketSize += pstrSeg[i].u16Sz;
+	}
+	if (u16PacketSize > 0)
+	{
+		tstrM2MWifiTxPacketInfo 	strTxPkt;
+
+		strTxPkt.u16PacketSize		= u16PacketSize;
+		strTxPkt.u16HeaderLength	= M2M_ETHERNET_HDR_LEN;
+		strTxPkt.u8IfcId			= u8IfcId;
+		s8Ret = hif_send_sg(M2M_REQ_GRP_WIFI, M2M_WIFI_REQ_SEND_ETHERNET_PACKET | M2M_REQ_DATA_PKT,
+		(uint8*)&strTxPkt, sizeof(tstrM2MWifiTxPacketInfo), pstrSeg, u8SegCnt,  M2M_ETHERNET_HDR_OFFSET + 2 - M2M_HIF_HDR_OFFSET);
+	}
+	return s8Ret;
+}
 /*!
 @fn          NMI_API sint8 m2m_wifi_get_otp_mac_address(uint8 *pu8MacAddr, uint8 * pu8IsValid);
 @brief       Request the MAC address stored on the OTP (one time programmable) memory of the device.
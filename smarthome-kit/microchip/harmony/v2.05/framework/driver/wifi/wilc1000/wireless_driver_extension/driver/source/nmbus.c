@@ -274,3 +274,28 @@ sint8 nm_write_block(uint32 u32Addr, uint8 *puBuf, uint32 u32Sz)
 	return s8Ret;
 }
 
+
+/**
+*	@fn		nm_reg_batch
+*	@brief	Run several register reads and writes in order, holding the bus
+*			for the whole batch
+*	@param [in, out]	pstrOps
+*				Register operations, read values are returned in u32Val
+*	@param [in]	u8Cnt
+*				Number of operations
+*	@return	M2M_SUCCESS in case of success and M2M_ERR_BUS_FAIL in case of failure
+*/
+sint8 nm_reg_batch(tstrNmRegOp *pstrOps, uint8 u8Cnt)
+{
+	return nm_spi_reg_batch(pstrOps, u8Cnt);
+}
+
+/**
+*	@fn		nm_bus_get_trx_count
+*	@brief	Number of bus transactions since the bus was initialized
+*	@return	Transaction count
+*/
+uint32 nm_bus_get_trx_count(void)
+{
+	return nm_spi_get_trx_count();
+}
@@ -43,6 +43,20 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #ifdef __cplusplus
 extern "C"{
 #endif
+
+/**
+*	@struct	tstrNmRegOp
+*	@brief	One register access of a batch, see nm_reg_batch
+*/
+typedef struct {
+	uint32	u32Addr;
+	/*!< Register address */
+	uint32	u32Val;
+	/*!< Value to write, or value read */
+	uint8	u8Write;
+	/*!< Non zero to write the register, zero to read it */
+} tstrNmRegOp;
+
 /**
 *	@fn		nm_bus_iface_init
 *	@brief	Initialize bus interface
@@ -130,6 +144,25 @@ sint8 nm_read_block(uint32 u32Addr, uint8 *puBuf, uint32 u32Sz);
 */ 
 sint8 nm_write_block(uint32 u32Addr, uint8 *puBuf, uint32 u32Sz);
 
+/**
+*	@fn		nm_reg_batch
+*	@brief	Run several register reads and writes in order, holding the bus
+*			for the whole batch
+*	@param [in, out]	pstrOps
+*				Register operations, read values are returned in u32Val
+*	@param [in]	u8Cnt
+*				Number of operations
+*	@return	ZERO in case of success and M2M_ERR_BUS_FAIL in case of failure
+*/
+sint8 nm_reg_batch(tstrNmRegOp *pstrOps, uint8 u8Cnt);
+
+/**
+*	@fn		nm_bus_get_trx_count
+*	@brief	Number of bus transactions since the bus was initialized
+*	@return	Transaction count
+*/
+uint32 nm_bus_get_trx_count(void);
+
 
 
 
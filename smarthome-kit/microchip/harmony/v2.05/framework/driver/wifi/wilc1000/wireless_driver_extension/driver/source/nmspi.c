@@ -91,6 +91,7 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #define DATA_PKT_SZ				DATA_PKT_SZ_8K
 
 static uint8 	gu8Crc_off	=   0;
+static volatile uint32	gu32TrxCnt	=	0;
 
 #if (OSAL_USE_RTOS == 1 || OSAL_USE_RTOS == 9)
 static OSAL_MUTEX_HANDLE_TYPE s_spiLock = NULL;
@@ -113,6 +114,7 @@ static sint8 nmi_spi_read(uint8 *b, uint16 sz)
     SYS_CONSOLE_PRINT("\r\n");
 #endif
 
+    gu32TrxCnt++;
     if (WDRV_STUB_SPI_In((unsigned char *const) b, sz))
         return M2M_SUCCESS;
     return M2M_SPI_FAIL;
@@ -131,11 +133,20 @@ static sint8 nmi_spi_write(uint8 *b, uint16 sz)
     SYS_CONSOLE_PRINT("\r\n");
 #endif
 
+    gu32TrxCnt++;
     if (WDRV_STUB_SPI_Out((unsigned char *const) b, sz))
         return M2M_SUCCESS;
     return M2M_SPI_FAIL;
 }
 
+static sint8 nmi_spi_write_chain(const WDRV_STUB_SPI_SEGMENT *pstrSeg, uint8 u8Cnt)
+{
+    gu32TrxCnt++;
+    if (WDRV_STUB_SPI_OutChain(pstrSeg, u8Cnt))
+        return M2M_SUCCESS;
+    return M2M_SPI_FAIL;
+}
+
 #ifndef USE_OLD_SPI_SW
 static sint8 nmi_spi_rw(uint8 *bin,uint8* bout,uint16 sz)
 {
@@ -225,6 +236,60 @@ static uint8 crc7(uint8 crc, const uint8 *buffer, uint32 len)
 #define DATA_PKT_SZ_8K			(8 * 1024)
 #define DATA_PKT_SZ				DATA_PKT_SZ_8K
 
+/**
+	Response bytes the chip sends right after a command are fetched in one
+	bus transaction. When the chip inserts wait bytes the rest is read one
+	byte at a time as before, so nothing past the response is ever clocked.
+**/
+#define SPI_RSP_CMD_SZ			2	/* command echo and state */
+#define SPI_RSP_DATA_HDR_SZ		1
+#define SPI_RSP_MAX_SZ			9
+
+/* data blocks up to this size are staged to write them in one transaction */
+#define SPI_DATA_STAGE_SZ		32
+
+typedef struct {
+	uint8	au8Buf[SPI_RSP_MAX_SZ];
+	uint8	u8Len;
+	uint8	u8Pos;
+} tstrSpiRsp;
+
+static void spi_rsp_init(tstrSpiRsp *pstrRsp)
+{
+	pstrRsp->u8Len = 0;
+	pstrRsp->u8Pos = 0;
+}
+
+static sint8 spi_rsp_prefetch(tstrSpiRsp *pstrRsp, uint8 u8Sz)
+{
+	spi_rsp_init(pstrRsp);
+	if (M2M_SUCCESS != nmi_spi_read(pstrRsp->au8Buf, u8Sz))
+		return M2M_SPI_FAIL;
+	pstrRsp->u8Len = u8Sz;
+	return M2M_SUCCESS;
+}
+
+static sint8 spi_rsp_read(tstrSpiRsp *pstrRsp, uint8 *b, uint16 sz)
+{
+	while ((sz > 0) && (pstrRsp->u8Pos < pstrRsp->u8Len)) {
+		*b++ = pstrRsp->au8Buf[pstrRsp->u8Pos++];
+		sz--;
+	}
+	if (sz == 0)
+		return M2M_SUCCESS;
+	return nmi_spi_read(b, sz);
+}
+
+/* bytes of a register read response: echo, state, data header, data, crc */
+static uint8 spi_rsp_reg_read_sz(uint8 clockless)
+{
+	uint8 sz = SPI_RSP_CMD_SZ + SPI_RSP_DATA_HDR_SZ + 4;
+
+	if ((!gu8Crc_off) && (!clockless))
+		sz += 2;
+	return sz;
+}
+
 static sint8 spi_cmd(uint8 cmd, uint32 adr, uint32 u32data, uint32 sz,uint8 clockless)
 {
 	uint8 bc[9];
@@ -323,6 +388,17 @@ static sint8 spi_cmd(uint8 cmd, uint32 adr, uint32 u32data, uint32 sz,uint8 cloc
 	return result;
 }
 
+static sint8 spi_cmd_rsp(uint8 cmd, tstrSpiRsp *pstrRsp);
+
+static void spi_reset(void)
+{
+	tstrSpiRsp strRsp;
+
+	spi_rsp_init(&strRsp);
+	spi_cmd(CMD_RESET, 0, 0, 0, 0);
+	spi_cmd_rsp(CMD_RESET, &strRsp);
+}
+
 static sint8 spi_data_rsp(uint8 cmd)
 {
 	uint8 len;
@@ -351,7 +427,7 @@ _fail_:
 	return result;
 }
 
-static sint8 spi_cmd_rsp(uint8 cmd)
+static sint8 spi_cmd_rsp(uint8 cmd, tstrSpiRsp *pstrRsp)
 {
 	uint8 rsp;
 	sint8 result = N_OK;
@@ -363,7 +439,7 @@ static sint8 spi_cmd_rsp(uint8 cmd)
 	if ((cmd == CMD_RESET) ||
 		 (cmd == CMD_TERMINATE) ||
 		 (cmd == CMD_REPEAT)) {
-		if (M2M_SUCCESS != nmi_spi_read(&rsp, 1)) {
+		if (M2M_SUCCESS != spi_rsp_read(pstrRsp, &rsp, 1)) {
 			result = N_FAIL;
 			goto _fail_;
 		}
@@ -373,7 +449,7 @@ static sint8 spi_cmd_rsp(uint8 cmd)
 	s8RetryCnt = SPI_RESP_RETRY_COUNT;
 	do
 	{
-		if (M2M_SUCCESS != nmi_spi_read(&rsp, 1)) {
+		if (M2M_SUCCESS != spi_rsp_read(pstrRsp, &rsp, 1)) {
 			M2M_ERR("[nmi spi]: Failed cmd response read, bus error...\n");
 			result = N_FAIL;
 			goto _fail_;
@@ -394,7 +470,7 @@ static sint8 spi_cmd_rsp(uint8 cmd)
 	s8RetryCnt = SPI_RESP_RETRY_COUNT;
 	do
 	{
-		if (M2M_SUCCESS != nmi_spi_read(&rsp, 1)) {
+		if (M2M_SUCCESS != spi_rsp_read(pstrRsp, &rsp, 1)) {
 			M2M_ERR("[nmi spi]: Failed cmd response read, bus error...\n");
 			result = N_FAIL;
 			goto _fail_;
@@ -779,7 +855,7 @@ _error_:
 }
 #endif
 
-static sint8 spi_data_read(uint8 *b, uint16 sz,uint8 clockless)
+static sint8 spi_data_read(uint8 *b, uint16 sz,uint8 clockless, tstrSpiRsp *pstrRsp)
 {
 	sint16 retry, ix, nbytes;
 	sint8 result = N_OK;
@@ -801,7 +877,7 @@ static sint8 spi_data_read(uint8 *b, uint16 sz,uint8 clockless)
 		**/
 		retry = SPI_RESP_RETRY_COUNT;
 		do {
-			if (M2M_SUCCESS != nmi_spi_read(&rsp, 1)) {
+			if (M2M_SUCCESS != spi_rsp_read(pstrRsp, &rsp, 1)) {
 				M2M_ERR("[nmi spi]: Failed data response read, bus error...\n");
 				result = N_FAIL;
 				break;
@@ -822,7 +898,7 @@ static sint8 spi_data_read(uint8 *b, uint16 sz,uint8 clockless)
 		/**
 			Read bytes
 		**/
-		if (M2M_SUCCESS != nmi_spi_read(&b[ix], nbytes)) {
+		if (M2M_SUCCESS != spi_rsp_read(pstrRsp, (uint8 *)&b[ix], nbytes)) {
 			M2M_ERR("[nmi spi]: Failed data block read, bus error...\n");
 			result = N_FAIL;
 			break;
@@ -833,7 +909,7 @@ static sint8 spi_data_read(uint8 *b, uint16 sz,uint8 clockless)
 			Read Crc
 			**/
 			if (!gu8Crc_off) {
-				if (M2M_SUCCESS != nmi_spi_read(crc, 2)) {
+				if (M2M_SUCCESS != spi_rsp_read(pstrRsp, crc, 2)) {
 					M2M_ERR("[nmi spi]: Failed data block crc read, bus error...\n");
 					result = N_FAIL;
 					break;
@@ -882,27 +958,46 @@ static sint8 spi_data_write(uint8 *b, uint16 sz)
 				order = 0x2;
 		}
 		cmd |= order;
-		if (M2M_SUCCESS != nmi_spi_write(&cmd, 1)) {
-			M2M_ERR("[nmi spi]: Failed data block cmd write, bus error...\n");
-			result = N_FAIL;
-			break;
-		}
 
 		/**
-			Write data
+			Small blocks (HIF header, control) go out with their
+			command and crc in one transaction
 		**/
-		if (M2M_SUCCESS != nmi_spi_write(&b[ix], nbytes)) {
-			M2M_ERR("[nmi spi]: Failed data block write, bus error...\n");
-			result = N_FAIL;
-			break;
+		if (nbytes <= SPI_DATA_STAGE_SZ) {
+			uint8 au8Stage[1 + SPI_DATA_STAGE_SZ + 2];
+			uint16 len = 1 + nbytes;
+
+			au8Stage[0] = cmd;
+			m2m_memcpy(&au8Stage[1], &b[ix], nbytes);
+			if (!gu8Crc_off) {
+				au8Stage[len++] = crc[0];
+				au8Stage[len++] = crc[1];
+			}
+			if (M2M_SUCCESS != nmi_spi_write(au8Stage, len)) {
+				M2M_ERR("[nmi spi]: Failed data block write, bus error...\n");
+				result = N_FAIL;
+				break;
+			}
+			ix += nbytes;
+			sz -= nbytes;
+			continue;
 		}
 
 		/**
-			Write Crc
+			Larger blocks are not copied, command, data and crc
+			go out as one chained transaction
 		**/
-		if (!gu8Crc_off) {
-			if (M2M_SUCCESS != nmi_spi_write(crc, 2)) {
-				M2M_ERR("[nmi spi]: Failed data block crc write, bus error...\n");
+		{
+			WDRV_STUB_SPI_SEGMENT astrSeg[3];
+
+			astrSeg[0].buf = &cmd;
+			astrSeg[0].size = 1;
+			astrSeg[1].buf = &b[ix];
+			astrSeg[1].size = nbytes;
+			astrSeg[2].buf = crc;
+			astrSeg[2].size = 2;
+			if (M2M_SUCCESS != nmi_spi_write_chain(astrSeg, gu8Crc_off ? 2 : 3)) {
+				M2M_ERR("[nmi spi]: Failed data block write, bus error...\n");
 				result = N_FAIL;
 				break;
 			}
@@ -928,14 +1023,16 @@ static sint8 spi_data_write(uint8 *b, uint16 sz)
 
 ********************************************/
 
+/* caller holds s_spiLock */
 static sint8 spi_write_reg(uint32 addr, uint32 u32data)
 {
 	uint8 retry = SPI_RETRY_COUNT;
 	sint8 result = N_OK;
 	uint8 cmd = CMD_SINGLE_WRITE;
 	uint8 clockless = 0;
-
-	WDRV_MUTEX_LOCK(&s_spiLock, OSAL_WAIT_FOREVER);
+#if defined USE_OLD_SPI_SW
+	tstrSpiRsp strRsp;
+#endif
 
 _RETRY_:
 	if (addr <= 0x10) 
@@ -967,7 +1064,11 @@ _RETRY_:
 		goto _FAIL_;
 	}
 
-	result = spi_cmd_rsp(cmd);
+	if (M2M_SUCCESS != spi_rsp_prefetch(&strRsp, SPI_RSP_CMD_SZ)) {
+		result = N_FAIL;
+		goto _FAIL_;
+	}
+	result = spi_cmd_rsp(cmd, &strRsp);
 	if (result != N_OK) {
 		M2M_ERR("[nmi spi]: Failed cmd response, write reg (%08x)...\n", (unsigned int)addr);
 		goto _FAIL_;
@@ -986,16 +1087,13 @@ _FAIL_:
 	if(result != N_OK)
 	{
 		nm_sleep(1);
-		spi_cmd(CMD_RESET, 0, 0, 0, 0);
-		spi_cmd_rsp(CMD_RESET);
+		spi_reset();
 		M2M_ERR("Reset and retry %d %lx %lx\n",retry,addr,u32data);
 		nm_sleep(1);
 		retry--;
 		if(retry) goto _RETRY_;
 	}
 
-	WDRV_MUTEX_UNLOCK(&s_spiLock);
-
 	return result;
 }
 
@@ -1004,6 +1102,9 @@ static sint8 nm_spi_write(uint32 addr, uint8 *buf, uint16 size)
 	sint8 result;
 	uint8 retry = SPI_RETRY_COUNT;
 	uint8 cmd = CMD_DMA_EXT_WRITE;
+#if defined USE_OLD_SPI_SW
+	tstrSpiRsp strRsp;
+#endif
 
 	WDRV_MUTEX_LOCK(&s_spiLock, OSAL_WAIT_FOREVER); 
 
@@ -1022,7 +1123,11 @@ _RETRY_:
 		goto _FAIL_;
 	}
 
-	result = spi_cmd_rsp(cmd);
+	if (M2M_SUCCESS != spi_rsp_prefetch(&strRsp, SPI_RSP_CMD_SZ)) {
+		result = N_FAIL;
+		goto _FAIL_;
+	}
+	result = spi_cmd_rsp(cmd, &strRsp);
 	if (result != N_OK) {
 		M2M_ERR("[nmi spi ]: Failed cmd response, write block (%08x)...\n", (unsigned int)addr);
 		goto _FAIL_;
@@ -1056,8 +1161,7 @@ _FAIL_:
 	if(result != N_OK)
 	{
 		nm_sleep(1);
-		spi_cmd(CMD_RESET, 0, 0, 0, 0);
-		spi_cmd_rsp(CMD_RESET);
+		spi_reset();
 		M2M_ERR("Reset and retry %d %lx %d\n",retry,addr,size);
 		nm_sleep(1);
 		retry--;
@@ -1069,6 +1173,7 @@ _FAIL_:
 	return result;
 }
 
+/* caller holds s_spiLock */
 static sint8 spi_read_reg(uint32 addr, uint32 *u32data)
 {
 	uint8 retry = SPI_RETRY_COUNT;
@@ -1076,8 +1181,9 @@ static sint8 spi_read_reg(uint32 addr, uint32 *u32data)
 	uint8 cmd = CMD_SINGLE_READ;
 	uint8 tmp[4];
 	uint8 clockless = 0;
-
-	WDRV_MUTEX_LOCK(&s_spiLock, OSAL_WAIT_FOREVER); 
+#if defined USE_OLD_SPI_SW
+	tstrSpiRsp strRsp;
+#endif
 
 _RETRY_:
 
@@ -1110,14 +1216,18 @@ _RETRY_:
 		goto _FAIL_;
 	}
 
-	result = spi_cmd_rsp(cmd);
+	if (M2M_SUCCESS != spi_rsp_prefetch(&strRsp, spi_rsp_reg_read_sz(clockless))) {
+		result = N_FAIL;
+		goto _FAIL_;
+	}
+	result = spi_cmd_rsp(cmd, &strRsp);
 	if (result != N_OK) {
 		M2M_ERR("[nmi spi]: Failed cmd response, read reg (%08x)...\n", (unsigned int)addr);
 		goto _FAIL_;
 	}
 
 	/* to avoid endianess issues */
-	result = spi_data_read(&tmp[0], 4, clockless);
+	result = spi_data_read(&tmp[0], 4, clockless, &strRsp);
 	if (result != N_OK) {
 		M2M_ERR("[nmi spi]: Failed data read...\n");
 		goto _FAIL_;
@@ -1140,16 +1250,13 @@ _FAIL_:
 	if(result != N_OK)
 	{
 		nm_sleep(1);
-		spi_cmd(CMD_RESET, 0, 0, 0, 0);
-		spi_cmd_rsp(CMD_RESET);
+		spi_reset();
 		M2M_ERR("Reset and retry %d %lx\n",retry,addr);
 		nm_sleep(1);
 		retry--;
 		if(retry) goto _RETRY_;
 	}
 
-    WDRV_MUTEX_UNLOCK(&s_spiLock);
-
 	return result;
 }
 
@@ -1161,6 +1268,7 @@ static sint8 nm_spi_read(uint32 addr, uint8 *buf, uint16 size)
 #if defined USE_OLD_SPI_SW
 	uint8 tmp[2];
 	uint8 single_byte_workaround = 0;
+	tstrSpiRsp strRsp;
 #endif
     WDRV_MUTEX_LOCK(&s_spiLock, OSAL_WAIT_FOREVER);
 
@@ -1182,7 +1290,11 @@ _RETRY_:
 		goto _FAIL_;
 	}
 
-	result = spi_cmd_rsp(cmd);
+	if (M2M_SUCCESS != spi_rsp_prefetch(&strRsp, SPI_RSP_CMD_SZ + SPI_RSP_DATA_HDR_SZ)) {
+		result = N_FAIL;
+		goto _FAIL_;
+	}
+	result = spi_cmd_rsp(cmd, &strRsp);
 	if (result != N_OK) {
 		M2M_ERR("[nmi spi]: Failed cmd response, read block (%08x)...\n", (unsigned int)addr);
 		goto _FAIL_;
@@ -1193,11 +1305,11 @@ _RETRY_:
 	**/
 	if (single_byte_workaround)
 	{
-		result = spi_data_read(tmp, size,0);
+		result = spi_data_read(tmp, size,0, &strRsp);
 		buf[0] = tmp[0];
 	}
 	else
-		result = spi_data_read(buf, size,0);
+		result = spi_data_read(buf, size,0, &strRsp);
 
 	if (result != N_OK) {
 		M2M_ERR("[nmi spi]: Failed block data read...\n");
@@ -1215,8 +1327,7 @@ _FAIL_:
 	if(result != N_OK)
 	{
 		nm_sleep(1);
-		spi_cmd(CMD_RESET, 0, 0, 0, 0);
-		spi_cmd_rsp(CMD_RESET);
+		spi_reset();
 		M2M_ERR("Reset and retry %d %lx %d\n",retry,addr,size);
 		nm_sleep(1);
 		retry--;
@@ -1256,8 +1367,7 @@ static void spi_init_pkt_sz(void)
 
 sint8 nm_spi_reset(void)
 {
-	spi_cmd(CMD_RESET, 0, 0, 0, 0);
-	spi_cmd_rsp(CMD_RESET);
+	spi_reset();
 	return M2M_SUCCESS;
 }
 
@@ -1283,6 +1393,9 @@ sint8 nm_spi_init(void)
 		configure protocol
 	**/
 	gu8Crc_off = 0;
+	gu32TrxCnt = 0;
+
+	WDRV_MUTEX_LOCK(&s_spiLock, OSAL_WAIT_FOREVER);
 
 	// TODO: We can remove the CRC trials if there is a definite way to reset
 	// the SPI to it's initial value.
@@ -1294,6 +1407,7 @@ sint8 nm_spi_init(void)
 		if (!spi_read_reg(NMI_SPI_PROTOCOL_CONFIG, &reg)){
 			// Reaad failed with both CRC on and off, something went bad
 			M2M_ERR( "[nmi spi]: Failed internal read protocol...\n");
+			WDRV_MUTEX_UNLOCK(&s_spiLock);
 			return 0;
 		}
 	}
@@ -1304,6 +1418,7 @@ sint8 nm_spi_init(void)
 		reg |= (0x5 << 4);
 		if (!spi_write_reg(NMI_SPI_PROTOCOL_CONFIG, reg)) {
 			M2M_ERR( "[nmi spi]: Failed internal write protocol reg...\n");
+			WDRV_MUTEX_UNLOCK(&s_spiLock);
 			return 0;
 		}
 		gu8Crc_off = 1;
@@ -1314,8 +1429,10 @@ sint8 nm_spi_init(void)
 	**/
 	if (!spi_read_reg(0x1000, &chipid)) {
 		M2M_ERR("[nmi spi]: Fail cmd read chip id...\n");
+		WDRV_MUTEX_UNLOCK(&s_spiLock);
 		return M2M_ERR_BUS_FAIL;
 	}
+	WDRV_MUTEX_UNLOCK(&s_spiLock);
 
 	M2M_DBG("[nmi spi]: chipid (%08x)\n", (unsigned int)chipid);
 	spi_init_pkt_sz();
@@ -1352,7 +1469,9 @@ uint32 nm_spi_read_reg(uint32 u32Addr)
 {
 	uint32 u32Val;
 
+	WDRV_MUTEX_LOCK(&s_spiLock, OSAL_WAIT_FOREVER);
 	spi_read_reg(u32Addr, &u32Val);
+	WDRV_MUTEX_UNLOCK(&s_spiLock);
 
 	return u32Val;
 }
@@ -1373,7 +1492,9 @@ sint8 nm_spi_read_reg_with_ret(uint32 u32Addr, uint32* pu32RetVal)
 {
 	sint8 s8Ret;
 
+	WDRV_MUTEX_LOCK(&s_spiLock, OSAL_WAIT_FOREVER);
 	s8Ret = spi_read_reg(u32Addr,pu32RetVal);
+	WDRV_MUTEX_UNLOCK(&s_spiLock);
 
 	if(N_OK == s8Ret) s8Ret = M2M_SUCCESS;
 	else s8Ret = M2M_ERR_BUS_FAIL;
@@ -1397,7 +1518,9 @@ sint8 nm_spi_write_reg(uint32 u32Addr, uint32 u32Val)
 {
 	sint8 s8Ret;
 
+	WDRV_MUTEX_LOCK(&s_spiLock, OSAL_WAIT_FOREVER);
 	s8Ret = spi_write_reg(u32Addr, u32Val);
+	WDRV_MUTEX_UNLOCK(&s_spiLock);
 
 	if(N_OK == s8Ret) s8Ret = M2M_SUCCESS;
 	else s8Ret = M2M_ERR_BUS_FAIL;
@@ -1405,6 +1528,46 @@ sint8 nm_spi_write_reg(uint32 u32Addr, uint32 u32Val)
 	return s8Ret;
 }
 
+/*
+*	@fn		nm_spi_reg_batch
+*	@brief	Run several register reads and writes in order without
+*			releasing the bus in between
+*	@param [in, out]	pstrOps
+*				Register operations, read values are returned in u32Val
+*	@param [in]	u8Cnt
+*				Number of operations
+*	@return	M2M_SUCCESS in case of success and M2M_ERR_BUS_FAIL in case of failure
+*/
+sint8 nm_spi_reg_batch(tstrNmRegOp *pstrOps, uint8 u8Cnt)
+{
+	sint8 s8Ret = N_OK;
+	uint8 i;
+
+	WDRV_MUTEX_LOCK(&s_spiLock, OSAL_WAIT_FOREVER);
+	for (i = 0; (i < u8Cnt) && (N_OK == s8Ret); i++) {
+		if (pstrOps[i].u8Write)
+			s8Ret = spi_write_reg(pstrOps[i].u32Addr, pstrOps[i].u32Val);
+		else
+			s8Ret = spi_read_reg(pstrOps[i].u32Addr, &pstrOps[i].u32Val);
+	}
+	WDRV_MUTEX_UNLOCK(&s_spiLock);
+
+	if(N_OK == s8Ret) s8Ret = M2M_SUCCESS;
+	else s8Ret = M2M_ERR_BUS_FAIL;
+
+	return s8Ret;
+}
+
+/*
+*	@fn		nm_spi_get_trx_count
+*	@brief	Number of SPI bus transactions since initialization
+*	@return	Transaction count
+*/
+uint32 nm_spi_get_trx_count(void)
+{
+	return gu32TrxCnt;
+}
+
 /*
 *	@fn		nm_spi_read_block
 *	@brief	Read block of data
@@ -39,6 +39,7 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #define _NMSPI_H_
 
 #include "driver/wifi/wilc1000/wireless_driver_extension/common/include/nm_common.h"
+#include "driver/wifi/wilc1000/wireless_driver_extension/driver/source/nmbus.h"
 
 #ifdef __cplusplus
      extern "C" {
@@ -129,6 +130,25 @@ sint8 nm_spi_read_block(uint32 u32Addr, uint8 *puBuf, uint16 u16Sz);
 */
 sint8 nm_spi_write_block(uint32 u32Addr, uint8 *puBuf, uint16 u16Sz);
 
+/**
+*	@fn		nm_spi_reg_batch
+*	@brief	Run several register reads and writes in order without
+*			releasing the bus in between
+*	@param [in, out]	pstrOps
+*				Register operations, read values are returned in u32Val
+*	@param [in]	u8Cnt
+*				Number of operations
+*	@return	ZERO in case of success and M2M_ERR_BUS_FAIL in case of failure
+*/
+sint8 nm_spi_reg_batch(tstrNmRegOp *pstrOps, uint8 u8Cnt);
+
+/**
+*	@fn		nm_spi_get_trx_count
+*	@brief	Number of SPI bus transactions since initialization
+*	@return	Transaction count
+*/
+uint32 nm_spi_get_trx_count(void);
+
 #ifdef __cplusplus
 	 }
 #endif
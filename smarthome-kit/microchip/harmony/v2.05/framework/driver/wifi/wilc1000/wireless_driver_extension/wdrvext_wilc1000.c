@@ -430,9 +430,20 @@ void WDRV_EXT_WPSResultsRead(WDRV_CONFIG *config, uint32_t *status)
 
 void WDRV_EXT_HWInterruptHandler(void)
 {
+    g_wdrvext_priv.irqStamp = WDRV_CYCLE_COUNT();
     wilc1000_isr(&g_wdrvext_priv.eventWait);
 }
 
+void WDRV_EXT_PowerSaveIdleNotify(void)
+{
+    WDRV_SEM_GIVE(&g_wdrvext_priv.eventWait);
+}
+
+uint32_t WDRV_EXT_IrqTimestampGet(void)
+{
+    return g_wdrvext_priv.irqStamp;
+}
+
 uint32_t WDRV_EXT_DataSend(uint16_t segSize, uint8_t *p_segData)
 {
     int8_t ret;
@@ -455,6 +466,60 @@ uint32_t WDRV_EXT_DataSend(uint16_t segSize, uint8_t *p_segData)
     return ret;
 }
 
+uint32_t WDRV_EXT_DataSendSegments(WDRV_TX_SEGMENT const *segs, uint8_t segCnt)
+{
+    tstrHifSeg hifSegs[WDRV_TX_MAX_SEGMENTS];
+    uint8_t i;
+    int8_t ret;
+
+    if (segCnt > WDRV_TX_MAX_SEGMENTS)
+        return WDRV_INVALID_PARAMETER;
+
+    for (i = 0; i < segCnt; i++) {
+        hifSegs[i].pu8Buf = segs[i].data;
+        hifSegs[i].u16Sz = segs[i].size;
+    }
+
+    if (gp_wdrv_cfg->networkType == WDRV_NETWORK_TYPE_SOFT_AP) 
+    {
+        ret = wilc1000_eth_data_send_sg(hifSegs, segCnt, AP_INTERFACE);
+    } else {
+        ret = wilc1000_eth_data_send_sg(hifSegs, segCnt, STATION_INTERFACE);
+    }
+	if (ret) {
+		if (ret == M2M_ERR_MEM_ALLOC) {
+			WDRV_DBG_TRACE_MESSAGE(("Memory is not available temporarily\r\n"));
+			ret = WDRV_OUT_OF_MEMORY;
+		} else {
+			WDRV_DBG_ERROR_PRINT(("Failed to send data - %d\r\n", ret));
+        	ret = WDRV_ERROR;
+		}
+	}
+    return ret;
+}
+
+void WDRV_EXT_HifStatisticsGet(WDRV_HIF_STATISTICS *stats)
+{
+    tstrHifStats hifStats;
+
+    hif_get_stats(&hifStats);
+    stats->txMessages = hifStats.u32TxMsg;
+    stats->rxMessages = hifStats.u32RxMsg;
+    stats->busTransactions = hifStats.u32BusTrx;
+    stats->wakes = hifStats.u32Wakes;
+    stats->wakesSaved = hifStats.u32WakesSaved;
+    stats->wakeLastUs = hifStats.u32WakeUsLast;
+    stats->wakeMaxUs = hifStats.u32WakeUsMax;
+    stats->wakeAvgUs = hifStats.u32Wakes ? hifStats.u32WakeUsTotal / hifStats.u32Wakes : 0;
+    stats->awakePercent = hifStats.u32ElapsedMs ?
+        (uint32_t)(((uint64_t)hifStats.u32AwakeMs * 100) / hifStats.u32ElapsedMs) : 0;
+}
+
+void WDRV_EXT_PowerSaveIdleTimeSet(uint32_t idleMs)
+{
+    hif_set_sleep_idle_time(idleMs);
+}
+
 void WDRV_EXT_ModuleUpDown(uint32_t up)
 {
     up ? wilc1000_init() : wilc1000_deinit();
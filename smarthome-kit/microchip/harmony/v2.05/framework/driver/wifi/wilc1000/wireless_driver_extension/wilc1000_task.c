@@ -240,20 +240,17 @@ static void wifi_cb(uint8_t u8MsgType, void *pvMsg)
 static void eth_cb(uint8 u8MsgType, void * pvMsg,void * pvCtrlBuf)
 {
 #ifdef ETH_RX_ZERO_COPY
-	int32_t wait = 0;
 	TCPIP_MAC_PACKET *p_packet;
 	tstrM2mIpPktBuf *frame = (tstrM2mIpPktBuf *)pvMsg;
 
-	wilc1000_eth_data_received(frame->u16BufSz, frame->header);
+	/* Take the replacement first. If the stack holds every buffer, drop this
+	 * frame and receive the next one into the same buffer, waiting here would
+	 * stall the HIF. The driver counts the drop. */
 	p_packet = wilc1000_get_rx_bufer();
-	while (p_packet == NULL) {
-		WDRV_TIME_DELAY(10);
-		p_packet = wilc1000_get_rx_bufer();
-		if (++wait > 500) {
-			/* Something went wrong */
-			WDRV_ASSERT(false, "No Rx Buffer Available");
-		}
-	}
+	if (p_packet == NULL)
+		return;
+
+	wilc1000_eth_data_received(frame->u16BufSz, frame->header);
 	m2m_wifi_set_receive_buffer(p_packet->pDSeg->segLoad, PACKET_BUFFER_SIZE);
 #else /* !ETH_RX_ZERO_COPY */
 	tstrM2MDataBufCtrl *ctrl = (tstrM2MDataBufCtrl *)pvCtrlBuf;
@@ -331,6 +328,7 @@ void wilc1000_task(void *arg)
 	while (true) 
     {
 		int8_t ret;
+		uint32_t idleMs;
         ret = m2m_wifi_handle_events(&g_wdrvext_priv.eventWait);
         if (ret != M2M_SUCCESS) {
             WDRV_ASSERT(false, "Failed to handle m2m events");
@@ -338,7 +336,17 @@ void wilc1000_task(void *arg)
         }
 		if (g_wdrvext_priv.deinit_in_progress)
 			break;
-		WDRV_TIME_DELAY(10);
+		/* ISR leaves the source disabled until the event is handled. If the
+		 * line is still asserted the interrupt is forced again on enable. */
+		WDRV_STUB_INTR_SourceEnable();
+		/* Chip is left awake after a burst, wake up in time to put it to sleep. */
+		idleMs = hif_chip_idle();
+		if (idleMs < WDRV_EXT_EVENT_TIMEOUT)
+			WDRV_SEM_TAKE(&g_wdrvext_priv.eventWait, idleMs);
+		else
+			WDRV_SEM_TAKE(&g_wdrvext_priv.eventWait, WDRV_EXT_EVENT_TIMEOUT);
+		if (g_wdrvext_priv.deinit_in_progress)
+			break;
 	}
 
 	wilc1000_task_deinit();
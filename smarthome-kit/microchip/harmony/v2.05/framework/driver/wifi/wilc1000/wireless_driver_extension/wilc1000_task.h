@@ -48,6 +48,12 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
     extern "C" {
 #endif
 
+/* Driver task sleeps on eventWait until WILC1000 raises its interrupt line.
+ * Set to a number of milliseconds to also poll the chip periodically. */
+#ifndef WDRV_EXT_EVENT_TIMEOUT
+#define WDRV_EXT_EVENT_TIMEOUT OSAL_WAIT_FOREVER
+#endif
+
 typedef void *(*GetRxBufFunc)(void);
 
 typedef struct {
@@ -58,6 +64,7 @@ typedef struct {
     OSAL_SEM_HANDLE_TYPE scanResultWait;
     OSAL_SEM_HANDLE_TYPE connInfoWait;
     OSAL_SEM_HANDLE_TYPE eventWait;
+    volatile uint32_t irqStamp;
     volatile bool deinit_in_progress;
 } WILC1000_PRIV;
 
@@ -162,9 +169,10 @@ inline void wilc1000_connect_event_received(bool connected, bool isServer, uint8
     } while (0);
 }
 
-#define wilc1000_get_rx_bufer() do { if(g_wilc1000_intf->get_rx_buf) (*g_wilc1000_intf->get_rx_buf)(); } while (0);
+#define wilc1000_get_rx_bufer() (g_wilc1000_intf->get_rx_buf ? (*g_wilc1000_intf->get_rx_buf)() : NULL)
 #define wilc1000_eth_data_send(frame, len, ifcid) m2m_wifi_send_ethernet_pkt(frame, len, ifcid)
-#define wilc1000_isr(sem) isr()
+#define wilc1000_eth_data_send_sg(segs, cnt, ifcid) m2m_wifi_send_ethernet_pkt_sg(segs, cnt, ifcid)
+#define wilc1000_isr(sem) do { isr(); WDRV_SEM_GIVE_FROM_ISR(sem); } while (0)
 
 void wilc1000_task(void *arg);
 void wilc1000_task_deinit(void);
@@ -52,6 +52,21 @@ SUBSTITUTE  GOODS,  TECHNOLOGY,  SERVICES,  OR  ANY  CLAIMS  BY  THIRD   PARTIES
 <#else>
 #define SYS_TMR_INTERRUPT_NOTIFICATION  false
 </#if>
+<#if CONFIG_SYS_TMR_CLIENT_HEAP == true>
+#define SYS_TMR_CLIENT_HEAP             true
+<#else>
+#define SYS_TMR_CLIENT_HEAP             false
+</#if>
+<#if CONFIG_SYS_TMR_ALARM_STATISTICS_ENABLE == true>
+#define SYS_TMR_ALARM_STATISTICS_ENABLE true
+<#else>
+#define SYS_TMR_ALARM_STATISTICS_ENABLE false
+</#if>
+<#if CONFIG_SYS_TMR_TICKLESS == true>
+#define SYS_TMR_TICKLESS                true
+<#else>
+#define SYS_TMR_TICKLESS                false
+</#if>
 </#if>
 <#--
 /*******************************************************************************
@@ -256,6 +256,92 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #define SYS_TMR_INTERRUPT_NOTIFICATION                         (false)
 
 
+// *****************************************************************************
+/* Client Heap configuration
+
+  Summary:
+    Keeps the timer clients ordered by their expiration time.
+
+  Description:
+    This macro selects how the client objects are processed on each system tick.
+    
+    When disabled, all the SYS_TMR_MAX_CLIENT_OBJECTS client objects are
+    examined on every system tick, so the alarm processing time grows with the
+    number of client objects.
+    
+    When enabled, the active clients are kept in a binary heap ordered by their
+    expiration time. On each system tick only the clients that expired are
+    processed and creating, reloading or deleting a client takes
+    O(log SYS_TMR_MAX_CLIENT_OBJECTS) time.
+    This is the recommended setting for a large number of client objects.
+    
+    - true  - Client heap enabled
+    - false - Client heap disabled
+
+
+  Remarks:
+    The heap uses about 16 additional bytes of RAM per client object.
+
+*/
+
+#define SYS_TMR_CLIENT_HEAP                                    (false)
+
+
+// *****************************************************************************
+/* Alarm Statistics configuration
+
+  Summary:
+    Enables the alarm processing statistics.
+
+  Description:
+    This macro enables/disables measuring the time spent processing the
+    client objects on each system tick.
+    The statistics are returned by SYS_TMR_AlarmStatisticsGet.
+
+    - true  - Alarm statistics enabled
+    - false - Alarm statistics disabled
+
+
+  Remarks:
+    None.
+
+*/
+
+#define SYS_TMR_ALARM_STATISTICS_ENABLE                        (false)
+
+
+// *****************************************************************************
+/* Tickless configuration
+
+  Summary:
+    Stretches the timer period up to the next client alarm.
+
+  Description:
+    This macro enables/disables the tickless operation of the service.
+    
+    When disabled, the underlying timer generates an alarm on every system tick.
+    
+    When enabled, the timer period is reprogrammed to end when the first
+    client expires, so the timer interrupt does not wake up the CPU
+    while there is nothing to process.
+    The period is limited by the 16 bit timer: at most 0x10000 timer counts.
+    The system tick count (SYS_TMR_TickCountGet) keeps counting
+    the elapsed ticks.
+    
+    - true  - Tickless operation enabled
+    - false - Tickless operation disabled
+
+
+  Remarks:
+    Needs SYS_TMR_CLIENT_HEAP enabled.
+    
+    SYS_TMR_NextAlarmMsGet lets a polling thread sleep until the next alarm.
+
+*/
+
+#define SYS_TMR_TICKLESS                                       (false)
+
+
 #endif // _SYS_TMR_CONFIG_TEMPLATE_H
 
 /*******************************************************************************
@@ -66,6 +66,19 @@ static SYS_TMR_OBJECT           sSysTmrObject = { 0 };
 /* Client object array */
 static SYS_TMR_CLIENT_OBJECT    sClientObjects [ SYS_TMR_MAX_CLIENT_OBJECTS ];
 
+#if (SYS_TMR_CLIENT_HEAP)
+/* Active clients, ordered by the alarm time; sClientHeap[0] expires first */
+static SYS_TMR_CLIENT_OBJECT*   sClientHeap [ SYS_TMR_MAX_CLIENT_OBJECTS ];
+
+/* Number of clients in the heap */
+static int                      sClientHeapCount;
+
+#if (SYS_TMR_INTERRUPT_NOTIFICATION)
+/* Clients marked by the ISR, waiting to be processed by the TMR thread */
+static SYS_TMR_CLIENT_OBJECT*   sClientMarked;
+#endif  // (SYS_TMR_INTERRUPT_NOTIFICATION)
+#endif  // (SYS_TMR_CLIENT_HEAP)
+
 
 // *****************************************************************************
 /* OSAL user protection 
@@ -114,7 +127,8 @@ static __inline__ void  __attribute__((always_inline))          _UserGblUnlock(v
 
 // ISR protection
 // when the timer driver delivers the notification in interrupts
-#if (SYS_TMR_INTERRUPT_NOTIFICATION)
+// or the ISR updates the timer period
+#if (SYS_TMR_INTERRUPT_NOTIFICATION) || (SYS_TMR_TICKLESS)
 // do not re-schedule while locked the timer ISR
 // this needs to be real quick
 static __inline__ bool __attribute__((always_inline)) _IsrTmrLock(OSAL_CRITSECT_DATA_TYPE* pCritStat)
@@ -129,7 +143,7 @@ static __inline__ void __attribute__((always_inline)) _IsrTmrUnlock(bool lock, O
     OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStat);
 }
 
-#else   // !(SYS_TMR_INTERRUPT_NOTIFICATION)
+#else   // !(SYS_TMR_INTERRUPT_NOTIFICATION) && !(SYS_TMR_TICKLESS)
 static __inline__ bool __attribute__((always_inline)) _IsrTmrLock(OSAL_CRITSECT_DATA_TYPE* pCritStat)
 {
     return false;
@@ -139,7 +153,7 @@ static __inline__ void __attribute__((always_inline)) _IsrTmrUnlock(bool lock, O
 {
 }
 
-#endif  // (SYS_TMR_INTERRUPT_NOTIFICATION)
+#endif  // (SYS_TMR_INTERRUPT_NOTIFICATION) || (SYS_TMR_TICKLESS)
 
 
 static __inline__ void __attribute__((always_inline)) _SYS_TMR_ClientSrvUnlock(void)
@@ -158,6 +172,282 @@ static __inline__ void __attribute__((always_inline)) _SYS_TMR_ClientDelete(SYS_
     // do other clean up here
 }
 
+#if (SYS_TMR_TICKLESS)
+// the tick count is updated only when the timer period ends
+// adds the ticks elapsed in the current period
+static uint64_t _SYS_TMR_TickCountRead(void)
+{
+    uint32_t drvCount;
+    uint64_t tick1, tick2;
+    bool     pending;
+
+    do
+    {
+        tick1 = (uint64_t)sSysTmrObject.sysTickCountHigh << 32 | sSysTmrObject.sysTickCount;
+        pending = DRV_TMR_AlarmPendingGet(sSysTmrObject.driverHandle);
+        drvCount = DRV_TMR_CounterValueGet(sSysTmrObject.driverHandle);
+        tick2 = (uint64_t)sSysTmrObject.sysTickCountHigh << 32 | sSysTmrObject.sysTickCount;
+    }while(tick1 != tick2 || pending != DRV_TMR_AlarmPendingGet(sSysTmrObject.driverHandle));
+
+    if(pending)
+    {   // the period is over but the ISR did not run yet
+        // the counter started a new period
+        tick2 += sSysTmrObject.alarmTicks;
+    }
+
+    return tick2 + drvCount / sSysTmrObject.driverPeriod;
+}
+#endif  // (SYS_TMR_TICKLESS)
+
+// client heap
+// the heap is changed by both the threads and the ISR:
+// threads need to call these functions with _IsrTmrLock() taken
+#if (SYS_TMR_CLIENT_HEAP)
+
+// time of the last processed tick, in units
+// the alarm time of the clients is relative to this moment
+static __inline__ uint32_t __attribute__((always_inline)) _SYS_TMR_UnitsNow(void)
+{
+    return sSysTmrObject.sysTickPrevCount * sSysTmrObject.sysTickUnitCount;
+}
+
+// current time, in units
+// the alarm time of the newly started clients is relative to this moment
+static __inline__ uint32_t __attribute__((always_inline)) _SYS_TMR_UnitsCurrent(void)
+{
+#if (SYS_TMR_TICKLESS)
+    return (uint32_t)_SYS_TMR_TickCountRead() * sSysTmrObject.sysTickUnitCount;
+#else
+    return _SYS_TMR_UnitsNow();
+#endif  // (SYS_TMR_TICKLESS)
+}
+
+// the unit count wraps around, compare the difference
+static __inline__ bool __attribute__((always_inline)) _SYS_TMR_DueBefore(SYS_TMR_CLIENT_OBJECT* pC1, SYS_TMR_CLIENT_OBJECT* pC2)
+{
+    return (int32_t)(pC1->tuDue - pC2->tuDue) < 0;
+}
+
+static __inline__ void __attribute__((always_inline)) _SYS_TMR_HeapPlace(SYS_TMR_CLIENT_OBJECT* pClient, int ix)
+{
+    sClientHeap[ix] = pClient;
+    pClient->heapIx = ix;
+}
+
+// moves the client at position ix up or down to its place in the heap
+static void _SYS_TMR_HeapFix(int ix)
+{
+    int parentIx, childIx;
+    SYS_TMR_CLIENT_OBJECT* pClient = sClientHeap[ix];
+
+    while(ix > 0)
+    {
+        parentIx = (ix - 1) / 2;
+        if(!_SYS_TMR_DueBefore(pClient, sClientHeap[parentIx]))
+        {
+            break;
+        }
+        _SYS_TMR_HeapPlace(sClientHeap[parentIx], ix);
+        ix = parentIx;
+    }
+
+    while((childIx = 2 * ix + 1) < sClientHeapCount)
+    {
+        if(childIx + 1 < sClientHeapCount && _SYS_TMR_DueBefore(sClientHeap[childIx + 1], sClientHeap[childIx]))
+        {
+            childIx++;
+        }
+        if(!_SYS_TMR_DueBefore(sClientHeap[childIx], pClient))
+        {
+            break;
+        }
+        _SYS_TMR_HeapPlace(sClientHeap[childIx], ix);
+        ix = childIx;
+    }
+
+    _SYS_TMR_HeapPlace(pClient, ix);
+}
+
+static void _SYS_TMR_HeapInsert(SYS_TMR_CLIENT_OBJECT* pClient)
+{
+    _SYS_TMR_HeapPlace(pClient, sClientHeapCount++);
+    _SYS_TMR_HeapFix(pClient->heapIx);
+}
+
+static void _SYS_TMR_HeapRemove(SYS_TMR_CLIENT_OBJECT* pClient)
+{
+    int ix = pClient->heapIx;
+
+    pClient->heapIx = -1;
+    if(ix != --sClientHeapCount)
+    {   // move the last client in the hole
+        _SYS_TMR_HeapPlace(sClientHeap[sClientHeapCount], ix);
+        _SYS_TMR_HeapFix(ix);
+    }
+}
+
+// starts counting a client: its alarm is a full tuRate away
+static __inline__ void __attribute__((always_inline)) _SYS_TMR_ClientEnqueue(SYS_TMR_CLIENT_OBJECT* pClient)
+{
+    pClient->tuDue = _SYS_TMR_UnitsCurrent() + pClient->tuRate;
+    _SYS_TMR_HeapInsert(pClient);
+}
+
+// removes a client from the heap or from the marked list
+static void _SYS_TMR_ClientDequeue(SYS_TMR_CLIENT_OBJECT* pClient)
+{
+    if(pClient->heapIx >= 0)
+    {
+        _SYS_TMR_HeapRemove(pClient);
+    }
+#if (SYS_TMR_INTERRUPT_NOTIFICATION)
+    else if(pClient->isrState == SYS_TMR_CLIENT_ISR_MARK_DEL || pClient->isrState == SYS_TMR_CLIENT_ISR_MARK_INACTIVE)
+    {   // may be still waiting for the TMR thread
+        SYS_TMR_CLIENT_OBJECT** ppLink;
+        for(ppLink = &sClientMarked; *ppLink != 0; ppLink = &(*ppLink)->next)
+        {
+            if(*ppLink == pClient)
+            {
+                *ppLink = pClient->next;
+                break;
+            }
+        }
+    }
+#endif  // (SYS_TMR_INTERRUPT_NOTIFICATION)
+}
+
+// detaches the expired clients from the heap
+// returns them in the order of their alarm time
+static SYS_TMR_CLIENT_OBJECT* _SYS_TMR_ExpiredDetach(int* pnExpired)
+{
+    SYS_TMR_CLIENT_OBJECT  *pClient;
+    SYS_TMR_CLIENT_OBJECT  *pExpired = 0;
+    SYS_TMR_CLIENT_OBJECT  **ppTail = &pExpired;
+    uint32_t nowUnits = _SYS_TMR_UnitsNow();
+    int nExpired = 0;
+
+    while(sClientHeapCount != 0 && (int32_t)(sClientHeap[0]->tuDue - nowUnits) <= 0)
+    {
+        pClient = sClientHeap[0];
+        _SYS_TMR_HeapRemove(pClient);
+        *ppTail = pClient;
+        ppTail = &pClient->next;
+        nExpired++;
+    }
+
+    *ppTail = 0;
+    *pnExpired = nExpired;
+    return pExpired;
+}
+
+#endif  // (SYS_TMR_CLIENT_HEAP)
+
+// tickless operation
+// the timer period spans multiple ticks and ends on the first client alarm
+#if (SYS_TMR_TICKLESS)
+// sets the length of the current timer period
+// called by the ISR or by threads with _IsrTmrLock() taken
+static void _SYS_TMR_AlarmProgram(void)
+{
+    uint32_t nTicks, minTicks, drvCount;
+    uint32_t unitCount = sSysTmrObject.sysTickUnitCount;
+    uint32_t drvPeriod = sSysTmrObject.driverPeriod;
+
+    nTicks = sSysTmrObject.alarmMaxTicks;
+    if(sClientHeapCount != 0)
+    {
+        int32_t dueUnits = (int32_t)(sClientHeap[0]->tuDue - sSysTmrObject.sysTickCount * unitCount);
+        if(dueUnits <= 0)
+        {   // waiting to be processed
+            nTicks = 1;
+        }
+        else if((uint32_t)dueUnits < nTicks * unitCount)
+        {
+            nTicks = ((uint32_t)dueUnits + unitCount - 1) / unitCount;
+        }
+    }
+
+    // the timer keeps counting; the period has to end well ahead of the counter
+    drvCount = DRV_TMR_CounterValueGet(sSysTmrObject.driverHandle);
+    minTicks = (drvCount + drvPeriod / 4) / drvPeriod + 1;
+    if(nTicks < minTicks)
+    {
+        if(minTicks >= sSysTmrObject.alarmTicks)
+        {   // the current period is about to end anyway
+            return;
+        }
+        nTicks = minTicks;
+    }
+
+    if(nTicks != sSysTmrObject.alarmTicks)
+    {   // fails if the period is already over; the ISR will take care of it
+        if(DRV_TMR_AlarmPeriodUpdate(sSysTmrObject.driverHandle, nTicks * drvPeriod - 1))
+        {
+            sSysTmrObject.alarmTicks = nTicks;
+        }
+    }
+}
+#else
+static __inline__ void __attribute__((always_inline)) _SYS_TMR_AlarmProgram(void)
+{
+}
+#endif  // (SYS_TMR_TICKLESS)
+
+// alarm processing statistics
+#if (SYS_TMR_ALARM_STATISTICS_ENABLE)
+#if defined(__PIC32C__)
+#define _SYS_TMR_StatCycles()       ((uint32_t)SYS_TMR_SystemCountGet())
+#define _SYS_TMR_StatCyclesFreq()   SYS_TMR_SystemCountFrequencyGet()
+#else
+// core timer; it runs at half the system clock
+#define _SYS_TMR_StatCycles()       _CP0_GET_COUNT()
+#define _SYS_TMR_StatCyclesFreq()   (SYS_CLK_SystemFrequencyGet() / 2)
+#endif  // defined(__PIC32C__)
+
+static __inline__ uint32_t __attribute__((always_inline)) _SYS_TMR_AlarmStatStart(void)
+{
+    return _SYS_TMR_StatCycles();
+}
+
+static void _SYS_TMR_AlarmStatUpdate(uint32_t startCycles, int nExpired)
+{
+    SYS_TMR_ALARM_STATISTICS* pStat = &sSysTmrObject.alarmStat;
+    uint32_t cycles = _SYS_TMR_StatCycles() - startCycles;
+
+    if(pStat->nAlarms == 0 || cycles < pStat->minCycles)
+    {
+        pStat->minCycles = cycles;
+    }
+    if(cycles > pStat->maxCycles)
+    {
+        pStat->maxCycles = cycles;
+    }
+    if(nExpired > pStat->maxExpired)
+    {
+        pStat->maxExpired = nExpired;
+    }
+    pStat->totCycles += cycles;
+    pStat->nAlarms++;
+    pStat->nExpired += nExpired;
+#if (SYS_TMR_CLIENT_HEAP)
+    pStat->nVisited += nExpired;
+#else
+    pStat->nVisited += SYS_TMR_MAX_CLIENT_OBJECTS;
+#endif  // (SYS_TMR_CLIENT_HEAP)
+}
+
+#else
+static __inline__ uint32_t __attribute__((always_inline)) _SYS_TMR_AlarmStatStart(void)
+{
+    return 0;
+}
+
+static __inline__ void __attribute__((always_inline)) _SYS_TMR_AlarmStatUpdate(uint32_t startCycles, int nExpired)
+{
+}
+
+#endif  // (SYS_TMR_ALARM_STATISTICS_ENABLE)
+
 static __inline__ bool __attribute__((always_inline)) _SYS_TMR_ObjectCheck(SYS_MODULE_OBJ object)
 {
     // basic sanity check we're the right object
@@ -245,6 +535,12 @@ SYS_MODULE_OBJ SYS_TMR_Initialize ( const SYS_MODULE_INDEX index,
         sysTmrInit = ( const SYS_TMR_INIT * ) init;
         // clear the client structures
         memset(sClientObjects, 0, sizeof(sClientObjects));
+#if (SYS_TMR_CLIENT_HEAP)
+        sClientHeapCount = 0;
+#if (SYS_TMR_INTERRUPT_NOTIFICATION)
+        sClientMarked = 0;
+#endif  // (SYS_TMR_INTERRUPT_NOTIFICATION)
+#endif  // (SYS_TMR_CLIENT_HEAP)
 
         /* Set the status for the state machine to advance */
         sSysTmrObject.drvIndex = sysTmrInit->drvIndex;
@@ -321,6 +617,12 @@ void SYS_TMR_Deinitialize ( SYS_MODULE_OBJ object )
             _SYS_TMR_ClientDelete(pClient);
         }
     }
+#if (SYS_TMR_CLIENT_HEAP)
+    sClientHeapCount = 0;
+#if (SYS_TMR_INTERRUPT_NOTIFICATION)
+    sClientMarked = 0;
+#endif  // (SYS_TMR_INTERRUPT_NOTIFICATION)
+#endif  // (SYS_TMR_CLIENT_HEAP)
 
     _UserGblLockDelete();
 
@@ -451,7 +753,9 @@ void SYS_TMR_Tasks ( SYS_MODULE_OBJ object )
                 sSysTmrObject.alarmReceived = false;
                 // block user access; we may delete clients
                 _UserGblLock();
-                _SYS_TMR_ProcessTmrAlarm();
+                uint32_t statStart = _SYS_TMR_AlarmStatStart();
+                int nExpired = _SYS_TMR_ProcessTmrAlarm();
+                _SYS_TMR_AlarmStatUpdate(statStart, nExpired);
                 _UserGblUnlock();
             }
 #endif  // (SYS_TMR_INTERRUPT_NOTIFICATION)
@@ -513,6 +817,11 @@ static bool _SYS_TMR_Setup(SYS_TMR_OBJECT* tmrObject)
     tmrObject->sysTickUnitCount = tickUnitCount;
     tmrObject->driverFreq = drvFreq;
     tmrObject->driverPeriod = drvPeriod;
+#if (SYS_TMR_TICKLESS)
+    // start ticking; the period is limited by the 16 bit timer
+    tmrObject->alarmTicks = 1;
+    tmrObject->alarmMaxTicks = 0x10000 / drvPeriod;
+#endif  // (SYS_TMR_TICKLESS)
 
  
     return true;
@@ -578,6 +887,15 @@ static SYS_TMR_HANDLE _SYS_TMR_ClientCreate ( uint32_t periodMs, uintptr_t conte
                 timerObj->currState = SYS_TMR_CLIENT_ACTIVE;
                 timerObj->isrState = SYS_TMR_CLIENT_ISR_ACTIVE;
                 timerObj->isrEnable = 1;
+#if (SYS_TMR_CLIENT_HEAP)
+                bool isrLock;
+                OSAL_CRITSECT_DATA_TYPE critSect;
+
+                isrLock = _IsrTmrLock(&critSect);
+                _SYS_TMR_ClientEnqueue(timerObj);
+                _SYS_TMR_AlarmProgram();
+                _IsrTmrUnlock(isrLock, critSect);
+#endif  // (SYS_TMR_CLIENT_HEAP)
                 newObj = timerObj;
             }
             // else wrong parameters
@@ -636,10 +954,90 @@ static bool _SYS_TMR_ClientParamSet(SYS_TMR_CLIENT_OBJECT *timerObj, uint32_t pe
 // delete clients that are marked for delition
 #if (SYS_TMR_INTERRUPT_NOTIFICATION)
 
+#if (SYS_TMR_CLIENT_HEAP)
+// process timer alarm, ISR context
+// only the expired clients are touched
+// returns the number of expired clients
+static int _SYS_TMR_ProcessIsrAlarm(void)
+{
+    int nExpired;
+    SYS_TMR_CLIENT_OBJECT *pClient, *pNext;
+
+    sSysTmrObject.sysTickPrevCount =  sSysTmrObject.sysTickCount;
+
+    for(pClient = _SYS_TMR_ExpiredDetach(&nExpired); pClient != 0; pClient = pNext)
+    {
+        pNext = pClient->next;
+        /* invoke callback routine */
+        if ( pClient->callback != 0 )
+        {
+            pClient->callback ( pClient->context, sSysTmrObject.sysTickCount);
+        }
+        if ( pClient->flags.periodic == true )
+        {   // reload
+            pClient->tuDue += pClient->tuRate;
+            _SYS_TMR_HeapInsert(pClient);
+            continue;
+        }
+
+        if (pClient->callback != 0 && pClient->flags.auto_del == true)
+        {   // client notified; delete this object
+            // mark it to be deleted later on
+            pClient->isrState = SYS_TMR_CLIENT_ISR_MARK_DEL;
+        }
+        else
+        {   // non delete non periodic object; store the timeout condition
+            pClient->isrState = SYS_TMR_CLIENT_ISR_MARK_INACTIVE;
+            pClient->tuCount = 0;
+        }
+        pClient->next = sClientMarked;
+        sClientMarked = pClient;
+    }
+
+    return nExpired;
+}
+
+static void _SYS_TMR_ProcessIsrClients(void)
+{
+    SYS_TMR_CLIENT_OBJECT *pClient, *pNext;
+    bool isrLock;
+    OSAL_CRITSECT_DATA_TYPE critSect;
+
+    if(sClientMarked == 0)
+    {   // nothing to do
+        return;
+    }
+
+    // the threads are locked out
+    // once detached, the clients are not accessed by the ISR
+    isrLock = _IsrTmrLock(&critSect);
+    pClient = sClientMarked;
+    sClientMarked = 0;
+    _IsrTmrUnlock(isrLock, critSect);
+
+    for( ; pClient != 0; pClient = pNext)
+    {
+        pNext = pClient->next;
+        if ( pClient->isrState == SYS_TMR_CLIENT_ISR_MARK_DEL)
+        {
+            _SYS_TMR_ClientDelete(pClient);
+        }
+        else
+        {
+            pClient->isrEnable = 0;
+            pClient->isrState = SYS_TMR_CLIENT_ISR_IDLE;
+            pClient->currState = SYS_TMR_CLIENT_INACTIVE;
+        }
+    }
+}
+
+#else
 // process timer alarm, ISR context
-static void _SYS_TMR_ProcessIsrAlarm(void)
+// returns the number of expired clients
+static int _SYS_TMR_ProcessIsrAlarm(void)
 {
     int ix;
+    int nExpired = 0;
     SYS_TMR_CLIENT_OBJECT* pClient;
 
     // get number of elapsed counts
@@ -655,6 +1053,7 @@ static void _SYS_TMR_ProcessIsrAlarm(void)
         {
             if( (pClient->tuCount -= nUnitsElapsed) <= 0 )
             {   // timeout
+                nExpired++;
                 /* invoke callback routine */
                 if ( pClient->callback != 0 )
                 {
@@ -678,6 +1077,7 @@ static void _SYS_TMR_ProcessIsrAlarm(void)
         }
     }
 
+    return nExpired;
 }
 
 
@@ -708,14 +1108,64 @@ static void _SYS_TMR_ProcessIsrClients(void)
 
     _IsrTmrUnlock(isrLock, critSect);
 }
+#endif  // (SYS_TMR_CLIENT_HEAP)
 
 #else // !(SYS_TMR_INTERRUPT_NOTIFICATION)
 
+#if (SYS_TMR_CLIENT_HEAP)
 // process timer alarm
 // occurs within TMR thread
-static void _SYS_TMR_ProcessTmrAlarm(void)
+// only the expired clients are touched
+// returns the number of expired clients
+static int _SYS_TMR_ProcessTmrAlarm(void)
+{
+    int nExpired;
+    SYS_TMR_CLIENT_OBJECT *pClient, *pNext;
+    bool isrLock;
+    OSAL_CRITSECT_DATA_TYPE critSect;
+
+    sSysTmrObject.sysTickPrevCount =  sSysTmrObject.sysTickCount;
+
+    for(pClient = _SYS_TMR_ExpiredDetach(&nExpired); pClient != 0; pClient = pNext)
+    {
+        pNext = pClient->next;
+        /* invoke callback routine */
+        if ( pClient->callback != 0 )
+        {
+            pClient->callback ( pClient->context, sSysTmrObject.sysTickCount);
+        }
+        if ( pClient->flags.periodic == true )
+        {   // reload
+            pClient->tuDue += pClient->tuRate;
+            _SYS_TMR_HeapInsert(pClient);
+        }
+        else if (pClient->callback != 0 && pClient->flags.auto_del == true)
+        {   // client notified; delete this object
+            _SYS_TMR_ClientDelete(pClient);
+        }
+        else
+        {   // non delete non periodic object; store the timeout condition
+            pClient->currState = SYS_TMR_CLIENT_INACTIVE;
+            pClient->tuCount = 0;
+        }
+    }
+
+    // the ISR only counts the ticks; set the next period here
+    isrLock = _IsrTmrLock(&critSect);
+    _SYS_TMR_AlarmProgram();
+    _IsrTmrUnlock(isrLock, critSect);
+
+    return nExpired;
+}
+
+#else
+// process timer alarm
+// occurs within TMR thread
+// returns the number of expired clients
+static int _SYS_TMR_ProcessTmrAlarm(void)
 {
     int ix;
+    int nExpired = 0;
     SYS_TMR_CLIENT_OBJECT* pClient;
 
     // get number of elapsed counts
@@ -731,6 +1181,7 @@ static void _SYS_TMR_ProcessTmrAlarm(void)
         {
             if( (pClient->tuCount -= nUnitsElapsed) <= 0 )
             {   // timeout
+                nExpired++;
                 /* invoke callback routine */
                 if ( pClient->callback != 0 )
                 {
@@ -753,7 +1204,9 @@ static void _SYS_TMR_ProcessTmrAlarm(void)
         }
     }
 
+    return nExpired;
 }
+#endif  // (SYS_TMR_CLIENT_HEAP)
 
 #endif  // (SYS_TMR_INTERRUPT_NOTIFICATION)
 
@@ -775,7 +1228,17 @@ void SYS_TMR_ObjectDelete ( SYS_TMR_HANDLE handle)
 
     if(timerObj)
     {   // valid client; lock other users access   
+#if (SYS_TMR_CLIENT_HEAP)
+        bool isrLock;
+        OSAL_CRITSECT_DATA_TYPE critSect;
+
+        isrLock = _IsrTmrLock(&critSect);
+        _SYS_TMR_ClientDequeue(timerObj);
         _SYS_TMR_ClientDelete(timerObj);
+        _IsrTmrUnlock(isrLock, critSect);
+#else
+        _SYS_TMR_ClientDelete(timerObj);
+#endif  // (SYS_TMR_CLIENT_HEAP)
         _SYS_TMR_ClientSrvUnlock();
     }
 
@@ -793,6 +1256,32 @@ bool SYS_TMR_ObjectReload ( SYS_TMR_HANDLE handle, uint32_t periodMs, uintptr_t
 
     if(timerObj)
     {   
+#if (SYS_TMR_CLIENT_HEAP)
+        bool isrLock;
+        OSAL_CRITSECT_DATA_TYPE critSect;
+
+        isrLock = _IsrTmrLock(&critSect);
+        bool res = _SYS_TMR_ClientParamSet(timerObj, periodMs, context, callback);
+
+        if(timerObj->isrState == SYS_TMR_CLIENT_ISR_MARK_DEL)
+        {   // client is too late
+            _SYS_TMR_ClientDequeue(timerObj);
+            _SYS_TMR_ClientDelete(timerObj);
+            res = false;
+        }
+        else if(res)
+        {   // restart counting
+            _SYS_TMR_ClientDequeue(timerObj);
+            timerObj->currState = SYS_TMR_CLIENT_ACTIVE;
+            timerObj->isrState = SYS_TMR_CLIENT_ISR_ACTIVE;
+            timerObj->isrEnable = 1;
+            _SYS_TMR_ClientEnqueue(timerObj);
+            _SYS_TMR_AlarmProgram();
+        }
+        _IsrTmrUnlock(isrLock, critSect);
+        _SYS_TMR_ClientSrvUnlock();
+        return res;
+#else
         timerObj->isrEnable = 0;
         bool res = _SYS_TMR_ClientParamSet(timerObj, periodMs, context, callback);
 
@@ -806,6 +1295,7 @@ bool SYS_TMR_ObjectReload ( SYS_TMR_HANDLE handle, uint32_t periodMs, uintptr_t
         timerObj->isrEnable = 1;
         _SYS_TMR_ClientSrvUnlock();
         return res;
+#endif  // (SYS_TMR_CLIENT_HEAP)
     }
 
     return false;
@@ -825,11 +1315,34 @@ uint32_t SYS_TMR_ObjectCountGet ( SYS_TMR_HANDLE handle, uint32_t* pRateMs)
             *pRateMs = (timerObj->tuRate * 1000) / SYS_TMR_UNIT_RESOLUTION;
         }
 
+#if (SYS_TMR_CLIENT_HEAP)
+        bool isrLock;
+        OSAL_CRITSECT_DATA_TYPE critSect;
+
+        isrLock = _IsrTmrLock(&critSect);
+        if(timerObj->heapIx >= 0)
+        {   // counting clients are in the heap
+            int32_t dueUnits = (int32_t)(timerObj->tuDue - _SYS_TMR_UnitsCurrent());
+            // an expired client waiting to be processed is still counting
+            obCount = dueUnits > 0 ? dueUnits : 1;
+        }
+        else
+        {
+            obCount = timerObj->tuCount;
+        }
+        if(obCount == 0 && timerObj->flags.auto_del != 0)
+        {   // timed out, delete it
+            _SYS_TMR_ClientDequeue(timerObj);
+            _SYS_TMR_ClientDelete(timerObj);
+        }
+        _IsrTmrUnlock(isrLock, critSect);
+#else
         obCount = timerObj->tuCount;
         if(obCount == 0 && timerObj->flags.auto_del != 0)
         {   // timed out, delete it
             _SYS_TMR_ClientDelete(timerObj);
         }
+#endif  // (SYS_TMR_CLIENT_HEAP)
         _SYS_TMR_ClientSrvUnlock();
         // round up so that don't return 0 if there are still counts
         return (obCount * 1000 + SYS_TMR_UNIT_RESOLUTION - 1) / SYS_TMR_UNIT_RESOLUTION; 
@@ -894,6 +1407,11 @@ static void _SYS_TMR_AlarmCallback ( uintptr_t context, uint32_t alarmCount )
 
     SYS_TMR_OBJECT* pTmrObj = (SYS_TMR_OBJECT*)context;
 
+#if (SYS_TMR_TICKLESS)
+    // the driver counts periods; the period that ended was alarmTicks long
+    alarmCount = pTmrObj->sysTickCount + pTmrObj->alarmTicks;
+#endif  // (SYS_TMR_TICKLESS)
+
     if(alarmCount < pTmrObj->sysTickCount)
     {   // overflow
         pTmrObj->sysTickCountHigh++;
@@ -902,7 +1420,11 @@ static void _SYS_TMR_AlarmCallback ( uintptr_t context, uint32_t alarmCount )
     pTmrObj->sysTickCount = alarmCount;
 
 #if (SYS_TMR_INTERRUPT_NOTIFICATION)
-    _SYS_TMR_ProcessIsrAlarm();
+    uint32_t statStart = _SYS_TMR_AlarmStatStart();
+    int nExpired = _SYS_TMR_ProcessIsrAlarm();
+    _SYS_TMR_AlarmStatUpdate(statStart, nExpired);
+    // a new period just started
+    _SYS_TMR_AlarmProgram();
 #else
     pTmrObj->alarmReceived = true;
 #endif
@@ -915,7 +1437,11 @@ static void _SYS_TMR_AlarmCallback ( uintptr_t context, uint32_t alarmCount )
 // they are info only anyway
 uint32_t SYS_TMR_TickCountGet ( void )
 {
+#if (SYS_TMR_TICKLESS)
+    return _SYS_TMR_ReadyCheck() ? (uint32_t)_SYS_TMR_TickCountRead() : 0;
+#else
     return _SYS_TMR_ReadyCheck() ? sSysTmrObject.sysTickCount : 0;
+#endif  // (SYS_TMR_TICKLESS)
 }
 
 uint64_t SYS_TMR_TickCountGetLong ( void )
@@ -925,6 +1451,9 @@ uint64_t SYS_TMR_TickCountGetLong ( void )
         return 0;
     }
     
+#if (SYS_TMR_TICKLESS)
+    return _SYS_TMR_TickCountRead();
+#else
     uint64_t  tick1, tick2;
 
     do
@@ -935,6 +1464,7 @@ uint64_t SYS_TMR_TickCountGetLong ( void )
     while(tick1 != tick2);
 
     return tick2;
+#endif  // (SYS_TMR_TICKLESS)
 }
 
 uint32_t SYS_TMR_TickCounterFrequencyGet ( void )
@@ -947,6 +1477,98 @@ uint32_t SYS_TMR_SystemCountFrequencyGet( void )
     return _SYS_TMR_ReadyCheck() ? sSysTmrObject.driverFreq : 0;
 }
 
+bool SYS_TMR_AlarmStatisticsGet( SYS_TMR_ALARM_STATISTICS* pStat, bool clear )
+{
+#if (SYS_TMR_ALARM_STATISTICS_ENABLE)
+    if(!_SYS_TMR_ReadyCheck())
+    {
+        return false;
+    }
+
+    bool isrLock;
+    OSAL_CRITSECT_DATA_TYPE critSect;
+    uint32_t cyclesFreq = _SYS_TMR_StatCyclesFreq();
+
+    // the statistics are updated by the TMR thread or ISR
+    _UserGblLock();
+    isrLock = _IsrTmrLock(&critSect);
+    if(pStat)
+    {
+        *pStat = sSysTmrObject.alarmStat;
+        pStat->cyclesFreq = cyclesFreq;
+    }
+    if(clear)
+    {
+        memset(&sSysTmrObject.alarmStat, 0, sizeof(sSysTmrObject.alarmStat));
+    }
+    _IsrTmrUnlock(isrLock, critSect);
+    _UserGblUnlock();
+
+    return true;
+#else
+    return false;
+#endif  // (SYS_TMR_ALARM_STATISTICS_ENABLE)
+}
+
+
+uint32_t SYS_TMR_NextAlarmMsGet( void )
+{
+    if(!_SYS_TMR_ReadyCheck())
+    {
+        return 0xffffffff;
+    }
+
+#if !(SYS_TMR_INTERRUPT_NOTIFICATION)
+    if(sSysTmrObject.alarmReceived)
+    {   // waiting for the TMR thread
+        return 0;
+    }
+#endif  // !(SYS_TMR_INTERRUPT_NOTIFICATION)
+
+    int32_t dueUnits = 0;
+    bool    active = false;
+
+    _UserGblLock();
+#if (SYS_TMR_CLIENT_HEAP)
+    bool isrLock;
+    OSAL_CRITSECT_DATA_TYPE critSect;
+
+    isrLock = _IsrTmrLock(&critSect);
+    if(sClientHeapCount != 0)
+    {
+        dueUnits = (int32_t)(sClientHeap[0]->tuDue - _SYS_TMR_UnitsCurrent());
+        active = true;
+    }
+    _IsrTmrUnlock(isrLock, critSect);
+#else
+    int ix;
+    SYS_TMR_CLIENT_OBJECT* pClient = sClientObjects + 0;
+    for ( ix = 0; ix < sizeof(sClientObjects)/sizeof(*sClientObjects); ix++, pClient++ )
+    {
+#if (SYS_TMR_INTERRUPT_NOTIFICATION)
+        if ( pClient->isrEnable && pClient->isrState == SYS_TMR_CLIENT_ISR_ACTIVE)
+#else
+        if ( pClient->currState == SYS_TMR_CLIENT_ACTIVE)
+#endif  // (SYS_TMR_INTERRUPT_NOTIFICATION)
+        {
+            if(!active || pClient->tuCount < dueUnits)
+            {
+                dueUnits = pClient->tuCount;
+                active = true;
+            }
+        }
+    }
+#endif  // (SYS_TMR_CLIENT_HEAP)
+    _UserGblUnlock();
+
+    if(!active)
+    {
+        return 0xffffffff;
+    }
+
+    // round up so that don't return 0 if there are still counts
+    return dueUnits <= 0 ? 0 : ((uint64_t)dueUnits * 1000 + SYS_TMR_UNIT_RESOLUTION - 1) / SYS_TMR_UNIT_RESOLUTION;
+}
 
 // for this one we need to access the driver
 // we need to make sure the object is valid
@@ -59,6 +59,33 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 #include "system/common/sys_common.h"
 #include "osal/osal.h"
 
+// *****************************************************************************
+// *****************************************************************************
+// Section: Configuration Defaults
+// *****************************************************************************
+// *****************************************************************************
+
+// keep the active clients in a heap ordered by expiration time
+// instead of scanning all the client objects on every tick
+#ifndef SYS_TMR_CLIENT_HEAP
+#define SYS_TMR_CLIENT_HEAP                 false
+#endif
+
+// measure the alarm processing time
+#ifndef SYS_TMR_ALARM_STATISTICS_ENABLE
+#define SYS_TMR_ALARM_STATISTICS_ENABLE     false
+#endif
+
+// stretch the timer period up to the next client alarm
+// instead of an alarm on every tick
+#ifndef SYS_TMR_TICKLESS
+#define SYS_TMR_TICKLESS                    false
+#endif
+
+#if (SYS_TMR_TICKLESS) && !(SYS_TMR_CLIENT_HEAP)
+#error "SYS_TMR_TICKLESS needs SYS_TMR_CLIENT_HEAP"
+#endif
+
 
 // *****************************************************************************
 // *****************************************************************************
@@ -112,11 +139,24 @@ typedef struct
     /* Underlying timer driver divider period */
     uint32_t                            driverPeriod;
 
+#if (SYS_TMR_TICKLESS)
+    /* Number of ticks in the current timer period */
+    volatile uint32_t                   alarmTicks;
+
+    /* Maximum number of ticks in a timer period */
+    uint32_t                            alarmMaxTicks;
+#endif  // (SYS_TMR_TICKLESS)
+
     /* Do not start polling before we receive the first alarm */
     bool                                alarmReceived;
 
     /* user threads protection semaphore */
     OSAL_SEM_HANDLE_TYPE                userSem;
+
+#if (SYS_TMR_ALARM_STATISTICS_ENABLE)
+    /* alarm processing statistics */
+    SYS_TMR_ALARM_STATISTICS            alarmStat;
+#endif  // (SYS_TMR_ALARM_STATISTICS_ENABLE)
     
 } SYS_TMR_OBJECT;
 
@@ -184,7 +224,7 @@ typedef enum
     - units -> ms;          ms    = (units x 1000) / (F x UC) -> (units x 1000)/U;
 */
 
-typedef struct
+typedef struct _tag_SYS_TMR_CLIENT_OBJECT
 {
     /* object is in use, busy, etc. SYS_TMR_CLIENT_STATE value */
     /* written by the threads, read by threads, ISR */
@@ -219,6 +259,17 @@ typedef struct
     /* Event callback */
     SYS_TMR_CALLBACK                    callback;
 
+#if (SYS_TMR_CLIENT_HEAP)
+    /* absolute time of the alarm, in units; valid while in the heap */
+    uint32_t                            tuDue;
+
+    /* position in the client heap; < 0 if not in the heap */
+    int16_t                             heapIx;
+
+    /* link in the expired and marked clients lists */
+    struct _tag_SYS_TMR_CLIENT_OBJECT*  next;
+#endif  // (SYS_TMR_CLIENT_HEAP)
+
 } SYS_TMR_CLIENT_OBJECT;
 
 
@@ -234,10 +285,10 @@ static bool _SYS_TMR_ClientParamSet(SYS_TMR_CLIENT_OBJECT *timerObj, uint32_t pe
 static bool _SYS_TMR_Setup(SYS_TMR_OBJECT* tmrObject);
 
 #if (SYS_TMR_INTERRUPT_NOTIFICATION)
-static void _SYS_TMR_ProcessIsrAlarm(void);
+static int _SYS_TMR_ProcessIsrAlarm(void);
 static void _SYS_TMR_ProcessIsrClients(void);
 #else   // ! (SYS_TMR_INTERRUPT_NOTIFICATION)
-static void _SYS_TMR_ProcessTmrAlarm(void);
+static int _SYS_TMR_ProcessTmrAlarm(void);
 #endif
 
 
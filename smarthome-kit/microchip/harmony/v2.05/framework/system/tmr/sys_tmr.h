@@ -203,6 +203,52 @@ typedef struct
 } SYS_TMR_INIT;
 
 
+// *****************************************************************************
+/* SYS TMR Alarm Statistics
+
+  Summary:
+    Run time statistics of the system timer alarm processing.
+
+  Description:
+    This structure reports how much time the system timer spends processing
+    the client objects each time a system tick alarm is received.
+    With SYS_TMR_INTERRUPT_NOTIFICATION enabled this is the time spent in the
+    timer interrupt, otherwise the time spent in SYS_TMR_Tasks.
+
+  Remarks:
+    The cycle counts are measured with the counter returned in cyclesFreq.
+    Available only when SYS_TMR_ALARM_STATISTICS_ENABLE is true.
+*/
+
+typedef struct
+{
+    /* number of processed alarms */
+    uint32_t                        nAlarms;
+
+    /* number of client time-outs */
+    uint32_t                        nExpired;
+
+    /* most client time-outs processed in a single alarm */
+    uint32_t                        maxExpired;
+
+    /* number of client objects examined */
+    uint32_t                        nVisited;
+
+    /* shortest alarm processing time, cycles */
+    uint32_t                        minCycles;
+
+    /* longest alarm processing time, cycles */
+    uint32_t                        maxCycles;
+
+    /* total alarm processing time, cycles */
+    uint64_t                        totCycles;
+
+    /* frequency of the cycles counter, Hz */
+    uint32_t                        cyclesFreq;
+
+} SYS_TMR_ALARM_STATISTICS;
+
+
 // *****************************************************************************
 // *****************************************************************************
 // Section: SYS TMR Module Initialization Routines
@@ -1078,6 +1124,88 @@ uint64_t SYS_TMR_SystemCountGet( void );
 
 uint32_t SYS_TMR_SystemCountFrequencyGet( void );
 
+// *****************************************************************************
+/* Function:
+    bool SYS_TMR_AlarmStatisticsGet( SYS_TMR_ALARM_STATISTICS* pStat, bool clear )
+
+  Summary:
+    Provides the alarm processing statistics.
+
+  Description:
+    This function returns the time spent by the system timer service
+    processing the client objects on each system tick alarm,
+    together with the number of client objects examined and expired.
+
+  Precondition:
+    The SYS_TMR_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    pStat   - address to store the current statistics; could be 0
+    clear   - if true, the statistics are reset after being read
+
+  Returns:
+    true if the statistics are available and were returned,
+    false otherwise.
+
+  Example:
+    <code>
+    SYS_TMR_ALARM_STATISTICS tmrStat;
+    if(SYS_TMR_AlarmStatisticsGet (&tmrStat, false) && tmrStat.nAlarms != 0)
+    {
+        uint32_t avgCycles = tmrStat.totCycles / tmrStat.nAlarms;
+    }
+    </code>
+
+  Remarks:
+    Available only when SYS_TMR_ALARM_STATISTICS_ENABLE is true.
+*/
+
+bool SYS_TMR_AlarmStatisticsGet( SYS_TMR_ALARM_STATISTICS* pStat, bool clear );
+
+// *****************************************************************************
+/* Function:
+    uint32_t SYS_TMR_NextAlarmMsGet( void )
+
+  Summary:
+    Provides the time left until the next client alarm.
+
+  Description:
+    This function returns the number of milliseconds until the first
+    active client object expires.
+    A thread that polls the system timer service (SYS_TMR_Tasks)
+    can use it to sleep until there is something to process.
+
+  Precondition:
+    The SYS_TMR_Initialize function should have been called before calling this
+    function.
+
+  Parameters:
+    None.
+
+  Returns:
+    - the number of milliseconds until the next client alarm, rounded up
+    - 0 if there are expired clients waiting to be processed
+    - 0xffffffff if there are no active clients or the service is not ready
+
+  Example:
+    <code>
+    uint32_t waitMs = SYS_TMR_NextAlarmMsGet();
+    if(waitMs > 100)
+    {
+        waitMs = 100;
+    }
+    vTaskDelay(waitMs / portTICK_PERIOD_MS);
+    SYS_TMR_Tasks(sysObj.sysTmr);
+    </code>
+
+  Remarks:
+    When SYS_TMR_CLIENT_HEAP is false the result has a one system tick
+    resolution.
+*/
+
+uint32_t SYS_TMR_NextAlarmMsGet( void );
+
 //DOM-IGNORE-BEGIN
 #ifdef __cplusplus
 }
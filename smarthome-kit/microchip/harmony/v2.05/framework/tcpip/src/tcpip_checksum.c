@@ -0,0 +1,218 @@
+/*******************************************************************************
+  Checksum Helper Functions for Microchip tcpip
+
+  Summary:
+    IP checksum helpers
+    
+  Description:
+    Internet checksum of a buffer and of a segmented packet, kept apart from
+    the helpers library so they build and can be tested on their own
+*******************************************************************************/
+
+/*******************************************************************************
+File Name:  tcpip_checksum.c
+Copyright  2012 released Microchip Technology Inc.  All rights
+reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+*******************************************************************************/
+
+#define TCPIP_THIS_MODULE_ID    TCPIP_MODULE_MANAGER
+
+#include "tcpip/src/tcpip_private.h"
+
+/*****************************************************************************
+  Function:
+	uint16_t TCPIP_Helper_CalcIPChecksum(uint8_t* buffer, uint16_t count, uint16_t seed)
+
+  Summary:
+	Calculates an IP checksum value.
+
+  Description:
+	This function calculates an IP checksum over an array of input data.  The
+	checksum is the 16-bit one's complement of one's complement sum of all 
+	words in the data (with zero-padding if an odd number of bytes are 
+	summed).  This checksum is defined in RFC 793.
+
+  Precondition:
+	None
+
+  Parameters:
+	buffer - pointer to the data to be checksummed
+	count  - number of bytes to be checksummed
+    seed   - start seed
+
+  Returns:
+	The calculated checksum.
+	
+  Note:
+	The data is summed 32 bits at a time into a 64-bit accumulator,
+    4 words per loop iteration, so the carries are folded only once at the end.
+    A buffer starting on an odd address is summed as if preceded by a 0 byte
+    and the result is byte swapped, as RFC 1071 allows.
+    The seed is added after the swap so it is not affected by the alignment.
+
+    Define TCPIP_HELPER_CHECKSUM_ASM to use a platform assembly routine instead.
+  ***************************************************************************/
+#if !defined(TCPIP_HELPER_CHECKSUM_ASM)
+uint16_t TCPIP_Helper_CalcIPChecksum(uint8_t* buffer, uint16_t count, uint16_t seed)
+{
+    const uint32_t* pW;
+    uint64_t sum64;
+    uint32_t sum;
+    uint16_t nWords;
+    bool     oddStart;
+
+    sum64 = 0;
+    oddStart = ((uintptr_t)buffer & 0x1) != 0;
+    if(oddStart && count != 0)
+    {   // 1st byte goes into the high lane of the word starting at buffer - 1
+        sum64 += (uint32_t)(*buffer++) << 8;
+        count--;
+    }
+
+    if(((uintptr_t)buffer & 0x2) != 0 && count >= 2)
+    {   // align to a 32 bit boundary
+        sum64 += *(uint16_t*)buffer;
+        buffer += 2;
+        count -= 2;
+    }
+
+    pW = (const uint32_t*)buffer;
+    nWords = count >> 2;
+
+    while(nWords >= 4)
+    {
+        sum64 += pW[0];
+        sum64 += pW[1];
+        sum64 += pW[2];
+        sum64 += pW[3];
+        pW += 4;
+        nWords -= 4;
+    }
+
+    while(nWords--)
+    {
+        sum64 += *pW++;
+    }
+
+    buffer = (uint8_t*)pW;
+    if((count & 0x2) != 0)
+    {
+        sum64 += *(uint16_t*)buffer;
+        buffer += 2;
+    }
+
+    // Add in the sum of the remaining byte, if present
+    if((count & 0x1) != 0)
+    {
+        sum64 += *buffer;
+    }
+
+    // end-around carry 64 -> 32; twice in case the 1st one carried out
+    sum64 = (sum64 & 0xffffffff) + (sum64 >> 32);
+    sum = (uint32_t)sum64 + (uint32_t)(sum64 >> 32);
+
+    sum = TCPIP_Helper_ChecksumFold(sum);
+    if(oddStart)
+    {
+        sum = TCPIP_Helper_htons((uint16_t)sum);
+    }
+
+    // Return the resulting checksum
+    return ~TCPIP_Helper_ChecksumFold(sum + seed);
+}
+#endif  // !defined(TCPIP_HELPER_CHECKSUM_ASM)
+
+// calculates the IP checksum for a packet with multiple segments
+// a segment starting at an odd offset within the checksummed data
+// has its partial sum byte swapped before being added in
+uint16_t TCPIP_Helper_PacketChecksum(TCPIP_MAC_PACKET* pPkt, uint8_t* startAdd, uint16_t len, uint16_t seed)
+{
+    TCPIP_MAC_DATA_SEGMENT  *pSeg;
+    uint8_t* pChkBuff;
+    uint16_t checkLength, chkBytes, nBytes;
+    uint16_t segChkSum;
+    uint32_t calcChkSum;
+
+    if(len == 0)
+    {
+        return seed;
+    }
+
+    calcChkSum = seed;
+    checkLength = len;
+    nBytes = 0;
+    pChkBuff = startAdd; 
+    pSeg = TCPIP_PKT_DataSegmentGet(pPkt, startAdd, true);
+
+    while(pSeg != 0 && checkLength != 0)
+    {
+        chkBytes = (pSeg->segLoad + pSeg->segSize) - pChkBuff;
+
+        if(chkBytes > pSeg->segLen)
+        {
+            chkBytes = pSeg->segLen;
+        } 
+
+        if(chkBytes > checkLength)
+        {
+            chkBytes = checkLength;
+        } 
+
+        if(chkBytes)
+        {
+            segChkSum = ~TCPIP_Helper_CalcIPChecksum(pChkBuff, chkBytes, 0);
+            if((nBytes & 0x1) != 0)
+            {
+                segChkSum = TCPIP_Helper_htons(segChkSum);
+            }
+
+            checkLength -= chkBytes;
+            nBytes += chkBytes;
+            calcChkSum += segChkSum;
+        }
+        if((pSeg = pSeg->next) != 0)
+        {
+            pChkBuff = pSeg->segLoad;
+        }
+#if (TCPIP_IPV4_FRAGMENTATION != 0)
+        else if((pPkt = pPkt->pkt_next) != 0)
+        {
+            pSeg = pPkt->pDSeg;
+            pChkBuff = pPkt->pNetLayer;
+        }
+#endif  // (TCPIP_IPV4_FRAGMENTATION != 0)
+    }
+
+    return ~TCPIP_Helper_ChecksumFold(calcChkSum);
+}
+
+uint16_t TCPIP_Helper_ChecksumFold(uint32_t rawChksum)
+{
+    TCPIP_UINT32_VAL checksum;
+
+    checksum.Val = rawChksum;
+    checksum.Val = (uint32_t)checksum.w[0] + (uint32_t)checksum.w[1];
+    checksum.w[0] += checksum.w[1];
+    return checksum.w[0];
+    
+}
+
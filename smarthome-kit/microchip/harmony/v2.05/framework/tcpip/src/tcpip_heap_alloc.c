@@ -41,6 +41,10 @@ SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
 
 #include "tcpip/src/tcpip_private.h"
 
+#if defined(_TCPIP_STACK_HEAP_PROFILE_ENABLE)
+static void _TCPIP_HEAP_ProfRegister(TCPIP_STACK_HEAP_HANDLE heapH);
+#endif  // defined(_TCPIP_STACK_HEAP_PROFILE_ENABLE)
+
 
 
 // cache helpers
@@ -111,23 +115,28 @@ const void* _TCPIP_HEAP_PointerMapCached(const void* ptr)
 
 TCPIP_STACK_HEAP_HANDLE TCPIP_HEAP_Create(const TCPIP_STACK_HEAP_CONFIG* initData, TCPIP_STACK_HEAP_RES* pRes)
 {
+    TCPIP_STACK_HEAP_HANDLE newH = 0;
+
     if(initData != 0)
     {
         switch (initData->heapType)
         {
 #if defined (TCPIP_STACK_USE_INTERNAL_HEAP)
             case TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP:
-                return TCPIP_HEAP_CreateInternal((const TCPIP_STACK_HEAP_INTERNAL_CONFIG*)initData, pRes);
+                newH = TCPIP_HEAP_CreateInternal((const TCPIP_STACK_HEAP_INTERNAL_CONFIG*)initData, pRes);
+                break;
 #endif  // defined (TCPIP_STACK_USE_INTERNAL_HEAP)
 
 #if defined (TCPIP_STACK_USE_EXTERNAL_HEAP)
             case TCPIP_STACK_HEAP_TYPE_EXTERNAL_HEAP:
-                return TCPIP_HEAP_CreateExternal((const TCPIP_STACK_HEAP_EXTERNAL_CONFIG*)initData, pRes);
+                newH = TCPIP_HEAP_CreateExternal((const TCPIP_STACK_HEAP_EXTERNAL_CONFIG*)initData, pRes);
+                break;
 #endif  // defined (TCPIP_STACK_USE_EXTERNAL_HEAP)
 
 #if defined (TCPIP_STACK_USE_INTERNAL_HEAP_POOL)
             case TCPIP_STACK_HEAP_TYPE_INTERNAL_HEAP_POOL:
-                return TCPIP_HEAP_CreateInternalPool((const TCPIP_STACK_HEAP_POOL_CONFIG*)initData, pRes);
+                newH = TCPIP_HEAP_CreateInternalPool((const TCPIP_STACK_HEAP_POOL_CONFIG*)initData, pRes);
+                break;
 #endif  // defined (TCPIP_STACK_USE_INTERNAL_HEAP_POOL)
 
             default:
@@ -135,7 +144,14 @@ TCPIP_STACK_HEAP_HANDLE TCPIP_HEAP_Create(const TCPIP_STACK_HEAP_CONFIG* initDat
         }
     }
 
-    return 0;
+#if defined(_TCPIP_STACK_HEAP_PROFILE_ENABLE)
+    if(newH != 0)
+    {
+        _TCPIP_HEAP_ProfRegister(newH);
+    }
+#endif  // defined(_TCPIP_STACK_HEAP_PROFILE_ENABLE)
+
+    return newH;
 }
 
 // functions needed when not inlined
@@ -679,3 +695,651 @@ unsigned int TCPIP_HEAP_DistGetEntriesNo(TCPIP_STACK_HEAP_HANDLE heapH)
 
 #endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE) 
 
+
+// heap profiler
+#if defined(_TCPIP_STACK_HEAP_PROFILE_ENABLE)
+#include "system/clk/sys_clk.h"
+
+#if !defined(TCPIP_STACK_HEAP_PROFILE_SLOTS)
+#define TCPIP_STACK_HEAP_PROFILE_SLOTS      256     // allocated blocks that can be tracked at once
+#endif
+#if !defined(TCPIP_STACK_HEAP_PROFILE_MODULES)
+#define TCPIP_STACK_HEAP_PROFILE_MODULES    16      // modules that can be accounted
+#endif
+
+#if (TCPIP_STACK_HEAP_PROFILE_SLOTS & (TCPIP_STACK_HEAP_PROFILE_SLOTS - 1)) != 0
+#error "TCPIP_STACK_HEAP_PROFILE_SLOTS should be a power of 2"
+#endif
+#if (TCPIP_STACK_HEAP_PROFILE_MODULES > 255)
+#error "TCPIP_STACK_HEAP_PROFILE_MODULES should be < 255"
+#endif
+
+#define _TCPIP_HEAP_PROF_LAT_CLASSES    80      // latency classes; up to 2^21 ticks
+#define _TCPIP_HEAP_PROF_SIZE_CLASSES   60      // request size classes; up to 64 KB
+#define _TCPIP_HEAP_PROF_MAX_PROBE      32      // maximum search length in the blocks table
+#define _TCPIP_HEAP_PROF_NO_MODULE      0xff    // the module table was full
+
+#if defined(__PIC32C__)
+#define _TCPIP_HEAP_ProfTicks()     ((uint32_t)SYS_TMR_SystemCountGet())
+#define _TCPIP_HEAP_ProfTsFreq()    ((uint32_t)SYS_TMR_SystemCountFrequencyGet())
+#else
+// core timer; it runs at half the system clock
+#define _TCPIP_HEAP_ProfTicks()     _CP0_GET_COUNT()
+#define _TCPIP_HEAP_ProfTsFreq()    (SYS_CLK_SystemFrequencyGet() / 2)
+#endif  // defined(__PIC32C__)
+
+// an allocated block
+typedef struct
+{
+    const void* ptr;            // block address; 0 means slot free
+    uint32_t    nBytes: 24;     // requested size
+    uint32_t    modIx:  8;      // allocating module, index in modTbl
+}TCPIP_HEAP_PROF_BLOCK;
+
+typedef struct
+{
+    uint32_t    nAllocs;
+    uint32_t    currBlocks;
+    uint32_t    peakBlocks;
+}TCPIP_HEAP_PROF_SIZE_CLASS;
+
+typedef struct
+{
+    TCPIP_STACK_HEAP_HANDLE     heapH;          // profiled heap; 0 means slot free
+    uint32_t                    nAllocs;
+    uint32_t                    nFails;
+    uint32_t                    nFrees;
+    uint32_t                    nUntracked;
+    uint32_t                    currBlocks;
+    uint32_t                    peakBlocks;
+    uint32_t                    currBytes;
+    uint32_t                    peakBytes;
+    uint32_t                    maxFailSize;
+    uint32_t                    allocLatMax;
+    uint32_t                    freeLatMax;
+    uint32_t                    allocLat[_TCPIP_HEAP_PROF_LAT_CLASSES];     // latency histograms
+    uint32_t                    freeLat[_TCPIP_HEAP_PROF_LAT_CLASSES];
+    TCPIP_HEAP_PROF_SIZE_CLASS  sizeTbl[_TCPIP_HEAP_PROF_SIZE_CLASSES];
+    TCPIP_HEAP_PROFILE_MODULE   modTbl[TCPIP_STACK_HEAP_PROFILE_MODULES];
+    TCPIP_HEAP_PROF_BLOCK       blockTbl[TCPIP_STACK_HEAP_PROFILE_SLOTS];   // open addressing, linear probing
+}TCPIP_HEAP_PROF_DCPT;
+
+static TCPIP_HEAP_PROF_DCPT     _tcpipHeapProfDcpt[TCPIP_STACK_SUPPORTED_HEAPS];
+
+#if defined(SYS_CMD_ENABLE)
+static int  _CommandHeapProfile(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+
+static const SYS_CMD_DESCRIPTOR    _heapProfCmdTbl[]=
+{
+    {"heapprof",    _CommandHeapProfile,    ": Heap profile: heapprof <reset>"},
+};
+
+static bool                 _heapProfCmdAdded;
+#endif  // defined(SYS_CMD_ENABLE)
+
+// log-linear classes: 4 classes for each power of 2
+// the class error is < 25%
+static __inline__ int __attribute__((always_inline)) _TCPIP_HEAP_ProfClass(uint32_t val, int nClasses)
+{
+    int cIx;
+
+    if(val < 4)
+    {
+        cIx = val;
+    }
+    else
+    {
+        int msb = 31 - __builtin_clz(val);
+        cIx = (msb - 1) * 4 + ((val >> (msb - 2)) & 3);
+    }
+
+    return cIx < nClasses ? cIx : nClasses - 1;
+}
+
+// the lowest value in a class
+static uint32_t _TCPIP_HEAP_ProfClassLow(int cIx)
+{
+    return cIx < 4 ? cIx : (uint32_t)(4 + (cIx & 3)) << (cIx / 4 - 1);
+}
+
+// the highest value in a class; the last one is open
+static uint32_t _TCPIP_HEAP_ProfClassHigh(int cIx, int nClasses)
+{
+    return cIx == nClasses - 1 ? 0xffffffff : _TCPIP_HEAP_ProfClassLow(cIx + 1) - 1;
+}
+
+static __inline__ uint32_t __attribute__((always_inline)) _TCPIP_HEAP_ProfHome(const void* ptr)
+{   // the blocks are at least 8 bytes aligned
+    return ((((uint32_t)(uintptr_t)ptr >> 3) * 2654435761u) >> 16) & (TCPIP_STACK_HEAP_PROFILE_SLOTS - 1);
+}
+
+static TCPIP_HEAP_PROF_DCPT* _TCPIP_HEAP_ProfFindDcpt(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    int hIx;
+    TCPIP_HEAP_PROF_DCPT* pDcpt = _tcpipHeapProfDcpt;
+    for(hIx = 0; hIx < sizeof(_tcpipHeapProfDcpt) / sizeof(*_tcpipHeapProfDcpt); hIx++, pDcpt++)
+    {
+        if(pDcpt->heapH == heapH)
+        {
+            return pDcpt;
+        }
+    }
+
+    return 0;
+}
+
+static void _TCPIP_HEAP_ProfRegister(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    // a heap created again at the same address reuses its slot
+    TCPIP_HEAP_PROF_DCPT* pDcpt = _TCPIP_HEAP_ProfFindDcpt(heapH);
+
+    if(pDcpt == 0)
+    {
+        pDcpt = _TCPIP_HEAP_ProfFindDcpt(0);
+    }
+
+    if(pDcpt != 0)
+    {
+        memset(pDcpt, 0, sizeof(*pDcpt));
+        pDcpt->heapH = heapH;
+    }
+
+#if defined(SYS_CMD_ENABLE)
+    if(!_heapProfCmdAdded)
+    {
+        _heapProfCmdAdded = SYS_CMD_ADDGRP(_heapProfCmdTbl, sizeof(_heapProfCmdTbl)/sizeof(*_heapProfCmdTbl), "heapprof", ": heap profiler commands");
+    }
+#endif  // defined(SYS_CMD_ENABLE)
+}
+
+// returns the modTbl index for a module
+static int _TCPIP_HEAP_ProfModule(TCPIP_HEAP_PROF_DCPT* pDcpt, int moduleId)
+{
+    int modIx;
+    TCPIP_HEAP_PROFILE_MODULE* pMod = pDcpt->modTbl;
+
+    for(modIx = 0; modIx < TCPIP_STACK_HEAP_PROFILE_MODULES; modIx++, pMod++)
+    {
+        if(pMod->moduleId == moduleId)
+        {
+            return modIx;
+        }
+        else if(pMod->moduleId == 0)
+        {   // modules are never removed; the 1st free slot ends the search
+            pMod->moduleId = moduleId;
+            return modIx;
+        }
+    }
+
+    return _TCPIP_HEAP_PROF_NO_MODULE;
+}
+
+static void _TCPIP_HEAP_ProfAlloc(TCPIP_STACK_HEAP_HANDLE heapH, const void* ptr, size_t nBytes, int moduleId, uint32_t latency)
+{
+    TCPIP_HEAP_PROF_DCPT* pDcpt = _TCPIP_HEAP_ProfFindDcpt(heapH);
+
+    if(pDcpt == 0)
+    {
+        return;
+    }
+
+    OSAL_CRITSECT_DATA_TYPE critStat = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+
+    pDcpt->allocLat[_TCPIP_HEAP_ProfClass(latency, _TCPIP_HEAP_PROF_LAT_CLASSES)]++;
+    if(latency > pDcpt->allocLatMax)
+    {
+        pDcpt->allocLatMax = latency;
+    }
+
+    int modIx = moduleId == 0 ? _TCPIP_HEAP_PROF_NO_MODULE : _TCPIP_HEAP_ProfModule(pDcpt, moduleId);
+    TCPIP_HEAP_PROFILE_MODULE* pMod = modIx == _TCPIP_HEAP_PROF_NO_MODULE ? 0 : pDcpt->modTbl + modIx;
+
+    if(ptr == 0)
+    {
+        pDcpt->nFails++;
+        if(nBytes > pDcpt->maxFailSize)
+        {
+            pDcpt->maxFailSize = nBytes;
+        }
+        if(pMod)
+        {
+            pMod->nFails++;
+        }
+        OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStat);
+        return;
+    }
+
+    pDcpt->nAllocs++;
+    if(pMod)
+    {
+        pMod->nAllocs++;
+    }
+
+    TCPIP_HEAP_PROF_SIZE_CLASS* pSize = pDcpt->sizeTbl + _TCPIP_HEAP_ProfClass(nBytes, _TCPIP_HEAP_PROF_SIZE_CLASSES);
+    pSize->nAllocs++;
+
+    // track the block
+    int probe;
+    uint32_t bIx = _TCPIP_HEAP_ProfHome(ptr);
+    TCPIP_HEAP_PROF_BLOCK* pBlk = 0;
+    if(nBytes < (1 << 24))
+    {
+        for(probe = 0; probe < _TCPIP_HEAP_PROF_MAX_PROBE; probe++, bIx = (bIx + 1) & (TCPIP_STACK_HEAP_PROFILE_SLOTS - 1))
+        {
+            if(pDcpt->blockTbl[bIx].ptr == 0)
+            {
+                pBlk = pDcpt->blockTbl + bIx;
+                break;
+            }
+        }
+    }
+
+    if(pBlk == 0)
+    {   // no room; this block won't be accounted
+        pDcpt->nUntracked++;
+        OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStat);
+        return;
+    }
+
+    pBlk->ptr = ptr;
+    pBlk->nBytes = nBytes;
+    pBlk->modIx = modIx;
+
+    if(++pSize->currBlocks > pSize->peakBlocks)
+    {
+        pSize->peakBlocks = pSize->currBlocks;
+    }
+    if(++pDcpt->currBlocks > pDcpt->peakBlocks)
+    {
+        pDcpt->peakBlocks = pDcpt->currBlocks;
+    }
+    if((pDcpt->currBytes += nBytes) > pDcpt->peakBytes)
+    {
+        pDcpt->peakBytes = pDcpt->currBytes;
+    }
+    if(pMod && (pMod->currBytes += nBytes) > pMod->peakBytes)
+    {
+        pMod->peakBytes = pMod->currBytes;
+    }
+
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStat);
+}
+
+// untracks a block that is about to be freed
+// this has to run before the heap free: once the block is returned
+// another thread can get the same address from the heap and its
+// _TCPIP_HEAP_ProfAlloc would race with this removal
+static void _TCPIP_HEAP_ProfFree(TCPIP_STACK_HEAP_HANDLE heapH, const void* ptr)
+{
+    TCPIP_HEAP_PROF_DCPT* pDcpt = _TCPIP_HEAP_ProfFindDcpt(heapH);
+
+    if(pDcpt == 0)
+    {
+        return;
+    }
+
+    OSAL_CRITSECT_DATA_TYPE critStat = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+
+    pDcpt->nFrees++;
+
+    int probe;
+    uint32_t bIx = _TCPIP_HEAP_ProfHome(ptr);
+    TCPIP_HEAP_PROF_BLOCK* pBlk = 0;
+    for(probe = 0; probe < _TCPIP_HEAP_PROF_MAX_PROBE; probe++, bIx = (bIx + 1) & (TCPIP_STACK_HEAP_PROFILE_SLOTS - 1))
+    {
+        if(pDcpt->blockTbl[bIx].ptr == ptr)
+        {
+            pBlk = pDcpt->blockTbl + bIx;
+            break;
+        }
+        else if(pDcpt->blockTbl[bIx].ptr == 0)
+        {
+            break;
+        }
+    }
+
+    if(pBlk == 0)
+    {   // allocated while the table was full or before the profiler knew the heap
+        pDcpt->nUntracked++;
+        OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStat);
+        return;
+    }
+
+    uint32_t nBytes = pBlk->nBytes;
+    pDcpt->sizeTbl[_TCPIP_HEAP_ProfClass(nBytes, _TCPIP_HEAP_PROF_SIZE_CLASSES)].currBlocks--;
+    pDcpt->currBlocks--;
+    pDcpt->currBytes -= nBytes;
+    if(pBlk->modIx != _TCPIP_HEAP_PROF_NO_MODULE)
+    {
+        pDcpt->modTbl[pBlk->modIx].currBytes -= nBytes;
+    }
+
+    // remove the block; shift back the following blocks
+    // so that no search stops early on the hole
+    uint32_t holeIx = bIx;
+    for(probe = 1; probe < TCPIP_STACK_HEAP_PROFILE_SLOTS; probe++)
+    {
+        bIx = (bIx + 1) & (TCPIP_STACK_HEAP_PROFILE_SLOTS - 1);
+        const void* nextPtr = pDcpt->blockTbl[bIx].ptr;
+        if(nextPtr == 0)
+        {
+            break;
+        }
+        uint32_t homeIx = _TCPIP_HEAP_ProfHome(nextPtr);
+        bool inPlace = holeIx <= bIx ? (holeIx < homeIx && homeIx <= bIx) : (holeIx < homeIx || homeIx <= bIx);
+        if(!inPlace)
+        {
+            pDcpt->blockTbl[holeIx] = pDcpt->blockTbl[bIx];
+            holeIx = bIx;
+        }
+    }
+    pDcpt->blockTbl[holeIx].ptr = 0;
+
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStat);
+}
+
+// records the latency of a completed heap free
+static void _TCPIP_HEAP_ProfFreeLatency(TCPIP_STACK_HEAP_HANDLE heapH, uint32_t latency)
+{
+    TCPIP_HEAP_PROF_DCPT* pDcpt = _TCPIP_HEAP_ProfFindDcpt(heapH);
+
+    if(pDcpt == 0)
+    {
+        return;
+    }
+
+    OSAL_CRITSECT_DATA_TYPE critStat = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+
+    pDcpt->freeLat[_TCPIP_HEAP_ProfClass(latency, _TCPIP_HEAP_PROF_LAT_CLASSES)]++;
+    if(latency > pDcpt->freeLatMax)
+    {
+        pDcpt->freeLatMax = latency;
+    }
+
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStat);
+}
+
+void* TCPIP_HEAP_MallocProfile(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes, int moduleId)
+{
+    uint32_t startTick = _TCPIP_HEAP_ProfTicks();
+    void* ptr = (*((TCPIP_HEAP_OBJECT*)heapH)->TCPIP_HEAP_Malloc)(heapH, nBytes);
+    _TCPIP_HEAP_ProfAlloc(heapH, ptr, nBytes, moduleId, _TCPIP_HEAP_ProfTicks() - startTick);
+
+    return ptr;
+}
+
+void* TCPIP_HEAP_CallocProfile(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_t elemSize, int moduleId)
+{
+    uint32_t startTick = _TCPIP_HEAP_ProfTicks();
+    void* ptr = (*((TCPIP_HEAP_OBJECT*)heapH)->TCPIP_HEAP_Calloc)(heapH, nElems, elemSize);
+    _TCPIP_HEAP_ProfAlloc(heapH, ptr, nElems * elemSize, moduleId, _TCPIP_HEAP_ProfTicks() - startTick);
+
+    return ptr;
+}
+
+size_t TCPIP_HEAP_FreeProfile(TCPIP_STACK_HEAP_HANDLE heapH, const void* ptr, int moduleId)
+{
+    if(ptr != 0)
+    {
+        _TCPIP_HEAP_ProfFree(heapH, ptr);
+    }
+
+    uint32_t startTick = _TCPIP_HEAP_ProfTicks();
+    size_t nBytes = (*((TCPIP_HEAP_OBJECT*)heapH)->TCPIP_HEAP_Free)(heapH, ptr);
+    if(ptr != 0)
+    {
+        _TCPIP_HEAP_ProfFreeLatency(heapH, _TCPIP_HEAP_ProfTicks() - startTick);
+    }
+
+    return nBytes;
+}
+
+// value at a percentile of a latency histogram
+// the class high limit is reported, so the result is an upper bound
+static uint32_t _TCPIP_HEAP_ProfPercentile(const uint32_t* pHist, int percent, uint32_t maxVal)
+{
+    int cIx;
+    uint32_t nSamples = 0;
+    uint32_t cumul = 0;
+
+    for(cIx = 0; cIx < _TCPIP_HEAP_PROF_LAT_CLASSES; cIx++)
+    {
+        nSamples += pHist[cIx];
+    }
+
+    uint32_t target = (uint32_t)(((uint64_t)nSamples * percent + 99) / 100);
+    for(cIx = 0; cIx < _TCPIP_HEAP_PROF_LAT_CLASSES && nSamples != 0; cIx++)
+    {
+        cumul += pHist[cIx];
+        if(cumul >= target)
+        {
+            uint32_t highVal = _TCPIP_HEAP_ProfClassHigh(cIx, _TCPIP_HEAP_PROF_LAT_CLASSES);
+            return highVal < maxVal ? highVal : maxVal;
+        }
+    }
+
+    return maxVal;
+}
+
+bool TCPIP_HEAP_ProfileGetInfo(TCPIP_STACK_HEAP_HANDLE heapH, TCPIP_HEAP_PROFILE_INFO* pInfo)
+{
+    static const int latPercent[] = {50, 90, 99};
+    TCPIP_HEAP_PROF_DCPT* pDcpt = heapH == 0 ? 0 : _TCPIP_HEAP_ProfFindDcpt(heapH);
+    int ix;
+
+    if(pDcpt == 0 || pInfo == 0)
+    {
+        return false;
+    }
+
+    // the walk of the heap happens outside the critical section
+    pInfo->heapSize = TCPIP_HEAP_Size(heapH);
+    pInfo->freeSize = TCPIP_HEAP_FreeSize(heapH);
+    pInfo->maxBlock = TCPIP_HEAP_MaxSize(heapH);
+    pInfo->tsFreq = _TCPIP_HEAP_ProfTsFreq();
+
+    OSAL_CRITSECT_DATA_TYPE critStat = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    pInfo->nAllocs = pDcpt->nAllocs;
+    pInfo->nFails = pDcpt->nFails;
+    pInfo->nFrees = pDcpt->nFrees;
+    pInfo->nUntracked = pDcpt->nUntracked;
+    pInfo->currBlocks = pDcpt->currBlocks;
+    pInfo->peakBlocks = pDcpt->peakBlocks;
+    pInfo->currBytes = pDcpt->currBytes;
+    pInfo->peakBytes = pDcpt->peakBytes;
+    pInfo->maxFailSize = pDcpt->maxFailSize;
+    for(ix = 0; ix < sizeof(latPercent) / sizeof(*latPercent); ix++)
+    {
+        pInfo->allocLat[ix] = _TCPIP_HEAP_ProfPercentile(pDcpt->allocLat, latPercent[ix], pDcpt->allocLatMax);
+        pInfo->freeLat[ix] = _TCPIP_HEAP_ProfPercentile(pDcpt->freeLat, latPercent[ix], pDcpt->freeLatMax);
+    }
+    pInfo->allocLat[ix] = pDcpt->allocLatMax;
+    pInfo->freeLat[ix] = pDcpt->freeLatMax;
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStat);
+
+    return true;
+}
+
+bool TCPIP_HEAP_ProfileGetModule(TCPIP_STACK_HEAP_HANDLE heapH, unsigned int entryIx, TCPIP_HEAP_PROFILE_MODULE* pEntry)
+{
+    TCPIP_HEAP_PROF_DCPT* pDcpt = heapH == 0 ? 0 : _TCPIP_HEAP_ProfFindDcpt(heapH);
+    bool found = false;
+
+    if(pDcpt != 0 && pEntry != 0 && entryIx < TCPIP_STACK_HEAP_PROFILE_MODULES)
+    {   // the entry is updated by the allocating threads
+        OSAL_CRITSECT_DATA_TYPE critStat = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+        if(pDcpt->modTbl[entryIx].moduleId != 0)
+        {
+            *pEntry = pDcpt->modTbl[entryIx];
+            found = true;
+        }
+        OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStat);
+    }
+
+    return found;
+}
+
+bool TCPIP_HEAP_ProfileGetSizeEntry(TCPIP_STACK_HEAP_HANDLE heapH, unsigned int entryIx, TCPIP_HEAP_PROFILE_SIZE_ENTRY* pEntry)
+{
+    TCPIP_HEAP_PROF_DCPT* pDcpt = heapH == 0 ? 0 : _TCPIP_HEAP_ProfFindDcpt(heapH);
+
+    if(pDcpt != 0 && pEntry != 0 && entryIx < _TCPIP_HEAP_PROF_SIZE_CLASSES)
+    {
+        TCPIP_HEAP_PROF_SIZE_CLASS* pSize = pDcpt->sizeTbl + entryIx;
+        pEntry->lowLimit = _TCPIP_HEAP_ProfClassLow(entryIx);
+        pEntry->highLimit = _TCPIP_HEAP_ProfClassHigh(entryIx, _TCPIP_HEAP_PROF_SIZE_CLASSES);
+        OSAL_CRITSECT_DATA_TYPE critStat = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+        pEntry->nAllocs = pSize->nAllocs;
+        pEntry->currBlocks = pSize->currBlocks;
+        pEntry->peakBlocks = pSize->peakBlocks;
+        OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStat);
+        return true;
+    }
+
+    return false;
+}
+
+TCPIP_STACK_HEAP_RES TCPIP_HEAP_ProfileReset(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_PROF_DCPT* pDcpt = heapH == 0 ? 0 : _TCPIP_HEAP_ProfFindDcpt(heapH);
+    int ix;
+
+    if(pDcpt == 0)
+    {
+        return TCPIP_STACK_HEAP_RES_NO_HEAP;
+    }
+
+    OSAL_CRITSECT_DATA_TYPE critStat = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_LOW);
+    pDcpt->nAllocs = pDcpt->nFails = pDcpt->nFrees = pDcpt->nUntracked = 0;
+    pDcpt->maxFailSize = pDcpt->allocLatMax = pDcpt->freeLatMax = 0;
+    pDcpt->peakBlocks = pDcpt->currBlocks;
+    pDcpt->peakBytes = pDcpt->currBytes;
+    memset(pDcpt->allocLat, 0, sizeof(pDcpt->allocLat));
+    memset(pDcpt->freeLat, 0, sizeof(pDcpt->freeLat));
+    for(ix = 0; ix < _TCPIP_HEAP_PROF_SIZE_CLASSES; ix++)
+    {
+        pDcpt->sizeTbl[ix].nAllocs = 0;
+        pDcpt->sizeTbl[ix].peakBlocks = pDcpt->sizeTbl[ix].currBlocks;
+    }
+    for(ix = 0; ix < TCPIP_STACK_HEAP_PROFILE_MODULES; ix++)
+    {
+        pDcpt->modTbl[ix].nAllocs = pDcpt->modTbl[ix].nFails = 0;
+        pDcpt->modTbl[ix].peakBytes = pDcpt->modTbl[ix].currBytes;
+    }
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_LOW, critStat);
+
+    return TCPIP_STACK_HEAP_RES_OK;
+}
+
+#if defined(SYS_CMD_ENABLE)
+// prints a latency in us, with ns resolution
+static void _HeapProfPrintLat(SYS_CMD_DEVICE_NODE* pCmdIO, const char* title, const uint32_t* pLat, uint32_t tsFreq)
+{
+    int ix;
+    uint32_t latNs[4];
+
+    for(ix = 0; ix < 4; ix++)
+    {
+        latNs[ix] = (uint32_t)(((uint64_t)pLat[ix] * 1000000000ull) / tsFreq);
+    }
+
+    (*pCmdIO->pCmdApi->print)(pCmdIO->cmdIoParam, "%s us: p50 %lu.%03lu, p90 %lu.%03lu, p99 %lu.%03lu, max %lu.%03lu\r\n", title,
+            latNs[0] / 1000, latNs[0] % 1000, latNs[1] / 1000, latNs[1] % 1000,
+            latNs[2] / 1000, latNs[2] % 1000, latNs[3] / 1000, latNs[3] % 1000);
+}
+
+static int _CommandHeapProfile(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    // heapprof <reset>
+    const void* cmdIoParam = pCmdIO->cmdIoParam;
+    bool doReset = argc > 1 && strcmp(argv[1], "reset") == 0;
+    int hIx, ix;
+    TCPIP_HEAP_PROFILE_INFO profInfo;
+    TCPIP_HEAP_PROFILE_SIZE_ENTRY sizeEntry;
+    TCPIP_HEAP_PROFILE_MODULE modEntry;
+
+    if(argc > 1 && !doReset)
+    {
+        (*pCmdIO->pCmdApi->msg)(cmdIoParam, "Usage: heapprof <reset>\r\n");
+        return false;
+    }
+
+    for(hIx = 0; hIx < sizeof(_tcpipHeapProfDcpt) / sizeof(*_tcpipHeapProfDcpt); hIx++)
+    {
+        TCPIP_STACK_HEAP_HANDLE heapH = _tcpipHeapProfDcpt[hIx].heapH;
+
+        if(heapH == 0)
+        {
+            continue;
+        }
+
+        if(doReset)
+        {
+            TCPIP_HEAP_ProfileReset(heapH);
+            (*pCmdIO->pCmdApi->print)(cmdIoParam, "heap %d: profile reset\r\n", hIx);
+            continue;
+        }
+
+        TCPIP_HEAP_ProfileGetInfo(heapH, &profInfo);
+        (*pCmdIO->pCmdApi->print)(cmdIoParam, "heap %d: size %lu, free %lu, max block %lu", hIx, (uint32_t)profInfo.heapSize, (uint32_t)profInfo.freeSize, (uint32_t)profInfo.maxBlock);
+        if(profInfo.freeSize != 0)
+        {
+            (*pCmdIO->pCmdApi->print)(cmdIoParam, ", fragmentation %lu%%", (uint32_t)(100 - (profInfo.maxBlock * 100) / profInfo.freeSize));
+        }
+        (*pCmdIO->pCmdApi->msg)(cmdIoParam, "\r\n");
+        (*pCmdIO->pCmdApi->print)(cmdIoParam, "allocs %lu, frees %lu, fails %lu (max %lu bytes), untracked %lu\r\n",
+                profInfo.nAllocs, profInfo.nFrees, profInfo.nFails, profInfo.maxFailSize, profInfo.nUntracked);
+        (*pCmdIO->pCmdApi->print)(cmdIoParam, "blocks %lu, peak %lu; bytes %lu, peak %lu\r\n",
+                profInfo.currBlocks, profInfo.peakBlocks, profInfo.currBytes, profInfo.peakBytes);
+        _HeapProfPrintLat(pCmdIO, "malloc", profInfo.allocLat, profInfo.tsFreq);
+        _HeapProfPrintLat(pCmdIO, "free", profInfo.freeLat, profInfo.tsFreq);
+
+        (*pCmdIO->pCmdApi->msg)(cmdIoParam, "size                  allocs     blocks     peak\r\n");
+        for(ix = 0; TCPIP_HEAP_ProfileGetSizeEntry(heapH, ix, &sizeEntry); ix++)
+        {
+            if(sizeEntry.nAllocs != 0 || sizeEntry.peakBlocks != 0)
+            {
+                (*pCmdIO->pCmdApi->print)(cmdIoParam, "%5lu-%-10lu %10lu %10lu %8lu\r\n", sizeEntry.lowLimit,
+                        sizeEntry.highLimit, sizeEntry.nAllocs, sizeEntry.currBlocks, sizeEntry.peakBlocks);
+            }
+        }
+
+        (*pCmdIO->pCmdApi->msg)(cmdIoParam, "module      allocs   fails      bytes     peak\r\n");
+        for(ix = 0; ix < TCPIP_STACK_HEAP_PROFILE_MODULES; ix++)
+        {
+            if(TCPIP_HEAP_ProfileGetModule(heapH, ix, &modEntry))
+            {
+                (*pCmdIO->pCmdApi->print)(cmdIoParam, "0x%04x %11lu %7lu %10lu %8lu\r\n", modEntry.moduleId,
+                        modEntry.nAllocs, modEntry.nFails, modEntry.currBytes, modEntry.peakBytes);
+            }
+        }
+    }
+
+    return true;
+}
+#endif  // defined(SYS_CMD_ENABLE)
+
+#else
+
+bool TCPIP_HEAP_ProfileGetInfo(TCPIP_STACK_HEAP_HANDLE heapH, TCPIP_HEAP_PROFILE_INFO* pInfo)
+{
+    return false;
+}
+
+bool TCPIP_HEAP_ProfileGetModule(TCPIP_STACK_HEAP_HANDLE heapH, unsigned int entryIx, TCPIP_HEAP_PROFILE_MODULE* pEntry)
+{
+    return false;
+}
+
+bool TCPIP_HEAP_ProfileGetSizeEntry(TCPIP_STACK_HEAP_HANDLE heapH, unsigned int entryIx, TCPIP_HEAP_PROFILE_SIZE_ENTRY* pEntry)
+{
+    return false;
+}
+
+TCPIP_STACK_HEAP_RES TCPIP_HEAP_ProfileReset(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    return TCPIP_STACK_HEAP_RES_NO_HEAP;
+}
+
+#endif  // defined(_TCPIP_STACK_HEAP_PROFILE_ENABLE)
+
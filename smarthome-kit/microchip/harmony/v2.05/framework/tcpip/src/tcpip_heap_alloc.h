@@ -73,6 +73,59 @@ typedef struct
     int         currHits;           // current number of allocations hits
 }TCPIP_HEAP_DIST_ENTRY;
 
+// heap profiler
+// only if TCPIP_STACK_HEAP_PROFILE_ENABLE is enabled and TCPIP_STACK_DRAM_DEBUG_ENABLE is not:
+// the debug build has its own trace and distribution.
+// The profiler is meant to run in production builds:
+// it times every TCPIP_HEAP_Malloc/Calloc/Free call and keeps the
+// allocated blocks in a fixed table so that the bytes are accounted
+// to the module that allocated them, whichever module frees them.
+// All sizes are the requested ones, the heap overhead is not included.
+#if defined(TCPIP_STACK_HEAP_PROFILE_ENABLE) && !defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+#define _TCPIP_STACK_HEAP_PROFILE_ENABLE
+#endif
+
+// heap profiler summary
+typedef struct
+{
+    uint32_t    nAllocs;            // successful allocations
+    uint32_t    nFails;             // failed allocations
+    uint32_t    nFrees;             // successful frees
+    uint32_t    nUntracked;         // blocks that could not be accounted: live table full or unknown pointer freed
+    uint32_t    currBlocks;         // blocks currently allocated
+    uint32_t    peakBlocks;         // maximum value of currBlocks
+    uint32_t    currBytes;          // bytes currently allocated
+    uint32_t    peakBytes;          // maximum value of currBytes
+    uint32_t    maxFailSize;        // largest request that failed
+    uint32_t    tsFreq;             // frequency of the latency time base, Hz
+    uint32_t    allocLat[4];        // allocation latency, ticks: 50th, 90th, 99th percentile and maximum
+    uint32_t    freeLat[4];         // free latency, ticks: 50th, 90th, 99th percentile and maximum
+    size_t      heapSize;           // TCPIP_HEAP_Size()
+    size_t      freeSize;           // TCPIP_HEAP_FreeSize()
+    size_t      maxBlock;           // TCPIP_HEAP_MaxSize(); fragmentation is 1 - maxBlock/freeSize
+}TCPIP_HEAP_PROFILE_INFO;
+
+// heap profiler module entry
+typedef struct
+{
+    int         moduleId;           // TCPIP_STACK_MODULE; 0 means slot free
+    uint32_t    nAllocs;            // successful allocations
+    uint32_t    nFails;             // failed allocations
+    uint32_t    currBytes;          // bytes currently allocated by this module
+    uint32_t    peakBytes;          // maximum value of currBytes
+}TCPIP_HEAP_PROFILE_MODULE;
+
+// heap profiler size distribution entry
+// the size classes are log-linear: 4 classes for each power of 2
+typedef struct
+{
+    uint32_t    lowLimit;           // smallest request size in this class
+    uint32_t    highLimit;          // largest request size in this class
+    uint32_t    nAllocs;            // successful allocations in this class
+    uint32_t    currBlocks;         // blocks currently allocated
+    uint32_t    peakBlocks;         // maximum value of currBlocks; the number of pool blocks needed for this class
+}TCPIP_HEAP_PROFILE_SIZE_ENTRY;
+
 /********************************
  * Interface Functions
 *******************************************/ 
@@ -415,6 +468,90 @@ bool  TCPIP_HEAP_DistGetEntry(TCPIP_STACK_HEAP_HANDLE heapH, unsigned int entryI
  ********************************************************************/
 unsigned int     TCPIP_HEAP_DistGetEntriesNo(TCPIP_STACK_HEAP_HANDLE heapH);
 
+/*********************************************************************
+ * Function:      bool  TCPIP_HEAP_ProfileGetInfo(TCPIP_STACK_HEAP_HANDLE heapH, TCPIP_HEAP_PROFILE_INFO* pInfo)
+ *
+ * PreCondition:    None
+ *
+ * Input:           heapH       - handle of a heap
+ *                  pInfo       - address to store the heap profile summary
+ *
+ * Output:          true if pInfo was populated with the info
+ *                  false if no such heap or if profiling is not enabled
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The function returns the heap profile summary:
+ *                  usage counters, peaks, latency percentiles and fragmentation data.
+ *
+ * Note:            
+ *                  Profile info is recorded only when
+ *                  TCPIP_STACK_HEAP_PROFILE_ENABLE is enabled and TCPIP_STACK_DRAM_DEBUG_ENABLE is not.
+ *
+ *                  The call walks the heap to find the maximum block size; it could be expensive.
+ ********************************************************************/
+bool  TCPIP_HEAP_ProfileGetInfo(TCPIP_STACK_HEAP_HANDLE heapH, TCPIP_HEAP_PROFILE_INFO* pInfo);
+
+/*********************************************************************
+ * Function:      bool  TCPIP_HEAP_ProfileGetModule(TCPIP_STACK_HEAP_HANDLE heapH, unsigned int entryIx, TCPIP_HEAP_PROFILE_MODULE* pEntry)
+ *
+ * PreCondition:    None
+ *
+ * Input:           heapH       - handle of a heap
+ *                  entryIx     - index of the requested module entry
+ *                  pEntry      - address to store the module info
+ *
+ * Output:          true if pEntry was populated with the info
+ *                  false if entryIx is not a used slot or if profiling is not enabled
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The function returns the profile info of one module using the heap.
+ *
+ * Note:            The number of slots is TCPIP_STACK_HEAP_PROFILE_MODULES.
+ ********************************************************************/
+bool  TCPIP_HEAP_ProfileGetModule(TCPIP_STACK_HEAP_HANDLE heapH, unsigned int entryIx, TCPIP_HEAP_PROFILE_MODULE* pEntry);
+
+/*********************************************************************
+ * Function:      bool  TCPIP_HEAP_ProfileGetSizeEntry(TCPIP_STACK_HEAP_HANDLE heapH, unsigned int entryIx, TCPIP_HEAP_PROFILE_SIZE_ENTRY* pEntry)
+ *
+ * PreCondition:    None
+ *
+ * Input:           heapH       - handle of a heap
+ *                  entryIx     - index of the requested size class
+ *                  pEntry      - address to store the size class info
+ *
+ * Output:          true if pEntry was populated with the info
+ *                  false if entryIx is out of range or if profiling is not enabled
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The function returns the allocation counters of a request size class.
+ *                  Size classes are returned in increasing order, including the unused ones.
+ *
+ * Note:            None
+ ********************************************************************/
+bool  TCPIP_HEAP_ProfileGetSizeEntry(TCPIP_STACK_HEAP_HANDLE heapH, unsigned int entryIx, TCPIP_HEAP_PROFILE_SIZE_ENTRY* pEntry);
+
+/*********************************************************************
+ * Function:      TCPIP_STACK_HEAP_RES  TCPIP_HEAP_ProfileReset(TCPIP_STACK_HEAP_HANDLE heapH)
+ *
+ * PreCondition:    None
+ *
+ * Input:           heapH       - handle of a heap
+ *
+ * Output:          TCPIP_STACK_HEAP_RES_OK if the profile was reset
+ *                  TCPIP_STACK_HEAP_RES_NO_HEAP if no such heap or if profiling is not enabled
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The function clears the profile counters and latency histograms.
+ *                  The peaks restart from the current usage; the allocated blocks are still tracked.
+ *
+ * Note:            None
+ ********************************************************************/
+TCPIP_STACK_HEAP_RES  TCPIP_HEAP_ProfileReset(TCPIP_STACK_HEAP_HANDLE heapH);
+
 // *****************************************************************************
 /*
   Structure:
@@ -463,6 +600,21 @@ size_t TCPIP_HEAP_FreeDebug(TCPIP_STACK_HEAP_HANDLE h, const void* ptr, int modu
 
 TCPIP_STACK_HEAP_RES TCPIP_HEAP_SetNoMemHandler(TCPIP_STACK_HEAP_HANDLE h, TCPIP_HEAP_NO_MEM_HANDLER handler);
 
+#elif defined(_TCPIP_STACK_HEAP_PROFILE_ENABLE)
+
+// heap object calls timed and accounted by the profiler
+void* TCPIP_HEAP_MallocProfile(TCPIP_STACK_HEAP_HANDLE h, size_t nBytes, int moduleId);
+#define  TCPIP_HEAP_Malloc(h, nBytes)   TCPIP_HEAP_MallocProfile(h, nBytes, TCPIP_THIS_MODULE_ID)
+void*   TCPIP_HEAP_MallocOutline(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes);
+
+void* TCPIP_HEAP_CallocProfile(TCPIP_STACK_HEAP_HANDLE h, size_t nElems, size_t elemSize, int moduleId);
+#define  TCPIP_HEAP_Calloc(h, nElems, elemSize)   TCPIP_HEAP_CallocProfile(h, nElems, elemSize, TCPIP_THIS_MODULE_ID)
+void* TCPIP_HEAP_CallocOutline(TCPIP_STACK_HEAP_HANDLE h, size_t nElems, size_t elemSize);
+
+size_t TCPIP_HEAP_FreeProfile(TCPIP_STACK_HEAP_HANDLE h, const void* ptr, int moduleId);
+#define  TCPIP_HEAP_Free(h, ptr)   TCPIP_HEAP_FreeProfile(h, ptr, TCPIP_THIS_MODULE_ID)
+size_t TCPIP_HEAP_FreeOutline(TCPIP_STACK_HEAP_HANDLE h, const void* ptr);
+
 #else
 
 static __inline__ void* __attribute__((always_inline)) TCPIP_HEAP_MallocInline(TCPIP_STACK_HEAP_HANDLE h, size_t nBytes)
@@ -539,6 +691,10 @@ typedef struct
     // the expansion size at the moment of call
     // Note that this is a global pool number, not per entry  
     int expansionSize;
+    // lowest number of free blocks seen in this entry
+    int minFreeBlocks;
+    // allocations that did not find a free block in this entry
+    int allocFails;
 }TCPIP_HEAP_POOL_ENTRY_LIST;
 
 // returns the number of entries in the pool heap
@@ -0,0 +1,713 @@
+/*******************************************************************************
+  TCPIP Heap Allocation Manager
+
+  Summary:
+    Fixed block pool heap
+
+  Description:
+    Each pool entry holds blocks of one size class, kept on a lock-free LIFO.
+    Allocation takes the smallest entry that fits, so there is no fragmentation
+    and no semaphore on the allocation path.
+*******************************************************************************/
+
+/*******************************************************************************
+File Name:  tcpip_heap_pool.c
+Copyright  2012 released Microchip Technology Inc.  All rights
+reserved.
+
+Microchip licenses to you the right to use, modify, copy and distribute
+Software only when embedded on a Microchip microcontroller or digital signal
+controller that is integrated into your product or third party product
+(pursuant to the sublicense terms in the accompanying license agreement).
+
+You should refer to the license agreement accompanying this Software for
+additional information regarding your rights and obligations.
+
+SOFTWARE AND DOCUMENTATION ARE PROVIDED AS IS WITHOUT WARRANTY OF ANY KIND,
+EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT LIMITATION, ANY WARRANTY OF
+MERCHANTABILITY, TITLE, NON-INFRINGEMENT AND FITNESS FOR A PARTICULAR PURPOSE.
+IN NO EVENT SHALL MICROCHIP OR ITS LICENSORS BE LIABLE OR OBLIGATED UNDER
+CONTRACT, NEGLIGENCE, STRICT LIABILITY, CONTRIBUTION, BREACH OF WARRANTY, OR
+OTHER LEGAL EQUITABLE THEORY ANY DIRECT OR INDIRECT DAMAGES OR EXPENSES
+INCLUDING BUT NOT LIMITED TO ANY INCIDENTAL, SPECIAL, INDIRECT, PUNITIVE OR
+CONSEQUENTIAL DAMAGES, LOST PROFITS OR LOST DATA, COST OF PROCUREMENT OF
+SUBSTITUTE GOODS, TECHNOLOGY, SERVICES, OR ANY CLAIMS BY THIRD PARTIES
+(INCLUDING BUT NOT LIMITED TO ANY DEFENSE THEREOF), OR OTHER SIMILAR COSTS.
+*******************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include <stddef.h>
+
+#include <sys/kmem.h>
+
+
+#include "tcpip/src/tcpip_private.h"
+
+#if defined (TCPIP_STACK_USE_INTERNAL_HEAP_POOL)
+// definitions
+
+
+// min heap alignment
+// always power of 2
+#if defined(__PIC32MX__)
+typedef uint32_t _heap_Align;
+#elif defined(__PIC32MZ__) || defined(__PIC32WK__)
+typedef struct __attribute__((aligned(16)))
+{
+    uint64_t     pad[2];
+}_heap_Align;
+#endif  // defined(__PIC32MX__) || defined(__PIC32MZ__)
+
+struct _tag_TCPIP_HEAP_POOL_ENTRY_DCPT;
+
+// block header; the user data follows it
+typedef union __attribute__((aligned(16))) _tag_poolHead
+{
+    _heap_Align x;
+    struct
+    {
+        struct _tag_TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry;    // entry owning this block
+        union _tag_poolHead*    next;       // next free block, valid while on the free list
+        uint32_t                allocMark;  // _TCPIP_HEAP_POOL_ALLOC_MARK while allocated
+    };
+}_poolHead;
+
+#define _TCPIP_HEAP_POOL_ALLOC_MARK     0x504f4f4cu     // "POOL"
+
+
+typedef struct _tag_TCPIP_HEAP_POOL_ENTRY_DCPT
+{
+    _poolHead* volatile     freeHead;   // LIFO of free blocks; updated lock-free only
+    volatile uint32_t       nFree;      // current number of free blocks
+    volatile uint32_t       nBlocks;    // total number of blocks, expansion included
+    volatile uint32_t       minFree;    // low water mark of nFree
+    volatile uint32_t       allocFails; // allocations that could not be satisfied from this entry
+    uint16_t                entrySize;  // size of the user data in a block
+    uint16_t                blkSize;    // size of a block, header included
+    uint8_t                 nExpBlks;   // blocks to carve from the expansion area when empty
+    uint8_t                 pad[3];     // padding, not used
+}TCPIP_HEAP_POOL_ENTRY_DCPT;
+
+
+typedef struct
+{
+    TCPIP_STACK_HEAP_POOL_CONFIG    heapConfig;     // configuration data save
+    TCPIP_HEAP_POOL_ENTRY_DCPT*     entryTbl;       // entries, sorted by increasing entrySize
+    int                             nEntries;       // number of entries in entryTbl
+    void*                           allocPtr;       // storage as returned by the allocation function
+    uint8_t*                        heapStart;      // aligned start of the blocks area
+    size_t                          heapSize;       // size of the blocks area, expansion included
+    uint8_t*                        expStart;       // start of the expansion area
+    uint32_t                        expSize;        // size of the expansion area
+    volatile uint32_t               expUsed;        // bytes already carved from the expansion area
+    TCPIP_STACK_HEAP_RES            _lastHeapErr;   // last error encountered
+    uint8_t                         heapStrict;     // allocate strictly from the matching entry
+    uint8_t                         heapPad[3];     // padding, not used
+}TCPIP_HEAP_POOL_DCPT; // descriptor of a heap
+
+
+// local data
+//
+
+static TCPIP_STACK_HEAP_RES   _TCPIP_HEAP_Delete(TCPIP_STACK_HEAP_HANDLE heapH);
+static void*            _TCPIP_HEAP_Malloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes);
+static void*            _TCPIP_HEAP_Calloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_t elemSize);
+static size_t           _TCPIP_HEAP_Free(TCPIP_STACK_HEAP_HANDLE heapH, const void* pBuff);
+
+static size_t           _TCPIP_HEAP_Size(TCPIP_STACK_HEAP_HANDLE heapH);
+static size_t           _TCPIP_HEAP_MaxSize(TCPIP_STACK_HEAP_HANDLE heapH);
+static size_t           _TCPIP_HEAP_FreeSize(TCPIP_STACK_HEAP_HANDLE heapH);
+static TCPIP_STACK_HEAP_RES   _TCPIP_HEAP_LastError(TCPIP_STACK_HEAP_HANDLE heapH);
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+static size_t           _TCPIP_HEAP_AllocSize(TCPIP_STACK_HEAP_HANDLE heapH, const void* ptr);
+#endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+
+// maps a buffer to non cached memory
+const void*   _TCPIP_HEAP_BufferMapNonCached(const void* buffer, size_t buffSize);
+
+
+
+// the heap object
+static const TCPIP_HEAP_OBJECT      _tcpip_heap_object =
+{
+    _TCPIP_HEAP_Delete,
+    _TCPIP_HEAP_Malloc,
+    _TCPIP_HEAP_Calloc,
+    _TCPIP_HEAP_Free,
+    _TCPIP_HEAP_Size,
+    _TCPIP_HEAP_MaxSize,
+    _TCPIP_HEAP_FreeSize,
+    _TCPIP_HEAP_LastError,
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+    _TCPIP_HEAP_AllocSize,
+#endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+};
+
+typedef struct
+{
+    TCPIP_HEAP_OBJECT       heapObj;    // heap object API
+    TCPIP_HEAP_POOL_DCPT    heapDcpt;   // private heap object data
+}TCPIP_HEAP_POOL_OBJ_INSTANCE;
+
+
+
+// local prototypes
+//
+static __inline__ bool __attribute__((always_inline)) _TCPIP_HEAP_IsPtrAligned(const void* ptr)
+{
+    return (uintptr_t)(ptr) == ((uintptr_t)(ptr) & (~(sizeof(_poolHead) - 1)));
+}
+
+// returns the TCPIP_HEAP_POOL_OBJ_INSTANCE associated with a heap handle
+// null if invalid
+static __inline__ TCPIP_HEAP_POOL_OBJ_INSTANCE* __attribute__((always_inline)) _TCPIP_HEAP_ObjInstance(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+    if(heapH)
+    {
+        TCPIP_HEAP_POOL_OBJ_INSTANCE* pInst = (TCPIP_HEAP_POOL_OBJ_INSTANCE*)heapH;
+        if(pInst->heapObj.TCPIP_HEAP_Delete == _TCPIP_HEAP_Delete)
+        {
+            return pInst;
+        }
+    }
+    return 0;
+#else
+    return (heapH == 0) ? 0 : (TCPIP_HEAP_POOL_OBJ_INSTANCE*)heapH;
+#endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+
+}
+
+// returns the TCPIP_HEAP_POOL_DCPT associated with a heap handle
+// null if invalid
+static __inline__ TCPIP_HEAP_POOL_DCPT* __attribute__((always_inline)) _TCPIP_HEAP_ObjDcpt(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_OBJ_INSTANCE* hInst = _TCPIP_HEAP_ObjInstance(heapH);
+
+    return (hInst == 0) ? 0 : &hInst->heapDcpt;
+}
+
+// lock-free LIFO operations
+// the list heads live in the (cached) descriptor, as required by ll/sc
+//
+
+// pushes a block on a free list
+// the ABA problem does not affect a push
+static void _TCPIP_HEAP_POOL_Push(_poolHead* volatile* pHead, _poolHead* pBlk)
+{
+    _poolHead* pTop;
+
+    do
+    {
+        pTop = *pHead;
+        pBlk->next = pTop;
+    }while(!__sync_bool_compare_and_swap(pHead, pTop, pBlk));
+}
+
+// pops a block from a free list
+// returns 0 if the list is empty
+#if defined(__mips__)
+// the next pointer is read between ll and sc:
+// if the list changes in between, a context switch must have occurred,
+// which clears the link bit so the sc fails and the pop is retried.
+// This is what makes the pop ABA safe on a single core.
+static _poolHead* _TCPIP_HEAP_POOL_Pop(_poolHead* volatile* pHead)
+{
+    _poolHead* pBlk;
+    _poolHead* pNext;
+
+    __asm__ __volatile__(
+        "   .set    push            \n"
+        "   .set    noreorder       \n"
+        "1: ll      %0, 0(%2)       \n"
+        "   beqz    %0, 2f          \n"
+        "   nop                     \n"
+        "   lw      %1, %3(%0)      \n"
+        "   sc      %1, 0(%2)       \n"
+        "   beqz    %1, 1b          \n"
+        "   nop                     \n"
+        "2:                         \n"
+        "   .set    pop             \n"
+        : "=&r"(pBlk), "=&r"(pNext)
+        : "r"(pHead), "i"(offsetof(_poolHead, next))
+        : "memory");
+
+    return pBlk;
+}
+#else
+static _poolHead* _TCPIP_HEAP_POOL_Pop(_poolHead* volatile* pHead)
+{
+    _poolHead* pBlk;
+
+    OSAL_CRITSECT_DATA_TYPE critStat = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+    if((pBlk = *pHead) != 0)
+    {
+        *pHead = pBlk->next;
+    }
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, critStat);
+
+    return pBlk;
+}
+#endif  // defined(__mips__)
+
+// returns the smallest entry that can hold nBytes
+// 0 if none
+static TCPIP_HEAP_POOL_ENTRY_DCPT* _TCPIP_HEAP_POOL_EntryFind(TCPIP_HEAP_POOL_DCPT* hDcpt, size_t nBytes)
+{
+    int ix;
+    TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry = hDcpt->entryTbl;
+
+    for(ix = 0; ix < hDcpt->nEntries; ix++, pEntry++)
+    {
+        if(pEntry->entrySize >= nBytes)
+        {
+            return pEntry;
+        }
+    }
+
+    return 0;
+}
+
+// carves nBlks blocks from the area starting at pStart and adds them to the entry
+static void _TCPIP_HEAP_POOL_EntryAddBlocks(TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry, uint8_t* pStart, int nBlks)
+{
+    _poolHead* pBlk;
+
+    while(nBlks--)
+    {
+        pBlk = (_poolHead*)pStart;
+        pBlk->pEntry = pEntry;
+        pBlk->allocMark = 0;
+        _TCPIP_HEAP_POOL_Push(&pEntry->freeHead, pBlk);
+        pStart += pEntry->blkSize;
+    }
+}
+
+// extends an entry with nExpBlks blocks taken from the expansion area
+// the expansion area is a bump allocator, claimed lock-free
+static bool _TCPIP_HEAP_POOL_EntryExpand(TCPIP_HEAP_POOL_DCPT* hDcpt, TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry)
+{
+    uint32_t expBytes, expUsed;
+
+    if(pEntry->nExpBlks == 0)
+    {
+        return false;
+    }
+
+    expBytes = pEntry->nExpBlks * pEntry->blkSize;
+    do
+    {
+        expUsed = hDcpt->expUsed;
+        if(expUsed + expBytes > hDcpt->expSize)
+        {
+            return false;
+        }
+    }while(!__sync_bool_compare_and_swap(&hDcpt->expUsed, expUsed, expUsed + expBytes));
+
+    // count the blocks before they are visible so nFree never underflows
+    __sync_fetch_and_add(&pEntry->nBlocks, pEntry->nExpBlks);
+    __sync_fetch_and_add(&pEntry->nFree, pEntry->nExpBlks);
+    _TCPIP_HEAP_POOL_EntryAddBlocks(pEntry, hDcpt->expStart + expUsed, pEntry->nExpBlks);
+
+    return true;
+}
+
+
+// API
+
+TCPIP_STACK_HEAP_HANDLE TCPIP_HEAP_CreateInternalPool(const TCPIP_STACK_HEAP_POOL_CONFIG* pHeapConfig, TCPIP_STACK_HEAP_RES* pRes)
+{
+    TCPIP_HEAP_POOL_DCPT* hDcpt;
+    TCPIP_HEAP_POOL_OBJ_INSTANCE* hInst;
+    TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry;
+    TCPIP_HEAP_POOL_ENTRY_DCPT  tmpEntry;
+    const TCPIP_STACK_HEAP_POOL_ENTRY* pCfgEntry;
+    TCPIP_STACK_HEAP_RES  res;
+    size_t  blocksSize;
+    uint8_t* pStart;
+    int ix, jx;
+
+
+    while(true)
+    {
+        hDcpt =0;
+        hInst = 0;
+
+        if( pHeapConfig == 0 || pHeapConfig->nPoolEntries == 0 || pHeapConfig->pEntries == 0)
+        {
+            res = TCPIP_STACK_HEAP_RES_INIT_ERR;
+            break;
+        }
+
+        hInst = (TCPIP_HEAP_POOL_OBJ_INSTANCE*)(*pHeapConfig->calloc_fnc)(1, sizeof(*hInst) + pHeapConfig->nPoolEntries * sizeof(*pEntry));
+
+        if(hInst == 0)
+        {
+            res = TCPIP_STACK_HEAP_RES_CREATE_ERR;
+            break;
+        }
+
+        hDcpt = &hInst->heapDcpt;
+        hDcpt->entryTbl = (TCPIP_HEAP_POOL_ENTRY_DCPT*)(hInst + 1);
+        hDcpt->nEntries = pHeapConfig->nPoolEntries;
+
+        // build the entries, sorted by size
+        res = TCPIP_STACK_HEAP_RES_OK;
+        blocksSize = 0;
+        pCfgEntry = pHeapConfig->pEntries;
+        for(ix = 0; ix < hDcpt->nEntries; ix++, pCfgEntry++)
+        {
+            if(pCfgEntry->entrySize == 0)
+            {
+                res = TCPIP_STACK_HEAP_RES_INIT_ERR;
+                break;
+            }
+
+            memset(&tmpEntry, 0, sizeof(tmpEntry));
+            tmpEntry.entrySize = pCfgEntry->entrySize;
+            tmpEntry.blkSize = ((pCfgEntry->entrySize + sizeof(_poolHead) - 1) / sizeof(_poolHead) + 1) * sizeof(_poolHead);
+            tmpEntry.nBlocks = pCfgEntry->nBlocks;
+            tmpEntry.nExpBlks = pCfgEntry->nExpBlks;
+            blocksSize += tmpEntry.blkSize * tmpEntry.nBlocks;
+
+            for(jx = ix; jx > 0 && hDcpt->entryTbl[jx - 1].entrySize > tmpEntry.entrySize; jx--)
+            {
+                hDcpt->entryTbl[jx] = hDcpt->entryTbl[jx - 1];
+            }
+            if(jx > 0 && hDcpt->entryTbl[jx - 1].entrySize == tmpEntry.entrySize)
+            {   // duplicate entry sizes not supported
+                res = TCPIP_STACK_HEAP_RES_INIT_ERR;
+                break;
+            }
+            hDcpt->entryTbl[jx] = tmpEntry;
+        }
+
+        if(res != TCPIP_STACK_HEAP_RES_OK)
+        {
+            (*pHeapConfig->free_fnc)(hInst);
+            hInst = 0;
+            break;
+        }
+
+        // allocate the storage: blocks + expansion area, aligned
+        hDcpt->expSize = (pHeapConfig->expansionHeapSize / sizeof(_poolHead)) * sizeof(_poolHead);
+        hDcpt->heapSize = blocksSize + hDcpt->expSize;
+        hDcpt->allocPtr = (*pHeapConfig->malloc_fnc)(hDcpt->heapSize + sizeof(_poolHead) - 1);
+        if(hDcpt->allocPtr == 0)
+        {
+            (*pHeapConfig->free_fnc)(hInst);
+            hInst = 0;
+            res = TCPIP_STACK_HEAP_RES_BUFF_SIZE_ERR;
+            break;
+        }
+
+        pStart = (uint8_t*)(((uintptr_t)hDcpt->allocPtr + sizeof(_poolHead) - 1) & ~(sizeof(_poolHead) - 1));
+        if((pHeapConfig->heapFlags & TCPIP_STACK_HEAP_FLAG_ALLOC_UNCACHED) != 0)
+        {   // map the whole area once; the descriptor stays cached for ll/sc
+            pStart = (uint8_t*)_TCPIP_HEAP_BufferMapNonCached(pStart, hDcpt->heapSize);
+        }
+        hDcpt->heapStart = pStart;
+        hDcpt->expStart = pStart + blocksSize;
+
+        for(ix = 0, pEntry = hDcpt->entryTbl; ix < hDcpt->nEntries; ix++, pEntry++)
+        {
+            _TCPIP_HEAP_POOL_EntryAddBlocks(pEntry, pStart, pEntry->nBlocks);
+            pEntry->nFree = pEntry->minFree = pEntry->nBlocks;
+            pStart += pEntry->blkSize * pEntry->nBlocks;
+        }
+
+        // save the configuration parameters
+        hDcpt->heapConfig = *pHeapConfig;
+        hDcpt->heapStrict = (pHeapConfig->heapFlags & TCPIP_STACK_HEAP_FLAG_POOL_STRICT) != 0;
+        // create the object
+        hInst->heapObj = _tcpip_heap_object;
+
+        break;
+    }
+
+    if(pRes)
+    {
+        *pRes = res;
+    }
+
+    return hInst;
+
+}
+
+int TCPIP_HEAP_POOL_Entries(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_DCPT*   hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+    return (hDcpt == 0) ? 0 : hDcpt->nEntries;
+}
+
+bool TCPIP_HEAP_POOL_EntryList(TCPIP_STACK_HEAP_HANDLE heapH, int entryIx, TCPIP_HEAP_POOL_ENTRY_LIST* pList)
+{
+    TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry;
+    TCPIP_HEAP_POOL_DCPT*   hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+    if(hDcpt == 0 || entryIx < 0 || entryIx >= hDcpt->nEntries)
+    {
+        return false;
+    }
+
+    if(pList)
+    {
+        pEntry = hDcpt->entryTbl + entryIx;
+        pList->blockSize = pEntry->entrySize;
+        pList->nBlocks = pEntry->nBlocks;
+        pList->freeBlocks = pEntry->nFree;
+        pList->totEntrySize = pEntry->nBlocks * pEntry->blkSize;
+        pList->totFreeSize = pEntry->nFree * pEntry->blkSize;
+        pList->expansionSize = hDcpt->expSize - hDcpt->expUsed;
+        pList->minFreeBlocks = pEntry->minFree;
+        pList->allocFails = pEntry->allocFails;
+    }
+
+    return true;
+}
+
+// internal functions
+//
+// deallocates the heap
+// fails if some blocks are still in use
+static TCPIP_STACK_HEAP_RES _TCPIP_HEAP_Delete(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    int ix;
+    TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry;
+    TCPIP_HEAP_POOL_OBJ_INSTANCE*   hInst = _TCPIP_HEAP_ObjInstance(heapH);
+
+    if(hInst == 0)
+    {
+        return TCPIP_STACK_HEAP_RES_NO_HEAP;
+    }
+
+    for(ix = 0, pEntry = hInst->heapDcpt.entryTbl; ix < hInst->heapDcpt.nEntries; ix++, pEntry++)
+    {
+        if(pEntry->nFree != pEntry->nBlocks)
+        {
+            return TCPIP_STACK_HEAP_RES_IN_USE;
+        }
+    }
+
+    (*hInst->heapDcpt.heapConfig.free_fnc)(hInst->heapDcpt.allocPtr);
+    // invalidate it
+    memset(&hInst->heapObj, 0, sizeof(hInst->heapObj));
+    (*hInst->heapDcpt.heapConfig.free_fnc)(hInst);
+    return TCPIP_STACK_HEAP_RES_OK;
+}
+
+
+static void* _TCPIP_HEAP_Malloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nBytes)
+{
+    TCPIP_HEAP_POOL_ENTRY_DCPT  *pEntry, *pMatch, *pLast;
+    _poolHead*  pBlk;
+    uint32_t    nFree, minFree;
+    TCPIP_HEAP_POOL_DCPT*   hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+
+    if(hDcpt == 0 || nBytes == 0)
+    {
+        return 0;
+    }
+
+    pMatch = _TCPIP_HEAP_POOL_EntryFind(hDcpt, nBytes);
+    if(pMatch == 0)
+    {
+        hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_SIZE_ERR;
+        return 0;
+    }
+
+    if((pBlk = _TCPIP_HEAP_POOL_Pop(&pMatch->freeHead)) == 0)
+    {
+        if(_TCPIP_HEAP_POOL_EntryExpand(hDcpt, pMatch))
+        {
+            pBlk = _TCPIP_HEAP_POOL_Pop(&pMatch->freeHead);
+        }
+    }
+    pEntry = pMatch;
+
+    if(pBlk == 0)
+    {
+        __sync_fetch_and_add(&pMatch->allocFails, 1);
+        if(!hDcpt->heapStrict)
+        {   // try the larger blocks
+            pLast = hDcpt->entryTbl + hDcpt->nEntries;
+            for(pEntry = pMatch + 1; pEntry < pLast; pEntry++)
+            {
+                if((pBlk = _TCPIP_HEAP_POOL_Pop(&pEntry->freeHead)) != 0)
+                {
+                    break;
+                }
+            }
+        }
+
+        if(pBlk == 0)
+        {
+            hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_NO_MEM;
+            return 0;
+        }
+    }
+
+    pBlk->allocMark = _TCPIP_HEAP_POOL_ALLOC_MARK;
+    nFree = __sync_sub_and_fetch(&pEntry->nFree, 1);
+    // a preempting allocation may lower the mark in between
+    do
+    {
+        minFree = pEntry->minFree;
+        if(nFree >= minFree)
+        {
+            break;
+        }
+    }while(!__sync_bool_compare_and_swap(&pEntry->minFree, minFree, nFree));
+
+    return pBlk + 1;
+}
+
+static void* _TCPIP_HEAP_Calloc(TCPIP_STACK_HEAP_HANDLE heapH, size_t nElems, size_t elemSize)
+{
+    size_t nBytes = nElems * elemSize;
+
+    // redirect to malloc
+
+    void* ptr = _TCPIP_HEAP_Malloc(heapH, nBytes);
+    if(ptr)
+    {
+        memset(ptr, 0, nBytes);
+    }
+
+    return ptr;
+}
+
+// returns the size of the released block
+// this is what the heap trace and distribution need
+static size_t _TCPIP_HEAP_Free(TCPIP_STACK_HEAP_HANDLE heapH, const void* ptr)
+{
+    _poolHead*  pBlk;
+    TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry;
+    TCPIP_HEAP_POOL_DCPT*   hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+    if(hDcpt == 0 || ptr == 0)
+    {
+        return 0;
+    }
+
+    pBlk = (_poolHead*)ptr - 1;
+    pEntry = _TCPIP_HEAP_IsPtrAligned(ptr) ? pBlk->pEntry : 0;
+    if(pEntry < hDcpt->entryTbl || pEntry >= hDcpt->entryTbl + hDcpt->nEntries || pBlk->allocMark != _TCPIP_HEAP_POOL_ALLOC_MARK)
+    {   // not ours or already freed
+        hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_PTR_ERR;
+        return 0;
+    }
+
+    pBlk->allocMark = 0;
+    __sync_fetch_and_add(&pEntry->nFree, 1);
+    _TCPIP_HEAP_POOL_Push(&pEntry->freeHead, pBlk);
+
+    return pEntry->entrySize;
+}
+
+
+static size_t _TCPIP_HEAP_Size(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_DCPT*      hDcpt;
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+    if(hDcpt)
+    {
+        return hDcpt->heapSize;
+    }
+
+    return -1;
+}
+
+static size_t _TCPIP_HEAP_FreeSize(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    int ix;
+    size_t freeSize;
+    TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry;
+    TCPIP_HEAP_POOL_DCPT*      hDcpt;
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+
+    if(hDcpt)
+    {
+        freeSize = hDcpt->expSize - hDcpt->expUsed;
+        for(ix = 0, pEntry = hDcpt->entryTbl; ix < hDcpt->nEntries; ix++, pEntry++)
+        {
+            freeSize += pEntry->nFree * pEntry->entrySize;
+        }
+        return freeSize;
+    }
+    return -1;
+}
+
+
+// largest block that could be currently allocated
+static size_t _TCPIP_HEAP_MaxSize(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    int ix;
+    TCPIP_HEAP_POOL_ENTRY_DCPT* pEntry;
+    TCPIP_HEAP_POOL_DCPT*      hDcpt;
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+
+    if(hDcpt)
+    {
+        for(ix = hDcpt->nEntries - 1, pEntry = hDcpt->entryTbl + ix; ix >= 0; ix--, pEntry--)
+        {
+            if(pEntry->nFree != 0)
+            {
+                return pEntry->entrySize;
+            }
+            if(pEntry->nExpBlks != 0 && hDcpt->expUsed + pEntry->nExpBlks * pEntry->blkSize <= hDcpt->expSize)
+            {
+                return pEntry->entrySize;
+            }
+        }
+        return 0;
+    }
+    return -1;
+}
+
+
+static TCPIP_STACK_HEAP_RES _TCPIP_HEAP_LastError(TCPIP_STACK_HEAP_HANDLE heapH)
+{
+    TCPIP_HEAP_POOL_DCPT*      hDcpt;
+    TCPIP_STACK_HEAP_RES  res;
+
+    hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+    if(hDcpt)
+    {
+        res = hDcpt->_lastHeapErr;
+        hDcpt->_lastHeapErr = TCPIP_STACK_HEAP_RES_OK;
+    }
+    else
+    {
+        res = TCPIP_STACK_HEAP_RES_NO_HEAP;
+    }
+
+    return res;
+}
+
+#if defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+static size_t _TCPIP_HEAP_AllocSize(TCPIP_STACK_HEAP_HANDLE heapH, const void* ptr)
+{
+    TCPIP_HEAP_POOL_DCPT*   hDcpt = _TCPIP_HEAP_ObjDcpt(heapH);
+
+    if(hDcpt)
+    {
+        return ((_poolHead*)ptr - 1)->pEntry->entrySize;
+    }
+
+    return -1;
+}
+#endif  // defined(TCPIP_STACK_DRAM_DEBUG_ENABLE)
+
+#endif  // defined (TCPIP_STACK_USE_INTERNAL_HEAP_POOL)
+
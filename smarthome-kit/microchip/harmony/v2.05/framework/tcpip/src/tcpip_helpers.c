@@ -745,154 +745,6 @@ uint16_t TCPIP_Helper_Base64Encode(const uint8_t* cSourceData, uint16_t wSourceL
 }
 
 
-/*****************************************************************************
-  Function:
-	uint16_t TCPIP_Helper_CalcIPChecksum(uint8_t* buffer, uint16_t count, uint16_t seed)
-
-  Summary:
-	Calculates an IP checksum value.
-
-  Description:
-	This function calculates an IP checksum over an array of input data.  The
-	checksum is the 16-bit one's complement of one's complement sum of all 
-	words in the data (with zero-padding if an odd number of bytes are 
-	summed).  This checksum is defined in RFC 793.
-
-  Precondition:
-	None
-
-  Parameters:
-	buffer - pointer to the data to be checksummed
-	count  - number of bytes to be checksummed
-    seed   - start seed
-
-  Returns:
-	The calculated checksum.
-	
-  Note:
-	The checksum is implemented as a fast assembly function on PIC32 platforms.
-  ***************************************************************************/
-#if !defined(__PIC32__)
-uint16_t TCPIP_Helper_CalcIPChecksum(uint8_t* buffer, uint16_t count, uint16_t seed)
-{
-	uint16_t i;
-	uint16_t *val;
-	union
-	{
-		uint8_t  b[4];
-		uint16_t w[2];
-		uint32_t dw;
-	} sum;
-
-	val = (uint16_t*)buffer;
-
-	// Calculate the sum of all words
-	sum.dw = (uint32_t)seed;
-    if ((unsigned int)buffer % 2)
-    {
-        sum.w[0] += (*(uint8_t *)buffer) << 8;
-        val = (uint16_t *)(buffer + 1);
-        count--;
-    }
-
-	i = count >> 1;
-
-	while(i--)
-		sum.dw += (uint32_t)*val++;
-
-	// Add in the sum of the remaining byte, if present
-	if(count & 0x1)
-		sum.dw += (uint32_t)*(uint8_t*)val;
-
-	// Do an end-around carry (one's complement arrithmatic)
-	sum.dw = (uint32_t)sum.w[0] + (uint32_t)sum.w[1];
-
-	// Do another end-around carry in case if the prior add 
-	// caused a carry out
-	sum.w[0] += sum.w[1];
-
-    if ((unsigned int)buffer % 2)
-    {
-        sum.w[0] = ((uint16_t)sum.b[0] << 8 ) | (uint16_t)sum.b[1];
-    }
-
-	// Return the resulting checksum
-	return ~sum.w[0];
-}
-#endif  // !defined(__PIC32__)
-
-// calculates the IP checksum for a packet with multiple segments
-uint16_t TCPIP_Helper_PacketChecksum(TCPIP_MAC_PACKET* pPkt, uint8_t* startAdd, uint16_t len, uint16_t seed)
-{
-    TCPIP_MAC_DATA_SEGMENT  *pSeg;
-    uint8_t* pChkBuff;
-    uint16_t checkLength, chkBytes, nBytes;
-    uint16_t segChkSum;
-    uint32_t calcChkSum;
-
-    if(len == 0)
-    {
-        return seed;
-    }
-
-    calcChkSum = seed;
-    checkLength = len;
-    nBytes = 0;
-    pChkBuff = startAdd; 
-    pSeg = TCPIP_PKT_DataSegmentGet(pPkt, startAdd, true);
-
-    while(pSeg != 0 && checkLength != 0)
-    {
-        chkBytes = (pSeg->segLoad + pSeg->segSize) - pChkBuff;
-
-        if(chkBytes > pSeg->segLen)
-        {
-            chkBytes = pSeg->segLen;
-        } 
-
-        if(chkBytes > checkLength)
-        {
-            chkBytes = checkLength;
-        } 
-
-        if(chkBytes)
-        {
-            segChkSum = ~TCPIP_Helper_CalcIPChecksum(pChkBuff, chkBytes, 0);
-            if((nBytes & 0x1) != 0)
-            {
-                segChkSum = TCPIP_Helper_htons(segChkSum);
-            }
-
-            checkLength -= chkBytes;
-            nBytes += chkBytes;
-            calcChkSum += segChkSum;
-        }
-        if((pSeg = pSeg->next) != 0)
-        {
-            pChkBuff = pSeg->segLoad;
-        }
-#if (TCPIP_IPV4_FRAGMENTATION != 0)
-        else if((pPkt = pPkt->pkt_next) != 0)
-        {
-            pSeg = pPkt->pDSeg;
-            pChkBuff = pPkt->pNetLayer;
-        }
-#endif  // (TCPIP_IPV4_FRAGMENTATION != 0)
-    }
-
-    return ~TCPIP_Helper_ChecksumFold(calcChkSum);
-}
-
-uint16_t TCPIP_Helper_ChecksumFold(uint32_t rawChksum)
-{
-    TCPIP_UINT32_VAL checksum;
-
-    checksum.Val = rawChksum;
-    checksum.Val = (uint32_t)checksum.w[0] + (uint32_t)checksum.w[1];
-    checksum.w[0] += checksum.w[1];
-    return checksum.w[0];
-    
-}
 #endif
 
 // copies packet segment data to a linear destination buffer
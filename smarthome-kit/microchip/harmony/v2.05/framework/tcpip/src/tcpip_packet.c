@@ -119,6 +119,45 @@ static TCPIP_PKT_LOG_INFO   _pktLogInfo;  // global log counters
 static int                  _pktOverwriteIx;    // simple LRU displacement pointer
 #endif  // (TCPIP_PACKET_LOG_ENABLE)
 
+#if (TCPIP_PACKET_RECORDER_ENABLE)
+#include "system/clk/sys_clk.h"
+
+#if !defined(TCPIP_PKT_RECORDER_SIZE)
+#define TCPIP_PKT_RECORDER_SIZE     256
+#endif
+
+#if (TCPIP_PKT_RECORDER_SIZE & (TCPIP_PKT_RECORDER_SIZE - 1)) != 0 || (TCPIP_PKT_RECORDER_SIZE > 0x8000)
+#error "TCPIP_PKT_RECORDER_SIZE should be a power of 2, <= 32K"
+#endif
+
+// the records are overwritten in a circular fashion
+static TCPIP_PKT_REC_ENTRY  _pktRecTbl[TCPIP_PKT_RECORDER_SIZE];
+
+static volatile uint32_t    _pktRecCount;       // total records made; next record number
+static volatile bool        _pktRecStopped;     // recording is stopped
+
+#if defined(__PIC32C__)
+// time stamps from the system timer
+#define _TCPIP_PKT_RecTimeStamp()   ((uint32_t)SYS_TMR_SystemCountGet())
+#define _TCPIP_PKT_RecTsFreq()      ((uint32_t)SYS_TMR_SystemCountFrequencyGet())
+#else
+// time stamps from the core timer; it runs at half the system clock
+#define _TCPIP_PKT_RecTimeStamp()   _CP0_GET_COUNT()
+#define _TCPIP_PKT_RecTsFreq()      (SYS_CLK_SystemFrequencyGet() / 2)
+#endif  // defined(__PIC32C__)
+
+#if defined(SYS_CMD_ENABLE)
+static int  _CommandPktRecorder(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv);
+
+static const SYS_CMD_DESCRIPTOR    _pktRecCmdTbl[]=
+{
+    {"pktrec",  _CommandPktRecorder,    ": Packet recorder: pktrec <dump|clear|stop|start>"},
+};
+
+static bool                 _pktRecCmdAdded;
+#endif  // defined(SYS_CMD_ENABLE)
+#endif  // (TCPIP_PACKET_RECORDER_ENABLE)
+
 
 
 // API
@@ -170,6 +209,10 @@ bool TCPIP_PKT_Initialize(TCPIP_STACK_HEAP_HANDLE heapH, const TCPIP_NETWORK_CON
 
 #endif  // (TCPIP_PACKET_LOG_ENABLE)
 
+#if (TCPIP_PACKET_RECORDER_ENABLE)
+        TCPIP_PKT_RecorderInitialize();
+#endif  // (TCPIP_PACKET_RECORDER_ENABLE)
+
         break;
     }
 
@@ -194,6 +237,7 @@ void _TCPIP_PKT_PacketAcknowledge(TCPIP_MAC_PACKET* pPkt, TCPIP_MAC_PKT_ACK_RES
 
     if(pPkt->ackFunc)
     {
+       TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_ACK, moduleId, pPkt->ackRes);
        TCPIP_PKT_FlightLogAcknowledge(pPkt, moduleId, ackRes);
        if((*pPkt->ackFunc)(pPkt, pPkt->ackParam))
        {
@@ -359,6 +403,7 @@ static __inline__ TCPIP_MAC_PACKET* __attribute__((always_inline)) _TCPIP_PKT_Pa
         {
             pPkt = (TCPIP_MAC_PACKET*)KVA0_TO_KVA1(pPkt);
         }
+        TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_ALLOC, moduleId, 0);
     }
 
     return pPkt;
@@ -370,6 +415,8 @@ static __inline__ void __attribute__((always_inline)) _TCPIP_PKT_PacketFreeInt(T
     {   // we don't deallocate static packets
         TCPIP_MAC_DATA_SEGMENT  *pSeg, *pNSeg;
 
+        TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_FREE, moduleId, 0);
+
         for(pSeg = pPkt->pDSeg; pSeg != 0 ; )
         {
             pNSeg = pSeg->next;
@@ -723,6 +770,7 @@ TCPIP_MAC_PACKET* _TCPIP_PKT_PacketAlloc(uint16_t pktLen, uint16_t segLoadLen, T
         {
             pPkt = (TCPIP_MAC_PACKET*)KVA0_TO_KVA1(pPkt);
         }
+        TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_ALLOC, 0, 0);
     }
 
     return pPkt;
@@ -765,6 +813,8 @@ void _TCPIP_PKT_PacketFree(TCPIP_MAC_PACKET* pPkt)
     {   // we don't deallocate static packets
         TCPIP_MAC_DATA_SEGMENT  *pSeg, *pNSeg;
 
+        TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_FREE, 0, 0);
+
         for(pSeg = pPkt->pDSeg; pSeg != 0 ; )
         {
             pNSeg = pSeg->next;
@@ -1034,6 +1084,7 @@ static TCPIP_PKT_LOG_ENTRY* _TCPIP_PKT_FlightLog(TCPIP_MAC_PACKET* pPkt, TCPIP_S
 
 void TCPIP_PKT_FlightLogTx(TCPIP_MAC_PACKET* pPkt, TCPIP_STACK_MODULE moduleId)
 {
+    TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_TX, moduleId, 0);
     TCPIP_PKT_LOG_ENTRY* pLogEntry = _TCPIP_PKT_FlightLog(pPkt, moduleId, TCPIP_PKT_LOG_FLAG_TX);
 
     if(pLogEntry)
@@ -1044,6 +1095,7 @@ void TCPIP_PKT_FlightLogTx(TCPIP_MAC_PACKET* pPkt, TCPIP_STACK_MODULE moduleId)
 
 void TCPIP_PKT_FlightLogRx(TCPIP_MAC_PACKET* pPkt, TCPIP_STACK_MODULE moduleId)
 {
+    TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_RX, moduleId, 0);
     TCPIP_PKT_LOG_ENTRY* pLogEntry =  _TCPIP_PKT_FlightLog(pPkt, moduleId, TCPIP_PKT_LOG_FLAG_RX);
 
     if(pLogEntry)
@@ -1054,6 +1106,7 @@ void TCPIP_PKT_FlightLogRx(TCPIP_MAC_PACKET* pPkt, TCPIP_STACK_MODULE moduleId)
 
 void TCPIP_PKT_FlightLogTxSkt(TCPIP_MAC_PACKET* pPkt, TCPIP_STACK_MODULE moduleId, uint32_t lclRemPort, uint16_t sktNo )
 {
+    TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_TX, moduleId, sktNo);
     TCPIP_PKT_LOG_ENTRY* pLogEntry = _TCPIP_PKT_FlightLog(pPkt, moduleId, TCPIP_PKT_LOG_FLAG_TX);
 
     if(pLogEntry)
@@ -1068,6 +1121,7 @@ void TCPIP_PKT_FlightLogTxSkt(TCPIP_MAC_PACKET* pPkt, TCPIP_STACK_MODULE moduleI
 
 void TCPIP_PKT_FlightLogRxSkt(TCPIP_MAC_PACKET* pPkt, TCPIP_STACK_MODULE moduleId, uint32_t lclRemPort, uint16_t sktNo )
 {
+    TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_RX, moduleId, sktNo);
     TCPIP_PKT_LOG_ENTRY* pLogEntry = _TCPIP_PKT_FlightLog(pPkt, moduleId, TCPIP_PKT_LOG_FLAG_RX);
 
     if(pLogEntry)
@@ -1451,5 +1505,184 @@ void TCPIP_PKT_FlightLogClear(bool clrPersist)
 
 #endif  //  (TCPIP_PACKET_LOG_ENABLE)
 
+#if (TCPIP_PACKET_RECORDER_ENABLE)
+void TCPIP_PKT_Record(TCPIP_MAC_PACKET* pPkt, TCPIP_PKT_REC_EVENT event, int moduleId, int arg)
+{
+    if(_pktRecStopped)
+    {
+        return;
+    }
+
+    // a handful of stores; done with interrupts off so that the time stamps
+    // follow the record numbers and a clear never sees a half written record
+    OSAL_CRITSECT_DATA_TYPE critStat = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+
+    if(_pktRecStopped)
+    {
+        OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, critStat);
+        return;
+    }
+
+    uint32_t recNo = _pktRecCount++;
+    TCPIP_PKT_REC_ENTRY* pRec = _pktRecTbl + (recNo & (TCPIP_PKT_RECORDER_SIZE - 1));
+
+    pRec->timeStamp = _TCPIP_PKT_RecTimeStamp();
+    pRec->pktId = (uint32_t)pPkt;
+    pRec->moduleId = (uint16_t)moduleId;
+    if(pPkt->pDSeg == 0)
+    {
+        pRec->pktLen = 0;
+    }
+    else
+    {   // at allocation nothing is loaded yet, the buffer size is more useful
+        pRec->pktLen = event == TCPIP_PKT_REC_EVENT_ALLOC ? pPkt->pDSeg->segSize : pPkt->pDSeg->segLen;
+    }
+    pRec->event = (uint8_t)event;
+    pRec->arg = (int8_t)arg;
+    // the sequence number validates the record; a reader seeing the old one discards it
+    pRec->seq = (uint16_t)recNo;
+
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, critStat);
+}
+
+void TCPIP_PKT_RecorderGetInfo(TCPIP_PKT_REC_INFO* pRecInfo)
+{
+    pRecInfo->nEntries = TCPIP_PKT_RECORDER_SIZE;
+    pRecInfo->recCount = _pktRecCount;
+    pRecInfo->tsFreq = _TCPIP_PKT_RecTsFreq();
+    pRecInfo->stopped = _pktRecStopped;
+}
+
+bool TCPIP_PKT_RecorderGetEntry(int recIx, TCPIP_PKT_REC_ENTRY* pRec)
+{
+    uint32_t recCount = _pktRecCount;
+    uint32_t nRecs = recCount < TCPIP_PKT_RECORDER_SIZE ? recCount : TCPIP_PKT_RECORDER_SIZE;
+
+    if(recIx < 0 || recIx >= nRecs)
+    {
+        return false;
+    }
+
+    uint32_t recNo = recCount - nRecs + recIx;
+    *pRec = _pktRecTbl[recNo & (TCPIP_PKT_RECORDER_SIZE - 1)];
+
+    return pRec->seq == (uint16_t)recNo;
+}
+
+void TCPIP_PKT_RecorderSet(bool run, bool clear)
+{
+    OSAL_CRITSECT_DATA_TYPE critStat = OSAL_CRIT_Enter(OSAL_CRIT_TYPE_HIGH);
+
+    if(clear)
+    {
+        memset(_pktRecTbl, 0, sizeof(_pktRecTbl));
+        _pktRecCount = 0;
+    }
+    _pktRecStopped = !run;
+
+    OSAL_CRIT_Leave(OSAL_CRIT_TYPE_HIGH, critStat);
+}
+
+void TCPIP_PKT_RecorderInitialize(void)
+{
+#if defined(SYS_CMD_ENABLE)
+    if(!_pktRecCmdAdded)
+    {   // the recorder survives a stack restart; register its command only once
+        _pktRecCmdAdded = SYS_CMD_ADDGRP(_pktRecCmdTbl, sizeof(_pktRecCmdTbl)/sizeof(*_pktRecCmdTbl), "pktrec", ": packet recorder commands");
+    }
+#endif  // defined(SYS_CMD_ENABLE)
+}
+
+#if defined(SYS_CMD_ENABLE)
+// dumps the recorder, oldest record first
+// the format is parsed by the pkt_recorder_decode.py host utility:
+//  "pktrec: 1 <tsFreq> <nEntries> <recCount>"
+//  "pktrec: <hex bytes of up to 4 records>"
+//  ...
+//  "pktrec: end"
+// The raw table is dumped; the decoder validates each record by its sequence number.
+static void _PktRecorderDump(SYS_CMD_DEVICE_NODE* pCmdIO)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+    char lineBuff[8 + 4 * 2 * sizeof(TCPIP_PKT_REC_ENTRY) + 3];
+    const void* cmdIoParam = pCmdIO->cmdIoParam;
+    TCPIP_PKT_REC_INFO recInfo;
+    bool wasStopped = _pktRecStopped;
+
+    // freeze the ring while it's printed
+    _pktRecStopped = true;
+    TCPIP_PKT_RecorderGetInfo(&recInfo);
+
+    uint32_t nRecs = recInfo.recCount < TCPIP_PKT_RECORDER_SIZE ? recInfo.recCount : TCPIP_PKT_RECORDER_SIZE;
+    uint32_t recNo = recInfo.recCount - nRecs;
+
+    (*pCmdIO->pCmdApi->print)(cmdIoParam, "pktrec: 1 %lu %lu %lu\r\n", recInfo.tsFreq, recInfo.nEntries, recInfo.recCount);
+
+    while(nRecs)
+    {
+        char* pLine = lineBuff;
+        int ix;
+
+        strcpy(pLine, "pktrec: ");
+        pLine += 8;
+        for(ix = 0; ix < 4 && nRecs != 0; ix++, nRecs--, recNo++)
+        {
+            const uint8_t* pByte = (const uint8_t*)(_pktRecTbl + (recNo & (TCPIP_PKT_RECORDER_SIZE - 1)));
+            int bIx;
+            for(bIx = 0; bIx < sizeof(TCPIP_PKT_REC_ENTRY); bIx++, pByte++)
+            {
+                *pLine++ = hexDigits[*pByte >> 4];
+                *pLine++ = hexDigits[*pByte & 0x0f];
+            }
+        }
+        strcpy(pLine, "\r\n");
+        (*pCmdIO->pCmdApi->msg)(cmdIoParam, lineBuff);
+    }
+
+    (*pCmdIO->pCmdApi->msg)(cmdIoParam, "pktrec: end\r\n");
+
+    _pktRecStopped = wasStopped;
+}
+
+static int _CommandPktRecorder(SYS_CMD_DEVICE_NODE* pCmdIO, int argc, char** argv)
+{
+    // pktrec <dump|clear|stop|start>
+    const void* cmdIoParam = pCmdIO->cmdIoParam;
+    TCPIP_PKT_REC_INFO recInfo;
+
+    if(argc < 2)
+    {
+        TCPIP_PKT_RecorderGetInfo(&recInfo);
+        (*pCmdIO->pCmdApi->print)(cmdIoParam, "pktrec: %s, %lu records, %lu entries\r\n", recInfo.stopped ? "stopped" : "running", recInfo.recCount, recInfo.nEntries);
+        (*pCmdIO->pCmdApi->msg)(cmdIoParam, "Usage: pktrec <dump|clear|stop|start>\r\n");
+        return false;
+    }
+
+    if(strcmp(argv[1], "dump") == 0)
+    {
+        _PktRecorderDump(pCmdIO);
+    }
+    else if(strcmp(argv[1], "clear") == 0)
+    {
+        TCPIP_PKT_RecorderSet(!_pktRecStopped, true);
+    }
+    else if(strcmp(argv[1], "stop") == 0)
+    {
+        TCPIP_PKT_RecorderSet(false, false);
+    }
+    else if(strcmp(argv[1], "start") == 0)
+    {
+        TCPIP_PKT_RecorderSet(true, false);
+    }
+    else
+    {
+        (*pCmdIO->pCmdApi->msg)(cmdIoParam, "Usage: pktrec <dump|clear|stop|start>\r\n");
+        return false;
+    }
+
+    return true;
+}
+#endif  // defined(SYS_CMD_ENABLE)
 
+#endif  // (TCPIP_PACKET_RECORDER_ENABLE)
 
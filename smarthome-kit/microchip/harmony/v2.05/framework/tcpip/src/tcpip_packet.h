@@ -176,6 +176,47 @@ typedef struct
 
 }TCPIP_PKT_LOG_INFO;
 
+// binary packet recorder
+// only if TCPIP_PACKET_RECORDER_ENABLE is enabled
+//
+// Unlike the flight log above, the recorder does no searching and no formatting:
+// each event claims the next slot of a power of 2 ring and stores a fixed size record.
+// It is meant to stay enabled in production builds.
+// The ring is dumped in hex over the console ("pktrec dump") and decoded on the host
+// by the pkt_recorder_decode.py host utility.
+
+// recorded events
+typedef enum
+{
+    TCPIP_PKT_REC_EVENT_NONE        = 0,    // unused slot
+    TCPIP_PKT_REC_EVENT_ALLOC,              // packet allocated
+    TCPIP_PKT_REC_EVENT_FREE,               // packet freed
+    TCPIP_PKT_REC_EVENT_RX,                 // packet received by a module
+    TCPIP_PKT_REC_EVENT_TX,                 // packet handed to a module for transmission
+    TCPIP_PKT_REC_EVENT_ACK,                // packet acknowledged; arg is the TCPIP_MAC_PKT_ACK_RES
+}TCPIP_PKT_REC_EVENT;
+
+// recorder entry; 16 bytes, little endian, this layout is the dump format (version 1)
+typedef struct
+{
+    uint32_t    timeStamp;      // core timer count when the event was recorded
+    uint32_t    pktId;          // packet address; identifies the packet through its lifetime
+    uint16_t    moduleId;       // TCPIP_STACK_MODULE making the record; 0 if not known
+    uint16_t    pktLen;         // length of the packet 1st segment
+    uint8_t     event;          // TCPIP_PKT_REC_EVENT
+    int8_t      arg;            // event specific: ack result, socket number
+    uint16_t    seq;            // low 16 bits of the record number; written last
+}TCPIP_PKT_REC_ENTRY;
+
+// recorder info
+typedef struct
+{
+    uint32_t    nEntries;       // size of the recorder ring
+    uint32_t    recCount;       // total number of records made since the last clear
+    uint32_t    tsFreq;         // frequency of the timeStamp counter, Hz
+    bool        stopped;        // recording is currently stopped
+}TCPIP_PKT_REC_INFO;
+
 // Extra TX/RX packet flags
 // NOTE: // 16 bits only packet flags!
 
@@ -441,6 +482,32 @@ bool    TCPIP_PKT_FlightLogTypeSet(TCPIP_PKT_LOG_TYPE logType, bool clrPersist);
 // if clrPersist is true, it clears persistent entries too
 void    TCPIP_PKT_FlightLogClear(bool clrPersist);
 
+#if (TCPIP_PACKET_RECORDER_ENABLE)
+// records a packet event in the binary recorder
+// safe to call from any context, including interrupts
+void    TCPIP_PKT_Record(TCPIP_MAC_PACKET* pPkt, TCPIP_PKT_REC_EVENT event, int moduleId, int arg);
+
+// gets the recorder info
+void    TCPIP_PKT_RecorderGetInfo(TCPIP_PKT_REC_INFO* pRecInfo);
+
+// copies the recorder entry with the index recIx
+// 0 is the oldest record still in the ring
+// returns false if there's no such record
+bool    TCPIP_PKT_RecorderGetEntry(int recIx, TCPIP_PKT_REC_ENTRY* pRec);
+
+// starts/stops the recording
+// if clear is true, all records are discarded
+void    TCPIP_PKT_RecorderSet(bool run, bool clear);
+
+// registers the recorder console command
+// called by TCPIP_PKT_Initialize; a system that records packets
+// without running the TCP/IP stack calls it at initialization
+// may be called more than once
+void    TCPIP_PKT_RecorderInitialize(void);
+#else
+#define TCPIP_PKT_Record(pPkt, event, moduleId, arg)
+#endif  // (TCPIP_PACKET_RECORDER_ENABLE)
+
 #if defined(TCPIP_PACKET_ALLOCATION_TRACE_ENABLE)
 
 // proto
@@ -515,13 +582,14 @@ static __inline__ bool __attribute__((always_inline)) TCPIP_PKT_TraceGetEntrySta
 
 #if !(TCPIP_PACKET_LOG_ENABLE)
 
-#define TCPIP_PKT_FlightLogTx(pPkt, moduleId)
+// with the log disabled, the TX/RX log points still feed the binary recorder
+#define TCPIP_PKT_FlightLogTx(pPkt, moduleId)   TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_TX, moduleId, 0)
 
-#define TCPIP_PKT_FlightLogRx(pPkt, moduleId)
+#define TCPIP_PKT_FlightLogRx(pPkt, moduleId)   TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_RX, moduleId, 0)
 
-#define TCPIP_PKT_FlightLogTxSkt(pPkt, moduleId, lclRemPort, sktNo )
+#define TCPIP_PKT_FlightLogTxSkt(pPkt, moduleId, lclRemPort, sktNo )    TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_TX, moduleId, sktNo)
 
-#define TCPIP_PKT_FlightLogRxSkt(pPkt, moduleId, lclRemPort, sktNo )
+#define TCPIP_PKT_FlightLogRxSkt(pPkt, moduleId, lclRemPort, sktNo )    TCPIP_PKT_Record(pPkt, TCPIP_PKT_REC_EVENT_RX, moduleId, sktNo)
 
 #define TCPIP_PKT_FlightLogAcknowledge(pPkt, moduleId, ackRes)
 
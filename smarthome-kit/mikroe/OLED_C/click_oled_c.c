@@ -12,7 +12,7 @@
  ------------------------------------------------------------------------------
 
 - Global Library Prefix : OLEDC
-- Version               : 1.1.0
+- Version               : 1.3.0
 - Date                  : Dec 2018.
 - Developer             : Milos Vidojevic
     
@@ -20,6 +20,8 @@
 
 - 1.0.0 : Module created (Milos Vidojevic)
 - 1.1.0 : RTOS support implemented (Milos Vidojevic)
+- 1.2.0 : Transfers use asynchronous HAL, rows of a rectangle are queued at once
+- 1.3.0 : Window set and rows of a rectangle are sent as one chained SPI job
 
 ----------------------------------------------------------------------------- */
 
@@ -30,12 +32,19 @@
 /* ------------------------------------------------------------------- MACROS */
 
 /*  
-    Use this macro to enable partial screen update which slightly improves 
-    display performances.
+    Use this macro to enable partial screen update. Drawing functions record
+    damaged rectangles and task function sends only those rectangles using 
+    column and row address windows. Without it whole screen is sent on each 
+    change.
+*/
+#define _OLEDC_PARTIAL_SCREEN_UPDATE
 
-    !! NOT SUPPORTED IN CURRENT VERSION
+/*
+    Use this macro to send the frame buffer to the display as one chained, 
+    DMA backed SPI driver job instead of one driver job per pixel. The SPI 
+    driver splits the job into DRV_SPI_DMA_TXFER_SIZE descriptors on its own.
 */
-//#define _OLEDC_PARTIAL_SCREEN_UPDATE
+#define _OLEDC_DMA_FRAME_TRANSFER
 
 //  OLED REMAMP SET
 
@@ -61,6 +70,28 @@
 #define _OLEDC_SCRN_X_OFFSET            0x10
 #define _OLEDC_SCRN_Y_OFFSET            0x00
 
+//  Frame Transfer
+
+#define _OLEDC_CORE_TMR_PER_US          (SYS_CLK_FREQ / 2 / 1000000)
+#define _OLEDC_STATS_PERIOD             (1000 / portTICK_PERIOD_MS)
+
+//  Partial Screen Update
+
+#define _OLEDC_DIRTY_RECTS              8
+#define _OLEDC_WINDOW_COST              16
+#define _OLEDC_WINDOW_BYTES             7
+
+//  Rows sent in one chip select window, bus may be yielded between windows.
+
+#define _OLEDC_BAND_ROWS                16
+
+//  Chained job of a band : column, row and RAM write commands with arguments, 
+//  then one segment per row.
+
+#define _OLEDC_CHAIN_HEAD               5
+#define _OLEDC_CHAIN_SIZE               (_OLEDC_CHAIN_HEAD + _OLEDC_BAND_ROWS)
+#define _OLEDC_DC_KEEP                  0xFF
+
 //  SSD1355 Commands
 
 #define _OLEDC_SET_COL_ADDRESS          0x15
@@ -98,12 +129,31 @@
 
 /* ---------------------------------------------------------------- VARIABLES */
 
+typedef struct
+{
+    uint8_t xs;
+    uint8_t ys;
+    uint8_t xf;
+    uint8_t yf;
+
+}T_OLEDC_RECT;
+
 static uint8_t color_p[2];
-static uint8_t bound_x[2];
-static uint8_t bound_y[2];
 
-static uint8_t frame_update;
-static uint8_t frame_buffer[_OLEDC_SCRN_SIZE * 2];
+static T_OLEDC_RECT dirty[_OLEDC_DIRTY_RECTS];
+static uint8_t      dirty_cnt;
+
+static uint8_t frame_buffer[_OLEDC_SCRN_SIZE * 2] __attribute__((aligned(16)));
+
+#ifdef _OLEDC_DMA_FRAME_TRANSFER
+static DRV_SPI_BUFFER_SEGMENT rect_chain[_OLEDC_CHAIN_SIZE];
+#endif
+
+static T_OLEDC_YIELD        yield_cb;
+
+static T_OLEDC_STATS        frame_stats;
+static uint32_t             frame_stats_cnt;
+static TickType_t           frame_stats_tick;
 
 /* --------------------------------------------- PRIVATE FUNCTION DEFINITIONS */
 
@@ -121,6 +171,25 @@ static uint8_t get_font_height(const uint8_t* font);
 
 static uint8_t get_font_bitmap(const uint8_t* font, uint8_t ch, uint8_t* map);
 
+static void mark_dirty(uint8_t xs, uint8_t ys, uint8_t xf, uint8_t yf);
+
+static uint16_t rect_area(const T_OLEDC_RECT *rect);
+
+static void rect_union(const T_OLEDC_RECT *a, const T_OLEDC_RECT *b, 
+            T_OLEDC_RECT *u);
+
+#ifdef _OLEDC_DMA_FRAME_TRANSFER
+static void dc_set(DRV_SPI_BUFFER_EVENT event, DRV_SPI_BUFFER_HANDLE handle, 
+            void *context);
+
+static void chain_set(DRV_SPI_BUFFER_SEGMENT *seg, uint8_t *p_buf, 
+            uint16_t n_bytes, uint8_t dc);
+#endif
+
+static int send_rect(const T_OLEDC_RECT *rect);
+
+static void update_stats(uint32_t hold_start, uint32_t n_bytes, int err);
+
 /* --------------------------------------------------------- PUBLIC FUNCTIONS */
 
 #ifdef   __OLEDC_DRV_SPI__
@@ -187,7 +256,10 @@ void oledc_command(uint8_t command, uint8_t *p_args, uint16_t n_args)
     hal_gpio_pwmSet(0);
     hal_spiWrite(&command, 1);
     hal_gpio_pwmSet(1);
-    hal_spiWrite(p_args, n_args);
+    if (n_args != 0)
+    {
+        hal_spiWrite(p_args, n_args);
+    }
     hal_gpio_csSet(1);
     hal_gpio_pwmSet(0);
 }
@@ -241,26 +313,8 @@ void oledc_configure()
 
     memset(frame_buffer, 0, _OLEDC_SCRN_SIZE * 2);
 
-#ifdef _OLEDC_PARTIAL_SCREEN_UPDATE
-
-    update_x_bound(0);
-    update_x_bound(_OLEDC_SCRN_X_MAX);
-    update_y_bound(0);
-    update_y_bound(_OLEDC_SCRN_Y_MAX);
-
-#endif
-
-    //  Adjust RAM and local variables to fit display resolution.
-
-    bound_x[0] += _OLEDC_SCRN_X_OFFSET; 
-    bound_x[1] += _OLEDC_SCRN_X_MAX + _OLEDC_SCRN_X_OFFSET;
-    bound_y[0] += _OLEDC_SCRN_Y_OFFSET;
-    bound_y[1] += _OLEDC_SCRN_Y_MAX + _OLEDC_SCRN_Y_OFFSET;
-
-    oledc_command(_OLEDC_SET_COL_ADDRESS, bound_x, 2);
-    oledc_command(_OLEDC_SET_ROW_ADDRESS, bound_y, 2);
-
-    frame_update = 1;
+    dirty_cnt = 0;
+    mark_dirty(0, 0, _OLEDC_SCRN_X_MAX, _OLEDC_SCRN_Y_MAX);
 }
 
 void oledc_set_pen_color(uint16_t rgb)
@@ -299,7 +353,7 @@ int oledc_draw_field(uint8_t xs, uint8_t ys, uint8_t xf, uint8_t yf)
 
     //  Schedule screen update from task.
 
-    frame_update = 1;
+    mark_dirty(xs, ys, xf, yf);
 
     return OLEDC_OK;
 }
@@ -324,6 +378,11 @@ int oledc_draw_line(uint8_t xs, uint8_t ys, uint8_t xf, uint8_t yf)
         return OLEDC_ERR;
     }
 
+    //  Schedule screen update from task.
+
+    mark_dirty((xs < xf) ? xs : xf, (ys < yf) ? ys : yf, 
+               (xs < xf) ? xf : xs, (ys < yf) ? yf : ys);
+
     if (xs > xf) { dx = xs - xf; }
     else         { dx = xf - xs; }
 
@@ -373,10 +432,6 @@ int oledc_draw_line(uint8_t xs, uint8_t ys, uint8_t xf, uint8_t yf)
         }
     }
 
-    //  Schedule screen update from task.
-
-    frame_update = 1;
-
     return OLEDC_OK;
 }
 
@@ -453,7 +508,7 @@ int oledc_image(const uint8_t* img, uint8_t xs, uint8_t ys)
 
     //  Schedule screen update from task.
 
-    frame_update = 1;
+    mark_dirty(xs, ys, xs + img[2] - 1, ys + img[4] - 1);
 
     return OLEDC_OK;
 }
@@ -507,7 +562,7 @@ int oledc_draw_bitmap_c(const uint8_t *bitmap,
     
     //  Schedule screen update from task.
 
-    frame_update = 1;
+    mark_dirty(xs, ys, xf, yf);
 
     return OLEDC_OK;
 }
@@ -562,7 +617,7 @@ int oledc_draw_bitmap(uint8_t *bitmap,
     
     //  Schedule screen update from task.
 
-    frame_update = 1;
+    mark_dirty(xs, ys, xf, yf);
 
     return OLEDC_OK;
 }
@@ -614,58 +669,86 @@ int oledc_text(const uint8_t *font, unsigned char *text, uint8_t xs, uint8_t ys)
     return OLEDC_OK;
 }
 
-void oledc_task()
+int oledc_task()
 {
-    uint16_t i;
-    uint8_t cmd = _OLEDC_WRITE_RAM;
+    uint8_t      i;
+    uint8_t      j;
+    uint32_t     hold_start;
+    uint32_t     n_bytes;
+    T_OLEDC_RECT band;
+    int          err = OLEDC_OK;
+
+    if (dirty_cnt == 0)
+    {
+        return OLEDC_OK;
+    }
 
-#ifdef _OLEDC_PARTIAL_SCREEN_UPDATE
+    hold_start = _CP0_GET_COUNT();
+    n_bytes = 0;
+    i = 0;
 
-    //  Adjust bounds according to offset.
+    while ((i < dirty_cnt) && (err == OLEDC_OK))
+    {
+        band = dirty[i];
 
-    bound_x[0] += _OLEDC_SCRN_X_OFFSET; 
-    bound_x[1] += _OLEDC_SCRN_X_OFFSET;
-    bound_y[0] += _OLEDC_SCRN_Y_OFFSET;
-    bound_y[1] += _OLEDC_SCRN_Y_OFFSET;
+        if ((band.yf - band.ys) >= _OLEDC_BAND_ROWS)
+        {
+            band.yf = band.ys + _OLEDC_BAND_ROWS - 1;
+        }
 
-    oledc_command(_OLEDC_SET_COL_ADDRESS, bound_x, 2);
-    oledc_command(_OLEDC_SET_ROW_ADDRESS, bound_y, 2);
+        err = send_rect(&band);
 
-#endif
+        if (err != OLEDC_OK)
+        {
+            break;
+        }
 
-    if (frame_update != 0)
-    {
-        hal_gpio_csSet(0);
-        hal_gpio_pwmSet(0);
-        hal_spiWrite(&cmd, 1);
-        hal_gpio_pwmSet(1);
-        
-        
-        /*
-            ! IMPROVEMENT :
+        n_bytes += _OLEDC_WINDOW_BYTES + (rect_area(&band) * 2);
 
-            For maximal performances populate whole SPI buffer on each loop. 
-            Number of loops should be adjusted to be compatible with SPI buffer 
-            size - (_OLEDC_SCRN_SIZE / SPI_BUF_SIZE).
-        */
+        //  Rest of the rectangle stays damaged until it is sent.
 
-        for (i = 0; i < (_OLEDC_SCRN_SIZE * 2); i += 2)
+        if (band.yf == dirty[i].yf)
         {
-            hal_spiWrite(&frame_buffer[i], 2);
+            i++;
         }
-        
-        hal_gpio_csSet(1);
-        hal_gpio_pwmSet(0);
+        else
+        {
+            dirty[i].ys = band.yf + 1;
+        }
+
+        if ((i < dirty_cnt) && (yield_cb != NULL) && (yield_cb() != 0))
+        {
+            err = OLEDC_YIELDED;
+        }
+    }
 
-        //  Reset bound variables.
+    update_stats(hold_start, n_bytes, err);
 
-        bound_x[0] = _OLEDC_SCRN_X_MAX;
-        bound_y[0] = _OLEDC_SCRN_Y_MAX;
-        bound_x[1] = 0;
-        bound_y[1] = 0;
+    //  Drop rectangles which were sent, keep the rest for the next call.
 
-        frame_update = 0;
+    for (j = 0; (i + j) < dirty_cnt; j++)
+    {
+        dirty[j] = dirty[i + j];
     }
+
+    dirty_cnt = j;
+
+    return err;
+}
+
+void oledc_set_yield(T_OLEDC_YIELD yield)
+{
+    yield_cb = yield;
+}
+
+void oledc_get_stats(T_OLEDC_STATS *stats)
+{
+    *stats = frame_stats;
+}
+
+void oledc_get_spi_stats(T_CLICK_SPI_STATS *stats)
+{
+    hal_spiStats(stats);
 }
 
 /* ------------------------------------------ PRIVATE FUNCTION IMPLEMENTATION */
@@ -687,15 +770,6 @@ static int update_x_bound(uint8_t x)
     {
         return 1;
     }
-    else
-    {
-#if _OLEDC_PARTIAL_SCREEN_UPDATE
-
-        if (x < bound_x[0]) { bound_x[0] = x; }
-        if (x > bound_x[1]) { bound_x[1] = x; }
-
-#endif
-    }
 
     return 0;
 }
@@ -706,17 +780,277 @@ static int update_y_bound(uint8_t y)
     {
         return 1;
     }
+    
+    return 0;    
+}
+
+static void mark_dirty(uint8_t xs, uint8_t ys, uint8_t xf, uint8_t yf)
+{
+    T_OLEDC_RECT    rect;
+    T_OLEDC_RECT    tmp;
+    uint8_t         i;
+    uint8_t         best;
+    uint16_t        cost;
+    uint16_t        best_cost;
+    uint8_t         merged;
+
+#ifndef _OLEDC_PARTIAL_SCREEN_UPDATE
+
+    //  Whole screen is sent on each change.
+
+    xs = 0;
+    ys = 0;
+    xf = _OLEDC_SCRN_X_MAX;
+    yf = _OLEDC_SCRN_Y_MAX;
+
+#endif
+
+    rect.xs = xs;
+    rect.ys = ys;
+    rect.xf = xf;
+    rect.yf = yf;
+
+    /*
+        Absorb every recorded rectangle which is cheaper to send together 
+        with the new one than through its own address window. Union may grow
+        into other rectangles so list is scanned again after each merge.
+    */
+
+    do
+    {
+        merged = 0;
+
+        for (i = 0; i < dirty_cnt; i++)
+        {
+            rect_union(&rect, &dirty[i], &tmp);
+
+            if (rect_area(&tmp) <= rect_area(&rect) + rect_area(&dirty[i]) + 
+                        _OLEDC_WINDOW_COST)
+            {
+                rect = tmp;
+                dirty[i] = dirty[--dirty_cnt];
+                merged = 1;
+
+                break;
+            }
+        }
+
+        //  List is full - merge with rectangle which grows the least.
+
+        if ((merged == 0) && (dirty_cnt == _OLEDC_DIRTY_RECTS))
+        {
+            best = 0;
+            best_cost = 0xFFFF;
+
+            for (i = 0; i < dirty_cnt; i++)
+            {
+                rect_union(&rect, &dirty[i], &tmp);
+                cost = rect_area(&tmp) - rect_area(&dirty[i]);
+
+                if (cost < best_cost)
+                {
+                    best_cost = cost;
+                    best = i;
+                }
+            }
+
+            rect_union(&rect, &dirty[best], &rect);
+            dirty[best] = dirty[--dirty_cnt];
+            merged = 1;
+        }
+
+    } while (merged != 0);
+
+    dirty[dirty_cnt++] = rect;
+}
+
+static uint16_t rect_area(const T_OLEDC_RECT *rect)
+{
+    return (uint16_t)(rect->xf - rect->xs + 1) * (rect->yf - rect->ys + 1);
+}
+
+static void rect_union(const T_OLEDC_RECT *a, const T_OLEDC_RECT *b, 
+            T_OLEDC_RECT *u)
+{
+    u->xs = (a->xs < b->xs) ? a->xs : b->xs;
+    u->ys = (a->ys < b->ys) ? a->ys : b->ys;
+    u->xf = (a->xf > b->xf) ? a->xf : b->xf;
+    u->yf = (a->yf > b->yf) ? a->yf : b->yf;
+}
+
+#ifdef _OLEDC_DMA_FRAME_TRANSFER
+static void dc_set(DRV_SPI_BUFFER_EVENT event, DRV_SPI_BUFFER_HANDLE handle, 
+            void *context)
+{
+    //  Called from the SPI interrupt, previous segment has left the shifter.
+
+    hal_gpio_pwmSet((uintptr_t)context != 0);
+}
+
+static void chain_set(DRV_SPI_BUFFER_SEGMENT *seg, uint8_t *p_buf, 
+            uint16_t n_bytes, uint8_t dc)
+{
+    seg->txBuffer = p_buf;
+    seg->rxBuffer = NULL;
+    seg->size = n_bytes;
+    seg->segmentStart = (dc == _OLEDC_DC_KEEP) ? NULL : dc_set;
+    seg->context = (void*)(uintptr_t)dc;
+}
+#endif
+
+static int send_rect(const T_OLEDC_RECT *rect)
+{
+    uint8_t         y;
+    uint16_t        n_row;
+    int             err = OLEDC_OK;
+#ifdef _OLEDC_DMA_FRAME_TRANSFER
+    //  Read by the driver together with rect_chain.
+    static uint8_t  col[2];
+    static uint8_t  row[2];
+    static uint8_t  cmd[3] = { _OLEDC_SET_COL_ADDRESS, _OLEDC_SET_ROW_ADDRESS, 
+                               _OLEDC_WRITE_RAM };
+    uint8_t         n_seg;
+
+    //  Job a wait gave up on still reads rect_chain and the window bytes.
+
+    if (hal_spiWait() != 0)
+    {
+        return OLEDC_ERR;
+    }
+#else
+    uint8_t         col[2];
+    uint8_t         row[2];
+    uint8_t         cmd = _OLEDC_WRITE_RAM;
+    uint16_t        i;
+#endif
+
+    //  Set RAM window to the rectangle, adjusted by display offset.
+
+    col[0] = rect->xs + _OLEDC_SCRN_X_OFFSET;
+    col[1] = rect->xf + _OLEDC_SCRN_X_OFFSET;
+    row[0] = rect->ys + _OLEDC_SCRN_Y_OFFSET;
+    row[1] = rect->yf + _OLEDC_SCRN_Y_OFFSET;
+
+    n_row = (rect->xf - rect->xs + 1) * 2;
+
+#ifdef _OLEDC_DMA_FRAME_TRANSFER
+
+    /*
+        Window set, RAM write command and pixel rows are one SPI driver job, 
+        the driver switches segments inside its interrupt and D/C follows 
+        from the segment hooks. Chip select may be released only when the 
+        whole job is done. Band never has more rows than the chain has room.
+    */
+
+    chain_set(&rect_chain[0], &cmd[0], 1, 0);
+    chain_set(&rect_chain[1], col, 2, 1);
+    chain_set(&rect_chain[2], &cmd[1], 1, 0);
+    chain_set(&rect_chain[3], row, 2, 1);
+    chain_set(&rect_chain[4], &cmd[2], 1, 0);
+    n_seg = _OLEDC_CHAIN_HEAD;
+
+    if (n_row == (_OLEDC_SCRN_X_MAX + 1) * 2)
+    {
+        //  Full width rows are contiguous inside frame buffer.
+
+        chain_set(&rect_chain[n_seg++], &frame_buffer[rect->ys * n_row], 
+                    n_row * (rect->yf - rect->ys + 1), 1);
+    }
     else
     {
-#if _OLEDC_PARTIAL_SCREEN_UPDATE
+        for (y = rect->ys; (y <= rect->yf) && (n_seg < _OLEDC_CHAIN_SIZE); 
+                    y++)
+        {
+            //  D/C is already high for the rows after the first one.
+
+            chain_set(&rect_chain[n_seg], 
+                        &frame_buffer[(y * 96 + rect->xs) * 2], n_row, 
+                        (n_seg == _OLEDC_CHAIN_HEAD) ? 1 : _OLEDC_DC_KEEP);
+            n_seg++;
+        }
+    }
+
+    hal_gpio_csSet(0);
+
+    if (hal_spiChainStart(rect_chain, n_seg) || hal_spiWait())
+    {
+        err = OLEDC_ERR;
+    }
+
+#else
+
+    oledc_command(_OLEDC_SET_COL_ADDRESS, col, 2);
+    oledc_command(_OLEDC_SET_ROW_ADDRESS, row, 2);
+
+    hal_gpio_csSet(0);
+    hal_gpio_pwmSet(0);
+
+    hal_spiWrite(&cmd, 1);
+    hal_gpio_pwmSet(1);
 
-        if (y < bound_y[0]) { bound_y[0] = y; }
-        if (y > bound_y[1]) { bound_y[1] = y; }
+    for (y = rect->ys; y <= rect->yf; y++)
+    {
+        for (i = 0; i < n_row; i += 2)
+        {
+            hal_spiWrite(&frame_buffer[((y * 96 + rect->xs) * 2) + i], 2);
+        }
+    }
 
 #endif
+
+    hal_gpio_csSet(1);
+    hal_gpio_pwmSet(0);
+
+    return err;
+}
+
+static void update_stats(uint32_t hold_start, uint32_t n_bytes, int err)
+{
+    uint32_t    hold_us;
+    TickType_t  now;
+
+    //  Core timer runs at half of the system clock.
+
+    hold_us = (_CP0_GET_COUNT() - hold_start) / _OLEDC_CORE_TMR_PER_US;
+
+    //  Bands sent before the update stopped were transferred too.
+
+    frame_stats.bytes_total += n_bytes;
+
+    if (err == OLEDC_YIELDED)
+    {
+        frame_stats.bus_lost++;
+
+        return;
+    }
+
+    if (err != OLEDC_OK)
+    {
+        frame_stats.errors++;
+
+        return;
+    }
+
+    frame_stats.frames++;
+    frame_stats.bus_hold_us = hold_us;
+    frame_stats.bytes_last = n_bytes;
+
+    if (hold_us > frame_stats.bus_hold_max_us)
+    {
+        frame_stats.bus_hold_max_us = hold_us;
+    }
+
+    //  Frames per second are latched once per statistics period.
+
+    frame_stats_cnt++;
+    now = xTaskGetTickCount();
+
+    if ((now - frame_stats_tick) >= _OLEDC_STATS_PERIOD)
+    {
+        frame_stats.fps = frame_stats_cnt;
+        frame_stats_cnt = 0;
+        frame_stats_tick = now;
     }
-    
-    return 0;    
 }
 
 static uint8_t get_font_first_char(const uint8_t* font)
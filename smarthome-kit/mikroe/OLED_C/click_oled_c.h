@@ -41,6 +41,7 @@ Driver carries additional graphic functions.
 #define _OLEDC_H_
 
 #include <stdint.h>
+#include "../click_spi_stats.h"
 
 #define __OLEDC_DRV_SPI__           ///< \macro __OLEDC_DRV_SPI__  \brief SPI driver selector.
 // #define __OLEDC_DRV_I2C__        ///< \macro __OLEDC_DRV_I2C__  \brief I2C driver selector.
@@ -50,6 +51,37 @@ Driver carries additional graphic functions.
 
 #define OLEDC_ERR       1           ///< \macro OLEDC_ERR \brief Return value error.
 #define OLEDC_OK        0           ///< \macro OLEDC_OK  \brief Return value OK.
+#define OLEDC_YIELDED   2           ///< \macro OLEDC_YIELDED \brief Return value bus not given back after yield.
+
+/**
+ * \brief OLED C Frame Transfer Statistics
+ *
+ * Bus hold time is measured from chip select assertion until the last byte
+ * of the update leaves the SPI peripheral, time the bus was yielded to other
+ * devices included. Byte counters include address window commands sent for 
+ * each band of damaged rectangle.
+ */
+typedef struct
+{
+    uint32_t frames;            ///< Frames sent to the display.
+    uint32_t fps;               ///< Frames sent during the last second.
+    uint32_t bus_hold_us;       ///< Bus hold time of the last frame.
+    uint32_t bus_hold_max_us;   ///< Longest bus hold time so far.
+    uint32_t errors;            ///< Failed or timed out frame transfers.
+    uint32_t bus_lost;          ///< Updates cut short by a yield, resent later.
+    uint32_t bytes_last;        ///< Bytes sent by the last update.
+    uint32_t bytes_total;       ///< Bytes sent since start.
+
+}T_OLEDC_STATS;
+
+/**
+ * \brief OLED C Bus Yield Callback
+ *
+ * Called by task function between two chip select windows of one update, 
+ * while the bus is free for other devices. Returning non zero value aborts 
+ * the update, content which was not sent is kept for the next call.
+ */
+typedef int (*T_OLEDC_YIELD)(void);
 
 #ifdef __cplusplus
 extern "C"{
@@ -115,10 +147,41 @@ void oledc_command(uint8_t command, uint8_t *args, uint16_t args_len);
  *
  * Funcion sending content of frame buffer to the device.
  *
+ * \return OLEDC_OK if whole update was sent, OLEDC_YIELDED if bus was not 
+ * given back after a yield, OLEDC_ERR otherwise
+ *
  * \note 
  * Function should be placed inside infinite loop in case of bare metal apps.
  */
-void oledc_task();
+int oledc_task();
+
+/**
+ * \brief OLED C Set Bus Yield Callback
+ *
+ * \param[in] yield     callback, NULL to disable
+ *
+ * Damaged rectangles are sent in bands of rows and callback is called 
+ * between bands.
+ */
+void oledc_set_yield(T_OLEDC_YIELD yield);
+
+/**
+ * \brief OLED C Get Statistics
+ *
+ * \param[out] stats frame transfer statistics
+ *
+ * Function copies frame transfer statistics collected by task function.
+ */
+void oledc_get_stats(T_OLEDC_STATS *stats);
+
+/**
+ * \brief OLED C Get SPI Statistics
+ *
+ * \param[out] stats SPI jobs and time spent waiting for them
+ *
+ * Function copies SPI HAL statistics of the display driver.
+ */
+void oledc_get_spi_stats(T_CLICK_SPI_STATS *stats);
 
 /**
  * \brief OLED C Set Pen Color
@@ -176,6 +176,11 @@ void rotary_disable()
     hal_gpio_rstSet(0);
 }
 
+void rotary_get_spi_stats(T_CLICK_SPI_STATS *stats)
+{
+    hal_spiStats(stats);
+}
+
 /* -------------------------------------------------------------------------- */
 /*
     Rotary_click.c
@@ -32,6 +32,7 @@
 /* -------------------------------------------------------------------------- */
 
 #include <stdint.h>
+#include "../click_spi_stats.h"
 
 #ifndef _ROTARY_H_
 #define _ROTARY_H_
@@ -77,6 +78,8 @@ void rotary_enable ( void );
 
 void rotary_disable ( void );
 
+void rotary_get_spi_stats ( T_CLICK_SPI_STATS *stats );
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -505,6 +505,7 @@ static void hal_gpioMap(T_HAL_P gpioObj)
 // ---------------------------------------------------- MPLAB PIC32 HARMONY HAL 
 
 #ifdef __XC_H
+#define _HAL_SPI_DMA    0       // SPI driver instance 1 has no DMA channels
 #include "../click_common.h"
 #endif
 
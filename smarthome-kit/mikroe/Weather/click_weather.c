@@ -29,14 +29,25 @@
 
 /* ------------------------------------------------------------------- MACROS */
 
+//  First register of each calibration block.
 
+#define _WEATHER_CALIB_PT_START_REG     _WEATHER_TEMPERATURE_CALIB_DIG_T1_LSB_REG
+#define _WEATHER_CALIB_H_START_REG      _WEATHER_HUMIDITY_CALIB_DIG_H2_LSB_REG
+
+//  Trim words are stored little endian.
+
+#define _WEATHER_CALIB_U16(b, lsb)      ((uint16_t)(b)[lsb] | ((uint16_t)(b)[(lsb) + 1] << 8))
+
+//  Address / value pairs sent in a single SPI transfer, bounds stack usage.
+
+#define _WEATHER_BURST_MAX_PAIRS        8
 
 /* ---------------------------------------------------------------- VARIABLES */
 
 static uint32_t adc_t;
 static uint32_t adc_p;
 static uint32_t adc_h;
-static uint32_t t_fine;
+static int32_t  t_fine;
 
 static uint16_t dig_T1;
 static int16_t  dig_T2;
@@ -59,19 +70,36 @@ static int16_t  dig_P7;
 static int16_t  dig_P8;
 static int16_t  dig_P9;
 
+//  Trim parameters are read once, they never change.
+
+static uint8_t  calib_valid;
+
+//  SPI bytes transferred in total and by the last sample.
+
+static uint32_t spi_bytes;
+static uint32_t sample_bytes;
+
 /* -------------------------------------------- PRIVATE FUNCTION DECLARATIONS */
 
-//  Read single register
+//  Read single register, returns non zero if the transfer failed
 
-static void read_register(uint8_t reg, uint8_t *buf, uint8_t len);
+static int read_register(uint8_t reg, uint8_t *buf, uint8_t len);
 
 //  Write register
 
 static void write_register(uint8_t reg, uint8_t *buf, uint8_t len);
 
-//  Read 16bit register
+//  Write address / value pairs in a single chip select window
+
+static void write_pairs(const T_WEATHER_REG *regs, uint8_t count);
+
+//  Pack address / value pairs into SPI write stream, returns stream length
+
+static uint8_t pack_pairs(uint8_t *out, const T_WEATHER_REG *regs, uint8_t count);
+
+//  Read measurement data, calibration is read only if not cached
 
-static uint16_t read_16bit_reg(uint8_t reg);
+static void read_sample();
 
 //  Compensate temperature function
 
@@ -140,9 +168,34 @@ void weather_writeData(uint8_t regAddress, uint8_t writeData)
     write_register(regAddress, &writeData, 1);
 }
 
+void weather_writeRegisters(const T_WEATHER_REG *regs, uint8_t count)
+{
+    write_pairs(regs, count);
+}
+
+void weather_configure(uint8_t standby, uint8_t filter, uint8_t osrsT,
+                       uint8_t osrsH, uint8_t osrsP, uint8_t mode)
+{
+    T_WEATHER_REG regs[3];
+
+    //  Humidity oversampling takes effect only after CTRL_MEAS is written.
+
+    regs[0].address = _WEATHER_CTRL_HUMIDITY_REG;
+    regs[0].value   = osrsH;
+    regs[1].address = _WEATHER_CONFIG_REG;
+    regs[1].value   = (standby << _WEATHER_CONFIG_REG_TSB_POS) |
+                      (filter << _WEATHER_CONFIG_REG_FILTER_POS);
+    regs[2].address = _WEATHER_CTRL_MEAS_REG;
+    regs[2].value   = (osrsT << _WEATHER_CTRL_MEAS_REG_OVERSAMP_TEMPERATURE_POS) |
+                      (osrsP << _WEATHER_CTRL_MEAS_REG_OVERSAMP_PRESSURE_POS) |
+                      mode;
+
+    write_pairs(regs, 3);
+}
+
 uint8_t weather_readData(uint8_t regAddress)
 {
-    uint8_t res;
+    uint8_t res = 0;
 
     read_register(regAddress, &res, 1);
 
@@ -153,7 +206,12 @@ void weather_readMeasurements()
 {
     uint8_t rBuffer[ 8 ];
 
-    read_register(_WEATHER_PRESSURE_MSB_REG, rBuffer, 8);
+    //  Failed read keeps the previous sample.
+
+    if (read_register(_WEATHER_PRESSURE_MSB_REG, rBuffer, 8) != 0)
+    {
+        return;
+    }
 
     adc_h  = (uint32_t)rBuffer[_WEATHER_DATA_FRAME_HUMIDITY_LSB_BYTE];
     adc_h |= (uint32_t)rBuffer[_WEATHER_DATA_FRAME_HUMIDITY_MSB_BYTE] << 8;
@@ -169,30 +227,46 @@ void weather_readMeasurements()
 
 void weather_readCalibrationParams()
 {
-    dig_T1 = read_16bit_reg(_WEATHER_TEMPERATURE_CALIB_DIG_T1_MSB_REG);
-    dig_T2 = read_16bit_reg(_WEATHER_TEMPERATURE_CALIB_DIG_T2_MSB_REG);
-    dig_T3 = read_16bit_reg(_WEATHER_TEMPERATURE_CALIB_DIG_T3_MSB_REG);
-
-    dig_P1 = read_16bit_reg(_WEATHER_PRESSURE_CALIB_DIG_P1_MSB_REG);
-    dig_P2 = read_16bit_reg(_WEATHER_PRESSURE_CALIB_DIG_P2_MSB_REG);
-    dig_P3 = read_16bit_reg(_WEATHER_PRESSURE_CALIB_DIG_P3_MSB_REG);
-    dig_P4 = read_16bit_reg(_WEATHER_PRESSURE_CALIB_DIG_P4_MSB_REG);
-    dig_P5 = read_16bit_reg(_WEATHER_PRESSURE_CALIB_DIG_P5_MSB_REG);
-    dig_P6 = read_16bit_reg(_WEATHER_PRESSURE_CALIB_DIG_P6_MSB_REG);
-    dig_P7 = read_16bit_reg(_WEATHER_PRESSURE_CALIB_DIG_P7_MSB_REG);
-    dig_P8 = read_16bit_reg(_WEATHER_PRESSURE_CALIB_DIG_P8_MSB_REG);
-    dig_P9 = read_16bit_reg(_WEATHER_PRESSURE_CALIB_DIG_P9_MSB_REG);
-
-    dig_H1 = weather_readData(_WEATHER_HUMIDITY_CALIB_DIG_H1_REG);
-    dig_H2 = read_16bit_reg(_WEATHER_HUMIDITY_CALIB_DIG_H2_MSB_REG);
-    dig_H3 = weather_readData(_WEATHER_HUMIDITY_CALIB_DIG_H3_REG);
-    dig_H4 = weather_readData(_WEATHER_HUMIDITY_CALIB_DIG_H4_MSB_REG);
-    dig_H4 <<= 4;
-    dig_H4 |= (weather_readData(_WEATHER_HUMIDITY_CALIB_DIG_H4_LSB_REG) & 0x0F);
-    dig_H5 = weather_readData(_WEATHER_HUMIDITY_CALIB_DIG_H5_MSB_REG);
-    dig_H5 <<= 4;
-    dig_H5 |= (weather_readData(_WEATHER_HUMIDITY_CALIB_DIG_H5_MSB_REG) >> 4);
-    dig_H6 = weather_readData(_WEATHER_HUMIDITY_CALIB_DIG_H6_REG);
+    uint8_t pt[ _WEATHER_PRESSURE_TEMPERATURE_CALIB_DATA_LENGTH ];
+    uint8_t h[ _WEATHER_HUMIDITY_CALIB_DATA_LENGTH ];
+
+    //  Whole trim area is read with two bursts, 0x88 - 0xA1 and 0xE1 - 0xE7.
+
+    //  Failed read leaves the trim to be read again with the next sample.
+
+    if ((read_register(_WEATHER_CALIB_PT_START_REG, pt, sizeof(pt)) != 0) ||
+        (read_register(_WEATHER_CALIB_H_START_REG, h, sizeof(h)) != 0))
+    {
+        return;
+    }
+
+    dig_T1 = _WEATHER_CALIB_U16(pt, _WEATHER_TEMPERATURE_CALIB_DIG_T1_LSB);
+    dig_T2 = (int16_t)_WEATHER_CALIB_U16(pt, _WEATHER_TEMPERATURE_CALIB_DIG_T2_LSB);
+    dig_T3 = (int16_t)_WEATHER_CALIB_U16(pt, _WEATHER_TEMPERATURE_CALIB_DIG_T3_LSB);
+
+    dig_P1 = _WEATHER_CALIB_U16(pt, _WEATHER_PRESSURE_CALIB_DIG_P1_LSB);
+    dig_P2 = (int16_t)_WEATHER_CALIB_U16(pt, _WEATHER_PRESSURE_CALIB_DIG_P2_LSB);
+    dig_P3 = (int16_t)_WEATHER_CALIB_U16(pt, _WEATHER_PRESSURE_CALIB_DIG_P3_LSB);
+    dig_P4 = (int16_t)_WEATHER_CALIB_U16(pt, _WEATHER_PRESSURE_CALIB_DIG_P4_LSB);
+    dig_P5 = (int16_t)_WEATHER_CALIB_U16(pt, _WEATHER_PRESSURE_CALIB_DIG_P5_LSB);
+    dig_P6 = (int16_t)_WEATHER_CALIB_U16(pt, _WEATHER_PRESSURE_CALIB_DIG_P6_LSB);
+    dig_P7 = (int16_t)_WEATHER_CALIB_U16(pt, _WEATHER_PRESSURE_CALIB_DIG_P7_LSB);
+    dig_P8 = (int16_t)_WEATHER_CALIB_U16(pt, _WEATHER_PRESSURE_CALIB_DIG_P8_LSB);
+    dig_P9 = (int16_t)_WEATHER_CALIB_U16(pt, _WEATHER_PRESSURE_CALIB_DIG_P9_LSB);
+
+    dig_H1 = pt[_WEATHER_HUMIDITY_CALIB_DIG_H1];
+    dig_H2 = (int16_t)_WEATHER_CALIB_U16(h, _WEATHER_HUMIDITY_CALIB_DIG_H2_LSB);
+    dig_H3 = h[_WEATHER_HUMIDITY_CALIB_DIG_H3];
+
+    //  H4 and H5 are 12 bit values sharing the nibbles of 0xE5.
+
+    dig_H4  = (int16_t)((int8_t)h[_WEATHER_HUMIDITY_CALIB_DIG_H4_MSB]) * 16;
+    dig_H4 |= (h[_WEATHER_HUMIDITY_CALIB_DIG_H4_LSB] & 0x0F);
+    dig_H5  = (int16_t)((int8_t)h[_WEATHER_HUMIDITY_CALIB_DIG_H5_MSB]) * 16;
+    dig_H5 |= (h[_WEATHER_HUMIDITY_CALIB_DIG_H4_LSB] >> 4);
+    dig_H6  = (int8_t)h[_WEATHER_HUMIDITY_CALIB_DIG_H6];
+
+    calib_valid = 1;
 }
 
 void weather_setOversamplingPressure( uint8_t value )
@@ -279,9 +353,7 @@ float weather_getTemperature()
     float result;
     int32_t tempVal;
 
-    weather_readMeasurements();
-
-    weather_readCalibrationParams();
+    read_sample();
 
     tempVal =  compensate_T();
 
@@ -294,9 +366,11 @@ float weather_getHumidity()
 {
     uint32_t humVal;
 
-    weather_readMeasurements();
-    weather_readCalibrationParams();
+    read_sample();
 
+    //  Humidity compensation depends on t_fine.
+
+    compensate_T();
     humVal = compensate_H();
     
     return (((float) humVal) / 1024.0);
@@ -307,10 +381,11 @@ float weather_getPressure()
     float result;
     uint32_t pressVal;
 
-    weather_readMeasurements();
+    read_sample();
 
-    weather_readCalibrationParams();
+    //  Pressure compensation depends on t_fine.
 
+    compensate_T();
     pressVal = compensate_P();
 
     result =( ( float ) pressVal ) / 100.0;
@@ -324,7 +399,7 @@ void weather_getWeather(float *temperature, float *humidity, float *pressure)
     uint32_t humVal;
     uint32_t pressVal;
 
-    weather_readMeasurements();
+    read_sample();
     
     tempVal  = compensate_T();
     humVal   = compensate_H();
@@ -335,6 +410,16 @@ void weather_getWeather(float *temperature, float *humidity, float *pressure)
     *pressure = ((float)pressVal) / 100.0;
 }
 
+uint32_t weather_getSampleBytes()
+{
+    return sample_bytes;
+}
+
+void weather_getSpiStats(T_CLICK_SPI_STATS *stats)
+{
+    hal_spiStats(stats);
+}
+
 uint8_t weather_getID()
 {
     uint8_t idVal;
@@ -389,49 +474,89 @@ uint8_t weather_getConfig()
 
 static void write_register(uint8_t reg, uint8_t *buf, uint8_t len)
 {
+    T_WEATHER_REG regs[_WEATHER_BURST_MAX_PAIRS];
     uint8_t c;
-    uint8_t tmp[256];
 
-    switch (dev_comm)
-    {
-    case _WEATHER_I2C :
+    //  Consecutive registers are written as pairs, chunk by chunk.
+
+    while (len)
     {
-        tmp[0] = reg;
-        
-        memcpy(&tmp[1], buf, len);
-#if 0
-        hal_i2cStart();
-        hal_i2cWrite( _slaveAddress, tmp, len + 1, END_MODE_STOP );
-#endif
-        
+        for (c = 0; c < len && c < _WEATHER_BURST_MAX_PAIRS; ++c)
+        {
+            regs[c].address = reg++;
+            regs[c].value   = *buf++;
+        }
+
+        write_pairs(regs, c);
+        len -= c;
     }
-    break;
-    case _WEATHER_SPI :
+}
+
+static uint8_t pack_pairs(uint8_t *out, const T_WEATHER_REG *regs, uint8_t count)
+{
+    uint8_t c;
+
+    //  Bit 7 of the address cleared selects SPI write.
+
+    for (c = 0; c < count; ++c)
     {
-        uint8_t c;
+        *out++ = regs[c].address & 0x7F;
+        *out++ = regs[c].value;
+    }
 
-        hal_gpio_csSet(0);
+    return 2 * count;
+}
+
+static void write_pairs(const T_WEATHER_REG *regs, uint8_t count)
+{
+    uint8_t tmp[2 * _WEATHER_BURST_MAX_PAIRS];
+    uint8_t chunk;
+    uint8_t len;
 
-        for (c = 0; c < len; ++c)
+    while (count)
+    {
+        chunk = (count > _WEATHER_BURST_MAX_PAIRS) ? _WEATHER_BURST_MAX_PAIRS : count;
+
+        switch (dev_comm)
+        {
+        case _WEATHER_I2C :
         {
-            tmp[0] = (reg++ & 0x7F);
-            tmp[1] = buf[c];
-            hal_spiWrite(tmp, 2);
+            //  I2C has no auto increment on write, same pairs are sent.
+
+            len = pack_pairs(tmp, regs, chunk);
+#if 0
+            hal_i2cStart();
+            hal_i2cWrite( _slaveAddress, tmp, len, END_MODE_STOP );
+#endif
+            (void)len;
         }
+        break;
+        case _WEATHER_SPI :
 
-        hal_gpio_csSet(1);
-    }
-    break;
-    default :
+            len = pack_pairs(tmp, regs, chunk);
 
-        //  Unknown communication type.
+            spi_bytes += len;
+            hal_gpio_csSet(0);
+            hal_spiWrite(tmp, len);
+            hal_gpio_csSet(1);
 
-    break;
+        break;
+        default :
+
+            //  Unknown communication type.
+
+        break;
+        }
+
+        regs  += chunk;
+        count -= chunk;
     }
 }
 
-static void read_register(uint8_t reg, uint8_t *buf, uint8_t len)
+static int read_register(uint8_t reg, uint8_t *buf, uint8_t len)
 {
+    int err = 1;
+
     switch (dev_comm)
     {
     case _WEATHER_I2C :
@@ -445,9 +570,19 @@ static void read_register(uint8_t reg, uint8_t *buf, uint8_t len)
     break;
     case _WEATHER_SPI :
 
+        //  Address and data jobs are queued together, one wait for both.
+
+        spi_bytes += 1 + len;
         hal_gpio_csSet(0);
-        hal_spiWrite(&reg, 1);
-        hal_spiRead(buf, len);
+        if ((hal_spiWriteStart(&reg, 1) == 0) && 
+            (hal_spiReadStart(buf, len) == 0))
+        {
+            err = 0;
+        }
+        if (hal_spiWait() != 0)
+        {
+            err = 1;
+        }
         hal_gpio_csSet(1);
 
     break;
@@ -457,20 +592,24 @@ static void read_register(uint8_t reg, uint8_t *buf, uint8_t len)
 
     break;
     }
+
+    return err;
 }
 
-static uint16_t read_16bit_reg(uint8_t reg)
+static void read_sample()
 {
-    uint16_t res;
-    uint8_t  tmp[2];
+    uint32_t start = spi_bytes;
 
-    read_register(reg, tmp, 2);
+    if (!calib_valid)
+    {
+        weather_readCalibrationParams();
+    }
 
-    res  = tmp[0];
-    res <<= 8;
-    res |= tmp[1];
+    //  Single burst of 0xF7 - 0xFE data registers.
 
-    return res;
+    weather_readMeasurements();
+
+    sample_bytes = spi_bytes - start;
 }
 
 static int32_t compensate_T()
@@ -479,8 +618,9 @@ static int32_t compensate_T()
     int32_t temp2;
     int32_t valT;
 
-    temp1 = ((((adc_t >> 3) - ((int32_t)dig_T1 << 1))) * ((int32_t)dig_T2)) >> 11;
-    temp2 = (((((adc_t >> 4) - ((int32_t)dig_T1)) * ((adc_t >> 4) - ((int32_t)dig_T1))) >> 12) * ((int32_t)dig_T3)) >> 14;
+    //  Signed arithmetic, dig_T3 and the differences below may be negative.
+    temp1 = (((((int32_t)adc_t >> 3) - ((int32_t)dig_T1 << 1))) * ((int32_t)dig_T2)) >> 11;
+    temp2 = ((((((int32_t)adc_t >> 4) - ((int32_t)dig_T1)) * (((int32_t)adc_t >> 4) - ((int32_t)dig_T1))) >> 12) * ((int32_t)dig_T3)) >> 14;
 
     t_fine = temp1 + temp2;
     valT = (t_fine * 5 + 128) >> 8;
@@ -494,7 +634,7 @@ static uint32_t compensate_H()
     
     valHum = (t_fine - ((int32_t)76800));
     
-    valHum = (((((adc_h << 14) - (((int32_t)dig_H4) << 20) - (((int32_t)dig_H5) * valHum)) +
+    valHum = ((((((int32_t)adc_h << 14) - (((int32_t)dig_H4) << 20) - (((int32_t)dig_H5) * valHum)) +
              ((int32_t)16384)) >> 15) * (((((((valHum * ((int32_t)dig_H6)) >> 10) * 
              (((valHum * ((int32_t )dig_H3)) >> 11) + ((int32_t)32768))) >> 10) + 
              ((int32_t)2097152)) * ((int32_t)dig_H2) + 8192) >> 14));
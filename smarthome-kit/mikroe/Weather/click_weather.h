@@ -36,6 +36,7 @@
 /* -------------------------------------------------------------------------- */
 
 #include <xc.h>
+#include "../click_spi_stats.h"
 
 #ifndef _WEATHER_H_
 #define _WEATHER_H_
@@ -46,6 +47,17 @@
  */
 #define T_WEATHER_P    const uint8_t*
 
+/**
+ * @struct T_WEATHER_REG
+ * @brief Register address and value pair used by burst write
+ */
+typedef struct
+{
+    uint8_t address;
+    uint8_t value;
+
+} T_WEATHER_REG;
+
 #define __WEATHER_DRV_SPI__     ///< \macro __WEATHER_DRV_SPI__  \brief SPI driver selector.
 // #define __WEATHER_DRV_I2C__     ///< \macro __WEATHER_DRV_I2C__  \brief I2C driver selector.
 // #define __WEATHER_DRV_UART__ ///< \macro __WEATHER_DRV_UART__ \brief UART driver selector.
@@ -377,6 +389,40 @@ void weather_uartDriverInit(T_WEATHER_P gpioObj, T_WEATHER_P uartObj);
  */
 void weather_writeData( uint8_t regAddress, uint8_t writeData );
 
+/**
+ * @brief Burst write of register address and value pairs
+ *
+ * @param[in] regs                      Address and value pairs
+ *
+ * @param[in] count                     Number of pairs
+ *
+ * Function writes all pairs in the given order inside of a single chip
+ * select window. Registers do not have to be consecutive. Pairs are
+ * sent in chunks of 8 so stack usage does not depend on count.
+ */
+void weather_writeRegisters( const T_WEATHER_REG *regs, uint8_t count );
+
+/**
+ * @brief Configure function
+ *
+ * @param[in] standby                   Standby time
+ *
+ * @param[in] filter                    IIR filter coefficient
+ *
+ * @param[in] osrsT                     Temperature oversampling
+ *
+ * @param[in] osrsH                     Humidity oversampling
+ *
+ * @param[in] osrsP                     Pressure oversampling
+ *
+ * @param[in] mode                      Power mode
+ *
+ * Function writes humidity control, config and measurement control
+ * registers in one burst, without reading them back first.
+ */
+void weather_configure( uint8_t standby, uint8_t filter, uint8_t osrsT,
+                        uint8_t osrsH, uint8_t osrsP, uint8_t mode );
+
 /**
  * @brief Generic read byte of data function
  *
@@ -463,6 +509,8 @@ uint8_t weather_getConfig();
  *
  * Function read factory calibration parameters value from the
  * calibration registers address of BME280 chip on Weather Click board.
+ * Parameters are cached, measurement functions read them only if this
+ * function was not called before.
  */
 void weather_readCalibrationParams();
 
@@ -587,6 +635,27 @@ float weather_getPressure();
  */
 void weather_getWeather( float *temperature, float *humidity, float *pressure );
 
+/**
+ * @brief Get SPI bytes per sample function
+ *
+ * @return
+ * number of SPI bytes transferred by the last measurement
+ *
+ * Function returns number of bytes exchanged with BME280 chip by the last
+ * call of any measurement function, including calibration read if the
+ * calibration was not cached yet.
+ */
+uint32_t weather_getSampleBytes();
+
+/**
+ * @brief Get SPI statistics function
+ *
+ * @param[out] stats                    SPI jobs and time spent waiting for them
+ *
+ * Function copies SPI transfer statistics of the Weather click driver.
+ */
+void weather_getSpiStats(T_CLICK_SPI_STATS *stats);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
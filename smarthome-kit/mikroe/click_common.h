@@ -9,13 +9,17 @@
 
  ------------------------------------------------------------------------------
 
-- Version               : 1.0.0
+- Version               : 1.4.0
 - Date                  : Dec 2018.
 - Developer             : Milos Vidojevic
     
 ---
 
 - 1.0.0 : Module created (Milos Vidojevic)
+- 1.1.0 : Jobs wait for completion, asynchronous start/wait added
+- 1.2.0 : Chained jobs added
+- 1.3.0 : Late jobs waited for, DMA receive buffers invalidated
+- 1.4.0 : Wait for late jobs bounded
 
 ---
 
@@ -23,6 +27,36 @@
 
 SPI support only.
 
+Every click driver including this file gets its own copy of the HAL state,
+so completions and statistics are kept per driver even when drivers share
+one SPI driver instance.
+
+hal_spiWrite/Read/Transfer return when the data was transferred, chip select
+can be released right after them and the buffers may live on the stack.
+
+hal_spiWriteStart/ReadStart/TransferStart only queue the job, the SPI driver
+completion callback signals it. Caller may do other work and has to call
+hal_spiWait before the buffers are reused or the chip select is released.
+Up to _HAL_SPI_MAX_PENDING jobs may be started before waiting.
+
+The SPI driver can't take a queued job back, so hal_spiWait normally doesn't
+return before every started job completed. A job taking longer than 
+_HAL_SPI_TIMEOUT is counted as an error in the statistics and waited for 
+further, up to _HAL_SPI_WAIT_MAX in total. Then hal_spiWait returns an error
+with the job still started, the driver is stuck and may still access its 
+buffers. New jobs are refused until a later hal_spiWait sees it complete.
+
+Click HAL header defines _HAL_SPI_DMA to 0 before including this file when
+its SPI driver instance has no DMA channels. Otherwise transmit buffers are
+written back from the data cache before the job, and receive buffers are
+invalidated before the job and after its completion. Receive buffers must then
+start on a cache line and span whole cache lines ( _HAL_SPI_CACHE_LINE ),
+jobs with other receive buffers are rejected.
+
+hal_spiChainStart queues several segments as one job. The SPI driver moves
+from one segment to the next inside its interrupt, no other job gets between
+them, and the segment start hooks may switch lines like D/C on the way.
+
 ----------------------------------------------------------------------------- */
 
 #ifndef _HAL_PIC32_HARMONY_
@@ -30,32 +64,354 @@ SPI support only.
 
 #include "system/common/sys_module.h"
 #include "driver/driver_common.h"
+#include "semphr.h"
+#include "click_spi_stats.h"
+
+#define _HAL_SPI_MAX_PENDING        8
+#define _HAL_SPI_TIMEOUT            (100 / portTICK_PERIOD_MS)
+#define _HAL_SPI_WAIT_MAX           (1000 / portTICK_PERIOD_MS)
+#define _HAL_SPI_CACHE_LINE         16
+
+#ifndef _HAL_SPI_DMA
+#define _HAL_SPI_DMA                DRV_SPI_DMA
+#endif
 
 // ----------------------------- MPLAB PIC32 HARMONY HAL TO MIKROSDK ADAPTATION
 
-static DRV_HANDLE spi_obj;
+static DRV_HANDLE           spi_obj;
+static SemaphoreHandle_t    spi_done;       // given once per completed job
+static uint8_t              spi_pending;    // started, not waited for yet
+static uint8_t              spi_late;       // hal_spiWait gave up on a job
+static volatile uint8_t     spi_failed;     // completed with error
+static T_CLICK_SPI_STATS    spi_stats;
+
+#if (_HAL_SPI_DMA == 1)
+//  Receive buffers of the started jobs, invalidated once they complete.
+
+typedef struct
+{
+    uint8_t                         *rx;
+    uint16_t                        size;
+    const DRV_SPI_BUFFER_SEGMENT    *seg;
+    uint8_t                         n_seg;
+
+}T_HAL_SPI_RX;
+
+static T_HAL_SPI_RX         spi_rx[_HAL_SPI_MAX_PENDING];
+#endif
+
+static int hal_spiWait(void);
+
+static void hal_spiDone(DRV_SPI_BUFFER_EVENT event, 
+            DRV_SPI_BUFFER_HANDLE handle, void *context)
+{
+    BaseType_t woken = pdFALSE;
+
+    if (event != DRV_SPI_BUFFER_EVENT_COMPLETE)
+    {
+        spi_failed++;
+    }
+
+    xSemaphoreGiveFromISR(spi_done, &woken);
+    portEND_SWITCHING_ISR(woken);
+}
+
+static int hal_spiQueued(DRV_SPI_BUFFER_HANDLE handle, uint8_t *pRx, 
+            uint16_t nBytes, const DRV_SPI_BUFFER_SEGMENT *pSeg, uint8_t nSeg)
+{
+    if (handle == DRV_SPI_BUFFER_HANDLE_INVALID)
+    {
+        spi_stats.errors++;
+
+        return 1;
+    }
+
+#if (_HAL_SPI_DMA == 1)
+    spi_rx[spi_pending].rx    = pRx;
+    spi_rx[spi_pending].size  = nBytes;
+    spi_rx[spi_pending].seg   = pSeg;
+    spi_rx[spi_pending].n_seg = nSeg;
+#endif
+
+    spi_pending++;
+    spi_stats.jobs++;
+
+    return 0;
+}
+
+static int hal_spiReserve(void)
+{
+    /*
+        Completion count is bounded, make room by waiting for started jobs.
+        Nothing is queued behind a job the last wait gave up on.
+    */
+
+    if ((spi_pending >= _HAL_SPI_MAX_PENDING) || (spi_late != 0))
+    {
+        return hal_spiWait();
+    }
+
+    return 0;
+}
+
+#if (_HAL_SPI_DMA == 1)
+static int hal_spiRxPrepare(uint8_t *pBuf, uint16_t nBytes)
+{
+    //  Invalidating a partial line would drop the neighbouring data.
+
+    if (((uint32_t)pBuf | nBytes) & (_HAL_SPI_CACHE_LINE - 1))
+    {
+        spi_stats.errors++;
+
+        return 1;
+    }
+
+    //  No dirty line may be written back over the received data.
+
+    SYS_DEVCON_DataCacheInvalidate((uint32_t)pBuf, nBytes);
+
+    return 0;
+}
+
+static void hal_spiRxComplete(uint8_t nJobs)
+{
+    T_HAL_SPI_RX *job;
+    uint8_t i;
+    uint8_t j;
+
+    //  Lines speculatively loaded during the transfer hold stale data.
+
+    for (i = 0; i < nJobs; i++)
+    {
+        job = &spi_rx[i];
+
+        if (job->rx != NULL)
+        {
+            SYS_DEVCON_DataCacheInvalidate((uint32_t)job->rx, job->size);
+        }
+
+        for (j = 0; j < job->n_seg; j++)
+        {
+            if (job->seg[j].rxBuffer != NULL)
+            {
+                SYS_DEVCON_DataCacheInvalidate((uint32_t)job->seg[j].rxBuffer, 
+                            job->seg[j].size);
+            }
+        }
+    }
+
+    //  Jobs still running keep their entries, in start order.
+
+    for (i = 0; i < spi_pending; i++)
+    {
+        spi_rx[i] = spi_rx[nJobs + i];
+    }
+}
+#endif
 
 static void hal_spiMap(T_HAL_P spiObj)
 {
     spi_obj = (DRV_HANDLE)spiObj;
+
+    if (spi_done == NULL)
+    {
+        spi_done = xSemaphoreCreateCounting(_HAL_SPI_MAX_PENDING, 0);
+    }
+}
+
+static int hal_spiWriteStart(uint8_t *pBuf, uint16_t nBytes)
+{
+    if (hal_spiReserve() != 0)
+    {
+        return 1;
+    }
+
+#if (_HAL_SPI_DMA == 1)
+    //  DMA reads memory directly, so the cached data must be written back.
+
+    SYS_DEVCON_DataCacheClean((uint32_t)pBuf, nBytes);
+#endif
+
+    return hal_spiQueued(DRV_SPI_BufferAddWrite2(spi_obj, (void*)pBuf, 
+                (size_t)nBytes, hal_spiDone, NULL, NULL), NULL, 0, NULL, 0);
+}
+
+static int hal_spiReadStart(uint8_t *pBuf, uint16_t nBytes)
+{
+    if (hal_spiReserve() != 0)
+    {
+        return 1;
+    }
+
+#if (_HAL_SPI_DMA == 1)
+    if (hal_spiRxPrepare(pBuf, nBytes) != 0)
+    {
+        return 1;
+    }
+#endif
+
+    return hal_spiQueued(DRV_SPI_BufferAddRead2(spi_obj, (void*)pBuf, 
+                (size_t)nBytes, hal_spiDone, NULL, NULL), pBuf, nBytes, NULL, 0);
+}
+
+static int hal_spiTransferStart(uint8_t *pIn, uint8_t *pOut, uint16_t nBytes)
+{
+    if (hal_spiReserve() != 0)
+    {
+        return 1;
+    }
+
+#if (_HAL_SPI_DMA == 1)
+    if (hal_spiRxPrepare(pOut, nBytes) != 0)
+    {
+        return 1;
+    }
+
+    SYS_DEVCON_DataCacheClean((uint32_t)pIn, nBytes);
+#endif
+
+    return hal_spiQueued(DRV_SPI_BufferAddWriteRead2(spi_obj, (void*)pIn, 
+                nBytes, (void*)pOut, nBytes, hal_spiDone, NULL, NULL), 
+                pOut, nBytes, NULL, 0);
+}
+
+static int hal_spiChainStart(const DRV_SPI_BUFFER_SEGMENT *pSeg, uint8_t nSeg)
+{
+#if (_HAL_SPI_DMA == 1)
+    uint8_t i;
+#endif
+
+    if (hal_spiReserve() != 0)
+    {
+        return 1;
+    }
+
+#if (_HAL_SPI_DMA == 1)
+    for (i = 0; i < nSeg; i++)
+    {
+        if (pSeg[i].rxBuffer != NULL && 
+            hal_spiRxPrepare(pSeg[i].rxBuffer, pSeg[i].size) != 0)
+        {
+            return 1;
+        }
+
+        if (pSeg[i].txBuffer != NULL)
+        {
+            SYS_DEVCON_DataCacheClean((uint32_t)pSeg[i].txBuffer, 
+                        pSeg[i].size);
+        }
+    }
+#endif
+
+    //  Segments are read by the driver until the job completes.
+
+    return hal_spiQueued(DRV_SPI_BufferAddChain(spi_obj, pSeg, 
+                (size_t)nSeg, hal_spiDone, NULL, NULL), NULL, 0, pSeg, nSeg);
+}
+
+/*
+    Waits for all started jobs, returns non zero if any of them failed or
+    took longer than _HAL_SPI_TIMEOUT.
+    Late job is still waited for, it owns its buffers and the chip select
+    until the SPI driver completes it. After _HAL_SPI_WAIT_MAX the driver
+    is taken as stuck and the wait returns with the job still started.
+*/
+static int hal_spiWait(void)
+{
+    uint32_t    start;
+    uint32_t    cycles;
+    TickType_t  wait_start;
+    int         err = 0;
+#if (_HAL_SPI_DMA == 1)
+    uint8_t     jobs = spi_pending;
+#endif
+
+    if (spi_pending == 0)
+    {
+        return 0;
+    }
+
+    start = _CP0_GET_COUNT();
+    wait_start = xTaskGetTickCount();
+
+    while (spi_pending != 0)
+    {
+        if (xSemaphoreTake(spi_done, _HAL_SPI_TIMEOUT) == pdTRUE)
+        {
+            spi_pending--;
+
+            continue;
+        }
+
+        if (err == 0)
+        {
+            spi_stats.errors++;
+            err = 1;
+        }
+
+        if ((xTaskGetTickCount() - wait_start) >= _HAL_SPI_WAIT_MAX)
+        {
+            break;
+        }
+    }
+
+    spi_late = (spi_pending != 0);
+
+#if (_HAL_SPI_DMA == 1)
+    hal_spiRxComplete(jobs - spi_pending);
+#endif
+
+    cycles = _CP0_GET_COUNT() - start;
+
+    spi_stats.waits++;
+    spi_stats.wait_cycles += cycles;
+
+    if (cycles > spi_stats.wait_max_cycles)
+    {
+        spi_stats.wait_max_cycles = cycles;
+    }
+
+    if (spi_failed != 0)
+    {
+        spi_stats.errors += spi_failed;
+        spi_failed = 0;
+        err = 1;
+    }
+
+    return err;
+}
+
+static void hal_spiStats(T_CLICK_SPI_STATS *stats)
+{
+    *stats = spi_stats;
+
+    //  Core timer runs at half of the system clock.
+
+    stats->cycles_freq = SYS_CLK_SystemFrequencyGet() / 2;
 }
 
 static void hal_spiWrite(uint8_t *pBuf, uint16_t nBytes)
 {
-    DRV_SPI_BufferAddWrite2(spi_obj, (void*)pBuf, (size_t)nBytes, 
-                NULL, NULL, NULL);    
+    if (hal_spiWriteStart(pBuf, nBytes) == 0)
+    {
+        hal_spiWait();
+    }
 }
 
 static void hal_spiRead(uint8_t *pBuf, uint16_t nBytes)
 {
-    DRV_SPI_BufferAddRead2(spi_obj, (void*)pBuf, (size_t)nBytes, 
-                NULL, NULL, NULL);
+    if (hal_spiReadStart(pBuf, nBytes) == 0)
+    {
+        hal_spiWait();
+    }
 }
 
 static void hal_spiTransfer(uint8_t *pIn, uint8_t *pOut, uint16_t nBytes)
 {
-    DRV_SPI_BufferAddWriteRead2(spi_obj, (void*)pIn, nBytes, (void*)pOut, 
-                nBytes, NULL, NULL, NULL);
+    if (hal_spiTransferStart(pIn, pOut, nBytes) == 0)
+    {
+        hal_spiWait();
+    }
 }
 
 #endif
@@ -0,0 +1,44 @@
+/*
+   click_spi_stats.h
+
+ ------------------------------------------------------------------------------
+
+  Copyright (c) 2017, MikroElektonika - http://www.mikroe.com
+
+  All rights reserved.
+
+ ------------------------------------------------------------------------------
+
+    \note
+
+SPI transfer statistics kept by the click_common.h HAL, one set per click
+driver.
+
+----------------------------------------------------------------------------- */
+
+#ifndef _CLICK_SPI_STATS_H_
+#define _CLICK_SPI_STATS_H_
+
+#include <stdint.h>
+
+/**
+ * \brief Click SPI HAL Statistics
+ *
+ * Wait time is the time the driver task spent blocked in hal_spiWait for
+ * SPI jobs to complete, in core timer cycles. Time between starting a job
+ * and waiting for it is not counted, that time was available to the task.
+ */
+typedef struct
+{
+    uint32_t jobs;              ///< SPI jobs queued to the SPI driver.
+    uint32_t errors;            ///< Rejected, failed or timed out jobs.
+    uint32_t waits;             ///< hal_spiWait calls which had to block.
+    uint32_t wait_max_cycles;   ///< Longest single wait.
+    uint64_t wait_cycles;       ///< Total time spent waiting.
+    uint32_t cycles_freq;       ///< Core timer frequency, Hz.
+
+}T_CLICK_SPI_STATS;
+
+#endif
+
+/* -------------------------------------------------------------------------- */